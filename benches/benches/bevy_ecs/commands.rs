@@ -8,6 +8,8 @@ criterion_group!(
     benches,
     empty_commands,
     spawn_commands,
+    spawn_bundle_commands,
+    insert_commands,
     fake_commands,
     zero_sized_commands,
     medium_sized_commands,
@@ -76,6 +78,60 @@ fn spawn_commands(criterion: &mut Criterion) {
     group.finish();
 }
 
+fn spawn_bundle_commands(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("spawn_bundle_commands");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    for entity_count in (1..5).map(|i| i * 2 * 1000) {
+        group.bench_function(format!("{}_entities", entity_count), |bencher| {
+            let mut world = World::default();
+            let mut command_queue = CommandQueue::default();
+
+            bencher.iter(|| {
+                let mut commands = Commands::new(&mut command_queue, &world);
+                for _ in 0..entity_count {
+                    commands.spawn_bundle((A, B, C));
+                }
+                drop(commands);
+                command_queue.apply(&mut world);
+            });
+        });
+    }
+
+    group.finish();
+}
+
+fn insert_commands(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("insert_commands");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    for entity_count in (1..5).map(|i| i * 2 * 1000) {
+        group.bench_function(format!("{}_entities", entity_count), |bencher| {
+            let mut world = World::default();
+            let entities = world
+                .spawn_batch((0..entity_count).map(|_| (A,)))
+                .collect::<Vec<_>>();
+            let mut command_queue = CommandQueue::default();
+
+            bencher.iter(|| {
+                let mut commands = Commands::new(&mut command_queue, &world);
+                for entity in entities.iter() {
+                    commands.entity(*entity).insert(B);
+                }
+                for entity in entities.iter() {
+                    commands.entity(*entity).remove::<B>();
+                }
+                drop(commands);
+                command_queue.apply(&mut world);
+            });
+        });
+    }
+
+    group.finish();
+}
+
 struct FakeCommandA;
 struct FakeCommandB(u64);
 
@@ -0,0 +1,81 @@
+use bevy::ecs::{entity::Entity, world::World};
+use criterion::{criterion_group, criterion_main, BatchSize, Criterion};
+
+criterion_group!(benches, insert_component, remove_component);
+criterion_main!(benches);
+
+struct Position(f32);
+struct Velocity(f32);
+struct Stunned(f32);
+
+fn setup(entity_count: usize) -> (World, Vec<Entity>) {
+    let mut world = World::default();
+    let entities = world
+        .spawn_batch((0..entity_count).map(|i| (Position(i as f32), Velocity(1.0))))
+        .collect();
+    (world, entities)
+}
+
+fn insert_component(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("insert_component");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    for &entity_count in [100, 1_000, 5_000].iter() {
+        group.bench_function(format!("{}_entities_one_by_one", entity_count), |bencher| {
+            bencher.iter_batched_ref(
+                || setup(entity_count),
+                |(world, entities)| {
+                    for entity in entities.iter() {
+                        world.entity_mut(*entity).insert(Stunned(1.0));
+                    }
+                },
+                BatchSize::LargeInput,
+            );
+        });
+        group.bench_function(format!("{}_entities_batch", entity_count), |bencher| {
+            bencher.iter_batched_ref(
+                || setup(entity_count),
+                |(world, entities)| {
+                    world.insert_bundle_batch(
+                        entities.iter().map(|entity| (*entity, (Stunned(1.0),))),
+                    );
+                },
+                BatchSize::LargeInput,
+            );
+        });
+    }
+
+    group.finish();
+}
+
+fn remove_component(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("remove_component");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    for &entity_count in [100, 1_000, 5_000].iter() {
+        group.bench_function(format!("{}_entities_one_by_one", entity_count), |bencher| {
+            bencher.iter_batched_ref(
+                || setup(entity_count),
+                |(world, entities)| {
+                    for entity in entities.iter() {
+                        world
+                            .entity_mut(*entity)
+                            .remove_bundle_intersection::<(Velocity,)>();
+                    }
+                },
+                BatchSize::LargeInput,
+            );
+        });
+        group.bench_function(format!("{}_entities_batch", entity_count), |bencher| {
+            bencher.iter_batched_ref(
+                || setup(entity_count),
+                |(world, entities)| world.remove_bundle_batch::<(Velocity,)>(entities),
+                BatchSize::LargeInput,
+            );
+        });
+    }
+
+    group.finish();
+}
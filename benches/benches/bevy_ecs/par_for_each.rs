@@ -0,0 +1,46 @@
+use bevy::{
+    ecs::{query::AUTO_BATCH_SIZE, world::World},
+    tasks::TaskPool,
+};
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+
+criterion_group!(benches, par_for_each_batch_sizes);
+criterion_main!(benches);
+
+struct Position(f32);
+struct Velocity(f32);
+
+fn par_for_each_batch_sizes(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("par_for_each_batch_sizes");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    let task_pool = TaskPool::new();
+    for entity_count in [100, 1_000, 10_000, 100_000].iter() {
+        let mut world = World::default();
+        world.spawn_batch((0..*entity_count).map(|i| (Position(i as f32), Velocity(1.0))));
+        let mut query = world.query::<(&mut Position, &Velocity)>();
+
+        for &batch_size in [16, 256, 4096, AUTO_BATCH_SIZE].iter() {
+            let name = if batch_size == AUTO_BATCH_SIZE {
+                format!("{}_entities_auto", entity_count)
+            } else {
+                format!("{}_entities_batch_{}", entity_count, batch_size)
+            };
+            group.bench_function(BenchmarkId::from_parameter(name), |bencher| {
+                bencher.iter(|| {
+                    query.par_for_each_mut(
+                        &mut world,
+                        &task_pool,
+                        batch_size,
+                        |(mut position, velocity)| {
+                            position.0 = black_box(position.0 + velocity.0);
+                        },
+                    );
+                });
+            });
+        }
+    }
+
+    group.finish();
+}
@@ -0,0 +1,79 @@
+use bevy::reflect::{GetPath, Reflect, ReflectPath};
+use criterion::{black_box, criterion_group, criterion_main, Criterion};
+
+criterion_group!(benches, reflect_path);
+criterion_main!(benches);
+
+const INSTANCES: usize = 1000;
+const PATH: &str = "joints[2].transform.scale";
+
+#[derive(Reflect, Default)]
+struct Skeleton {
+    name: String,
+    visible: bool,
+    weight: f32,
+    joints: Vec<Joint>,
+}
+
+#[derive(Reflect, Default)]
+struct Joint {
+    parent: usize,
+    stiffness: f32,
+    length: f32,
+    transform: JointTransform,
+}
+
+#[derive(Reflect, Default)]
+struct JointTransform {
+    translation: f32,
+    rotation: f32,
+    skew: f32,
+    scale: f32,
+}
+
+fn skeletons() -> Vec<Skeleton> {
+    (0..INSTANCES)
+        .map(|_| Skeleton {
+            joints: (0..4).map(|_| Joint::default()).collect(),
+            ..Default::default()
+        })
+        .collect()
+}
+
+/// Writes the same field of many values, like an animation curve targeting many entities
+fn reflect_path(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("reflect_path");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    group.bench_function("get_path", |bencher| {
+        let mut skeletons = skeletons();
+        bencher.iter(|| {
+            for skeleton in skeletons.iter_mut() {
+                *skeleton.get_path_mut::<f32>(black_box(PATH)).unwrap() += 1.0;
+            }
+        });
+    });
+
+    group.bench_function("parsed_path", |bencher| {
+        let mut skeletons = skeletons();
+        let path = ReflectPath::parse(PATH).unwrap();
+        bencher.iter(|| {
+            for skeleton in skeletons.iter_mut() {
+                *path.element_mut::<f32>(skeleton).unwrap() += 1.0;
+            }
+        });
+    });
+
+    group.bench_function("parse_and_apply", |bencher| {
+        let mut skeletons = skeletons();
+        bencher.iter(|| {
+            let path = ReflectPath::parse(black_box(PATH)).unwrap();
+            for skeleton in skeletons.iter_mut() {
+                *path.element_mut::<f32>(skeleton).unwrap() += 1.0;
+            }
+        });
+    });
+
+    group.finish();
+}
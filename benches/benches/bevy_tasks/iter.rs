@@ -52,6 +52,40 @@ fn bench_overhead(c: &mut Criterion) {
     group.finish();
 }
 
+fn bench_small_tasks(c: &mut Criterion) {
+    fn small_work(x: &mut usize) {
+        for _ in 0..10 {
+            *x = black_box(x.wrapping_mul(3));
+        }
+    }
+
+    let mut v = (0..100_000).collect::<Vec<usize>>();
+    let mut group = c.benchmark_group("small_tasks_par_iter");
+    for thread_count in &[1, 2, 4, 8, 16, 32] {
+        for &work_stealing in &[false, true] {
+            let pool = TaskPoolBuilder::new()
+                .num_threads(*thread_count)
+                .work_stealing(work_stealing)
+                .build();
+            let name = if work_stealing {
+                "work_stealing_threads"
+            } else {
+                "threads"
+            };
+            group.bench_with_input(
+                BenchmarkId::new(name, thread_count),
+                thread_count,
+                |b, _| {
+                    b.iter(|| {
+                        ParChunksMut(v.chunks_mut(10)).for_each(&pool, small_work);
+                    })
+                },
+            );
+        }
+    }
+    group.finish();
+}
+
 fn bench_for_each(c: &mut Criterion) {
     fn busy_work(n: usize) {
         let mut i = n;
@@ -144,5 +178,11 @@ fn bench_many_maps(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_overhead, bench_for_each, bench_many_maps);
+criterion_group!(
+    benches,
+    bench_overhead,
+    bench_small_tasks,
+    bench_for_each,
+    bench_many_maps
+);
 criterion_main!(benches);
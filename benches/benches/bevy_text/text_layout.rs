@@ -0,0 +1,94 @@
+use bevy::{
+    app::App,
+    asset::{AddAsset, AssetPlugin, Assets},
+    core::CorePlugin,
+    ecs::entity::Entity,
+    math::Size,
+    render::texture::Texture,
+    sprite::TextureAtlas,
+    text::{DefaultTextPipeline, Font, FontAtlasSet, TextAlignment, TextSection, TextStyle},
+};
+use criterion::{criterion_group, criterion_main, Criterion};
+
+criterion_group!(benches, text_churn);
+criterion_main!(benches);
+
+struct TextAssets {
+    fonts: Assets<Font>,
+    font_atlas_sets: Assets<FontAtlasSet>,
+    texture_atlases: Assets<TextureAtlas>,
+    textures: Assets<Texture>,
+}
+
+fn setup() -> (TextAssets, TextStyle) {
+    let mut app = App::build();
+    app.add_plugin(CorePlugin::default())
+        .add_plugin(AssetPlugin::default())
+        .add_asset::<Font>()
+        .add_asset::<FontAtlasSet>()
+        .add_asset::<TextureAtlas>()
+        .add_asset::<Texture>();
+    let world = app.world_mut();
+    let mut assets = TextAssets {
+        fonts: world.remove_resource().unwrap(),
+        font_atlas_sets: world.remove_resource().unwrap(),
+        texture_atlases: world.remove_resource().unwrap(),
+        textures: world.remove_resource().unwrap(),
+    };
+    let font =
+        Font::try_from_bytes(include_bytes!("../../../assets/fonts/FiraSans-Bold.ttf").to_vec())
+            .unwrap();
+    let style = TextStyle {
+        font: assets.fonts.add(font),
+        ..Default::default()
+    };
+    (assets, style)
+}
+
+/// Damage number like text: values and sizes change every frame, a few values repeat
+fn text_churn(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("text_churn");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    for distinct_values in [16, 256, 4096].iter().copied() {
+        group.bench_function(format!("{}_distinct_values", distinct_values), |bencher| {
+            let (mut assets, style) = setup();
+            let mut pipeline = DefaultTextPipeline::default();
+            // small enough for atlases of sizes no text uses anymore to be evicted
+            pipeline.max_font_atlas_bytes = 4 * 1024 * 1024;
+            let mut frame = 0u32;
+
+            bencher.iter(|| {
+                frame += 1;
+                for i in 0..100u32 {
+                    let value =
+                        frame.wrapping_mul(7919).wrapping_add(i * 104_729) % distinct_values;
+                    let sections = [TextSection {
+                        value: format!("-{}", value),
+                        style: TextStyle {
+                            font_size: 16.0 + (value % 8) as f32 * 4.0,
+                            ..style.clone()
+                        },
+                    }];
+                    pipeline
+                        .queue_text(
+                            Entity::new(i),
+                            &assets.fonts,
+                            &sections,
+                            1.0,
+                            TextAlignment::default(),
+                            Size::new(f32::MAX, f32::MAX),
+                            &mut assets.font_atlas_sets,
+                            &mut assets.texture_atlases,
+                            &mut assets.textures,
+                        )
+                        .unwrap();
+                }
+                pipeline.evict_font_atlases(&mut assets.font_atlas_sets, &assets.texture_atlases);
+            });
+        });
+    }
+
+    group.finish();
+}
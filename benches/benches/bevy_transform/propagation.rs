@@ -0,0 +1,100 @@
+use bevy::{
+    ecs::{
+        entity::Entity,
+        schedule::{Schedule, Stage, SystemStage},
+        system::IntoSystem,
+        world::World,
+    },
+    tasks::{ComputeTaskPool, TaskPool},
+    transform::{
+        components::{GlobalTransform, Transform},
+        hierarchy::{parent_update_system, BuildWorldChildren},
+        transform_propagate_system::transform_propagate_system,
+    },
+};
+use criterion::{criterion_group, criterion_main, Criterion};
+
+criterion_group!(benches, transform_propagation);
+criterion_main!(benches);
+
+const ENTITY_COUNT: usize = 50_000;
+
+fn setup_schedule(world: &mut World) -> Schedule {
+    world.insert_resource(ComputeTaskPool(TaskPool::default()));
+
+    let mut update_stage = SystemStage::parallel();
+    update_stage.add_system(parent_update_system.system());
+    update_stage.add_system(transform_propagate_system.system());
+
+    let mut schedule = Schedule::default();
+    schedule.add_stage("update", update_stage);
+    schedule
+}
+
+/// Spawns `roots` hierarchies of `depth` levels below the root, each entity having `width`
+/// children
+fn spawn_hierarchy(world: &mut World, roots: usize, depth: usize, width: usize) {
+    fn spawn_children(world: &mut World, parent: Entity, depth: usize, width: usize) {
+        if depth == 0 {
+            return;
+        }
+        let children = (0..width)
+            .map(|_| {
+                let child = world
+                    .spawn()
+                    .insert_bundle((
+                        Transform::from_xyz(0.0, 1.0, 0.0),
+                        GlobalTransform::identity(),
+                    ))
+                    .id();
+                spawn_children(world, child, depth - 1, width);
+                child
+            })
+            .collect::<Vec<_>>();
+        world.entity_mut(parent).push_children(&children);
+    }
+
+    for _ in 0..roots {
+        let root = world
+            .spawn()
+            .insert_bundle((Transform::identity(), GlobalTransform::identity()))
+            .id();
+        spawn_children(world, root, depth, width);
+    }
+}
+
+fn transform_propagation(criterion: &mut Criterion) {
+    let mut group = criterion.benchmark_group("transform_propagation");
+    group.warm_up_time(std::time::Duration::from_millis(500));
+    group.measurement_time(std::time::Duration::from_secs(4));
+
+    // (name, roots, depth, width), each with roughly ENTITY_COUNT entities
+    let shapes = [
+        ("deep", ENTITY_COUNT / 100, 100, 1),
+        ("wide", ENTITY_COUNT / 1000, 1, 999),
+        ("balanced", ENTITY_COUNT / 156, 3, 5),
+    ];
+    for &(name, roots, depth, width) in shapes.iter() {
+        let mut world = World::default();
+        let mut schedule = setup_schedule(&mut world);
+        spawn_hierarchy(&mut world, roots, depth, width);
+        schedule.run(&mut world);
+
+        group.bench_function(format!("{}_all_changed", name), |bencher| {
+            bencher.iter(|| {
+                for mut transform in world.query::<&mut Transform>().iter_mut(&mut world) {
+                    transform.translation.x += 1.0;
+                }
+                schedule.run(&mut world);
+            });
+        });
+
+        group.bench_function(format!("{}_unchanged", name), |bencher| {
+            bencher.iter(|| {
+                schedule.run(&mut world);
+            });
+        });
+    }
+
+    group.finish();
+}
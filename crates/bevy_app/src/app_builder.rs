@@ -5,7 +5,7 @@ use crate::{
 };
 use bevy_ecs::{
     component::{Component, ComponentDescriptor},
-    event::Events,
+    event::{ConcurrentEvents, Events},
     schedule::{
         IntoSystemDescriptor, RunOnce, Schedule, Stage, StageLabel, State, SystemSet, SystemStage,
     },
@@ -318,6 +318,22 @@ impl AppBuilder {
             .add_system_to_stage(CoreStage::First, Events::<T>::update_system.system())
     }
 
+    /// Setup the application to manage events of type `T` that can be sent from several systems
+    /// in parallel.
+    ///
+    /// This is done by adding a `Resource` of type `ConcurrentEvents::<T>`,
+    /// and inserting a `ConcurrentEvents::<T>::update_system` system into `CoreStage::First`.
+    pub fn add_concurrent_event<T>(&mut self) -> &mut Self
+    where
+        T: Component,
+    {
+        self.insert_resource(ConcurrentEvents::<T>::default())
+            .add_system_to_stage(
+                CoreStage::First,
+                ConcurrentEvents::<T>::update_system.system(),
+            )
+    }
+
     /// Inserts a resource to the current [App] and overwrites any resource previously added of the same type.
     ///
     /// A resource in Bevy represents globally unique data. Resources must be added to Bevy Apps
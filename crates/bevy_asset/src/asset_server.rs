@@ -1,8 +1,8 @@
 use crate::{
     path::{AssetPath, AssetPathId, SourcePathId},
     Asset, AssetIo, AssetIoError, AssetLifecycle, AssetLifecycleChannel, AssetLifecycleEvent,
-    AssetLoader, Assets, Handle, HandleId, HandleUntyped, LabelId, LoadContext, LoadState,
-    RefChange, RefChangeChannel, SourceInfo, SourceMeta,
+    AssetLoader, Assets, Handle, HandleId, HandleUntyped, LabelId, LoadContext, LoadPriority,
+    LoadQueue, LoadState, RefChange, RefChangeChannel, SourceInfo, SourceMeta,
 };
 use anyhow::Result;
 use bevy_ecs::system::{Res, ResMut};
@@ -56,6 +56,7 @@ pub struct AssetServerInternal {
     loaders: RwLock<Vec<Arc<Box<dyn AssetLoader>>>>,
     extension_to_loader_index: RwLock<HashMap<String, usize>>,
     handle_to_path: Arc<RwLock<HashMap<HandleId, AssetPath<'static>>>>,
+    load_queue: Mutex<LoadQueue>,
     task_pool: TaskPool,
 }
 
@@ -86,6 +87,7 @@ impl AssetServer {
                 asset_ref_counter: Default::default(),
                 handle_to_path: Default::default(),
                 asset_lifecycles: Default::default(),
+                load_queue: Default::default(),
                 task_pool,
                 asset_io,
             }),
@@ -115,6 +117,30 @@ impl AssetServer {
         loaders.push(Arc::new(Box::new(loader)));
     }
 
+    /// Limits how many asset sources are loaded at the same time. Further loads wait in a queue
+    /// ordered by [`LoadPriority`] and report [`LoadState::Queued`]. `None` (the default) starts
+    /// every load right away.
+    pub fn set_max_loads_in_flight(&self, max_in_flight: Option<usize>) {
+        self.server.load_queue.lock().max_in_flight = max_in_flight;
+        self.start_queued_loads();
+    }
+
+    /// The number of asset sources that are currently being loaded
+    pub fn loads_in_flight(&self) -> usize {
+        self.server.load_queue.lock().in_flight
+    }
+
+    /// The number of asset sources waiting for a free load slot
+    pub fn queued_load_count(&self) -> usize {
+        self.server.load_queue.lock().len()
+    }
+
+    /// The [`AssetIo`] assets are read from, for reading files outside of [`AssetLoader`]s (ex:
+    /// streaming)
+    pub fn asset_io(&self) -> &dyn AssetIo {
+        &*self.server.asset_io
+    }
+
     pub fn watch_for_changes(&self) -> Result<(), AssetServerError> {
         self.server.asset_io.watch_for_changes()?;
         Ok(())
@@ -202,7 +228,7 @@ impl AssetServer {
             match handle_id {
                 HandleId::AssetPathId(id) => match self.get_load_state(id) {
                     LoadState::Loaded => continue,
-                    LoadState::Loading => {
+                    LoadState::Queued | LoadState::Loading => {
                         load_state = LoadState::Loading;
                     }
                     LoadState::Failed => return LoadState::Failed,
@@ -233,46 +259,72 @@ impl AssetServer {
         self.load_untyped(path).typed()
     }
 
+    /// Like [`AssetServer::load`], but queued loads with a higher `priority` start first. Loads
+    /// only wait in the queue when [`AssetServer::set_max_loads_in_flight`] is set. If every
+    /// handle to a queued asset is dropped before its load starts, the load is cancelled.
+    #[must_use = "not using the returned strong handle may result in the unexpected release of the asset"]
+    pub fn load_with_priority<'a, T: Asset, P: Into<AssetPath<'a>>>(
+        &self,
+        path: P,
+        priority: LoadPriority,
+    ) -> Handle<T> {
+        self.load_untyped_with_priority(path, priority).typed()
+    }
+
     async fn load_async(
         &self,
         asset_path: AssetPath<'_>,
         force: bool,
+        priority: LoadPriority,
     ) -> Result<AssetPathId, AssetServerError> {
-        let asset_path_id: AssetPathId = asset_path.get_id();
+        match self.begin_load(&asset_path, force) {
+            Some(version) => self.load_begun(asset_path, version, priority).await,
+            None => Ok(asset_path.get_id()),
+        }
+    }
 
-        // load metadata and update source info. this is done in a scope to ensure we release the
-        // locks before loading
-        let version = {
-            let mut asset_sources = self.server.asset_sources.write();
-            let source_info = match asset_sources.entry(asset_path_id.source_path_id()) {
-                Entry::Occupied(entry) => entry.into_mut(),
-                Entry::Vacant(entry) => entry.insert(SourceInfo {
-                    asset_types: Default::default(),
-                    committed_assets: Default::default(),
-                    load_state: LoadState::NotLoaded,
-                    meta: None,
-                    path: asset_path.path().to_owned(),
-                    version: 0,
-                }),
-            };
+    /// Marks the source of `asset_path` as [`LoadState::Loading`] and returns the version of the
+    /// new load. Returns `None` if the source doesn't need to be loaded.
+    fn begin_load(&self, asset_path: &AssetPath<'_>, force: bool) -> Option<usize> {
+        let asset_path_id: AssetPathId = asset_path.get_id();
+        let mut asset_sources = self.server.asset_sources.write();
+        let source_info = match asset_sources.entry(asset_path_id.source_path_id()) {
+            Entry::Occupied(entry) => entry.into_mut(),
+            Entry::Vacant(entry) => entry.insert(SourceInfo {
+                asset_types: Default::default(),
+                committed_assets: Default::default(),
+                load_state: LoadState::NotLoaded,
+                meta: None,
+                path: asset_path.path().to_owned(),
+                version: 0,
+            }),
+        };
 
-            // if asset is already loaded or is loading, don't load again
-            if !force
-                && (source_info
-                    .committed_assets
-                    .contains(&asset_path_id.label_id())
-                    || source_info.load_state == LoadState::Loading)
-            {
-                return Ok(asset_path_id);
-            }
+        // if asset is already loaded or is loading, don't load again
+        if !force
+            && (source_info
+                .committed_assets
+                .contains(&asset_path_id.label_id())
+                || source_info.load_state == LoadState::Loading)
+        {
+            return None;
+        }
 
-            source_info.load_state = LoadState::Loading;
-            source_info.committed_assets.clear();
-            source_info.version += 1;
-            source_info.meta = None;
-            source_info.version
-        };
+        source_info.load_state = LoadState::Loading;
+        source_info.committed_assets.clear();
+        source_info.version += 1;
+        source_info.meta = None;
+        Some(source_info.version)
+    }
 
+    /// Loads the source of `asset_path` after [`AssetServer::begin_load`] started loading it
+    async fn load_begun(
+        &self,
+        asset_path: AssetPath<'_>,
+        version: usize,
+        priority: LoadPriority,
+    ) -> Result<AssetPathId, AssetServerError> {
+        let asset_path_id: AssetPathId = asset_path.get_id();
         let set_asset_failed = || {
             let mut asset_sources = self.server.asset_sources.write();
             let source_info = asset_sources
@@ -291,7 +343,12 @@ impl AssetServer {
         };
 
         // load the asset bytes
-        let bytes = match self.server.asset_io.load_path(asset_path.path()).await {
+        let bytes = match self
+            .server
+            .asset_io
+            .load_path_shared(asset_path.path())
+            .await
+        {
             Ok(bytes) => bytes,
             Err(err) => {
                 set_asset_failed();
@@ -341,14 +398,20 @@ impl AssetServer {
             assets: load_context.get_asset_metas(),
         });
 
-        // load asset dependencies and prepare asset type hashmap
+        // prepare asset type hashmap and collect asset dependencies
+        let mut dependencies = Vec::new();
         for (label, loaded_asset) in load_context.labeled_assets.iter_mut() {
             let label_id = LabelId::from(label.as_ref().map(|label| label.as_str()));
             let type_uuid = loaded_asset.value.as_ref().unwrap().type_uuid();
             source_info.asset_types.insert(label_id, type_uuid);
-            for dependency in loaded_asset.dependencies.iter() {
-                self.load_untracked(dependency.clone(), false);
-            }
+            dependencies.extend(loaded_asset.dependencies.iter().cloned());
+        }
+        // queueing a load locks the asset sources
+        drop(asset_sources);
+
+        // dependencies are needed as urgently as the asset that depends on them
+        for dependency in dependencies {
+            self.queue_load(dependency, false, priority, false);
         }
 
         self.server
@@ -361,22 +424,33 @@ impl AssetServer {
 
     #[must_use = "not using the returned strong handle may result in the unexpected release of the asset"]
     pub fn load_untyped<'a, P: Into<AssetPath<'a>>>(&self, path: P) -> HandleUntyped {
-        let handle_id = self.load_untracked(path.into(), false);
-        self.get_handle_untyped(handle_id)
+        self.load_untyped_with_priority(path, LoadPriority::default())
+    }
+
+    #[must_use = "not using the returned strong handle may result in the unexpected release of the asset"]
+    pub fn load_untyped_with_priority<'a, P: Into<AssetPath<'a>>>(
+        &self,
+        path: P,
+        priority: LoadPriority,
+    ) -> HandleUntyped {
+        let asset_path = path.into();
+        // the handle is created first so the queued load can't be cancelled before it is used
+        let handle = self.get_handle_untyped(asset_path.get_id());
+        self.queue_load(asset_path, false, priority, true);
+        handle
     }
 
     pub(crate) fn load_untracked(&self, asset_path: AssetPath<'_>, force: bool) -> HandleId {
-        let server = self.clone();
-        let owned_path = asset_path.to_owned();
-        self.server
-            .task_pool
-            .spawn(async move {
-                if let Err(err) = server.load_async(owned_path, force).await {
-                    warn!("{}", err);
-                }
-            })
-            .detach();
+        self.queue_load(asset_path, force, LoadPriority::default(), false)
+    }
 
+    fn queue_load(
+        &self,
+        asset_path: AssetPath<'_>,
+        force: bool,
+        priority: LoadPriority,
+        cancellable: bool,
+    ) -> HandleId {
         let handle_id = asset_path.get_id().into();
         self.server
             .handle_to_path
@@ -384,7 +458,81 @@ impl AssetServer {
             .entry(handle_id)
             .or_insert_with(|| asset_path.to_owned());
 
-        asset_path.into()
+        if self.mark_queued(&asset_path, force) {
+            self.server
+                .load_queue
+                .lock()
+                .push(asset_path.to_owned(), priority, force, cancellable);
+            self.start_queued_loads();
+        }
+
+        handle_id
+    }
+
+    /// Marks the source of `asset_path` as [`LoadState::Queued`]. Returns false if it doesn't
+    /// need to be loaded.
+    fn mark_queued(&self, asset_path: &AssetPath<'_>, force: bool) -> bool {
+        let asset_path_id = asset_path.get_id();
+        let mut asset_sources = self.server.asset_sources.write();
+        let source_info = asset_sources
+            .entry(asset_path_id.source_path_id())
+            .or_insert_with(|| SourceInfo {
+                asset_types: Default::default(),
+                committed_assets: Default::default(),
+                load_state: LoadState::NotLoaded,
+                meta: None,
+                path: asset_path.path().to_owned(),
+                version: 0,
+            });
+        if !force
+            && (source_info
+                .committed_assets
+                .contains(&asset_path_id.label_id())
+                || source_info.load_state == LoadState::Loading)
+        {
+            return false;
+        }
+        // a forced reload of a loading asset keeps reporting `Loading`
+        if source_info.load_state != LoadState::Loading {
+            source_info.load_state = LoadState::Queued;
+        }
+        true
+    }
+
+    /// Starts queued loads until the queue is empty or the in flight limit is reached
+    fn start_queued_loads(&self) {
+        loop {
+            let queued_load = self.server.load_queue.lock().pop();
+            let queued_load = if let Some(queued_load) = queued_load {
+                queued_load
+            } else {
+                break;
+            };
+
+            // the source is marked as loading right away, so requests made before the load task
+            // runs don't queue it again
+            let version = match self.begin_load(&queued_load.asset_path, queued_load.force) {
+                Some(version) => version,
+                None => {
+                    self.server.load_queue.lock().finish();
+                    continue;
+                }
+            };
+            let server = self.clone();
+            self.server
+                .task_pool
+                .spawn(async move {
+                    if let Err(err) = server
+                        .load_begun(queued_load.asset_path, version, queued_load.priority)
+                        .await
+                    {
+                        warn!("{}", err);
+                    }
+                    server.server.load_queue.lock().finish();
+                    server.start_queued_loads();
+                })
+                .detach();
+        }
     }
 
     #[must_use = "not using the returned strong handles may result in the unexpected release of the assets"]
@@ -420,11 +568,16 @@ impl AssetServer {
         let mut potential_frees = self.server.asset_ref_counter.mark_unused_assets.lock();
 
         if !potential_frees.is_empty() {
+            let mut cancelled_loads = Vec::new();
             let ref_counts = self.server.asset_ref_counter.ref_counts.read();
             let asset_sources = self.server.asset_sources.read();
             let asset_lifecycles = self.server.asset_lifecycles.read();
+            let mut load_queue = self.server.load_queue.lock();
             for potential_free in potential_frees.drain(..) {
                 if let Some(&0) = ref_counts.get(&potential_free) {
+                    // don't start loading assets nobody uses anymore
+                    cancelled_loads.extend(load_queue.cancel(potential_free));
+
                     let type_uuid = match potential_free {
                         HandleId::Id(type_uuid, _) => Some(type_uuid),
                         HandleId::AssetPathId(id) => asset_sources
@@ -439,6 +592,19 @@ impl AssetServer {
                     }
                 }
             }
+            drop(load_queue);
+            drop(asset_sources);
+
+            if !cancelled_loads.is_empty() {
+                let mut asset_sources = self.server.asset_sources.write();
+                for source_path_id in cancelled_loads {
+                    if let Some(source_info) = asset_sources.get_mut(&source_path_id) {
+                        if source_info.load_state == LoadState::Queued {
+                            source_info.load_state = LoadState::NotLoaded;
+                        }
+                    }
+                }
+            }
         }
     }
 
@@ -557,6 +723,7 @@ mod test {
     use bevy_ecs::prelude::*;
     use bevy_reflect::TypeUuid;
     use bevy_utils::BoxedFuture;
+    use std::sync::atomic::{AtomicUsize, Ordering};
 
     #[derive(Debug, TypeUuid)]
     #[uuid = "a5189b72-0572-4290-a2e0-96f73a491c44"]
@@ -578,6 +745,27 @@ mod test {
         }
     }
 
+    #[derive(Default)]
+    struct CountingPngLoader {
+        loads: Arc<AtomicUsize>,
+    }
+    impl AssetLoader for CountingPngLoader {
+        fn load<'a>(
+            &'a self,
+            _: &'a [u8],
+            ctx: &'a mut LoadContext,
+        ) -> BoxedFuture<'a, Result<(), anyhow::Error>> {
+            self.loads.fetch_add(1, Ordering::Relaxed);
+            ctx.set_default_asset(LoadedAsset::new(PngAsset));
+            ctx.set_labeled_asset("Other", LoadedAsset::new(PngAsset));
+            Box::pin(async move { Ok(()) })
+        }
+
+        fn extensions(&self) -> &[&str] {
+            &["png"]
+        }
+    }
+
     struct FailingLoader;
     impl AssetLoader for FailingLoader {
         fn load<'a>(
@@ -619,6 +807,7 @@ mod test {
                 asset_ref_counter: Default::default(),
                 handle_to_path: Default::default(),
                 asset_lifecycles: Default::default(),
+                load_queue: Default::default(),
                 task_pool: Default::default(),
                 asset_io: Box::new(FileAssetIo::new(asset_path)),
             }),
@@ -717,8 +906,12 @@ mod test {
         let path: AssetPath = "file.not-a-real-extension".into();
         let handle = asset_server.get_handle_untyped(path.get_id());
 
-        let err = futures_lite::future::block_on(asset_server.load_async(path.clone(), true))
-            .unwrap_err();
+        let err = futures_lite::future::block_on(asset_server.load_async(
+            path.clone(),
+            true,
+            LoadPriority::default(),
+        ))
+        .unwrap_err();
         assert!(match err {
             AssetServerError::MissingAssetLoader { extensions } => {
                 extensions == ["not-a-real-extension"]
@@ -737,8 +930,12 @@ mod test {
         let path: AssetPath = "an/invalid/path.png".into();
         let handle = asset_server.get_handle_untyped(path.get_id());
 
-        let err = futures_lite::future::block_on(asset_server.load_async(path.clone(), true))
-            .unwrap_err();
+        let err = futures_lite::future::block_on(asset_server.load_async(
+            path.clone(),
+            true,
+            LoadPriority::default(),
+        ))
+        .unwrap_err();
         assert!(matches!(err, AssetServerError::AssetIoError(_)));
 
         assert_eq!(asset_server.get_load_state(handle), LoadState::Failed);
@@ -753,13 +950,42 @@ mod test {
         let path: AssetPath = "fake.fail".into();
         let handle = asset_server.get_handle_untyped(path.get_id());
 
-        let err = futures_lite::future::block_on(asset_server.load_async(path.clone(), true))
-            .unwrap_err();
+        let err = futures_lite::future::block_on(asset_server.load_async(
+            path.clone(),
+            true,
+            LoadPriority::default(),
+        ))
+        .unwrap_err();
         assert!(matches!(err, AssetServerError::AssetLoaderError(_)));
 
         assert_eq!(asset_server.get_load_state(handle), LoadState::Failed);
     }
 
+    #[test]
+    fn queued_loads_of_one_source_load_it_once() {
+        let dir = create_dir_and_file("fake.png");
+        let asset_server = setup(dir.path());
+        let loader = CountingPngLoader::default();
+        let loads = loader.loads.clone();
+        asset_server.add_loader(loader);
+        let _assets = asset_server.register_asset_type::<PngAsset>();
+
+        // requested in the same frame, before the first load task runs
+        let handles = [
+            asset_server.load_untyped("fake.png"),
+            asset_server.load_untyped("fake.png#Other"),
+            asset_server.load_untyped("fake.png"),
+        ];
+        assert_eq!(asset_server.get_load_state(&handles[0]), LoadState::Loading);
+
+        let start = std::time::Instant::now();
+        while asset_server.server.load_queue.lock().in_flight > 0 {
+            assert!(start.elapsed() < std::time::Duration::from_secs(10));
+            std::thread::sleep(std::time::Duration::from_millis(1));
+        }
+        assert_eq!(loads.load(Ordering::Relaxed), 1);
+    }
+
     #[test]
     fn test_asset_lifecycle() {
         let dir = create_dir_and_file("fake.png");
@@ -785,8 +1011,12 @@ mod test {
 
         fn load_asset(path: AssetPath, world: &World) -> HandleUntyped {
             let asset_server = world.get_resource::<AssetServer>().unwrap();
-            let id = futures_lite::future::block_on(asset_server.load_async(path.clone(), true))
-                .unwrap();
+            let id = futures_lite::future::block_on(asset_server.load_async(
+                path.clone(),
+                true,
+                LoadPriority::default(),
+            ))
+            .unwrap();
             asset_server.get_handle_untyped(id)
         }
 
@@ -0,0 +1,40 @@
+use crate::AssetServer;
+use bevy_app::prelude::*;
+use bevy_diagnostic::{Diagnostic, DiagnosticId, Diagnostics};
+use bevy_ecs::system::{IntoSystem, Res, ResMut};
+
+/// Adds "asset loads queued" and "asset loads in flight" diagnostics to an App
+#[derive(Default)]
+pub struct AssetLoadQueueDiagnosticsPlugin;
+
+impl Plugin for AssetLoadQueueDiagnosticsPlugin {
+    fn build(&self, app: &mut AppBuilder) {
+        app.add_startup_system(Self::setup_system.system())
+            .add_system(Self::diagnostic_system.system());
+    }
+}
+
+impl AssetLoadQueueDiagnosticsPlugin {
+    pub const QUEUED_LOADS: DiagnosticId =
+        DiagnosticId::from_u128(70392019467857804939683410340026506718);
+    pub const LOADS_IN_FLIGHT: DiagnosticId =
+        DiagnosticId::from_u128(280960263876040248222111247209606001076);
+
+    pub fn setup_system(mut diagnostics: ResMut<Diagnostics>) {
+        diagnostics.add(Diagnostic::new(
+            Self::QUEUED_LOADS,
+            "asset_loads_queued",
+            20,
+        ));
+        diagnostics.add(Diagnostic::new(
+            Self::LOADS_IN_FLIGHT,
+            "asset_loads_in_flight",
+            20,
+        ));
+    }
+
+    pub fn diagnostic_system(mut diagnostics: ResMut<Diagnostics>, asset_server: Res<AssetServer>) {
+        diagnostics.add_measurement(Self::QUEUED_LOADS, asset_server.queued_load_count() as f64);
+        diagnostics.add_measurement(Self::LOADS_IN_FLIGHT, asset_server.loads_in_flight() as f64);
+    }
+}
@@ -1,2 +1,4 @@
 mod asset_count_diagnostics_plugin;
 pub use asset_count_diagnostics_plugin::AssetCountDiagnosticsPlugin;
+mod asset_load_queue_diagnostics_plugin;
+pub use asset_load_queue_diagnostics_plugin::AssetLoadQueueDiagnosticsPlugin;
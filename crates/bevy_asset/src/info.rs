@@ -43,6 +43,9 @@ impl SourceInfo {
 pub enum LoadState {
     /// The asset has not be loaded.
     NotLoaded,
+    /// The asset is waiting for a free load slot, see
+    /// [`AssetServer::set_max_loads_in_flight`](crate::AssetServer::set_max_loads_in_flight).
+    Queued,
     /// The asset in the the process of loading.
     Loading,
     /// The asset has loaded and is living inside an [`Assets`](crate::Assets) collection.
@@ -0,0 +1,215 @@
+use crate::{
+    slice_asset_bytes, ArchiveCompression, ArchiveIndex, AssetBytes, AssetIo, AssetIoError,
+};
+use anyhow::Result;
+use bevy_utils::BoxedFuture;
+use parking_lot::Mutex;
+use std::{
+    fs::File,
+    io::{BufReader, Read, Seek, SeekFrom},
+    ops::Range,
+    path::{Path, PathBuf},
+};
+
+/// An [`AssetIo`] that reads assets from a single archive file written by
+/// [`AssetArchiveBuilder`](crate::AssetArchiveBuilder).
+///
+/// The archive index is read once when the archive is opened, after which looking up a path is
+/// a hash map probe instead of a filesystem open. Paths that are not in the archive are passed
+/// on to the fallback [`AssetIo`], if there is one.
+pub struct ArchiveAssetIo {
+    file: Mutex<File>,
+    path: PathBuf,
+    index: ArchiveIndex,
+    fallback: Option<Box<dyn AssetIo>>,
+}
+
+impl ArchiveAssetIo {
+    pub fn open<P: AsRef<Path>>(path: P) -> Result<Self, AssetIoError> {
+        let path = path.as_ref();
+        let mut file = File::open(path).map_err(|e| {
+            if e.kind() == std::io::ErrorKind::NotFound {
+                AssetIoError::NotFound(path.to_owned())
+            } else {
+                e.into()
+            }
+        })?;
+        let index = ArchiveIndex::read(&mut BufReader::new(&mut file))?;
+        Ok(Self {
+            file: Mutex::new(file),
+            path: path.to_owned(),
+            index,
+            fallback: None,
+        })
+    }
+
+    /// Loads assets that are not in the archive from `fallback` (ex: the platform default
+    /// [`AssetIo`] during development)
+    pub fn with_fallback(mut self, fallback: Box<dyn AssetIo>) -> Self {
+        self.fallback = Some(fallback);
+        self
+    }
+
+    pub fn index(&self) -> &ArchiveIndex {
+        &self.index
+    }
+
+    fn read_stored(&self, offset: u64, len: u64) -> Result<Vec<u8>, AssetIoError> {
+        let mut bytes = vec![0; len as usize];
+        let mut file = self.file.lock();
+        file.seek(SeekFrom::Start(offset))?;
+        file.read_exact(&mut bytes)?;
+        Ok(bytes)
+    }
+
+    fn not_found(&self, path: &Path) -> AssetIoError {
+        AssetIoError::NotFound(self.path.join(path))
+    }
+}
+
+impl AssetIo for ArchiveAssetIo {
+    fn load_path<'a>(&'a self, path: &'a Path) -> BoxedFuture<'a, Result<Vec<u8>, AssetIoError>> {
+        Box::pin(async move {
+            match (self.index.get(path), &self.fallback) {
+                (Some(entry), _) => {
+                    let stored = self.read_stored(entry.offset, entry.stored_size)?;
+                    Ok(entry.decompress(stored)?)
+                }
+                (None, Some(fallback)) => fallback.load_path(path).await,
+                (None, None) => Err(self.not_found(path)),
+            }
+        })
+    }
+
+    fn load_path_range<'a>(
+        &'a self,
+        path: &'a Path,
+        range: Range<u64>,
+    ) -> BoxedFuture<'a, Result<AssetBytes, AssetIoError>> {
+        Box::pin(async move {
+            match (self.index.get(path), &self.fallback) {
+                // uncompressed entries can be read partially
+                (Some(entry), _) if entry.compression == ArchiveCompression::None => {
+                    if range.start > range.end || range.end > entry.size {
+                        return Err(AssetIoError::RangeOutOfBounds(path.to_owned(), range));
+                    }
+                    let bytes =
+                        self.read_stored(entry.offset + range.start, range.end - range.start)?;
+                    Ok(bytes.into())
+                }
+                (Some(_), _) => {
+                    let bytes = self.load_path_shared(path).await?;
+                    slice_asset_bytes(&bytes, path, range)
+                }
+                (None, Some(fallback)) => fallback.load_path_range(path, range).await,
+                (None, None) => Err(self.not_found(path)),
+            }
+        })
+    }
+
+    fn path_len<'a>(&'a self, path: &'a Path) -> BoxedFuture<'a, Result<u64, AssetIoError>> {
+        Box::pin(async move {
+            match (self.index.get(path), &self.fallback) {
+                (Some(entry), _) => Ok(entry.size),
+                (None, Some(fallback)) => fallback.path_len(path).await,
+                (None, None) => Err(self.not_found(path)),
+            }
+        })
+    }
+
+    fn read_directory(
+        &self,
+        path: &Path,
+    ) -> Result<Box<dyn Iterator<Item = PathBuf>>, AssetIoError> {
+        match (self.index.read_directory(path), &self.fallback) {
+            (Some(children), _) => Ok(Box::new(
+                children
+                    .iter()
+                    .map(PathBuf::from)
+                    .collect::<Vec<_>>()
+                    .into_iter(),
+            )),
+            (None, Some(fallback)) => fallback.read_directory(path),
+            (None, None) => Err(self.not_found(path)),
+        }
+    }
+
+    fn is_directory(&self, path: &Path) -> bool {
+        self.index.is_directory(path)
+            || self
+                .fallback
+                .as_ref()
+                .map_or(false, |fallback| fallback.is_directory(path))
+    }
+
+    fn watch_path_for_changes(&self, path: &Path) -> Result<(), AssetIoError> {
+        // archives are immutable, only fallback assets can change
+        match &self.fallback {
+            Some(fallback) if self.index.get(path).is_none() => {
+                fallback.watch_path_for_changes(path)
+            }
+            _ => Ok(()),
+        }
+    }
+
+    fn watch_for_changes(&self) -> Result<(), AssetIoError> {
+        match &self.fallback {
+            Some(fallback) => fallback.watch_for_changes(),
+            None => Ok(()),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::AssetArchiveBuilder;
+    use futures_lite::future;
+
+    #[test]
+    fn loads_files_and_ranges_from_archive() {
+        let dir = tempfile::tempdir().unwrap();
+        let archive_path = dir.path().join("assets.pak");
+        let mut builder = AssetArchiveBuilder::default();
+        let text = b"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa".to_vec();
+        builder
+            .add_file(
+                Path::new("text/a.txt"),
+                text.clone(),
+                ArchiveCompression::Deflate,
+            )
+            .unwrap();
+        builder
+            .add_file(
+                Path::new("data.bin"),
+                vec![0, 1, 2, 3, 4, 5],
+                ArchiveCompression::None,
+            )
+            .unwrap();
+        builder
+            .write(&mut File::create(&archive_path).unwrap())
+            .unwrap();
+
+        let asset_io = ArchiveAssetIo::open(&archive_path).unwrap();
+        let load = |path: &str| future::block_on(asset_io.load_path(Path::new(path)));
+        assert_eq!(load("text/a.txt").unwrap(), text);
+        assert_eq!(load("data.bin").unwrap(), vec![0, 1, 2, 3, 4, 5]);
+        assert!(matches!(
+            load("missing.bin"),
+            Err(AssetIoError::NotFound(_))
+        ));
+
+        let range =
+            |path: &str, range| future::block_on(asset_io.load_path_range(Path::new(path), range));
+        assert_eq!(&*range("data.bin", 2..4).unwrap(), &[2, 3]);
+        assert_eq!(&*range("text/a.txt", 40..42).unwrap(), b"aa");
+        assert!(range("data.bin", 4..7).is_err());
+
+        assert!(asset_io.is_directory(Path::new("text")));
+        let files = asset_io
+            .read_directory(Path::new("text"))
+            .unwrap()
+            .collect::<Vec<_>>();
+        assert_eq!(files, vec![PathBuf::from("text/a.txt")]);
+    }
+}
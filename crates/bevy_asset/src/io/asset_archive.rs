@@ -0,0 +1,300 @@
+use bevy_utils::HashMap;
+use std::{
+    convert::TryInto,
+    io::{self, Read, Write},
+    path::{Component, Path},
+};
+
+/// The first bytes of every asset archive
+pub const ASSET_ARCHIVE_MAGIC: [u8; 8] = *b"BEVYPACK";
+/// The archive format version written by [`AssetArchiveBuilder`]
+pub const ASSET_ARCHIVE_VERSION: u32 = 1;
+
+const HEADER_SIZE: u64 = 16;
+// offset, stored size, size: u64 each + compression: u8, after the path
+const ENTRY_FIELDS_SIZE: u64 = 8 * 3 + 1;
+
+/// How the bytes of an archive entry are stored
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ArchiveCompression {
+    None,
+    Deflate,
+}
+
+impl ArchiveCompression {
+    fn to_u8(self) -> u8 {
+        match self {
+            ArchiveCompression::None => 0,
+            ArchiveCompression::Deflate => 1,
+        }
+    }
+
+    fn from_u8(value: u8) -> io::Result<Self> {
+        match value {
+            0 => Ok(ArchiveCompression::None),
+            1 => Ok(ArchiveCompression::Deflate),
+            _ => Err(invalid_data("unknown archive compression")),
+        }
+    }
+}
+
+/// The location of a file in an asset archive
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct ArchiveEntry {
+    /// Offset of the stored bytes from the start of the archive
+    pub offset: u64,
+    /// The size of the stored (possibly compressed) bytes
+    pub stored_size: u64,
+    /// The size of the file once decompressed
+    pub size: u64,
+    pub compression: ArchiveCompression,
+}
+
+impl ArchiveEntry {
+    /// Turns the stored bytes of this entry back into the file's bytes
+    pub fn decompress(&self, stored: Vec<u8>) -> io::Result<Vec<u8>> {
+        match self.compression {
+            ArchiveCompression::None => Ok(stored),
+            ArchiveCompression::Deflate => {
+                let bytes = miniz_oxide::inflate::decompress_to_vec(&stored)
+                    .map_err(|_| invalid_data("corrupt deflate stream in asset archive"))?;
+                if bytes.len() as u64 != self.size {
+                    return Err(invalid_data("asset archive entry has the wrong size"));
+                }
+                Ok(bytes)
+            }
+        }
+    }
+}
+
+/// The index of an asset archive: where each file is stored, looked up by its normalized path
+#[derive(Debug, Default)]
+pub struct ArchiveIndex {
+    entries: HashMap<String, ArchiveEntry>,
+    directories: HashMap<String, Vec<String>>,
+}
+
+impl ArchiveIndex {
+    /// Reads the header and index at the start of an archive
+    pub fn read(reader: &mut impl Read) -> io::Result<Self> {
+        let mut header = [0; HEADER_SIZE as usize];
+        reader.read_exact(&mut header)?;
+        if header[0..8] != ASSET_ARCHIVE_MAGIC {
+            return Err(invalid_data("not an asset archive"));
+        }
+        let version = u32::from_le_bytes(header[8..12].try_into().unwrap());
+        if version != ASSET_ARCHIVE_VERSION {
+            return Err(invalid_data("unsupported asset archive version"));
+        }
+        let entry_count = u32::from_le_bytes(header[12..16].try_into().unwrap());
+
+        let mut index = ArchiveIndex::default();
+        index.entries.reserve(entry_count as usize);
+        for _ in 0..entry_count {
+            let mut path_len = [0; 4];
+            reader.read_exact(&mut path_len)?;
+            let mut path = vec![0; u32::from_le_bytes(path_len) as usize];
+            reader.read_exact(&mut path)?;
+            let path = String::from_utf8(path)
+                .map_err(|_| invalid_data("asset archive path is not valid utf-8"))?;
+
+            let mut fields = [0; ENTRY_FIELDS_SIZE as usize];
+            reader.read_exact(&mut fields)?;
+            let entry = ArchiveEntry {
+                offset: u64::from_le_bytes(fields[0..8].try_into().unwrap()),
+                stored_size: u64::from_le_bytes(fields[8..16].try_into().unwrap()),
+                size: u64::from_le_bytes(fields[16..24].try_into().unwrap()),
+                compression: ArchiveCompression::from_u8(fields[24])?,
+            };
+            index.insert(path, entry);
+        }
+        Ok(index)
+    }
+
+    fn insert(&mut self, path: String, entry: ArchiveEntry) {
+        // register the file with every directory above it, up to the first one that already
+        // existed
+        let mut child = path.as_str();
+        loop {
+            let parent = child.rfind('/').map_or("", |separator| &child[..separator]);
+            let is_new_directory = !self.directories.contains_key(parent);
+            self.directories
+                .entry(parent.to_string())
+                .or_insert_with(Vec::new)
+                .push(child.to_string());
+            if !is_new_directory || parent.is_empty() {
+                break;
+            }
+            child = parent;
+        }
+        self.entries.insert(path, entry);
+    }
+
+    pub fn get(&self, path: &Path) -> Option<&ArchiveEntry> {
+        self.entries.get(&normalize_path(path)?)
+    }
+
+    pub fn is_directory(&self, path: &Path) -> bool {
+        normalize_path(path).map_or(false, |path| self.directories.contains_key(&path))
+    }
+
+    /// The paths of the files and directories directly inside the directory at `path`
+    pub fn read_directory(&self, path: &Path) -> Option<&[String]> {
+        self.directories
+            .get(&normalize_path(path)?)
+            .map(|children| children.as_slice())
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+}
+
+/// Converts a relative path to the '/' separated form used as an archive key
+pub fn normalize_path(path: &Path) -> Option<String> {
+    let mut normalized = String::new();
+    for component in path.components() {
+        match component {
+            Component::Normal(name) => {
+                if !normalized.is_empty() {
+                    normalized.push('/');
+                }
+                normalized.push_str(name.to_str()?);
+            }
+            Component::CurDir => {}
+            _ => return None,
+        }
+    }
+    Some(normalized)
+}
+
+/// Writes asset archives: a header, an index of every file and then the file contents
+#[derive(Debug, Default)]
+pub struct AssetArchiveBuilder {
+    files: Vec<(String, ArchiveCompression, u64, Vec<u8>)>,
+}
+
+impl AssetArchiveBuilder {
+    /// Adds a file to the archive. With [`ArchiveCompression::Deflate`] the file is only
+    /// compressed if that makes it smaller.
+    pub fn add_file(
+        &mut self,
+        path: &Path,
+        bytes: Vec<u8>,
+        compression: ArchiveCompression,
+    ) -> io::Result<()> {
+        let path = normalize_path(path)
+            .filter(|path| !path.is_empty())
+            .ok_or_else(|| invalid_data("archive paths must be relative utf-8 file paths"))?;
+        let size = bytes.len() as u64;
+        let (compression, stored) = match compression {
+            ArchiveCompression::None => (ArchiveCompression::None, bytes),
+            ArchiveCompression::Deflate => {
+                let compressed = miniz_oxide::deflate::compress_to_vec(&bytes, 6);
+                if compressed.len() < bytes.len() {
+                    (ArchiveCompression::Deflate, compressed)
+                } else {
+                    (ArchiveCompression::None, bytes)
+                }
+            }
+        };
+        self.files.push((path, compression, size, stored));
+        Ok(())
+    }
+
+    pub fn write(&self, writer: &mut impl Write) -> io::Result<()> {
+        writer.write_all(&ASSET_ARCHIVE_MAGIC)?;
+        writer.write_all(&ASSET_ARCHIVE_VERSION.to_le_bytes())?;
+        writer.write_all(&(self.files.len() as u32).to_le_bytes())?;
+
+        let index_size: u64 = self
+            .files
+            .iter()
+            .map(|(path, ..)| 4 + path.len() as u64 + ENTRY_FIELDS_SIZE)
+            .sum();
+        let mut offset = HEADER_SIZE + index_size;
+        for (path, compression, size, stored) in self.files.iter() {
+            writer.write_all(&(path.len() as u32).to_le_bytes())?;
+            writer.write_all(path.as_bytes())?;
+            writer.write_all(&offset.to_le_bytes())?;
+            writer.write_all(&(stored.len() as u64).to_le_bytes())?;
+            writer.write_all(&size.to_le_bytes())?;
+            writer.write_all(&[compression.to_u8()])?;
+            offset += stored.len() as u64;
+        }
+
+        for (_, _, _, stored) in self.files.iter() {
+            writer.write_all(stored)?;
+        }
+        Ok(())
+    }
+}
+
+fn invalid_data(message: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, message)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn index_roundtrip() {
+        let mut builder = AssetArchiveBuilder::default();
+        let text = b"hello hello hello hello hello hello".to_vec();
+        builder
+            .add_file(
+                Path::new("models/cube/cube.gltf"),
+                text.clone(),
+                ArchiveCompression::Deflate,
+            )
+            .unwrap();
+        builder
+            .add_file(
+                Path::new("textures/a.png"),
+                vec![1, 2, 3],
+                ArchiveCompression::Deflate,
+            )
+            .unwrap();
+        builder
+            .add_file(Path::new("root.txt"), vec![4], ArchiveCompression::None)
+            .unwrap();
+        let mut archive = Vec::new();
+        builder.write(&mut archive).unwrap();
+
+        let index = ArchiveIndex::read(&mut archive.as_slice()).unwrap();
+        assert_eq!(index.len(), 3);
+
+        let entry = *index.get(Path::new("models/cube/cube.gltf")).unwrap();
+        assert_eq!(entry.compression, ArchiveCompression::Deflate);
+        let start = entry.offset as usize;
+        let stored = archive[start..start + entry.stored_size as usize].to_vec();
+        assert_eq!(entry.decompress(stored).unwrap(), text);
+
+        // compressing three bytes doesn't pay off
+        let entry = *index.get(Path::new("./textures/a.png")).unwrap();
+        assert_eq!(entry.compression, ArchiveCompression::None);
+        assert_eq!(&archive[entry.offset as usize..], &[1, 2, 3, 4]);
+
+        assert!(index.is_directory(Path::new("models/cube")));
+        assert!(index.is_directory(Path::new("")));
+        assert!(!index.is_directory(Path::new("root.txt")));
+        assert_eq!(
+            index.read_directory(Path::new("models")).unwrap(),
+            &["models/cube".to_string()]
+        );
+        let mut root = index.read_directory(Path::new("")).unwrap().to_vec();
+        root.sort();
+        assert_eq!(root, vec!["models", "root.txt", "textures"]);
+    }
+
+    #[test]
+    fn rejects_other_files() {
+        assert!(ArchiveIndex::read(&mut &b"not an archive at all"[..]).is_err());
+        assert!(normalize_path(Path::new("../escape")).is_none());
+    }
+}
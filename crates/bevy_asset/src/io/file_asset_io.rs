@@ -1,13 +1,16 @@
-use crate::{filesystem_watcher::FilesystemWatcher, AssetIo, AssetIoError, AssetServer};
+use crate::{
+    filesystem_watcher::FilesystemWatcher, AssetBytes, AssetIo, AssetIoError, AssetServer,
+};
 use anyhow::Result;
 use bevy_ecs::system::Res;
 use bevy_utils::{BoxedFuture, HashSet};
 use crossbeam_channel::TryRecvError;
 use fs::File;
-use io::Read;
+use io::{Read, Seek, SeekFrom};
 use parking_lot::RwLock;
 use std::{
     env, fs, io,
+    ops::Range,
     path::{Path, PathBuf},
     sync::Arc,
 };
@@ -39,29 +42,53 @@ impl FileAssetIo {
                 .unwrap()
         }
     }
+
+    pub fn root_path(&self) -> &Path {
+        &self.root_path
+    }
+
+    pub(crate) fn open(&self, path: &Path) -> Result<File, AssetIoError> {
+        let full_path = self.root_path.join(path);
+        File::open(&full_path).map_err(|e| {
+            if e.kind() == std::io::ErrorKind::NotFound {
+                AssetIoError::NotFound(full_path)
+            } else {
+                e.into()
+            }
+        })
+    }
 }
 
 impl AssetIo for FileAssetIo {
     fn load_path<'a>(&'a self, path: &'a Path) -> BoxedFuture<'a, Result<Vec<u8>, AssetIoError>> {
         Box::pin(async move {
             let mut bytes = Vec::new();
-            let full_path = self.root_path.join(path);
-            match File::open(&full_path) {
-                Ok(mut file) => {
-                    file.read_to_end(&mut bytes)?;
-                }
-                Err(e) => {
-                    return if e.kind() == std::io::ErrorKind::NotFound {
-                        Err(AssetIoError::NotFound(full_path))
-                    } else {
-                        Err(e.into())
-                    }
-                }
-            }
+            self.open(path)?.read_to_end(&mut bytes)?;
             Ok(bytes)
         })
     }
 
+    fn load_path_range<'a>(
+        &'a self,
+        path: &'a Path,
+        range: Range<u64>,
+    ) -> BoxedFuture<'a, Result<AssetBytes, AssetIoError>> {
+        Box::pin(async move {
+            let mut file = self.open(path)?;
+            if range.start > range.end || range.end > file.metadata()?.len() {
+                return Err(AssetIoError::RangeOutOfBounds(path.to_owned(), range));
+            }
+            let mut bytes = vec![0; (range.end - range.start) as usize];
+            file.seek(SeekFrom::Start(range.start))?;
+            file.read_exact(&mut bytes)?;
+            Ok(bytes.into())
+        })
+    }
+
+    fn path_len<'a>(&'a self, path: &'a Path) -> BoxedFuture<'a, Result<u64, AssetIoError>> {
+        Box::pin(async move { Ok(self.open(path)?.metadata()?.len()) })
+    }
+
     fn read_directory(
         &self,
         path: &Path,
@@ -104,6 +131,39 @@ impl AssetIo for FileAssetIo {
     }
 }
 
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use futures_lite::future;
+    use std::io::Write;
+
+    #[test]
+    fn load_path_range_reads_only_the_range() {
+        let dir = tempfile::tempdir().unwrap();
+        File::create(dir.path().join("data.bin"))
+            .unwrap()
+            .write_all(&[0, 1, 2, 3, 4, 5, 6, 7])
+            .unwrap();
+        let asset_io = FileAssetIo {
+            root_path: dir.path().to_owned(),
+            #[cfg(feature = "filesystem_watcher")]
+            filesystem_watcher: Default::default(),
+        };
+
+        let path = Path::new("data.bin");
+        let bytes = future::block_on(asset_io.load_path_range(path, 2..5)).unwrap();
+        assert_eq!(&*bytes, &[2, 3, 4]);
+        assert!(matches!(
+            future::block_on(asset_io.load_path_range(path, 6..9)),
+            Err(AssetIoError::RangeOutOfBounds(_, _))
+        ));
+        let shared = future::block_on(asset_io.load_path_shared(path)).unwrap();
+        assert_eq!(&*shared.slice(6..8).unwrap(), &[6, 7]);
+        assert!(shared.slice(4..9).is_none());
+        assert_eq!(future::block_on(asset_io.path_len(path)).unwrap(), 8);
+    }
+}
+
 #[cfg(all(
     feature = "filesystem_watcher",
     all(not(target_arch = "wasm32"), not(target_os = "android"))
@@ -0,0 +1,100 @@
+use crate::{slice_asset_bytes, AssetBytes, AssetIo, AssetIoError, FileAssetIo};
+use anyhow::Result;
+use bevy_utils::{BoxedFuture, HashMap};
+use memmap2::Mmap;
+use parking_lot::Mutex;
+use std::{
+    ops::Range,
+    path::{Path, PathBuf},
+    sync::{Arc, Weak},
+};
+
+/// A file backed [`AssetIo`] that memory maps files instead of reading them.
+///
+/// [`AssetIo::load_path_shared`] and [`AssetIo::load_path_range`] hand out views into the
+/// mapping, so loaders read large files (ex: packed archives) without copying them into memory
+/// first. A file stays mapped while any of its [`AssetBytes`] are alive and repeated reads of
+/// the same file share one mapping.
+///
+/// Mapped files must not be modified or truncated while they are in use, so unlike
+/// [`FileAssetIo`] this does not support hot reloading.
+pub struct MmapAssetIo {
+    file_asset_io: FileAssetIo,
+    mappings: Mutex<HashMap<PathBuf, Weak<Mmap>>>,
+}
+
+impl MmapAssetIo {
+    pub fn new<P: AsRef<Path>>(path: P) -> Self {
+        Self {
+            file_asset_io: FileAssetIo::new(path),
+            mappings: Default::default(),
+        }
+    }
+
+    fn map(&self, path: &Path) -> Result<Arc<Mmap>, AssetIoError> {
+        let mut mappings = self.mappings.lock();
+        if let Some(mapping) = mappings.get(path).and_then(Weak::upgrade) {
+            return Ok(mapping);
+        }
+
+        let file = self.file_asset_io.open(path)?;
+        // SAFETY: asset files are treated as read only for as long as they are mapped, see the
+        // type level docs
+        let mapping = Arc::new(unsafe { Mmap::map(&file)? });
+        mappings.retain(|_, mapping| mapping.strong_count() > 0);
+        mappings.insert(path.to_owned(), Arc::downgrade(&mapping));
+        Ok(mapping)
+    }
+}
+
+/// Lets [`AssetBytes`] keep a shared mapping alive
+struct SharedMmap(Arc<Mmap>);
+
+impl AsRef<[u8]> for SharedMmap {
+    fn as_ref(&self) -> &[u8] {
+        &self.0
+    }
+}
+
+impl AssetIo for MmapAssetIo {
+    fn load_path<'a>(&'a self, path: &'a Path) -> BoxedFuture<'a, Result<Vec<u8>, AssetIoError>> {
+        Box::pin(async move { Ok(self.map(path)?.to_vec()) })
+    }
+
+    fn load_path_shared<'a>(
+        &'a self,
+        path: &'a Path,
+    ) -> BoxedFuture<'a, Result<AssetBytes, AssetIoError>> {
+        Box::pin(async move { Ok(AssetBytes::new(SharedMmap(self.map(path)?))) })
+    }
+
+    fn load_path_range<'a>(
+        &'a self,
+        path: &'a Path,
+        range: Range<u64>,
+    ) -> BoxedFuture<'a, Result<AssetBytes, AssetIoError>> {
+        Box::pin(async move {
+            let bytes = AssetBytes::new(SharedMmap(self.map(path)?));
+            slice_asset_bytes(&bytes, path, range)
+        })
+    }
+
+    fn read_directory(
+        &self,
+        path: &Path,
+    ) -> Result<Box<dyn Iterator<Item = PathBuf>>, AssetIoError> {
+        self.file_asset_io.read_directory(path)
+    }
+
+    fn is_directory(&self, path: &Path) -> bool {
+        self.file_asset_io.is_directory(path)
+    }
+
+    fn watch_path_for_changes(&self, _path: &Path) -> Result<(), AssetIoError> {
+        Ok(())
+    }
+
+    fn watch_for_changes(&self) -> Result<(), AssetIoError> {
+        Ok(())
+    }
+}
@@ -1,14 +1,32 @@
 #[cfg(target_os = "android")]
 mod android_asset_io;
+#[cfg(not(target_arch = "wasm32"))]
+mod archive_asset_io;
+mod asset_archive;
 #[cfg(all(not(target_arch = "wasm32"), not(target_os = "android")))]
 mod file_asset_io;
+#[cfg(all(
+    feature = "mmap",
+    not(target_arch = "wasm32"),
+    not(target_os = "android")
+))]
+mod mmap_asset_io;
 #[cfg(target_arch = "wasm32")]
 mod wasm_asset_io;
 
 #[cfg(target_os = "android")]
 pub use android_asset_io::*;
+#[cfg(not(target_arch = "wasm32"))]
+pub use archive_asset_io::*;
+pub use asset_archive::*;
 #[cfg(all(not(target_arch = "wasm32"), not(target_os = "android")))]
 pub use file_asset_io::*;
+#[cfg(all(
+    feature = "mmap",
+    not(target_arch = "wasm32"),
+    not(target_os = "android")
+))]
+pub use mmap_asset_io::*;
 #[cfg(target_arch = "wasm32")]
 pub use wasm_asset_io::*;
 
@@ -16,8 +34,10 @@ use anyhow::Result;
 use bevy_utils::BoxedFuture;
 use downcast_rs::{impl_downcast, Downcast};
 use std::{
-    io,
+    fmt, io,
+    ops::{Deref, Range},
     path::{Path, PathBuf},
+    sync::Arc,
 };
 use thiserror::Error;
 
@@ -30,11 +50,114 @@ pub enum AssetIoError {
     Io(#[from] io::Error),
     #[error("failed to watch path: {0}")]
     PathWatchError(PathBuf),
+    #[error("byte range {1:?} is out of bounds for {0}")]
+    RangeOutOfBounds(PathBuf, Range<u64>),
+}
+
+/// A cheaply cloneable, immutable view into bytes owned by an [`AssetIo`] (ex: a memory mapped
+/// file) or by a plain `Vec<u8>`
+#[derive(Clone)]
+pub struct AssetBytes {
+    data: Arc<dyn AsRef<[u8]> + Send + Sync>,
+    range: Range<usize>,
+}
+
+impl AssetBytes {
+    pub fn new<T: AsRef<[u8]> + Send + Sync + 'static>(data: T) -> Self {
+        let len = data.as_ref().len();
+        Self {
+            data: Arc::new(data),
+            range: 0..len,
+        }
+    }
+
+    /// Returns a view into `range` of these bytes without copying them, or `None` if the range
+    /// is out of bounds
+    pub fn slice(&self, range: Range<usize>) -> Option<AssetBytes> {
+        if range.start > range.end || range.end > self.len() {
+            return None;
+        }
+        Some(Self {
+            data: self.data.clone(),
+            range: self.range.start + range.start..self.range.start + range.end,
+        })
+    }
+}
+
+impl Deref for AssetBytes {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        &(*self.data).as_ref()[self.range.clone()]
+    }
+}
+
+impl AsRef<[u8]> for AssetBytes {
+    fn as_ref(&self) -> &[u8] {
+        self
+    }
+}
+
+impl From<Vec<u8>> for AssetBytes {
+    fn from(bytes: Vec<u8>) -> Self {
+        AssetBytes::new(bytes)
+    }
+}
+
+impl fmt::Debug for AssetBytes {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("AssetBytes")
+            .field("len", &self.len())
+            .finish()
+    }
+}
+
+/// Slices `range` out of the bytes read from `path`
+pub(crate) fn slice_asset_bytes(
+    bytes: &AssetBytes,
+    path: &Path,
+    range: Range<u64>,
+) -> Result<AssetBytes, AssetIoError> {
+    bytes
+        .slice(range.start as usize..range.end as usize)
+        .ok_or_else(|| AssetIoError::RangeOutOfBounds(path.to_owned(), range))
 }
 
 /// Handles load requests from an AssetServer
 pub trait AssetIo: Downcast + Send + Sync + 'static {
     fn load_path<'a>(&'a self, path: &'a Path) -> BoxedFuture<'a, Result<Vec<u8>, AssetIoError>>;
+    /// Reads the whole file at `path`. Backends that can share their storage with loaders (ex:
+    /// `MmapAssetIo`) return it without copying. This is what the [`AssetServer`] hands to
+    /// [`AssetLoader`]s.
+    ///
+    /// [`AssetServer`]: crate::AssetServer
+    /// [`AssetLoader`]: crate::AssetLoader
+    fn load_path_shared<'a>(
+        &'a self,
+        path: &'a Path,
+    ) -> BoxedFuture<'a, Result<AssetBytes, AssetIoError>> {
+        Box::pin(async move { self.load_path(path).await.map(AssetBytes::from) })
+    }
+    /// Reads `range` bytes of the file at `path`. Backends that can seek (or map) files read only
+    /// the requested range.
+    fn load_path_range<'a>(
+        &'a self,
+        path: &'a Path,
+        range: Range<u64>,
+    ) -> BoxedFuture<'a, Result<AssetBytes, AssetIoError>> {
+        Box::pin(async move {
+            let bytes = self.load_path_shared(path).await?;
+            slice_asset_bytes(&bytes, path, range)
+        })
+    }
+    /// The size in bytes of the file at `path`. Backends that can look it up without reading the
+    /// file should override this.
+    fn path_len<'a>(&'a self, path: &'a Path) -> BoxedFuture<'a, Result<u64, AssetIoError>> {
+        Box::pin(async move {
+            let bytes = self.load_path_shared(path).await?;
+            Ok(bytes.len() as u64)
+        })
+    }
     fn read_directory(
         &self,
         path: &Path,
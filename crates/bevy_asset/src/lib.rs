@@ -9,6 +9,7 @@ mod filesystem_watcher;
 mod handle;
 mod info;
 mod io;
+mod load_queue;
 mod loader;
 mod path;
 
@@ -23,6 +24,7 @@ pub use bevy_utils::BoxedFuture;
 pub use handle::*;
 pub use info::*;
 pub use io::*;
+pub use load_queue::*;
 pub use loader::*;
 pub use path::*;
 
@@ -0,0 +1,242 @@
+use crate::{AssetPath, HandleId, SourcePathId};
+use bevy_utils::HashMap;
+use std::{cmp::Ordering, collections::BinaryHeap};
+
+/// The order in which queued asset loads start. Loads with a higher priority start first, loads
+/// with the same priority start in the order they were requested.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum LoadPriority {
+    /// Loads that can wait (ex: prefetching the next level)
+    Background,
+    Normal,
+    /// Loads the player is waiting on (ex: assets that just became visible)
+    High,
+}
+
+impl Default for LoadPriority {
+    fn default() -> Self {
+        LoadPriority::Normal
+    }
+}
+
+#[derive(Debug)]
+struct QueueEntry {
+    asset_path: AssetPath<'static>,
+    priority: LoadPriority,
+    sequence: u64,
+}
+
+impl PartialEq for QueueEntry {
+    fn eq(&self, other: &Self) -> bool {
+        self.cmp(other) == Ordering::Equal
+    }
+}
+
+impl Eq for QueueEntry {}
+
+impl PartialOrd for QueueEntry {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for QueueEntry {
+    fn cmp(&self, other: &Self) -> Ordering {
+        // BinaryHeap is a max heap: highest priority first, then the oldest request
+        self.priority
+            .cmp(&other.priority)
+            .then_with(|| other.sequence.cmp(&self.sequence))
+    }
+}
+
+/// An asset source waiting to be loaded, merging every request made for it
+#[derive(Debug)]
+pub(crate) struct QueuedLoad {
+    pub(crate) asset_path: AssetPath<'static>,
+    pub(crate) priority: LoadPriority,
+    /// True if any request for the source forces a reload
+    pub(crate) force: bool,
+    /// The handles requested for the source, used to cancel the load once they are all dropped
+    handles: Vec<HandleId>,
+    /// False if the source was also requested without a handle (ex: as a dependency)
+    cancellable: bool,
+    sequence: u64,
+}
+
+/// Asset loads waiting for a free load slot
+#[derive(Debug, Default)]
+pub(crate) struct LoadQueue {
+    heap: BinaryHeap<QueueEntry>,
+    sources: HashMap<SourcePathId, QueuedLoad>,
+    next_sequence: u64,
+    pub(crate) in_flight: usize,
+    pub(crate) max_in_flight: Option<usize>,
+}
+
+impl LoadQueue {
+    /// Queues a load of `asset_path`. Requesting a source that is already queued merges the
+    /// requests, raising the queued priority and forcing the reload if needed. Loads requested with `cancellable` are
+    /// dropped from the queue by [`LoadQueue::cancel`] once all of their handles are unused.
+    pub(crate) fn push(
+        &mut self,
+        asset_path: AssetPath<'static>,
+        priority: LoadPriority,
+        force: bool,
+        cancellable: bool,
+    ) {
+        let asset_path_id = asset_path.get_id();
+        let handle_id = HandleId::from(asset_path_id);
+        let sequence = self.next_sequence;
+        let queued_load = self
+            .sources
+            .entry(asset_path_id.source_path_id())
+            .or_insert_with(|| QueuedLoad {
+                asset_path: asset_path.clone(),
+                priority,
+                force,
+                handles: Vec::new(),
+                cancellable,
+                sequence,
+            });
+        queued_load.force |= force;
+        queued_load.cancellable &= cancellable;
+        if cancellable && !queued_load.handles.contains(&handle_id) {
+            queued_load.handles.push(handle_id);
+        }
+        if queued_load.sequence != sequence && priority <= queued_load.priority {
+            return;
+        }
+
+        // the entry pushed for the old priority (if any) is skipped when it is popped
+        queued_load.priority = priority;
+        queued_load.sequence = sequence;
+        self.heap.push(QueueEntry {
+            asset_path,
+            priority,
+            sequence,
+        });
+        self.next_sequence += 1;
+    }
+
+    /// Takes the next load to start and reserves a load slot for it, if one is free
+    pub(crate) fn pop(&mut self) -> Option<QueuedLoad> {
+        if self
+            .max_in_flight
+            .map_or(false, |max_in_flight| self.in_flight >= max_in_flight)
+        {
+            return None;
+        }
+        while let Some(entry) = self.heap.pop() {
+            let source_path_id = entry.asset_path.get_id().source_path_id();
+            let is_current = self
+                .sources
+                .get(&source_path_id)
+                .map_or(false, |queued_load| queued_load.sequence == entry.sequence);
+            if is_current {
+                self.in_flight += 1;
+                return self.sources.remove(&source_path_id);
+            }
+        }
+        None
+    }
+
+    /// Removes an unused handle from its queued load. Returns the source of the load if that was
+    /// its last handle and the load was cancelled.
+    pub(crate) fn cancel(&mut self, handle_id: HandleId) -> Option<SourcePathId> {
+        let source_path_id = match handle_id {
+            HandleId::AssetPathId(id) => id.source_path_id(),
+            HandleId::Id(..) => return None,
+        };
+        let queued_load = self.sources.get_mut(&source_path_id)?;
+        queued_load.handles.retain(|handle| *handle != handle_id);
+        if !queued_load.cancellable || !queued_load.handles.is_empty() {
+            return None;
+        }
+        // the heap entry of the load is skipped when it is popped
+        self.sources.remove(&source_path_id);
+        Some(source_path_id)
+    }
+
+    /// Frees the load slot reserved by [`LoadQueue::pop`]
+    pub(crate) fn finish(&mut self) {
+        self.in_flight -= 1;
+    }
+
+    /// The number of asset sources waiting to be loaded
+    pub(crate) fn len(&self) -> usize {
+        self.sources.len()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn path(load: &QueuedLoad) -> &str {
+        load.asset_path.path().to_str().unwrap()
+    }
+
+    #[test]
+    fn pops_by_priority_then_request_order() {
+        let mut queue = LoadQueue {
+            max_in_flight: Some(2),
+            ..Default::default()
+        };
+        queue.push("a.png".into(), LoadPriority::Normal, false, true);
+        queue.push("b.png".into(), LoadPriority::Background, false, true);
+        queue.push("c.png".into(), LoadPriority::High, false, true);
+        queue.push("d.png".into(), LoadPriority::Normal, false, true);
+        assert_eq!(queue.len(), 4);
+
+        assert_eq!(path(&queue.pop().unwrap()), "c.png");
+        assert_eq!(path(&queue.pop().unwrap()), "a.png");
+        // both slots are taken
+        assert!(queue.pop().is_none());
+        queue.finish();
+        assert_eq!(path(&queue.pop().unwrap()), "d.png");
+        assert_eq!(queue.len(), 1);
+    }
+
+    #[test]
+    fn merges_requests_for_the_same_source() {
+        let mut queue = LoadQueue::default();
+        queue.push("a.gltf#Mesh0".into(), LoadPriority::Background, false, true);
+        queue.push("b.png".into(), LoadPriority::Normal, false, true);
+        queue.push("a.gltf#Mesh1".into(), LoadPriority::High, false, true);
+        queue.push("a.gltf#Mesh1".into(), LoadPriority::Background, true, true);
+        assert_eq!(queue.len(), 2);
+
+        let load = queue.pop().unwrap();
+        assert_eq!(path(&load), "a.gltf");
+        assert_eq!(load.priority, LoadPriority::High);
+        assert!(load.force);
+        assert_eq!(load.handles.len(), 2);
+        assert_eq!(path(&queue.pop().unwrap()), "b.png");
+        // the stale background entry of a.gltf is skipped
+        assert!(queue.pop().is_none());
+    }
+
+    #[test]
+    fn cancels_loads_without_used_handles() {
+        let mut queue = LoadQueue::default();
+        queue.push("a.gltf#Mesh0".into(), LoadPriority::Normal, false, true);
+        queue.push("a.gltf#Mesh1".into(), LoadPriority::Normal, false, true);
+        queue.push("b.png".into(), LoadPriority::Normal, false, true);
+        queue.push("b.png".into(), LoadPriority::Normal, false, false);
+
+        let mesh0: AssetPath = "a.gltf#Mesh0".into();
+        let mesh1: AssetPath = "a.gltf#Mesh1".into();
+        let png: AssetPath = "b.png".into();
+        assert!(queue.cancel(mesh0.get_id().into()).is_none());
+        assert_eq!(
+            queue.cancel(mesh1.get_id().into()),
+            Some(mesh1.get_id().source_path_id())
+        );
+        // b.png is also needed without a handle
+        assert!(queue.cancel(png.get_id().into()).is_none());
+
+        assert_eq!(queue.len(), 1);
+        assert_eq!(path(&queue.pop().unwrap()), "b.png");
+        assert!(queue.pop().is_none());
+    }
+}
@@ -1,6 +1,6 @@
 use crate::{
-    path::AssetPath, AssetIo, AssetIoError, AssetMeta, AssetServer, Assets, Handle, HandleId,
-    RefChangeChannel,
+    path::AssetPath, AssetBytes, AssetIo, AssetIoError, AssetMeta, AssetServer, Assets, Handle,
+    HandleId, RefChangeChannel,
 };
 use anyhow::Result;
 use bevy_ecs::{
@@ -12,7 +12,7 @@ use bevy_tasks::TaskPool;
 use bevy_utils::{BoxedFuture, HashMap};
 use crossbeam_channel::{Receiver, Sender};
 use downcast_rs::{impl_downcast, Downcast};
-use std::path::Path;
+use std::{ops::Range, path::Path};
 
 /// A loader for an asset source
 pub trait AssetLoader: Send + Sync + 'static {
@@ -127,6 +127,24 @@ impl<'a> LoadContext<'a> {
         self.asset_io.load_path(path.as_ref()).await
     }
 
+    /// Like [`LoadContext::read_asset_bytes`], but avoids copying the bytes when the
+    /// [`AssetIo`] can share them
+    pub async fn read_asset_bytes_shared<P: AsRef<Path>>(
+        &self,
+        path: P,
+    ) -> Result<AssetBytes, AssetIoError> {
+        self.asset_io.load_path_shared(path.as_ref()).await
+    }
+
+    /// Reads only the `range` bytes of the file at `path`
+    pub async fn read_asset_bytes_range<P: AsRef<Path>>(
+        &self,
+        path: P,
+        range: Range<u64>,
+    ) -> Result<AssetBytes, AssetIoError> {
+        self.asset_io.load_path_range(path.as_ref(), range).await
+    }
+
     pub fn get_asset_metas(&self) -> Vec<AssetMeta> {
         let mut asset_metas = Vec::new();
         for (label, asset) in self.labeled_assets.iter() {
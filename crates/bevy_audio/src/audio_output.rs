@@ -37,6 +37,21 @@ where
     }
 }
 
+impl<P> AudioOutput<P>
+where
+    P: Decodable,
+{
+    /// An output for another kind of audio source that plays on the same audio device, which
+    /// stays open as long as `self` exists
+    pub fn for_source<Q: Decodable>(&self) -> AudioOutput<Q> {
+        AudioOutput {
+            _stream: None,
+            stream_handle: self.stream_handle.clone(),
+            phantom: PhantomData,
+        }
+    }
+}
+
 impl<P> AudioOutput<P>
 where
     P: Asset + Decodable,
@@ -0,0 +1,167 @@
+use crate::{AudioSource, Decodable};
+use bevy_asset::{AssetPath, AssetServer, Assets, Handle, HandleId, LoadState};
+use bevy_ecs::system::{Res, ResMut};
+use bevy_reflect::TypeUuid;
+use bevy_utils::tracing::warn;
+use rodio::decoder::DecoderError;
+use std::{io::Cursor, sync::Arc, time::Duration};
+
+/// Audio that is decoded to PCM samples once, so playing it doesn't decode anything and every
+/// play shares the same samples. Meant for short sounds that play often, like sound effects.
+///
+/// Load one from a file with [`AudioDecodeQueue::load_decoded`], or decode a loaded
+/// [`AudioSource`] with [`DecodedAudioSource::new`].
+#[derive(Debug, Clone, TypeUuid)]
+#[uuid = "5c0b3f4e-8e2a-4d6b-a3b1-0f7e9d2c4a16"]
+pub struct DecodedAudioSource {
+    pub channels: u16,
+    pub sample_rate: u32,
+    /// Interleaved samples of all channels
+    pub samples: Arc<[i16]>,
+}
+
+impl DecodedAudioSource {
+    /// Decodes all of `audio_source`. The channel count and sample rate of the start of the audio
+    /// are used for all of it.
+    pub fn new(audio_source: &AudioSource) -> Result<Self, DecoderError> {
+        let decoder = rodio::Decoder::new(Cursor::new(audio_source.clone()))?;
+        let channels = rodio::Source::channels(&decoder);
+        let sample_rate = rodio::Source::sample_rate(&decoder);
+        Ok(DecodedAudioSource {
+            channels,
+            sample_rate,
+            samples: decoder.collect(),
+        })
+    }
+}
+
+/// Decodes audio files into [`DecodedAudioSource`]s once they are loaded as [`AudioSource`]s
+#[derive(Default)]
+pub struct AudioDecodeQueue {
+    pending: Vec<(Handle<AudioSource>, Handle<DecodedAudioSource>)>,
+}
+
+impl AudioDecodeQueue {
+    /// Loads the audio file at `path` and returns the handle of its decoded samples, which are
+    /// added by [`decode_audio_sources_system`] once the file is loaded. The handle can be played
+    /// right away, the sound starts once it is decoded.
+    pub fn load_decoded<'a, P: Into<AssetPath<'a>>>(
+        &mut self,
+        asset_server: &AssetServer,
+        path: P,
+    ) -> Handle<DecodedAudioSource> {
+        let decoded = asset_server.get_handle(HandleId::random::<DecodedAudioSource>());
+        self.pending
+            .push((asset_server.load(path), decoded.clone()));
+        decoded
+    }
+}
+
+/// Decodes the loaded [`AudioSource`]s of the [`AudioDecodeQueue`]
+pub fn decode_audio_sources_system(
+    mut queue: ResMut<AudioDecodeQueue>,
+    asset_server: Res<AssetServer>,
+    audio_sources: Res<Assets<AudioSource>>,
+    mut decoded_audio_sources: ResMut<Assets<DecodedAudioSource>>,
+) {
+    queue.pending.retain(|(audio_source, decoded)| {
+        let audio_source_path = || asset_server.get_handle_path(audio_source);
+        match audio_sources.get(audio_source) {
+            Some(audio_source) => match DecodedAudioSource::new(audio_source) {
+                Ok(decoded_audio_source) => {
+                    decoded_audio_sources.set_untracked(decoded, decoded_audio_source)
+                }
+                Err(err) => warn!("Could not decode {:?}: {}", audio_source_path(), err),
+            },
+            None if asset_server.get_load_state(audio_source) == LoadState::Failed => {
+                warn!("Could not load {:?} to decode it", audio_source_path())
+            }
+            None => return true,
+        }
+        false
+    });
+}
+
+impl Decodable for DecodedAudioSource {
+    type Decoder = PcmDecoder;
+
+    fn decoder(&self) -> Self::Decoder {
+        PcmDecoder {
+            source: self.clone(),
+            position: 0,
+        }
+    }
+}
+
+/// Plays the samples of a [`DecodedAudioSource`]
+#[derive(Debug, Clone)]
+pub struct PcmDecoder {
+    source: DecodedAudioSource,
+    position: usize,
+}
+
+impl Iterator for PcmDecoder {
+    type Item = i16;
+
+    fn next(&mut self) -> Option<i16> {
+        let sample = self.source.samples.get(self.position).copied();
+        self.position += 1;
+        sample
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        let remaining = self.source.samples.len().saturating_sub(self.position);
+        (remaining, Some(remaining))
+    }
+}
+
+impl rodio::Source for PcmDecoder {
+    fn current_frame_len(&self) -> Option<usize> {
+        Some(self.source.samples.len().saturating_sub(self.position))
+    }
+
+    fn channels(&self) -> u16 {
+        self.source.channels
+    }
+
+    fn sample_rate(&self) -> u32 {
+        self.source.sample_rate
+    }
+
+    fn total_duration(&self) -> Option<Duration> {
+        let frames = self.source.samples.len() as f64 / self.source.channels.max(1) as f64;
+        Some(Duration::from_secs_f64(
+            frames / self.source.sample_rate.max(1) as f64,
+        ))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use rodio::Source;
+
+    #[test]
+    fn pcm_decoder_plays_all_samples() {
+        let source = DecodedAudioSource {
+            channels: 2,
+            sample_rate: 100,
+            samples: (0..400).map(|i| i as i16).collect(),
+        };
+        let mut decoder = source.decoder();
+        assert_eq!(decoder.channels(), 2);
+        assert_eq!(decoder.sample_rate(), 100);
+        // 200 frames of 2 samples at 100 frames per second
+        assert_eq!(decoder.total_duration(), Some(Duration::from_secs(2)));
+        assert_eq!(decoder.size_hint(), (400, Some(400)));
+
+        assert_eq!(decoder.by_ref().take(150).last(), Some(149));
+        assert_eq!(decoder.current_frame_len(), Some(250));
+        assert_eq!(decoder.count(), 250);
+
+        // plays share the samples
+        let decoder = source.decoder();
+        assert!(Arc::ptr_eq(&decoder.source.samples, &source.samples));
+        assert_eq!(decoder.collect::<Vec<_>>(), source.samples.to_vec());
+    }
+}
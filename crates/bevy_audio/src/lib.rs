@@ -1,19 +1,30 @@
 mod audio;
 mod audio_output;
 mod audio_source;
+mod decoded_audio_source;
+#[cfg(not(target_arch = "wasm32"))]
+mod streaming_audio_source;
 
 pub mod prelude {
     #[doc(hidden)]
-    pub use crate::{Audio, AudioOutput, AudioSource, Decodable};
+    #[cfg(not(target_arch = "wasm32"))]
+    pub use crate::StreamingAudioSource;
+    #[doc(hidden)]
+    pub use crate::{
+        Audio, AudioDecodeQueue, AudioOutput, AudioSource, Decodable, DecodedAudioSource,
+    };
 }
 
 pub use audio::*;
 pub use audio_output::*;
 pub use audio_source::*;
+pub use decoded_audio_source::*;
+#[cfg(not(target_arch = "wasm32"))]
+pub use streaming_audio_source::*;
 
 use bevy_app::prelude::*;
-use bevy_asset::AddAsset;
-use bevy_ecs::system::IntoExclusiveSystem;
+use bevy_asset::{AddAsset, Asset};
+use bevy_ecs::system::{IntoExclusiveSystem, IntoSystem};
 
 /// Adds support for audio playback to an App
 #[derive(Default)]
@@ -28,8 +39,35 @@ impl Plugin for AudioPlugin {
                 CoreStage::PostUpdate,
                 play_queued_audio_system::<AudioSource>.exclusive_system(),
             );
+        add_audio_source::<DecodedAudioSource>(app);
+        app.init_resource::<AudioDecodeQueue>()
+            .add_system_to_stage(CoreStage::PreUpdate, decode_audio_sources_system.system());
+        #[cfg(not(target_arch = "wasm32"))]
+        add_audio_source::<StreamingAudioSource>(app);
 
         #[cfg(any(feature = "mp3", feature = "flac", feature = "wav", feature = "vorbis"))]
         app.init_asset_loader::<Mp3Loader>();
     }
 }
+
+/// Adds another kind of audio source, which plays on the device of the
+/// [`AudioOutput<AudioSource>`]
+fn add_audio_source<P>(app: &mut AppBuilder)
+where
+    P: Asset + Decodable,
+    <P as Decodable>::Decoder: rodio::Source + Send + Sync,
+    <<P as Decodable>::Decoder as Iterator>::Item: rodio::Sample + Send + Sync,
+{
+    let audio_output = app
+        .world()
+        .get_non_send_resource::<AudioOutput<AudioSource>>()
+        .unwrap()
+        .for_source::<P>();
+    app.insert_non_send_resource(audio_output)
+        .add_asset::<P>()
+        .init_resource::<Audio<P>>()
+        .add_system_to_stage(
+            CoreStage::PostUpdate,
+            play_queued_audio_system::<P>.exclusive_system(),
+        );
+}
@@ -0,0 +1,334 @@
+use crate::Decodable;
+use bevy_asset::{AssetBytes, AssetIoError, AssetServer};
+use bevy_reflect::TypeUuid;
+use futures_lite::future;
+use parking_lot::Mutex;
+use std::{
+    fmt,
+    io::{self, Read, Seek, SeekFrom},
+    path::{Path, PathBuf},
+    sync::{
+        mpsc::{self, Receiver},
+        Arc,
+    },
+    thread,
+};
+use thiserror::Error;
+
+/// Files are read in chunks of this many bytes
+const CHUNK_SIZE: u64 = 64 * 1024;
+/// How many chunks a stream reads ahead of the decoder
+const PREFETCH_CHUNKS: usize = 4;
+
+/// An audio file that is read in chunks from the [`AssetIo`](bevy_asset::AssetIo) on a
+/// background thread while it plays, instead of being loaded into memory. Meant for long sounds
+/// like music; short sounds that play often are better off as a
+/// [`DecodedAudioSource`](crate::DecodedAudioSource).
+///
+/// Only the first chunk of the file is kept in memory, every play streams the rest on its own.
+/// Chunks are read with [`AssetIo::load_path_range`](bevy_asset::AssetIo::load_path_range), so
+/// the file should be stored where ranges are cheap to read: a compressed archive entry is
+/// decompressed whole for every chunk (the `asset_archive` tool stores audio files uncompressed).
+#[derive(Clone, TypeUuid)]
+#[uuid = "2d1c7d9b-5de5-4b3e-9c8b-6f0f3c1a5e47"]
+pub struct StreamingAudioSource {
+    stream: Arc<AudioStream>,
+}
+
+struct AudioStream {
+    asset_server: AssetServer,
+    path: PathBuf,
+    len: u64,
+    /// The first chunk of the file, which decoders read (and seek back over) to detect the format
+    head: AssetBytes,
+}
+
+/// An error that occurred while opening a [`StreamingAudioSource`]
+#[derive(Error, Debug)]
+pub enum StreamingAudioError {
+    #[error("encountered an io error while opening the audio file: {0}")]
+    AssetIoError(#[from] AssetIoError),
+    #[error("the audio file can't be decoded: {0}")]
+    DecoderError(#[from] rodio::decoder::DecoderError),
+}
+
+impl StreamingAudioSource {
+    /// Reads the size and the first chunk of the file at `path` (relative to the asset folder)
+    /// and checks that its format can be decoded, blocking the current thread.
+    pub fn new(
+        asset_server: &AssetServer,
+        path: impl Into<PathBuf>,
+    ) -> Result<Self, StreamingAudioError> {
+        let stream = Arc::new(AudioStream::open(asset_server, path.into())?);
+        // probe the format now, so playing the source doesn't fail in the audio output
+        rodio::Decoder::new(AudioStreamReader::new(stream.clone()))?;
+        Ok(StreamingAudioSource { stream })
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.stream.path
+    }
+}
+
+impl AudioStream {
+    fn open(asset_server: &AssetServer, path: PathBuf) -> Result<Self, AssetIoError> {
+        let asset_io = asset_server.asset_io();
+        let len = future::block_on(asset_io.path_len(&path))?;
+        let head = future::block_on(asset_io.load_path_range(&path, 0..len.min(CHUNK_SIZE)))?;
+        Ok(AudioStream {
+            asset_server: asset_server.clone(),
+            path,
+            len,
+            head,
+        })
+    }
+}
+
+impl fmt::Debug for StreamingAudioSource {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        f.debug_struct("StreamingAudioSource")
+            .field("path", &self.stream.path)
+            .field("len", &self.stream.len)
+            .finish()
+    }
+}
+
+impl Decodable for StreamingAudioSource {
+    type Decoder = rodio::Decoder<AudioStreamReader>;
+
+    fn decoder(&self) -> Self::Decoder {
+        let mut reader = AudioStreamReader::new(self.stream.clone());
+        reader.start_read_ahead();
+        rodio::Decoder::new(reader).expect("the format was probed when the source was created")
+    }
+}
+
+type ChunkReceiver = Receiver<Result<AssetBytes, AssetIoError>>;
+
+/// Reads a [`StreamingAudioSource`] for one play. Chunks are read ahead by a background thread,
+/// which is restarted when the decoder seeks outside of the current chunk.
+pub struct AudioStreamReader {
+    stream: Arc<AudioStream>,
+    position: u64,
+    /// The last chunk received from the background thread
+    chunk: AssetBytes,
+    chunk_start: u64,
+    /// Only accessed through `&mut self`, the mutex just makes the reader `Sync`
+    chunks: Option<Mutex<ChunkReceiver>>,
+}
+
+impl AudioStreamReader {
+    fn new(stream: Arc<AudioStream>) -> Self {
+        let head_len = stream.head.len() as u64;
+        AudioStreamReader {
+            stream,
+            position: 0,
+            chunk: AssetBytes::from(Vec::new()),
+            chunk_start: head_len,
+            chunks: None,
+        }
+    }
+
+    /// Starts reading the chunks after the head right away, so they are on their way while the
+    /// decoder detects the format from the head instead of being waited on by the audio output
+    fn start_read_ahead(&mut self) {
+        // if the thread can't be started, the first read past the head tries again
+        self.chunks = read_ahead(self.stream.clone(), self.chunk_start)
+            .ok()
+            .map(Mutex::new);
+    }
+
+    /// Receives the chunk after the current one, starting a background thread to read it if there
+    /// isn't one
+    fn next_chunk(&mut self) -> io::Result<()> {
+        let next_start = self.chunk_start + self.chunk.len() as u64;
+        if self.chunks.is_none() {
+            self.chunks = Some(Mutex::new(read_ahead(self.stream.clone(), next_start)?));
+        }
+        let chunks = self.chunks.as_mut().unwrap().get_mut();
+        match chunks.recv() {
+            Ok(Ok(chunk)) => {
+                self.chunk = chunk;
+                self.chunk_start = next_start;
+                Ok(())
+            }
+            Ok(Err(err)) => Err(io::Error::new(io::ErrorKind::Other, err)),
+            Err(_) => Err(io::ErrorKind::UnexpectedEof.into()),
+        }
+    }
+}
+
+/// Reads the chunks of `stream` from `start` on a new thread, until the receiver is dropped
+fn read_ahead(stream: Arc<AudioStream>, mut start: u64) -> io::Result<ChunkReceiver> {
+    let (sender, receiver) = mpsc::sync_channel(PREFETCH_CHUNKS);
+    thread::Builder::new()
+        .name("audio stream".to_string())
+        .spawn(move || {
+            let asset_io = stream.asset_server.asset_io();
+            while start < stream.len {
+                let end = (start + CHUNK_SIZE).min(stream.len);
+                let chunk = future::block_on(asset_io.load_path_range(&stream.path, start..end));
+                let failed = chunk.is_err();
+                if sender.send(chunk).is_err() || failed {
+                    break;
+                }
+                start = end;
+            }
+        })?;
+    Ok(receiver)
+}
+
+impl Read for AudioStreamReader {
+    fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+        if self.position >= self.stream.len {
+            return Ok(0);
+        }
+        let head_len = self.stream.head.len() as u64;
+        let bytes = if self.position < head_len {
+            &self.stream.head[self.position as usize..]
+        } else {
+            let chunk_end = self.chunk_start + self.chunk.len() as u64;
+            if self.position < self.chunk_start || self.position > chunk_end {
+                // the decoder seeked, stop reading ahead from the old position
+                self.chunks = None;
+                self.chunk = AssetBytes::from(Vec::new());
+                self.chunk_start = self.position;
+            }
+            if self.position == self.chunk_start + self.chunk.len() as u64 {
+                self.next_chunk()?;
+            }
+            &self.chunk[(self.position - self.chunk_start) as usize..]
+        };
+        let len = bytes.len().min(buf.len());
+        buf[..len].copy_from_slice(&bytes[..len]);
+        self.position += len as u64;
+        Ok(len)
+    }
+}
+
+impl Seek for AudioStreamReader {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        let (base, offset) = match pos {
+            SeekFrom::Start(position) => (position, 0),
+            SeekFrom::End(offset) => (self.stream.len, offset),
+            SeekFrom::Current(offset) => (self.position, offset),
+        };
+        let position = if offset >= 0 {
+            base.checked_add(offset as u64)
+        } else {
+            base.checked_sub(offset.unsigned_abs())
+        };
+        self.position = position.ok_or_else(|| {
+            io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "invalid seek to a negative position",
+            )
+        })?;
+        Ok(self.position)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use bevy_asset::FileAssetIo;
+    use bevy_tasks::TaskPool;
+    use std::{fs::File, io::Write};
+
+    const LEN: usize = 3 * CHUNK_SIZE as usize + 100;
+
+    fn stream_reader() -> (tempfile::TempDir, AudioStreamReader) {
+        let dir = tempfile::tempdir().unwrap();
+        let data = (0..LEN).map(|i| (i % 251) as u8).collect::<Vec<_>>();
+        File::create(dir.path().join("music.bin"))
+            .unwrap()
+            .write_all(&data)
+            .unwrap();
+        let asset_server = AssetServer::new(FileAssetIo::new(dir.path()), TaskPool::new());
+        // not a real audio file, so it can't be opened as a `StreamingAudioSource`
+        assert!(matches!(
+            StreamingAudioSource::new(&asset_server, "music.bin"),
+            Err(StreamingAudioError::DecoderError(_))
+        ));
+        let stream = AudioStream::open(&asset_server, "music.bin".into()).unwrap();
+        assert_eq!(stream.head.len() as u64, CHUNK_SIZE);
+        let mut reader = AudioStreamReader::new(Arc::new(stream));
+        reader.start_read_ahead();
+        (dir, reader)
+    }
+
+    fn expected(range: std::ops::Range<usize>) -> Vec<u8> {
+        range.map(|i| (i % 251) as u8).collect()
+    }
+
+    #[test]
+    fn reads_the_head_and_the_chunks_after_it() {
+        let (_dir, mut reader) = stream_reader();
+        let mut head = vec![0; 1000];
+        reader.read_exact(&mut head).unwrap();
+        assert_eq!(head, expected(0..1000));
+
+        // odd sized reads cross the end of the head and every chunk boundary
+        let mut rest = Vec::new();
+        let mut buf = [0; 7777];
+        loop {
+            match reader.read(&mut buf).unwrap() {
+                0 => break,
+                len => rest.extend_from_slice(&buf[..len]),
+            }
+        }
+        assert_eq!(rest, expected(1000..LEN));
+    }
+
+    #[test]
+    fn reads_across_chunk_boundaries() {
+        let (_dir, mut reader) = stream_reader();
+        for boundary in 1..=3 {
+            let start = boundary * CHUNK_SIZE as usize - 10;
+            reader.seek(SeekFrom::Start(start as u64)).unwrap();
+            let mut buf = [0; 20];
+            reader.read_exact(&mut buf).unwrap();
+            assert_eq!(&buf[..], &expected(start..start + 20)[..]);
+        }
+    }
+
+    #[test]
+    fn seeks_back_into_the_head() {
+        let (_dir, mut reader) = stream_reader();
+        let mut buf = [0; 100];
+        reader.seek(SeekFrom::Start(2 * CHUNK_SIZE + 5)).unwrap();
+        reader.read_exact(&mut buf).unwrap();
+
+        assert_eq!(reader.seek(SeekFrom::Start(10)).unwrap(), 10);
+        reader.read_exact(&mut buf).unwrap();
+        assert_eq!(&buf[..], &expected(10..110)[..]);
+
+        // reading on past the head restarts the read ahead at the end of the head
+        reader
+            .seek(SeekFrom::Current(CHUNK_SIZE as i64 - 130))
+            .unwrap();
+        reader.read_exact(&mut buf).unwrap();
+        let start = CHUNK_SIZE as usize - 20;
+        assert_eq!(&buf[..], &expected(start..start + 100)[..]);
+    }
+
+    #[test]
+    fn seeks_past_the_end() {
+        let (_dir, mut reader) = stream_reader();
+        let mut buf = [0; 10];
+        assert_eq!(reader.seek(SeekFrom::End(5)).unwrap(), LEN as u64 + 5,);
+        assert_eq!(reader.read(&mut buf).unwrap(), 0);
+
+        reader.seek(SeekFrom::End(-4)).unwrap();
+        assert_eq!(reader.read(&mut buf).unwrap(), 4);
+        assert_eq!(&buf[..4], &expected(LEN - 4..LEN)[..]);
+
+        assert_eq!(
+            reader
+                .seek(SeekFrom::Current(-(LEN as i64) - 1))
+                .unwrap_err()
+                .kind(),
+            io::ErrorKind::InvalidInput
+        );
+    }
+}
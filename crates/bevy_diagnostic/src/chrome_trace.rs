@@ -0,0 +1,163 @@
+use bevy_app::prelude::*;
+use bevy_ecs::system::{IntoSystem, ResMut};
+use bevy_log::warn;
+use bevy_utils::{HashMap, Instant};
+use std::{
+    fmt::Write as _,
+    fs::File,
+    io::{self, BufWriter, Write},
+    path::{Path, PathBuf},
+    thread::ThreadId,
+};
+
+/// Writes the spans recorded by timing plugins, like [crate::SystemTimingDiagnosticsPlugin], to a
+/// file in the Chrome trace event format, which can be opened with `chrome://tracing` or
+/// Perfetto.
+///
+/// Unlike the `trace_chrome` feature, this doesn't need `tracing` spans to be compiled in.
+pub struct ChromeTracePlugin {
+    pub path: PathBuf,
+}
+
+impl Default for ChromeTracePlugin {
+    fn default() -> Self {
+        ChromeTracePlugin {
+            path: PathBuf::from("trace.json"),
+        }
+    }
+}
+
+impl Plugin for ChromeTracePlugin {
+    fn build(&self, app: &mut AppBuilder) {
+        match ChromeTrace::create(&self.path) {
+            Ok(trace) => {
+                app.insert_resource(trace)
+                    .add_system_to_stage(CoreStage::Last, Self::flush_system.system());
+            }
+            Err(err) => warn!("Could not create trace file {:?}: {}", self.path, err),
+        }
+    }
+}
+
+impl ChromeTracePlugin {
+    /// Writes the spans of the frame to the file, so nothing is lost if the app doesn't exit
+    /// cleanly
+    pub fn flush_system(mut trace: ResMut<ChromeTrace>) {
+        trace.flush();
+    }
+}
+
+/// A trace file that spans are appended to as "complete" events
+pub struct ChromeTrace {
+    writer: BufWriter<File>,
+    start: Instant,
+    /// Chrome traces identify threads with numbers
+    threads: HashMap<ThreadId, usize>,
+    event_written: bool,
+    failed: bool,
+    line: String,
+}
+
+impl ChromeTrace {
+    pub fn create(path: impl AsRef<Path>) -> io::Result<Self> {
+        let mut writer = BufWriter::new(File::create(path)?);
+        writer.write_all(b"[")?;
+        Ok(ChromeTrace {
+            writer,
+            start: Instant::now(),
+            threads: Default::default(),
+            event_written: false,
+            failed: false,
+            line: String::new(),
+        })
+    }
+
+    /// Adds a span that ran on `thread` from `start` to `end`. `args` are shown with the span.
+    pub fn add_span(
+        &mut self,
+        name: &str,
+        category: &str,
+        thread: ThreadId,
+        start: Instant,
+        end: Instant,
+        args: &[(&str, f64)],
+    ) {
+        let thread_count = self.threads.len();
+        let tid = *self.threads.entry(thread).or_insert(thread_count);
+        let start = start.max(self.start);
+        let end = end.max(start);
+
+        self.line.clear();
+        if self.event_written {
+            self.line.push(',');
+        }
+        self.line.push_str("\n{\"name\":");
+        write_json_string(&mut self.line, name);
+        self.line.push_str(",\"cat\":");
+        write_json_string(&mut self.line, category);
+        let _ = write!(
+            self.line,
+            ",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3},\"dur\":{:.3}",
+            tid,
+            (start - self.start).as_secs_f64() * 1e6,
+            (end - start).as_secs_f64() * 1e6
+        );
+        if !args.is_empty() {
+            self.line.push_str(",\"args\":{");
+            for (i, (key, value)) in args.iter().enumerate() {
+                if i > 0 {
+                    self.line.push(',');
+                }
+                write_json_string(&mut self.line, key);
+                let _ = write!(self.line, ":{}", value);
+            }
+            self.line.push('}');
+        }
+        self.line.push('}');
+
+        let result = self.writer.write_all(self.line.as_bytes());
+        self.event_written = true;
+        self.check(result);
+    }
+
+    pub fn flush(&mut self) {
+        let result = self.writer.flush();
+        self.check(result);
+    }
+
+    /// Warns about the first error instead of flooding the log every frame
+    fn check(&mut self, result: io::Result<()>) {
+        if let Err(err) = result {
+            if !self.failed {
+                warn!("Could not write to trace file: {}", err);
+                self.failed = true;
+            }
+        }
+    }
+}
+
+impl Drop for ChromeTrace {
+    fn drop(&mut self) {
+        // the closing bracket is optional in the trace format, it is only missing if the app
+        // didn't exit cleanly
+        let result = self.writer.write_all(b"\n]\n");
+        self.check(result);
+        self.flush();
+    }
+}
+
+fn write_json_string(out: &mut String, value: &str) {
+    out.push('"');
+    for c in value.chars() {
+        match c {
+            '"' => out.push_str("\\\""),
+            '\\' => out.push_str("\\\\"),
+            '\n' => out.push_str("\\n"),
+            c if (c as u32) < 0x20 => {
+                let _ = write!(out, "\\u{:04x}", c as u32);
+            }
+            c => out.push(c),
+        }
+    }
+    out.push('"');
+}
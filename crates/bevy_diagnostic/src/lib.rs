@@ -1,11 +1,17 @@
+mod chrome_trace;
 mod diagnostic;
 mod entity_count_diagnostics_plugin;
 mod frame_time_diagnostics_plugin;
 mod log_diagnostics_plugin;
+mod system_timing_diagnostics_plugin;
+pub use chrome_trace::{ChromeTrace, ChromeTracePlugin};
 pub use diagnostic::*;
 pub use entity_count_diagnostics_plugin::EntityCountDiagnosticsPlugin;
 pub use frame_time_diagnostics_plugin::FrameTimeDiagnosticsPlugin;
 pub use log_diagnostics_plugin::LogDiagnosticsPlugin;
+pub use system_timing_diagnostics_plugin::{
+    SystemTimingDiagnosticsPlugin, SystemTimingDiagnosticsState,
+};
 
 use bevy_app::prelude::*;
 
@@ -0,0 +1,94 @@
+use crate::{ChromeTrace, Diagnostic, DiagnosticId, Diagnostics};
+use bevy_app::prelude::*;
+use bevy_ecs::{
+    schedule::SystemTimings,
+    system::{IntoSystem, ResMut},
+};
+use bevy_utils::HashMap;
+use std::borrow::Cow;
+
+/// Adds a "run time" diagnostic for every system, measured by the executors.
+///
+/// If the app has a [ChromeTrace], every run of a system is also added to it, with how long the
+/// system waited on its dependencies and on conflicting systems.
+#[derive(Default)]
+pub struct SystemTimingDiagnosticsPlugin;
+
+/// State used by the [SystemTimingDiagnosticsPlugin]
+#[derive(Default)]
+pub struct SystemTimingDiagnosticsState {
+    diagnostic_ids: HashMap<Cow<'static, str>, DiagnosticId>,
+    run_times: HashMap<DiagnosticId, f64>,
+}
+
+impl SystemTimingDiagnosticsState {
+    /// The id of the diagnostic of the system with the given name, once it has run
+    pub fn diagnostic_id(&self, system_name: &str) -> Option<DiagnosticId> {
+        self.diagnostic_ids.get(system_name).copied()
+    }
+}
+
+impl Plugin for SystemTimingDiagnosticsPlugin {
+    fn build(&self, app: &mut AppBuilder) {
+        app.init_resource::<SystemTimings>()
+            .init_resource::<SystemTimingDiagnosticsState>()
+            .add_system_to_stage(CoreStage::First, Self::diagnostic_system.system());
+    }
+}
+
+impl SystemTimingDiagnosticsPlugin {
+    /// Records the systems that ran since the last time this system ran
+    pub fn diagnostic_system(
+        mut diagnostics: ResMut<Diagnostics>,
+        mut timings: ResMut<SystemTimings>,
+        mut state: ResMut<SystemTimingDiagnosticsState>,
+        mut trace: Option<ResMut<ChromeTrace>>,
+    ) {
+        let state = &mut *state;
+        for timing in timings.drain() {
+            if let Some(trace) = &mut trace {
+                trace.add_span(
+                    &timing.name,
+                    "system",
+                    timing.thread,
+                    timing.start,
+                    timing.end,
+                    &[
+                        (
+                            "dependency_wait_ms",
+                            timing.dependency_wait_time().as_secs_f64() * 1000.0,
+                        ),
+                        (
+                            "conflict_wait_ms",
+                            timing.conflict_wait_time().as_secs_f64() * 1000.0,
+                        ),
+                    ],
+                );
+            }
+
+            let id = match state.diagnostic_ids.get(&timing.name) {
+                Some(id) => *id,
+                None => {
+                    let id = DiagnosticId::default();
+                    diagnostics
+                        .add(Diagnostic::new(id, short_name(&timing.name), 20).with_suffix("s"));
+                    state.diagnostic_ids.insert(timing.name.clone(), id);
+                    id
+                }
+            };
+            // systems can run more than once per frame
+            *state.run_times.entry(id).or_insert(0.0) += timing.run_time().as_secs_f64();
+        }
+        for (id, run_time) in state.run_times.drain() {
+            diagnostics.add_measurement(id, run_time);
+        }
+    }
+}
+
+/// Removes the module path of a system name, keeping its generic arguments
+fn short_name(name: &str) -> String {
+    let generics = name.find('<').unwrap_or(name.len());
+    let (path, generics) = name.split_at(generics);
+    let base = path.rsplit("::").next().unwrap_or(path);
+    format!("{}{}", base, generics)
+}
@@ -150,6 +150,7 @@ impl BundleInfo {
                                 table_row,
                                 component_ptr,
                                 ComponentTicks::new(change_tick),
+                                change_tick,
                             );
                         }
                         ComponentStatus::Mutated => {
@@ -1,4 +1,7 @@
-use crate::component::{Component, ComponentTicks};
+use crate::{
+    component::{Component, ComponentTicks},
+    storage::ColumnTicks,
+};
 use bevy_reflect::Reflect;
 use std::ops::{Deref, DerefMut};
 
@@ -63,6 +66,9 @@ macro_rules! change_detection_impl {
                 self.ticks
                     .component_ticks
                     .set_changed(self.ticks.change_tick);
+                if let Some(column_ticks) = self.ticks.column_ticks {
+                    column_ticks.set_changed(self.ticks.change_tick);
+                }
             }
         }
 
@@ -130,6 +136,8 @@ macro_rules! impl_debug {
 
 pub(crate) struct Ticks<'a> {
     pub(crate) component_ticks: &'a mut ComponentTicks,
+    /// The ticks of the table column the value is stored in, if any
+    pub(crate) column_ticks: Option<&'a ColumnTicks>,
     pub(crate) last_change_tick: u32,
     pub(crate) change_tick: u32,
 }
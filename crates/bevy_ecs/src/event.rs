@@ -5,10 +5,12 @@ use crate::{
 };
 use bevy_utils::tracing::trace;
 use std::{
+    cell::RefCell,
     fmt::{self},
     hash::Hash,
     marker::PhantomData,
 };
+use thread_local::ThreadLocal;
 
 /// An `EventId` uniquely identifies an event.
 ///
@@ -410,6 +412,211 @@ impl<T> std::iter::Extend<T> for Events<T> {
     }
 }
 
+/// An event collection like [`Events`] that can be written to with shared access, so systems
+/// sending the same event type can run in parallel (and while others read it).
+///
+/// Each thread sending events appends them to its own buffer. The buffers are merged into the
+/// readable events by [`ConcurrentEvents::update`], so events sent between two updates can be read
+/// after the second one. Events are then kept for two updates, like [`Events`].
+///
+/// Merged events are stored contiguously: [`ConcurrentEventReader::read`] returns the unread events
+/// as (at most) two slices.
+///
+/// # Example
+/// ```
+/// use bevy_ecs::event::ConcurrentEvents;
+///
+/// struct Collision(u32);
+///
+/// let mut events = ConcurrentEvents::<Collision>::default();
+/// let mut reader = events.get_reader();
+///
+/// // only needs `&events`, so this can be done from several threads at once
+/// events.send(Collision(1));
+/// events.send_batch((2..4).map(Collision));
+///
+/// // run this once per update/frame
+/// events.update();
+///
+/// let [older, newer] = reader.read_slices(&events);
+/// assert!(older.is_empty());
+/// assert_eq!(newer.len(), 3);
+/// ```
+pub struct ConcurrentEvents<T: Send> {
+    events_a: Vec<T>,
+    events_b: Vec<T>,
+    a_start_event_count: usize,
+    b_start_event_count: usize,
+    event_count: usize,
+    state: State,
+    sent: ThreadLocal<RefCell<Vec<T>>>,
+}
+
+impl<T: Send> Default for ConcurrentEvents<T> {
+    fn default() -> Self {
+        ConcurrentEvents {
+            events_a: Vec::new(),
+            events_b: Vec::new(),
+            a_start_event_count: 0,
+            b_start_event_count: 0,
+            event_count: 0,
+            state: State::A,
+            sent: ThreadLocal::new(),
+        }
+    }
+}
+
+impl<T: Send> fmt::Debug for ConcurrentEvents<T> {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        f.debug_struct("ConcurrentEvents")
+            .field("event_count", &self.event_count)
+            .field("len", &(self.events_a.len() + self.events_b.len()))
+            .finish()
+    }
+}
+
+impl<T: Send> ConcurrentEvents<T> {
+    /// Sends an `event` from the current thread. It can be read after the next
+    /// [`ConcurrentEvents::update`].
+    pub fn send(&self, event: T) {
+        self.sent.get_or_default().borrow_mut().push(event);
+    }
+
+    /// Sends a batch of `events` from the current thread
+    pub fn send_batch(&self, events: impl IntoIterator<Item = T>) {
+        self.sent.get_or_default().borrow_mut().extend(events);
+    }
+
+    /// Gets a new [ManualEventReader]. This will include all events already in the event buffers.
+    pub fn get_reader(&self) -> ManualEventReader<T> {
+        ManualEventReader {
+            last_event_count: 0,
+            _marker: PhantomData,
+        }
+    }
+
+    /// Gets a new [ManualEventReader]. This will ignore all events already in the event buffers. It
+    /// will read all future events.
+    pub fn get_reader_current(&self) -> ManualEventReader<T> {
+        ManualEventReader {
+            last_event_count: self.event_count,
+            _marker: PhantomData,
+        }
+    }
+
+    /// Swaps the event buffers, clearing the oldest one, and moves the events sent since the last
+    /// update into the current buffer. In general, this should be called once per frame/update.
+    pub fn update(&mut self) {
+        let events = match self.state {
+            State::A => {
+                self.state = State::B;
+                self.b_start_event_count = self.event_count;
+                &mut self.events_b
+            }
+            State::B => {
+                self.state = State::A;
+                self.a_start_event_count = self.event_count;
+                &mut self.events_a
+            }
+        };
+        // keep the allocation, the next frame is likely to send as many events
+        events.clear();
+        for sent in self.sent.iter_mut() {
+            events.append(sent.get_mut());
+        }
+        trace!(
+            "ConcurrentEvents::update() -> ids: ({}..{})",
+            self.event_count,
+            self.event_count + events.len()
+        );
+        self.event_count += events.len();
+    }
+
+    /// A system that calls [ConcurrentEvents::update] once per frame.
+    pub fn update_system(mut events: ResMut<Self>) {
+        events.update();
+    }
+
+    /// Removes all events, including the ones that were sent but not merged yet.
+    pub fn clear(&mut self) {
+        self.a_start_event_count = self.event_count;
+        self.b_start_event_count = self.event_count;
+        self.events_a.clear();
+        self.events_b.clear();
+        for sent in self.sent.iter_mut() {
+            sent.get_mut().clear();
+        }
+    }
+
+    /// Returns true if there are no events to read in this collection.
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.events_a.is_empty() && self.events_b.is_empty()
+    }
+
+    /// The events a reader that has read `last_event_count` events hasn't seen yet, oldest first
+    fn unread_slices(&self, last_event_count: usize) -> [&[T]; 2] {
+        let a_index = last_event_count.saturating_sub(self.a_start_event_count);
+        let b_index = last_event_count.saturating_sub(self.b_start_event_count);
+        let a = self.events_a.get(a_index..).unwrap_or_else(|| &[]);
+        let b = self.events_b.get(b_index..).unwrap_or_else(|| &[]);
+        match self.state {
+            State::A => [b, a],
+            State::B => [a, b],
+        }
+    }
+}
+
+/// Reads events of type `T` from [`ConcurrentEvents`] in order and tracks which events have
+/// already been read.
+#[derive(SystemParam)]
+pub struct ConcurrentEventReader<'a, T: Component> {
+    last_event_count: Local<'a, (usize, PhantomData<T>)>,
+    events: Res<'a, ConcurrentEvents<T>>,
+}
+
+impl<'a, T: Component> ConcurrentEventReader<'a, T> {
+    /// Returns the events this reader has not seen yet as the unread part of the older and of the
+    /// newer event buffer, in that order. Subsequent reads will not include these events.
+    pub fn read(&mut self) -> [&[T]; 2] {
+        let slices = self.events.unread_slices(self.last_event_count.0);
+        self.last_event_count.0 = self.events.event_count;
+        slices
+    }
+
+    /// Iterates over the events this reader has not seen yet, see [`ConcurrentEventReader::read`]
+    pub fn iter(&mut self) -> impl DoubleEndedIterator<Item = &T> {
+        let [older, newer] = self.read();
+        older.iter().chain(newer.iter())
+    }
+}
+
+/// Sends events of type `T` to [`ConcurrentEvents`]. Unlike [`EventWriter`], this only needs
+/// shared access to the events, so any number of writers can run at the same time.
+#[derive(SystemParam)]
+pub struct ConcurrentEventWriter<'a, T: Component> {
+    events: Res<'a, ConcurrentEvents<T>>,
+}
+
+impl<'a, T: Component> ConcurrentEventWriter<'a, T> {
+    pub fn send(&self, event: T) {
+        self.events.send(event);
+    }
+
+    pub fn send_batch(&self, events: impl IntoIterator<Item = T>) {
+        self.events.send_batch(events);
+    }
+}
+
+impl<T: Send> ManualEventReader<T> {
+    /// See [`ConcurrentEventReader::read`]
+    pub fn read_slices<'a>(&mut self, events: &'a ConcurrentEvents<T>) -> [&'a [T]; 2] {
+        let slices = events.unread_slices(self.last_event_count);
+        self.last_event_count = events.event_count;
+        slices
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -580,4 +787,51 @@ mod tests {
         events.update();
         assert!(events.is_empty());
     }
+
+    #[test]
+    fn test_concurrent_events() {
+        let mut events = ConcurrentEvents::<TestEvent>::default();
+        let mut reader = events.get_reader();
+
+        let task_pool = bevy_tasks::TaskPool::new();
+        task_pool.scope(|scope| {
+            for thread in 0..4 {
+                let events = &events;
+                scope.spawn(async move {
+                    events.send_batch((0..100).map(|i| TestEvent {
+                        i: thread * 100 + i,
+                    }));
+                });
+            }
+        });
+        events.send(TestEvent { i: 400 });
+        // sent events are readable after the next update
+        let no_events: &[TestEvent] = &[];
+        assert_eq!(reader.read_slices(&events), [no_events, no_events]);
+
+        events.update();
+        let mut read = reader
+            .read_slices(&events)
+            .iter()
+            .flat_map(|events| events.iter())
+            .map(|event| event.i)
+            .collect::<Vec<_>>();
+        read.sort_unstable();
+        assert_eq!(read, (0..=400).collect::<Vec<_>>());
+
+        events.send(TestEvent { i: 401 });
+        events.update();
+        let mut reader_b = events.get_reader();
+        let [older, newer] = reader_b.read_slices(&events);
+        assert_eq!(older.len(), 401);
+        assert_eq!(newer, &[TestEvent { i: 401 }]);
+        assert_eq!(
+            reader.read_slices(&events),
+            [no_events, &[TestEvent { i: 401 }]]
+        );
+
+        events.update();
+        events.update();
+        assert!(events.is_empty());
+    }
 }
@@ -21,7 +21,7 @@ pub mod prelude {
         bundle::Bundle,
         change_detection::DetectChanges,
         entity::Entity,
-        event::{EventReader, EventWriter},
+        event::{ConcurrentEventReader, ConcurrentEventWriter, EventReader, EventWriter},
         query::{Added, ChangeTrackers, Changed, Or, QueryState, With, WithBundle, Without},
         schedule::{
             AmbiguitySetLabel, ExclusiveSystemDescriptorCoercion, ParallelSystemDescriptorCoercion,
@@ -295,6 +295,23 @@ mod tests {
         );
     }
 
+    #[test]
+    fn par_for_each_auto_batch_size() {
+        let mut world = World::new();
+        let task_pool = TaskPool::default();
+        world.spawn_batch((0..1000).map(|i| (i,)));
+        world.spawn_batch((1000..1010).map(|i| (i, true)));
+        let results = Arc::new(Mutex::new(Vec::new()));
+        world.query::<&i32>().par_for_each(
+            &world,
+            &task_pool,
+            crate::query::AUTO_BATCH_SIZE,
+            |&i| results.lock().push(i),
+        );
+        results.lock().sort_unstable();
+        assert_eq!(*results.lock(), (0..1010).collect::<Vec<_>>());
+    }
+
     #[test]
     fn par_for_each_sparse() {
         let mut world = World::new();
@@ -873,6 +890,50 @@ mod tests {
         assert_eq!(get_changed(&mut world), vec![e1]);
     }
 
+    #[test]
+    fn changed_query_column_ticks() {
+        let mut world = World::default();
+        let e1 = world.spawn().insert_bundle((A(0), B(0))).id();
+        let e2 = world.spawn().insert(A(0)).id();
+
+        fn column_changed(world: &World, entity: Entity) -> bool {
+            let location = world.entities().get(entity).unwrap();
+            let table_id = world.archetypes()[location.archetype_id].table_id();
+            let component_id = world.components().get_id(TypeId::of::<A>()).unwrap();
+            world.storages().tables[table_id]
+                .get_column(component_id)
+                .unwrap()
+                .column_ticks()
+                .is_changed(world.last_change_tick(), world.read_change_tick())
+        }
+        fn get_changed(world: &mut World) -> Vec<Entity> {
+            world
+                .query_filtered::<Entity, Changed<A>>()
+                .iter(&world)
+                .collect::<Vec<Entity>>()
+        }
+        assert!(column_changed(&world, e1));
+        world.clear_trackers();
+        assert!(!column_changed(&world, e1));
+        assert!(!column_changed(&world, e2));
+
+        *world.get_mut::<A>(e1).unwrap() = A(1);
+        assert!(column_changed(&world, e1));
+        assert!(!column_changed(&world, e2));
+        assert_eq!(get_changed(&mut world), vec![e1]);
+
+        // moving to another table keeps the change
+        world.entity_mut(e1).insert(C);
+        assert!(column_changed(&world, e1));
+        assert_eq!(get_changed(&mut world), vec![e1]);
+
+        world.clear_trackers();
+        assert_eq!(get_changed(&mut world), vec![]);
+        world.entity_mut(e2).insert(A(2));
+        assert!(column_changed(&world, e2));
+        assert_eq!(get_changed(&mut world), vec![e2]);
+    }
+
     #[test]
     fn resource() {
         let mut world = World::default();
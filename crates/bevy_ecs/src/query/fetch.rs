@@ -4,7 +4,7 @@ use crate::{
     component::{Component, ComponentId, ComponentTicks, StorageType},
     entity::Entity,
     query::{Access, FilteredAccess},
-    storage::{ComponentSparseSet, Table, Tables},
+    storage::{ColumnTicks, ComponentSparseSet, Table, Tables},
     world::{Mut, World},
 };
 use bevy_ecs_macros::all_tuples;
@@ -104,6 +104,18 @@ pub trait Fetch<'w>: Sized {
     /// Must always be called _after_ [`Fetch::set_table`]. `table_row` must be in the range of the
     /// current table
     unsafe fn table_fetch(&mut self, table_row: usize) -> Self::Item;
+
+    /// Returns false if no entity of the current [`Table`] or [`Archetype`] can match, which lets
+    /// iterators skip it entirely (ex: [`Changed`](crate::query::Changed) on a table without
+    /// changed rows).
+    ///
+    /// # Safety
+    ///
+    /// Must always be called _after_ [`Fetch::set_table`] or [`Fetch::set_archetype`]
+    #[inline]
+    unsafe fn may_match_current(&self) -> bool {
+        true
+    }
 }
 
 /// State used to construct a Fetch. This will be cached inside [`QueryState`](crate::query::QueryState),
@@ -389,6 +401,7 @@ pub struct WriteFetch<T> {
     storage_type: StorageType,
     table_components: NonNull<T>,
     table_ticks: *const UnsafeCell<ComponentTicks>,
+    column_ticks: *const ColumnTicks,
     entities: *const Entity,
     entity_table_rows: *const usize,
     sparse_set: *const ComponentSparseSet,
@@ -402,6 +415,7 @@ impl<T> Clone for WriteFetch<T> {
             storage_type: self.storage_type,
             table_components: self.table_components,
             table_ticks: self.table_ticks,
+            column_ticks: self.column_ticks,
             entities: self.entities,
             entity_table_rows: self.entity_table_rows,
             sparse_set: self.sparse_set,
@@ -484,6 +498,7 @@ impl<'w, T: Component> Fetch<'w> for WriteFetch<T> {
             entity_table_rows: ptr::null::<usize>(),
             sparse_set: ptr::null::<ComponentSparseSet>(),
             table_ticks: ptr::null::<UnsafeCell<ComponentTicks>>(),
+            column_ticks: ptr::null::<ColumnTicks>(),
             last_change_tick,
             change_tick,
         };
@@ -512,6 +527,7 @@ impl<'w, T: Component> Fetch<'w> for WriteFetch<T> {
                     .unwrap();
                 self.table_components = column.get_data_ptr().cast::<T>();
                 self.table_ticks = column.get_ticks_ptr();
+                self.column_ticks = column.column_ticks();
             }
             StorageType::SparseSet => self.entities = archetype.entities().as_ptr(),
         }
@@ -522,6 +538,7 @@ impl<'w, T: Component> Fetch<'w> for WriteFetch<T> {
         let column = table.get_column(state.component_id).unwrap();
         self.table_components = column.get_data_ptr().cast::<T>();
         self.table_ticks = column.get_ticks_ptr();
+        self.column_ticks = column.column_ticks();
     }
 
     #[inline]
@@ -533,6 +550,7 @@ impl<'w, T: Component> Fetch<'w> for WriteFetch<T> {
                     value: &mut *self.table_components.as_ptr().add(table_row),
                     ticks: Ticks {
                         component_ticks: &mut *(&*self.table_ticks.add(table_row)).get(),
+                        column_ticks: Some(&*self.column_ticks),
                         change_tick: self.change_tick,
                         last_change_tick: self.last_change_tick,
                     },
@@ -546,6 +564,7 @@ impl<'w, T: Component> Fetch<'w> for WriteFetch<T> {
                     value: &mut *component.cast::<T>(),
                     ticks: Ticks {
                         component_ticks: &mut *component_ticks,
+                        column_ticks: None,
                         change_tick: self.change_tick,
                         last_change_tick: self.last_change_tick,
                     },
@@ -560,6 +579,7 @@ impl<'w, T: Component> Fetch<'w> for WriteFetch<T> {
             value: &mut *self.table_components.as_ptr().add(table_row),
             ticks: Ticks {
                 component_ticks: &mut *(&*self.table_ticks.add(table_row)).get(),
+                column_ticks: Some(&*self.column_ticks),
                 change_tick: self.change_tick,
                 last_change_tick: self.last_change_tick,
             },
@@ -954,6 +974,12 @@ macro_rules! impl_tuple_fetch {
                 let ($($name,)*) = self;
                 ($($name.archetype_fetch(_archetype_index),)*)
             }
+
+            #[inline]
+            unsafe fn may_match_current(&self) -> bool {
+                let ($($name,)*) = self;
+                true $(&& $name.may_match_current())*
+            }
         }
 
         // SAFETY: update_component_access and update_archetype_component_access are called for each item in the tuple
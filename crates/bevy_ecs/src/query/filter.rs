@@ -4,7 +4,7 @@ use crate::{
     component::{Component, ComponentId, ComponentTicks, StorageType},
     entity::Entity,
     query::{Access, Fetch, FetchState, FilteredAccess, WorldQuery},
-    storage::{ComponentSparseSet, Table, Tables},
+    storage::{ColumnTicks, ComponentSparseSet, Table, Tables},
     world::World,
 };
 use bevy_ecs_macros::all_tuples;
@@ -499,6 +499,12 @@ macro_rules! impl_query_filter_tuple {
                 let ($($filter,)*) = &mut self.0;
                 false $(|| ($filter.matches && $filter.fetch.archetype_filter_fetch(archetype_index)))*
             }
+
+            #[inline]
+            unsafe fn may_match_current(&self) -> bool {
+                let ($($filter,)*) = &self.0;
+                false $(|| ($filter.matches && $filter.fetch.may_match_current()))*
+            }
         }
 
         // SAFETY: update_component_access and update_archetype_component_access are called for each item in the tuple
@@ -542,7 +548,8 @@ macro_rules! impl_tick_filter {
         $state_name: ident,
         $(#[$fetch_meta:meta])*
         $fetch_name: ident,
-        $is_detected: expr
+        $is_detected: expr,
+        $is_detected_in_column: expr
     ) => {
         $(#[$meta])*
         pub struct $name<T>(PhantomData<T>);
@@ -551,6 +558,7 @@ macro_rules! impl_tick_filter {
         pub struct $fetch_name<T> {
             storage_type: StorageType,
             table_ticks: *const UnsafeCell<ComponentTicks>,
+            column_ticks: *const ColumnTicks,
             entity_table_rows: *const usize,
             marker: PhantomData<T>,
             entities: *const Entity,
@@ -620,6 +628,7 @@ macro_rules! impl_tick_filter {
                 let mut value = Self {
                     storage_type: state.storage_type,
                     table_ticks: ptr::null::<UnsafeCell<ComponentTicks>>(),
+                    column_ticks: ptr::null::<ColumnTicks>(),
                     entities: ptr::null::<Entity>(),
                     entity_table_rows: ptr::null::<usize>(),
                     sparse_set: ptr::null::<ComponentSparseSet>(),
@@ -642,19 +651,19 @@ macro_rules! impl_tick_filter {
             }
 
             unsafe fn set_table(&mut self, state: &Self::State, table: &Table) {
-                self.table_ticks = table
-                    .get_column(state.component_id).unwrap()
-                    .get_ticks_ptr();
+                let column = table.get_column(state.component_id).unwrap();
+                self.table_ticks = column.get_ticks_ptr();
+                self.column_ticks = column.column_ticks();
             }
 
             unsafe fn set_archetype(&mut self, state: &Self::State, archetype: &Archetype, tables: &Tables) {
                 match state.storage_type {
                     StorageType::Table => {
                         self.entity_table_rows = archetype.entity_table_rows().as_ptr();
-                        let table = &tables[archetype.table_id()];
-                        self.table_ticks = table
-                            .get_column(state.component_id).unwrap()
-                            .get_ticks_ptr();
+                        let column = tables[archetype.table_id()]
+                            .get_column(state.component_id).unwrap();
+                        self.table_ticks = column.get_ticks_ptr();
+                        self.column_ticks = column.column_ticks();
                     }
                     StorageType::SparseSet => self.entities = archetype.entities().as_ptr(),
                 }
@@ -677,6 +686,15 @@ macro_rules! impl_tick_filter {
                     }
                 }
             }
+
+            #[inline]
+            unsafe fn may_match_current(&self) -> bool {
+                match self.storage_type {
+                    // the column keeps the most recent ticks of all of its rows
+                    StorageType::Table => $is_detected_in_column(&*self.column_ticks, self.last_change_tick, self.change_tick),
+                    StorageType::SparseSet => true,
+                }
+            }
         }
     };
 }
@@ -718,7 +736,8 @@ impl_tick_filter!(
     AddedState,
     /// The [`Fetch`] of [`Added`].
     AddedFetch,
-    ComponentTicks::is_added
+    ComponentTicks::is_added,
+    ColumnTicks::is_added
 );
 
 impl_tick_filter!(
@@ -759,5 +778,6 @@ impl_tick_filter!(
     ChangedState,
     /// The [`Fetch`] of [`Changed`].
     ChangedFetch,
-    ComponentTicks::is_changed
+    ComponentTicks::is_changed,
+    ColumnTicks::is_changed
 );
@@ -85,7 +85,11 @@ where
                         };
                         let table = &self.tables[*table_id];
                         self.filter.set_table(&self.query_state.filter_state, table);
-                        self.current_len = table.len();
+                        self.current_len = if self.filter.may_match_current() {
+                            table.len()
+                        } else {
+                            0
+                        };
                         self.current_index = 0;
                         continue;
                     }
@@ -110,7 +114,11 @@ where
                             archetype,
                             self.tables,
                         );
-                        self.current_len = archetype.len();
+                        self.current_len = if self.filter.may_match_current() {
+                            archetype.len()
+                        } else {
+                            0
+                        };
                         self.current_index = 0;
                         continue;
                     }
@@ -146,7 +154,11 @@ where
                         let table = &self.tables[*table_id];
                         self.fetch.set_table(&self.query_state.fetch_state, table);
                         self.filter.set_table(&self.query_state.filter_state, table);
-                        self.current_len = table.len();
+                        self.current_len = if self.filter.may_match_current() {
+                            table.len()
+                        } else {
+                            0
+                        };
                         self.current_index = 0;
                         continue;
                     }
@@ -176,7 +188,11 @@ where
                             archetype,
                             self.tables,
                         );
-                        self.current_len = archetype.len();
+                        self.current_len = if self.filter.may_match_current() {
+                            archetype.len()
+                        } else {
+                            0
+                        };
                         self.current_index = 0;
                         continue;
                     }
@@ -509,7 +525,11 @@ where
                     let table = &tables[*table_id];
                     self.fetch.set_table(&query_state.fetch_state, table);
                     self.filter.set_table(&query_state.filter_state, table);
-                    self.current_len = table.len();
+                    self.current_len = if self.filter.may_match_current() {
+                        table.len()
+                    } else {
+                        0
+                    };
                     self.current_index = 0;
                     continue;
                 }
@@ -533,7 +553,11 @@ where
                         .set_archetype(&query_state.fetch_state, archetype, tables);
                     self.filter
                         .set_archetype(&query_state.filter_state, archetype, tables);
-                    self.current_len = archetype.len();
+                    self.current_len = if self.filter.may_match_current() {
+                        archetype.len()
+                    } else {
+                        0
+                    };
                     self.current_index = 0;
                     continue;
                 }
@@ -13,6 +13,25 @@ use bevy_tasks::TaskPool;
 use fixedbitset::FixedBitSet;
 use thiserror::Error;
 
+/// Pass this as the `batch_size` of `par_for_each` to let the query choose a batch size from the
+/// number of matched entities and the number of threads in the task pool.
+pub const AUTO_BATCH_SIZE: usize = 0;
+
+/// The number of batches per task pool thread [`AUTO_BATCH_SIZE`] aims for. More than one lets
+/// threads that finish early pick up work from slower ones.
+const AUTO_BATCHES_PER_THREAD: usize = 4;
+
+/// The smallest batch [`AUTO_BATCH_SIZE`] will choose, so tiny workloads aren't dominated by task
+/// spawning overhead.
+const AUTO_MIN_BATCH_SIZE: usize = 32;
+
+/// Picks a batch size that splits `entity_count` entities into roughly
+/// [`AUTO_BATCHES_PER_THREAD`] batches per thread.
+fn auto_batch_size(entity_count: usize, thread_num: usize) -> usize {
+    let batch_count = thread_num.max(1) * AUTO_BATCHES_PER_THREAD;
+    ((entity_count + batch_count - 1) / batch_count).max(AUTO_MIN_BATCH_SIZE)
+}
+
 pub struct QueryState<Q: WorldQuery, F: WorldQuery = ()>
 where
     F::Fetch: FilterFetch,
@@ -334,6 +353,8 @@ where
         );
     }
 
+    /// Runs `func` on each query result in parallel, split into batches of `batch_size` entities.
+    /// Pass [`AUTO_BATCH_SIZE`] to pick the batch size automatically.
     #[inline]
     pub fn par_for_each<'w>(
         &mut self,
@@ -412,6 +433,9 @@ where
                 let table = &tables[*table_id];
                 fetch.set_table(&self.fetch_state, table);
                 filter.set_table(&self.filter_state, table);
+                if !filter.may_match_current() {
+                    continue;
+                }
 
                 for table_index in 0..table.len() {
                     if !filter.table_filter_fetch(table_index) {
@@ -428,6 +452,9 @@ where
                 let archetype = &archetypes[*archetype_id];
                 fetch.set_archetype(&self.fetch_state, archetype, tables);
                 filter.set_archetype(&self.filter_state, archetype, tables);
+                if !filter.may_match_current() {
+                    continue;
+                }
 
                 for archetype_index in 0..archetype.len() {
                     if !filter.archetype_filter_fetch(archetype_index) {
@@ -464,6 +491,16 @@ where
 
             if fetch.is_dense() && filter.is_dense() {
                 let tables = &world.storages().tables;
+                let batch_size = if batch_size == AUTO_BATCH_SIZE {
+                    let entity_count = self
+                        .matched_table_ids
+                        .iter()
+                        .map(|id| tables[*id].len())
+                        .sum();
+                    auto_batch_size(entity_count, task_pool.thread_num())
+                } else {
+                    batch_size
+                };
                 for table_id in self.matched_table_ids.iter() {
                     let table = &tables[*table_id];
                     let mut offset = 0;
@@ -486,6 +523,9 @@ where
                             let table = &tables[*table_id];
                             fetch.set_table(&self.fetch_state, table);
                             filter.set_table(&self.filter_state, table);
+                            if !filter.may_match_current() {
+                                return;
+                            }
                             let len = batch_size.min(table.len() - offset);
                             for table_index in offset..offset + len {
                                 if !filter.table_filter_fetch(table_index) {
@@ -500,6 +540,16 @@ where
                 }
             } else {
                 let archetypes = &world.archetypes;
+                let batch_size = if batch_size == AUTO_BATCH_SIZE {
+                    let entity_count = self
+                        .matched_archetype_ids
+                        .iter()
+                        .map(|id| archetypes[*id].len())
+                        .sum();
+                    auto_batch_size(entity_count, task_pool.thread_num())
+                } else {
+                    batch_size
+                };
                 for archetype_id in self.matched_archetype_ids.iter() {
                     let mut offset = 0;
                     let archetype = &archetypes[*archetype_id];
@@ -522,6 +572,9 @@ where
                             let archetype = &world.archetypes[*archetype_id];
                             fetch.set_archetype(&self.fetch_state, archetype, tables);
                             filter.set_archetype(&self.filter_state, archetype, tables);
+                            if !filter.may_match_current() {
+                                return;
+                            }
 
                             let len = batch_size.min(archetype.len() - offset);
                             for archetype_index in offset..offset + len {
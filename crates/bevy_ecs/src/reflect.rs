@@ -2,7 +2,7 @@ pub use crate::change_detection::ReflectMut;
 use crate::{
     component::Component,
     entity::{Entity, EntityMap, MapEntities, MapEntitiesError},
-    world::{FromWorld, World},
+    world::{ComponentBatch, FromWorld, World},
 };
 use bevy_reflect::{impl_reflect_value, FromType, Reflect, ReflectDeserialize};
 
@@ -13,6 +13,7 @@ pub struct ReflectComponent {
     reflect_component: fn(&World, Entity) -> Option<&dyn Reflect>,
     reflect_component_mut: unsafe fn(&World, Entity) -> Option<ReflectMut>,
     copy_component: fn(&World, &mut World, Entity, Entity),
+    add_component_to_batch: fn(&mut World, &dyn Reflect, &mut ComponentBatch),
 }
 
 impl ReflectComponent {
@@ -69,6 +70,17 @@ impl ReflectComponent {
             destination_entity,
         );
     }
+
+    /// Adds a copy of `component` to `batch` for its next entity, see
+    /// [World::spawn_component_batch]
+    pub fn add_component_to_batch(
+        &self,
+        world: &mut World,
+        component: &dyn Reflect,
+        batch: &mut ComponentBatch,
+    ) {
+        (self.add_component_to_batch)(world, component, batch);
+    }
 }
 
 impl<C: Component + Reflect + FromWorld> FromType<C> for ReflectComponent {
@@ -91,6 +103,11 @@ impl<C: Component + Reflect + FromWorld> FromType<C> for ReflectComponent {
                     .entity_mut(destination_entity)
                     .insert(destination_component);
             },
+            add_component_to_batch: |world, reflected_component, batch| {
+                let mut component = C::from_world(world);
+                component.apply(reflected_component);
+                batch.push(world, component);
+            },
             reflect_component: |world, entity| {
                 world
                     .get_entity(entity)?
@@ -115,6 +132,7 @@ impl_reflect_value!(Entity(Hash, PartialEq, Serialize, Deserialize));
 #[derive(Clone)]
 pub struct ReflectMapEntities {
     map_entities: fn(&mut World, &EntityMap) -> Result<(), MapEntitiesError>,
+    map_specific_entities: fn(&mut World, &EntityMap, &[Entity]) -> Result<(), MapEntitiesError>,
 }
 
 impl ReflectMapEntities {
@@ -125,6 +143,17 @@ impl ReflectMapEntities {
     ) -> Result<(), MapEntitiesError> {
         (self.map_entities)(world, entity_map)
     }
+
+    /// Like [`ReflectMapEntities::map_entities`], but only maps the components of `entities`
+    /// (ex: the part of a scene that was just spawned)
+    pub fn map_specific_entities(
+        &self,
+        world: &mut World,
+        entity_map: &EntityMap,
+        entities: &[Entity],
+    ) -> Result<(), MapEntitiesError> {
+        (self.map_specific_entities)(world, entity_map, entities)
+    }
 }
 
 impl<C: Component + MapEntities> FromType<C> for ReflectMapEntities {
@@ -138,6 +167,14 @@ impl<C: Component + MapEntities> FromType<C> for ReflectMapEntities {
                 }
                 Ok(())
             },
+            map_specific_entities: |world, entity_map, entities| {
+                for &entity in entities {
+                    if let Some(mut component) = world.get_mut::<C>(entity) {
+                        component.map_entities(entity_map)?;
+                    }
+                }
+                Ok(())
+            },
         }
     }
 }
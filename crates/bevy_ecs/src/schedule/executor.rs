@@ -1,4 +1,9 @@
-use crate::{archetype::ArchetypeGeneration, schedule::ParallelSystemContainer, world::World};
+use crate::{
+    archetype::ArchetypeGeneration,
+    schedule::{ParallelSystemContainer, SystemTiming, SystemTimings},
+    world::World,
+};
+use bevy_utils::Instant;
 use downcast_rs::{impl_downcast, Downcast};
 
 pub trait ParallelSystemExecutor: Downcast + Send + Sync {
@@ -27,6 +32,11 @@ impl ParallelSystemExecutor for SingleThreadedExecutor {
 
     fn run_systems(&mut self, systems: &mut [ParallelSystemContainer], world: &mut World) {
         self.update_archetypes(systems, world);
+        let stage_start = if world.contains_resource::<SystemTimings>() {
+            Some(Instant::now())
+        } else {
+            None
+        };
 
         for system in systems {
             if system.should_run() {
@@ -34,7 +44,21 @@ impl ParallelSystemExecutor for SingleThreadedExecutor {
                 let system_span = bevy_utils::tracing::info_span!("system", name = &*system.name());
                 #[cfg(feature = "trace")]
                 let _system_guard = system_span.enter();
+                let start = stage_start.map(|_| Instant::now());
                 system.system_mut().run((), world);
+                if let (Some(stage_start), Some(start)) = (stage_start, start) {
+                    if let Some(mut timings) = world.get_resource_mut::<SystemTimings>() {
+                        // systems run in dependency order, so anything before is a dependency
+                        timings.push(SystemTiming {
+                            name: system.name(),
+                            thread: std::thread::current().id(),
+                            stage_start,
+                            ready: start,
+                            start,
+                            end: Instant::now(),
+                        });
+                    }
+                }
             }
         }
     }
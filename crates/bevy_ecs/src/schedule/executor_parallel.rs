@@ -1,12 +1,14 @@
 use crate::{
     archetype::{ArchetypeComponentId, ArchetypeGeneration},
     query::Access,
-    schedule::{ParallelSystemContainer, ParallelSystemExecutor},
+    schedule::{ParallelSystemContainer, ParallelSystemExecutor, SystemTiming, SystemTimings},
     world::World,
 };
 use async_channel::{Receiver, Sender};
 use bevy_tasks::{ComputeTaskPool, Scope, TaskPool};
+use bevy_utils::Instant;
 use fixedbitset::FixedBitSet;
+use std::thread::ThreadId;
 
 #[cfg(test)]
 use SchedulingEvent::*;
@@ -27,6 +29,8 @@ struct SystemSchedulingMetadata {
     archetype_component_access: Access<ArchetypeComponentId>,
     /// Whether or not this system is send-able
     is_send: bool,
+    /// When the system's dependencies were last satisfied, only updated while timings are recorded.
+    ready: Instant,
 }
 
 pub struct ParallelExecutor {
@@ -50,6 +54,12 @@ pub struct ParallelExecutor {
     active_archetype_component_access: Access<ArchetypeComponentId>,
     /// Scratch space to avoid reallocating a vector when updating dependency counters.
     dependants_scratch: Vec<usize>,
+    /// When the current run started, if the world has a [SystemTimings] resource.
+    stage_start: Option<Instant>,
+    /// Used by systems to report when they started and finished while timings are recorded.
+    timing_sender: Sender<(usize, ThreadId, Instant, Instant)>,
+    /// Receives the run times of systems.
+    timing_receiver: Receiver<(usize, ThreadId, Instant, Instant)>,
     #[cfg(test)]
     events_sender: Option<Sender<SchedulingEvent>>,
 }
@@ -57,6 +67,7 @@ pub struct ParallelExecutor {
 impl Default for ParallelExecutor {
     fn default() -> Self {
         let (finish_sender, finish_receiver) = async_channel::unbounded();
+        let (timing_sender, timing_receiver) = async_channel::unbounded();
         Self {
             archetype_generation: ArchetypeGeneration::initial(),
             system_metadata: Default::default(),
@@ -68,6 +79,9 @@ impl Default for ParallelExecutor {
             should_run: Default::default(),
             active_archetype_component_access: Default::default(),
             dependants_scratch: Default::default(),
+            stage_start: None,
+            timing_sender,
+            timing_receiver,
             #[cfg(test)]
             events_sender: None,
         }
@@ -94,6 +108,7 @@ impl ParallelSystemExecutor for ParallelExecutor {
                 dependencies_now: 0,
                 is_send: system.is_send(),
                 archetype_component_access: Default::default(),
+                ready: Instant::now(),
             });
         }
         // Populate the dependants lists in the scheduling metadata.
@@ -113,6 +128,11 @@ impl ParallelSystemExecutor for ParallelExecutor {
         }
 
         self.update_archetypes(systems, world);
+        self.stage_start = if world.contains_resource::<SystemTimings>() {
+            Some(Instant::now())
+        } else {
+            None
+        };
 
         let compute_pool = world
             .get_resource_or_insert_with(|| ComputeTaskPool(TaskPool::default()))
@@ -143,6 +163,21 @@ impl ParallelSystemExecutor for ParallelExecutor {
                 }
             });
         });
+
+        if let Some(stage_start) = self.stage_start.take() {
+            if let Some(mut timings) = world.get_resource_mut::<SystemTimings>() {
+                while let Ok((index, thread, start, end)) = self.timing_receiver.try_recv() {
+                    timings.push(SystemTiming {
+                        name: systems[index].name(),
+                        thread,
+                        stage_start,
+                        ready: self.system_metadata[index].ready,
+                        start,
+                        end,
+                    });
+                }
+            }
+        }
     }
 }
 
@@ -182,6 +217,7 @@ impl ParallelExecutor {
                 let start_receiver = system_data.start_receiver.clone();
                 let finish_sender = self.finish_sender.clone();
                 let system = unsafe { systems[index].system_mut_unsafe() };
+                let timing_sender = self.stage_start.map(|_| self.timing_sender.clone());
                 let task = async move {
                     start_receiver
                         .recv()
@@ -192,7 +228,12 @@ impl ParallelExecutor {
                         bevy_utils::tracing::info_span!("system", name = &*system.name());
                     #[cfg(feature = "trace")]
                     let system_guard = system_span.enter();
+                    let start = timing_sender.as_ref().map(|_| Instant::now());
                     unsafe { system.run_unsafe((), world) };
+                    if let (Some(timing_sender), Some(start)) = (timing_sender, start) {
+                        let thread = std::thread::current().id();
+                        let _ = timing_sender.try_send((index, thread, start, Instant::now()));
+                    }
                     #[cfg(feature = "trace")]
                     drop(system_guard);
                     finish_sender
@@ -209,6 +250,9 @@ impl ParallelExecutor {
             // Queue the system if it has no dependencies, otherwise reset its dependency counter.
             if system_data.dependencies_total == 0 {
                 self.queued.insert(index);
+                if let Some(stage_start) = self.stage_start {
+                    system_data.ready = stage_start;
+                }
             } else {
                 system_data.dependencies_now = system_data.dependencies_total;
             }
@@ -295,6 +339,9 @@ impl ParallelExecutor {
             dependant_data.dependencies_now -= 1;
             if dependant_data.dependencies_now == 0 {
                 self.queued.insert(index);
+                if self.stage_start.is_some() {
+                    dependant_data.ready = Instant::now();
+                }
             }
         }
     }
@@ -315,8 +362,11 @@ enum SchedulingEvent {
 mod tests {
     use super::SchedulingEvent::{self, *};
     use crate::{
-        schedule::{SingleThreadedExecutor, Stage, SystemStage},
-        system::{IntoSystem, NonSend, Query, Res, ResMut},
+        schedule::{
+            ParallelSystemDescriptorCoercion, SingleThreadedExecutor, Stage, SystemStage,
+            SystemTimings,
+        },
+        system::{IntoExclusiveSystem, IntoSystem, NonSend, Query, Res, ResMut},
         world::World,
     };
     use async_channel::Receiver;
@@ -445,4 +495,45 @@ mod tests {
         stage.set_executor(Box::new(SingleThreadedExecutor::default()));
         stage.run(&mut world);
     }
+
+    #[test]
+    fn system_timings() {
+        let mut world = World::new();
+        fn first() {}
+        fn second() {}
+        fn exclusive(_: &mut World) {}
+        let mut stage = SystemStage::parallel()
+            .with_system(first.system().label("first"))
+            .with_system(second.system().after("first"))
+            .with_system(exclusive.exclusive_system());
+        stage.run(&mut world);
+        assert!(world.get_resource::<SystemTimings>().is_none());
+
+        world.insert_resource(SystemTimings::default());
+        stage.run(&mut world);
+        let timings = world.get_resource::<SystemTimings>().unwrap();
+        assert_eq!(timings.len(), 3);
+        let timing = |name: &str| {
+            timings
+                .iter()
+                .find(|timing| timing.name.ends_with(name))
+                .unwrap()
+                .clone()
+        };
+        let (first, second) = (timing("first"), timing("second"));
+        assert!(first.start <= first.end);
+        assert!(second.ready >= first.end);
+        assert!(second.start >= second.ready);
+        // exclusive systems run at the start of the stage by default
+        assert!(timing("exclusive").end <= first.start);
+
+        world
+            .get_resource_mut::<SystemTimings>()
+            .unwrap()
+            .drain()
+            .for_each(drop);
+        stage.set_executor(Box::new(SingleThreadedExecutor::default()));
+        stage.run(&mut world);
+        assert_eq!(world.get_resource::<SystemTimings>().unwrap().len(), 3);
+    }
 }
@@ -8,6 +8,7 @@ mod state;
 mod system_container;
 mod system_descriptor;
 mod system_set;
+mod system_timings;
 
 pub use executor::*;
 pub use executor_parallel::*;
@@ -19,6 +20,7 @@ pub use state::*;
 pub use system_container::*;
 pub use system_descriptor::*;
 pub use system_set::*;
+pub use system_timings::*;
 
 use std::fmt::Debug;
 
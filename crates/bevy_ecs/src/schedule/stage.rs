@@ -6,12 +6,13 @@ use crate::{
         ExclusiveSystemContainer, GraphNode, InsertionPoint, ParallelExecutor,
         ParallelSystemContainer, ParallelSystemExecutor, RunCriteriaContainer,
         RunCriteriaDescriptor, RunCriteriaDescriptorOrLabel, RunCriteriaInner, ShouldRun,
-        SingleThreadedExecutor, SystemContainer, SystemDescriptor, SystemSet,
+        SingleThreadedExecutor, SystemContainer, SystemDescriptor, SystemSet, SystemTiming,
+        SystemTimings,
     },
     system::System,
     world::{World, WorldId},
 };
-use bevy_utils::{tracing::info, HashMap, HashSet};
+use bevy_utils::{tracing::info, HashMap, HashSet, Instant};
 use downcast_rs::{impl_downcast, Downcast};
 use fixedbitset::FixedBitSet;
 use std::fmt::Debug;
@@ -734,6 +735,27 @@ fn find_ambiguities(systems: &[impl SystemContainer]) -> Vec<(usize, usize, Vec<
     ambiguities
 }
 
+/// Runs an exclusive system, recording its timing if the world has a [SystemTimings] resource
+fn run_exclusive_system(container: &mut ExclusiveSystemContainer, world: &mut World) {
+    if !world.contains_resource::<SystemTimings>() {
+        container.system_mut().run(world);
+        return;
+    }
+    let start = Instant::now();
+    container.system_mut().run(world);
+    let end = Instant::now();
+    if let Some(mut timings) = world.get_resource_mut::<SystemTimings>() {
+        timings.push(SystemTiming {
+            name: container.name(),
+            thread: std::thread::current().id(),
+            stage_start: start,
+            ready: start,
+            start,
+            end,
+        });
+    }
+}
+
 impl Stage for SystemStage {
     fn run(&mut self, world: &mut World) {
         if let Some(world_id) = self.world_id {
@@ -808,7 +830,7 @@ impl Stage for SystemStage {
                 // Run systems that want to be at the start of stage.
                 for container in &mut self.exclusive_at_start {
                     if should_run(container, &self.run_criteria, default_should_run) {
-                        container.system_mut().run(world);
+                        run_exclusive_system(container, world);
                     }
                 }
 
@@ -823,7 +845,7 @@ impl Stage for SystemStage {
                 // Run systems that want to be between parallel systems and their command buffers.
                 for container in &mut self.exclusive_before_commands {
                     if should_run(container, &self.run_criteria, default_should_run) {
-                        container.system_mut().run(world);
+                        run_exclusive_system(container, world);
                     }
                 }
 
@@ -837,7 +859,7 @@ impl Stage for SystemStage {
                 // Run systems that want to be at the end of stage.
                 for container in &mut self.exclusive_at_end {
                     if should_run(container, &self.run_criteria, default_should_run) {
-                        container.system_mut().run(world);
+                        run_exclusive_system(container, world);
                     }
                 }
 
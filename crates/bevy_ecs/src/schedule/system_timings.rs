@@ -0,0 +1,65 @@
+use bevy_utils::{Duration, Instant};
+use std::{borrow::Cow, thread::ThreadId};
+
+/// When a system ran during one run of its stage.
+#[derive(Debug, Clone)]
+pub struct SystemTiming {
+    pub name: Cow<'static, str>,
+    /// The thread the system ran on
+    pub thread: ThreadId,
+    /// When the executor started running the systems of the stage
+    pub stage_start: Instant,
+    /// When all dependencies of the system had finished
+    pub ready: Instant,
+    pub start: Instant,
+    pub end: Instant,
+}
+
+impl SystemTiming {
+    /// How long the system ran
+    pub fn run_time(&self) -> Duration {
+        self.end - self.start
+    }
+
+    /// How long the system waited on the systems it depends on
+    pub fn dependency_wait_time(&self) -> Duration {
+        self.ready - self.stage_start
+    }
+
+    /// How long the system waited after its dependencies finished, because it conflicts with
+    /// running systems or no thread was free
+    pub fn conflict_wait_time(&self) -> Duration {
+        self.start - self.ready
+    }
+}
+
+/// Timings of the systems that ran since the last [SystemTimings::drain].
+///
+/// Executors only measure systems while this resource exists, so inserting it is how timings are
+/// turned on. Whoever inserts it should drain it every frame.
+#[derive(Debug, Default)]
+pub struct SystemTimings {
+    timings: Vec<SystemTiming>,
+}
+
+impl SystemTimings {
+    pub fn push(&mut self, timing: SystemTiming) {
+        self.timings.push(timing);
+    }
+
+    pub fn iter(&self) -> impl Iterator<Item = &SystemTiming> {
+        self.timings.iter()
+    }
+
+    pub fn drain(&mut self) -> impl Iterator<Item = SystemTiming> + '_ {
+        self.timings.drain(..)
+    }
+
+    pub fn len(&self) -> usize {
+        self.timings.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.timings.is_empty()
+    }
+}
@@ -118,6 +118,32 @@ impl BlobVec {
         index
     }
 
+    /// Appends bitwise copies of the items of `other` at `rows`, copying each run of consecutive
+    /// rows at once. Ownership of the copied items moves to this vec, the caller must make sure
+    /// `other` forgets them.
+    ///
+    /// # Safety
+    /// `other` must store items of the same type and every row must be in bounds
+    pub unsafe fn extend_from_rows_unchecked(&mut self, other: &BlobVec, rows: &[usize]) {
+        debug_assert_eq!(self.item_layout, other.item_layout);
+        self.reserve_exact(rows.len());
+        let size = self.item_layout.size();
+        let mut start = 0;
+        while start < rows.len() {
+            let mut end = start + 1;
+            while end < rows.len() && rows[end] == rows[end - 1] + 1 {
+                end += 1;
+            }
+            std::ptr::copy_nonoverlapping(
+                other.get_unchecked(rows[start]),
+                self.get_ptr().as_ptr().add((self.len + start) * size),
+                (end - start) * size,
+            );
+            start = end;
+        }
+        self.len += rows.len();
+    }
+
     /// # Safety
     /// len must be <= capacity. if length is decreased, "out of bounds" items must be dropped.
     /// Newly added items must be immediately populated with valid values and length must be
@@ -9,6 +9,7 @@ use std::{
     hash::{Hash, Hasher},
     ops::{Index, IndexMut},
     ptr::NonNull,
+    sync::atomic::{AtomicU32, Ordering},
 };
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -31,10 +32,94 @@ impl TableId {
     }
 }
 
+/// The most recent `added` and `changed` ticks of all the rows of a [`Column`]. This lets
+/// [`Added`](crate::query::Added) and [`Changed`](crate::query::Changed) queries skip tables
+/// without a single added or changed row.
+///
+/// Ticks written through [`Column::get_ticks_unchecked_mut`] or
+/// [`Column::get_ticks_mut_ptr_unchecked`] are not tracked, callers need to also call
+/// [`ColumnTicks::set_changed`].
+#[derive(Debug, Default)]
+pub struct ColumnTicks {
+    // atomic because rows of the same column can be mutated from several threads at once
+    added: AtomicU32,
+    changed: AtomicU32,
+}
+
+impl ColumnTicks {
+    #[inline]
+    pub fn is_added(&self, last_change_tick: u32, change_tick: u32) -> bool {
+        self.get().is_added(last_change_tick, change_tick)
+    }
+
+    #[inline]
+    pub fn is_changed(&self, last_change_tick: u32, change_tick: u32) -> bool {
+        self.get().is_changed(last_change_tick, change_tick)
+    }
+
+    /// Records a change of a row of the column. Systems running in parallel can write to the same
+    /// column with different change ticks, so the tick is only ever moved forward.
+    #[inline]
+    pub fn set_changed(&self, change_tick: u32) {
+        let _ = self
+            .changed
+            .fetch_update(Ordering::Relaxed, Ordering::Relaxed, |changed| {
+                if is_newer_tick(change_tick, changed) {
+                    Some(change_tick)
+                } else {
+                    None
+                }
+            });
+    }
+
+    #[inline]
+    fn get(&self) -> ComponentTicks {
+        ComponentTicks {
+            added: self.added.load(Ordering::Relaxed),
+            changed: self.changed.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Records the ticks of a row written to the column, keeping the most recent ticks relative
+    /// to `change_tick`, the current change tick of the world
+    #[inline]
+    fn update(&mut self, ticks: &ComponentTicks, change_tick: u32) {
+        let added = self.added.get_mut();
+        *added = most_recent_tick(*added, ticks.added, change_tick);
+        let changed = self.changed.get_mut();
+        *changed = most_recent_tick(*changed, ticks.changed, change_tick);
+    }
+
+    fn check_ticks(&mut self, change_tick: u32) {
+        let mut ticks = self.get();
+        ticks.check_ticks(change_tick);
+        *self.added.get_mut() = ticks.added;
+        *self.changed.get_mut() = ticks.changed;
+    }
+}
+
+/// Whether `tick` is more recent than `than`. Ticks are kept within `MAX_CHANGE_AGE` of the
+/// current change tick by `check_ticks`, so the wrapping difference of two ticks is always less
+/// than half of the tick range.
+#[inline]
+fn is_newer_tick(tick: u32, than: u32) -> bool {
+    (tick.wrapping_sub(than) as i32) > 0
+}
+
+#[inline]
+fn most_recent_tick(a: u32, b: u32, change_tick: u32) -> u32 {
+    if change_tick.wrapping_sub(a) <= change_tick.wrapping_sub(b) {
+        a
+    } else {
+        b
+    }
+}
+
 pub struct Column {
     pub(crate) component_id: ComponentId,
     pub(crate) data: BlobVec,
     pub(crate) ticks: Vec<UnsafeCell<ComponentTicks>>,
+    pub(crate) column_ticks: ColumnTicks,
 }
 
 impl Column {
@@ -44,19 +129,28 @@ impl Column {
             component_id: component_info.id(),
             data: BlobVec::new(component_info.layout(), component_info.drop(), capacity),
             ticks: Vec::with_capacity(capacity),
+            column_ticks: ColumnTicks::default(),
         }
     }
 
     /// Writes component data to the column at given row.
     /// Assumes the slot is uninitialized, drop is not called.
     /// To overwrite existing initialized value, use `replace` instead.
+    /// `change_tick` is the current change tick of the world.
     ///
     /// # Safety
     /// Assumes data has already been allocated for the given row.
     #[inline]
-    pub unsafe fn initialize(&mut self, row: usize, data: *mut u8, ticks: ComponentTicks) {
+    pub unsafe fn initialize(
+        &mut self,
+        row: usize,
+        data: *mut u8,
+        ticks: ComponentTicks,
+        change_tick: u32,
+    ) {
         debug_assert!(row < self.len());
         self.data.initialize_unchecked(row, data);
+        self.column_ticks.update(&ticks, change_tick);
         *self.ticks.get_unchecked_mut(row).get_mut() = ticks;
     }
 
@@ -73,6 +167,7 @@ impl Column {
             .get_unchecked_mut(row)
             .get_mut()
             .set_changed(change_tick);
+        self.column_ticks.set_changed(change_tick);
     }
 
     /// # Safety
@@ -179,11 +274,18 @@ impl Column {
         self.ticks.get_unchecked(row).get()
     }
 
+    /// The most recent ticks of the rows of this column
+    #[inline]
+    pub fn column_ticks(&self) -> &ColumnTicks {
+        &self.column_ticks
+    }
+
     #[inline]
     pub(crate) fn check_change_ticks(&mut self, change_tick: u32) {
         for component_ticks in &mut self.ticks {
             component_ticks.get_mut().check_ticks(change_tick);
         }
+        self.column_ticks.check_ticks(change_tick);
     }
 }
 
@@ -240,7 +342,8 @@ impl Table {
     /// Moves the `row` column values to `new_table`, for the columns shared between both tables.
     /// Returns the index of the new row in `new_table` and the entity in this table swapped in
     /// to replace it (if an entity was swapped in). missing columns will be "forgotten". It is
-    /// the caller's responsibility to drop them
+    /// the caller's responsibility to drop them.
+    /// `change_tick` is the current change tick of the world.
     ///
     /// # Safety
     /// Row must be in-bounds
@@ -248,6 +351,7 @@ impl Table {
         &mut self,
         row: usize,
         new_table: &mut Table,
+        change_tick: u32,
     ) -> TableMoveResult {
         debug_assert!(row < self.len());
         let is_last = row == self.entities.len() - 1;
@@ -255,7 +359,7 @@ impl Table {
         for column in self.columns.values_mut() {
             let (data, ticks) = column.swap_remove_and_forget_unchecked(row);
             if let Some(new_column) = new_table.get_column_mut(column.component_id) {
-                new_column.initialize(new_row, data, ticks);
+                new_column.initialize(new_row, data, ticks, change_tick);
             }
         }
         TableMoveResult {
@@ -271,6 +375,7 @@ impl Table {
     /// Moves the `row` column values to `new_table`, for the columns shared between both tables.
     /// Returns the index of the new row in `new_table` and the entity in this table swapped in
     /// to replace it (if an entity was swapped in).
+    /// `change_tick` is the current change tick of the world.
     ///
     /// # Safety
     /// row must be in-bounds
@@ -278,6 +383,7 @@ impl Table {
         &mut self,
         row: usize,
         new_table: &mut Table,
+        change_tick: u32,
     ) -> TableMoveResult {
         debug_assert!(row < self.len());
         let is_last = row == self.entities.len() - 1;
@@ -285,7 +391,7 @@ impl Table {
         for column in self.columns.values_mut() {
             if let Some(new_column) = new_table.get_column_mut(column.component_id) {
                 let (data, ticks) = column.swap_remove_and_forget_unchecked(row);
-                new_column.initialize(new_row, data, ticks);
+                new_column.initialize(new_row, data, ticks, change_tick);
             } else {
                 column.swap_remove_unchecked(row);
             }
@@ -303,6 +409,7 @@ impl Table {
     /// Moves the `row` column values to `new_table`, for the columns shared between both tables.
     /// Returns the index of the new row in `new_table` and the entity in this table swapped in
     /// to replace it (if an entity was swapped in).
+    /// `change_tick` is the current change tick of the world.
     ///
     /// # Safety
     /// `row` must be in-bounds. `new_table` must contain every component this table has
@@ -310,6 +417,7 @@ impl Table {
         &mut self,
         row: usize,
         new_table: &mut Table,
+        change_tick: u32,
     ) -> TableMoveResult {
         debug_assert!(row < self.len());
         let is_last = row == self.entities.len() - 1;
@@ -317,7 +425,7 @@ impl Table {
         for column in self.columns.values_mut() {
             let new_column = new_table.get_column_mut(column.component_id).unwrap();
             let (data, ticks) = column.swap_remove_and_forget_unchecked(row);
-            new_column.initialize(new_row, data, ticks);
+            new_column.initialize(new_row, data, ticks, change_tick);
         }
         TableMoveResult {
             new_row,
@@ -329,6 +437,94 @@ impl Table {
         }
     }
 
+    /// Moves the values at `rows` to the end of `new_table` as one batch: each shared column is
+    /// reserved once and copied a run of rows at a time. Values of columns missing from
+    /// `new_table` are dropped, columns only `new_table` has are left uninitialized for the
+    /// caller to write. Returns the first new row and the entities of this table that were
+    /// swapped into a moved row, in the order the swaps happened.
+    /// `change_tick` is the current change tick of the world.
+    ///
+    /// # Safety
+    /// `rows` must be in-bounds, sorted and unique. The new rows of columns that are not in this
+    /// table must be written immediately.
+    pub(crate) unsafe fn move_rows_and_drop_missing_unchecked(
+        &mut self,
+        rows: &[usize],
+        new_table: &mut Table,
+        change_tick: u32,
+    ) -> TableBatchMoveResult {
+        debug_assert!(rows.windows(2).all(|rows| rows[0] < rows[1]));
+        let count = rows.len();
+        let new_row = new_table.len();
+        new_table.reserve(count);
+        new_table
+            .entities
+            .extend(rows.iter().map(|row| *self.entities.get_unchecked(*row)));
+        for new_column in new_table.columns.values_mut() {
+            match self.columns.get(new_column.component_id) {
+                Some(column) => {
+                    new_column
+                        .data
+                        .extend_from_rows_unchecked(&column.data, rows);
+                    new_column.ticks.extend(
+                        rows.iter()
+                            .map(|row| UnsafeCell::new(column.get_ticks_unchecked(*row).clone())),
+                    );
+                    // the moved rows are at most as recent as all the rows of their column
+                    let column_ticks = column.column_ticks.get();
+                    new_column.column_ticks.update(&column_ticks, change_tick);
+                }
+                None => {
+                    new_column.data.set_len(new_row + count);
+                    new_column
+                        .ticks
+                        .resize_with(new_row + count, || UnsafeCell::new(ComponentTicks::new(0)));
+                }
+            }
+        }
+
+        let mut swapped_entities = Vec::new();
+        let remaining = self.entities.len() - count;
+        if count > 0 && rows[0] == remaining {
+            // the moved rows are the end of the table, nothing needs to be swapped in
+            for column in self.columns.values_mut() {
+                if new_table.has_column(column.component_id) {
+                    column.data.set_len(remaining);
+                    column.ticks.truncate(remaining);
+                } else {
+                    for row in rows.iter().rev() {
+                        column.swap_remove_unchecked(*row);
+                    }
+                }
+            }
+            self.entities.truncate(remaining);
+        } else {
+            // remove from the back so rows that are still to be removed are never swapped
+            for column in self.columns.values_mut() {
+                if new_table.has_column(column.component_id) {
+                    for row in rows.iter().rev() {
+                        column.swap_remove_and_forget_unchecked(*row);
+                    }
+                } else {
+                    for row in rows.iter().rev() {
+                        column.swap_remove_unchecked(*row);
+                    }
+                }
+            }
+            for row in rows.iter().rev() {
+                let is_last = *row == self.entities.len() - 1;
+                self.entities.swap_remove(*row);
+                if !is_last {
+                    swapped_entities.push((self.entities[*row], *row));
+                }
+            }
+        }
+        TableBatchMoveResult {
+            new_row,
+            swapped_entities,
+        }
+    }
+
     #[inline]
     pub fn get_column(&self, component_id: ComponentId) -> Option<&Column> {
         self.columns.get(component_id)
@@ -418,6 +614,13 @@ pub struct TableMoveResult {
     pub new_row: usize,
 }
 
+pub struct TableBatchMoveResult {
+    /// The row of the first moved entity in the new table, the others follow it
+    pub new_row: usize,
+    /// The entities swapped into moved rows and their new row
+    pub swapped_entities: Vec<(Entity, usize)>,
+}
+
 impl Tables {
     #[inline]
     pub fn len(&self) -> usize {
@@ -503,9 +706,27 @@ mod tests {
     use crate::{
         component::{Components, TypeInfo},
         entity::Entity,
-        storage::Table,
+        storage::{ColumnTicks, Table},
     };
 
+    #[test]
+    fn column_ticks_only_move_forward() {
+        let ticks = ColumnTicks::default();
+        ticks.set_changed(10);
+        // a parallel system that started earlier finishes its write last
+        ticks.set_changed(5);
+        assert!(ticks.is_changed(9, 12));
+        ticks.set_changed(11);
+        assert!(ticks.is_changed(10, 12));
+
+        // across the wrap around
+        let ticks = ColumnTicks::default();
+        ticks.set_changed(u32::MAX - 1);
+        ticks.set_changed(3);
+        ticks.set_changed(u32::MAX);
+        assert!(ticks.is_changed(2, 5));
+    }
+
     #[test]
     fn table() {
         let mut components = Components::default();
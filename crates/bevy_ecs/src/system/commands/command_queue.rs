@@ -1,9 +1,11 @@
 use super::Command;
 use crate::world::World;
+use std::{any::TypeId, marker::PhantomData};
 
 struct CommandMeta {
     offset: usize,
-    func: unsafe fn(value: *mut u8, world: &mut World),
+    type_id: TypeId,
+    func: unsafe fn(value: *mut u8, count: usize, world: &mut World),
 }
 
 /// A queue of [`Command`]s
@@ -32,12 +34,11 @@ impl CommandQueue {
     where
         C: Command,
     {
-        /// SAFE: This function is only every called when the `command` bytes is the associated
-        /// [`Commands`] `T` type. Also this only reads the data via `read_unaligned` so unaligned
-        /// accesses are safe.
-        unsafe fn write_command<T: Command>(command: *mut u8, world: &mut World) {
-            let command = command.cast::<T>().read_unaligned();
-            command.write(world);
+        /// SAFE: This function is only every called when the `commands` bytes are `count`
+        /// consecutive [`Commands`] of the associated `T` type. Also [`CommandBatch`] only reads
+        /// the data via `read_unaligned` so unaligned accesses are safe.
+        unsafe fn write_commands<T: Command>(commands: *mut u8, count: usize, world: &mut World) {
+            T::write_batch(CommandBatch::new(commands, count), world);
         }
 
         let size = std::mem::size_of::<C>();
@@ -45,7 +46,8 @@ impl CommandQueue {
 
         self.metas.push(CommandMeta {
             offset: old_len,
-            func: write_command::<C>,
+            type_id: TypeId::of::<C>(),
+            func: write_commands::<C>,
         });
 
         if size > 0 {
@@ -71,6 +73,8 @@ impl CommandQueue {
 
     /// Execute the queued [`Command`]s in the world.
     /// This clears the queue.
+    ///
+    /// Consecutive commands of the same type are written together with [`Command::write_batch`].
     #[inline]
     pub fn apply(&mut self, world: &mut World) {
         // flush the previously queued entities
@@ -97,16 +101,76 @@ impl CommandQueue {
             self.bytes.as_mut_ptr()
         };
 
-        for meta in self.metas.drain(..) {
-            // SAFE: The implementation of `write_command` is safe for the according Command type.
+        let mut metas = self.metas.drain(..).peekable();
+        while let Some(meta) = metas.next() {
+            // commands of the same type pushed one after the other are stored back to back
+            let mut count = 1;
+            while metas
+                .peek()
+                .map_or(false, |next| next.type_id == meta.type_id)
+            {
+                metas.next();
+                count += 1;
+            }
+            // SAFE: The implementation of `write_commands` is safe for the according Command type.
             // The bytes are safely cast to their original type, safely read, and then dropped.
             unsafe {
-                (meta.func)(byte_ptr.add(meta.offset), world);
+                (meta.func)(byte_ptr.add(meta.offset), count, world);
             }
         }
     }
 }
 
+/// An iterator over consecutive commands of the same type of a [`CommandQueue`], given to
+/// [`Command::write_batch`]. Commands that are not iterated over are dropped with the batch.
+pub struct CommandBatch<'a, T: Command> {
+    ptr: *mut u8,
+    remaining: usize,
+    phantom: PhantomData<(&'a mut [u8], T)>,
+}
+
+impl<'a, T: Command> CommandBatch<'a, T> {
+    /// # Safety
+    /// `ptr` must point to `count` unaligned values of `T`, that are moved out by the batch
+    unsafe fn new(ptr: *mut u8, count: usize) -> Self {
+        Self {
+            ptr,
+            remaining: count,
+            phantom: PhantomData,
+        }
+    }
+}
+
+impl<'a, T: Command> Iterator for CommandBatch<'a, T> {
+    type Item = T;
+
+    #[inline]
+    fn next(&mut self) -> Option<T> {
+        if self.remaining == 0 {
+            return None;
+        }
+        // SAFE: there are `remaining` values of `T` left at `ptr`, each one is only read once
+        unsafe {
+            let command = self.ptr.cast::<T>().read_unaligned();
+            self.ptr = self.ptr.add(std::mem::size_of::<T>());
+            self.remaining -= 1;
+            Some(command)
+        }
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        (self.remaining, Some(self.remaining))
+    }
+}
+
+impl<'a, T: Command> ExactSizeIterator for CommandBatch<'a, T> {}
+
+impl<'a, T: Command> Drop for CommandBatch<'a, T> {
+    fn drop(&mut self) {
+        self.for_each(drop);
+    }
+}
+
 #[cfg(test)]
 mod test {
     use super::*;
@@ -114,7 +178,7 @@ mod test {
         panic::AssertUnwindSafe,
         sync::{
             atomic::{AtomicU32, Ordering},
-            Arc,
+            Arc, Mutex,
         },
     };
 
@@ -221,6 +285,42 @@ mod test {
         assert_eq!(world.entities().len(), 2);
     }
 
+    struct BatchCheck(Arc<Mutex<Vec<usize>>>);
+
+    impl Command for BatchCheck {
+        fn write(self, _: &mut World) {
+            self.0.lock().unwrap().push(1);
+        }
+
+        fn write_batch(commands: CommandBatch<'_, Self>, _: &mut World) {
+            let count = commands.len();
+            // unread commands are dropped with the batch
+            let command = commands.take(1).next().unwrap();
+            command.0.lock().unwrap().push(count);
+        }
+    }
+
+    #[test]
+    fn test_command_queue_batches() {
+        let batches = Arc::new(Mutex::new(Vec::new()));
+        let (dropcheck, drops) = DropCheck::new();
+        let mut queue = CommandQueue::default();
+
+        for _ in 0..3 {
+            queue.push(BatchCheck(batches.clone()));
+        }
+        queue.push(dropcheck);
+        queue.push(BatchCheck(batches.clone()));
+
+        let mut world = World::new();
+        queue.apply(&mut world);
+
+        assert_eq!(*batches.lock().unwrap(), vec![3, 1]);
+        assert_eq!(drops.load(Ordering::Relaxed), 1);
+        // every `BatchCheck` was dropped
+        assert_eq!(Arc::strong_count(&batches), 1);
+    }
+
     // NOTE: `CommandQueue` is `Send` because `Command` is send.
     // If the `Command` trait gets reworked to be non-send, `CommandQueue`
     // should be reworked.
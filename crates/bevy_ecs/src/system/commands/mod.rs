@@ -7,12 +7,24 @@ use crate::{
     world::World,
 };
 use bevy_utils::tracing::debug;
-pub use command_queue::CommandQueue;
+pub use command_queue::{CommandBatch, CommandQueue};
 use std::marker::PhantomData;
 
 /// A [`World`] mutation.
 pub trait Command: Send + Sync + 'static {
     fn write(self, world: &mut World);
+
+    /// Writes consecutive commands of this type, in order. Commands that can be applied to many
+    /// entities at once (ex: spawning or inserting the same bundle) override this so that the
+    /// entities are moved together, by default each command is written on its own.
+    fn write_batch(commands: CommandBatch<'_, Self>, world: &mut World)
+    where
+        Self: Sized,
+    {
+        for command in commands {
+            command.write(world);
+        }
+    }
 }
 
 /// A list of commands that will be run to modify a [`World`].
@@ -269,6 +281,12 @@ where
     fn write(self, world: &mut World) {
         world.spawn().insert_bundle(self.bundle);
     }
+
+    fn write_batch(commands: CommandBatch<'_, Self>, world: &mut World) {
+        world
+            .spawn_batch(commands.map(|command| command.bundle))
+            .for_each(drop);
+    }
 }
 
 pub struct SpawnBatch<I>
@@ -314,6 +332,10 @@ where
     fn write(self, world: &mut World) {
         world.entity_mut(self.entity).insert_bundle(self.bundle);
     }
+
+    fn write_batch(commands: CommandBatch<'_, Self>, world: &mut World) {
+        world.insert_bundle_batch(commands.map(|command| (command.entity, command.bundle)));
+    }
 }
 
 #[derive(Debug)]
@@ -329,6 +351,10 @@ where
     fn write(self, world: &mut World) {
         world.entity_mut(self.entity).insert(self.component);
     }
+
+    fn write_batch(commands: CommandBatch<'_, Self>, world: &mut World) {
+        world.insert_bundle_batch(commands.map(|command| (command.entity, (command.component,))));
+    }
 }
 
 #[derive(Debug)]
@@ -346,6 +372,11 @@ where
             entity_mut.remove::<T>();
         }
     }
+
+    fn write_batch(commands: CommandBatch<'_, Self>, world: &mut World) {
+        let entities = existing_entities(world, commands.map(|command| command.entity));
+        world.remove_bundle_batch::<(T,)>(&entities);
+    }
 }
 
 #[derive(Debug)]
@@ -365,6 +396,18 @@ where
             entity_mut.remove_bundle_intersection::<T>();
         }
     }
+
+    fn write_batch(commands: CommandBatch<'_, Self>, world: &mut World) {
+        let entities = existing_entities(world, commands.map(|command| command.entity));
+        world.remove_bundle_batch::<T>(&entities);
+    }
+}
+
+/// Removal commands ignore entities that don't exist anymore
+fn existing_entities(world: &World, entities: impl Iterator<Item = Entity>) -> Vec<Entity> {
+    entities
+        .filter(|entity| world.entities().get(*entity).is_some())
+        .collect()
 }
 
 pub struct InsertResource<T: Component> {
@@ -497,6 +540,40 @@ mod tests {
         assert_eq!(results_after_u64, vec![]);
     }
 
+    #[test]
+    fn batched_commands() {
+        let mut world = World::default();
+        let mut command_queue = CommandQueue::default();
+        let entities = {
+            let mut commands = Commands::new(&mut command_queue, &world);
+            (0..10u32)
+                .map(|i| commands.spawn_bundle((i,)).id())
+                .collect::<Vec<_>>()
+        };
+        command_queue.apply(&mut world);
+        assert_eq!(world.query::<&u32>().iter(&world).count(), 10);
+
+        {
+            let mut commands = Commands::new(&mut command_queue, &world);
+            for (i, entity) in entities.iter().enumerate() {
+                if i % 2 == 0 {
+                    commands.entity(*entity).insert(i as u64);
+                }
+            }
+            commands.entity(entities[1]).despawn();
+            for entity in entities.iter() {
+                commands.entity(*entity).remove::<u32>();
+            }
+        }
+        command_queue.apply(&mut world);
+
+        assert_eq!(world.query::<&u32>().iter(&world).count(), 0);
+        assert_eq!(world.entities().len(), 9);
+        for (i, entity) in entities.iter().enumerate().step_by(2) {
+            assert_eq!(world.get::<u64>(*entity), Some(&(i as u64)));
+        }
+    }
+
     #[test]
     fn remove_resources() {
         let mut world = World::default();
@@ -300,6 +300,10 @@ where
 
     /// Runs `f` on each query result in parallel using the given task pool.
     ///
+    /// Results are processed in batches of `batch_size` entities. Pass
+    /// [`AUTO_BATCH_SIZE`](crate::query::AUTO_BATCH_SIZE) to choose a batch size from the number of
+    /// matched entities and the number of threads in `task_pool`.
+    ///
     /// This can only be called for read-only queries, see [`Self::par_for_each_mut`] for
     /// write-queries.
     #[inline]
@@ -326,6 +330,8 @@ where
     }
 
     /// Runs `f` on each query result in parallel using the given task pool.
+    ///
+    /// See [`Self::par_for_each`] for how `batch_size` is used.
     #[inline]
     pub fn par_for_each_mut(
         &mut self,
@@ -423,6 +423,7 @@ impl<'a, T: Component> SystemParamFetch<'a> for ResMutState<T> {
             value: value.value,
             ticks: Ticks {
                 component_ticks: value.ticks.component_ticks,
+                column_ticks: None,
                 last_change_tick: system_meta.last_change_tick,
                 change_tick,
             },
@@ -463,6 +464,7 @@ impl<'a, T: Component> SystemParamFetch<'a> for OptionResMutState<T> {
                 value: value.value,
                 ticks: Ticks {
                     component_ticks: value.ticks.component_ticks,
+                    column_ticks: None,
                     last_change_tick: system_meta.last_change_tick,
                     change_tick,
                 },
@@ -913,6 +915,7 @@ impl<'a, T: 'static> SystemParamFetch<'a> for NonSendMutState<T> {
             value: &mut *column.get_data_ptr().cast::<T>().as_ptr(),
             ticks: Ticks {
                 component_ticks: &mut *column.get_ticks_mut_ptr_unchecked(0),
+                column_ticks: None,
                 last_change_tick: system_meta.last_change_tick,
                 change_tick,
             },
@@ -954,6 +957,7 @@ impl<'a, T: 'static> SystemParamFetch<'a> for OptionNonSendMutState<T> {
                 value: &mut *column.get_data_ptr().cast::<T>().as_ptr(),
                 ticks: Ticks {
                     component_ticks: &mut *column.get_ticks_mut_ptr_unchecked(0),
+                    column_ticks: None,
                     last_change_tick: system_meta.last_change_tick,
                     change_tick,
                 },
@@ -0,0 +1,373 @@
+use crate::{
+    archetype::{ArchetypeId, Archetypes},
+    bundle::Bundle,
+    component::StorageType,
+    entity::{Entities, Entity},
+    storage::Tables,
+    world::{
+        entity_ref::{add_bundle_to_archetype, remove_bundle_from_archetype},
+        World,
+    },
+};
+
+impl World {
+    /// Inserts a bundle into each of the given entities, like calling [EntityMut::insert_bundle]
+    /// on each of them.
+    ///
+    /// Entities that are in the same archetype are moved to their new archetype together: the
+    /// archetype graph is looked up once and their table rows are moved as one batch instead of
+    /// one entity at a time.
+    ///
+    /// ```
+    /// use bevy_ecs::world::World;
+    ///
+    /// struct Enemy;
+    /// struct Stunned(f32);
+    ///
+    /// let mut world = World::new();
+    /// let enemies = world.spawn_batch((0..100).map(|_| (Enemy,))).collect::<Vec<_>>();
+    /// world.insert_bundle_batch(enemies.iter().map(|enemy| (*enemy, (Stunned(2.0),))));
+    ///
+    /// assert_eq!(world.query::<&Stunned>().iter(&world).count(), 100);
+    /// ```
+    ///
+    /// # Panics
+    /// Panics if one of the entities does not exist.
+    ///
+    /// [EntityMut::insert_bundle]: crate::world::EntityMut::insert_bundle
+    pub fn insert_bundle_batch<I, B>(&mut self, iter: I)
+    where
+        I: IntoIterator<Item = (Entity, B)>,
+        B: Bundle,
+    {
+        self.flush();
+        let change_tick = *self.change_tick.get_mut();
+        let mut batch = self.group_by_archetype(iter);
+        let bundle_info = self.bundles.init_info::<B>(&mut self.components);
+
+        let mut duplicates = Vec::new();
+        while let Some(source) = batch.last().map(|(archetype_id, ..)| *archetype_id) {
+            let start = batch
+                .iter()
+                .rposition(|(archetype_id, ..)| *archetype_id != source)
+                .map_or(0, |index| index + 1);
+            let group = batch.drain(start..);
+
+            // SAFE: the bundle components are registered and the source archetype exists
+            let destination = unsafe {
+                add_bundle_to_archetype(
+                    &mut self.archetypes,
+                    &mut self.storages,
+                    &mut self.components,
+                    source,
+                    bundle_info,
+                )
+            };
+            let bundle_status = self.archetypes[source]
+                .edges()
+                .get_add_bundle(bundle_info.id())
+                .unwrap()
+                .bundle_status
+                .clone();
+
+            let mut group = sort_by_table_row(&self.entities, &self.archetypes, group);
+            let mut index = 1;
+            // an entity can be in a batch more than once, its later bundles are inserted after
+            // the move
+            while index < group.len() {
+                if group[index].1 == group[index - 1].1 {
+                    let (_, entity, bundle) = group.remove(index);
+                    duplicates.push((entity, bundle));
+                } else {
+                    index += 1;
+                }
+            }
+            if source != destination {
+                let moves = group
+                    .iter()
+                    .map(|(row, entity, _)| (*row, *entity))
+                    .collect::<Vec<_>>();
+                // SAFE: the entities are in `source` and the new components are written below
+                unsafe {
+                    move_entities_unchecked(
+                        &mut self.entities,
+                        &mut self.archetypes,
+                        &mut self.storages.tables,
+                        source,
+                        destination,
+                        &moves,
+                        change_tick,
+                    );
+                }
+            }
+
+            let archetype = &self.archetypes[destination];
+            let table = &mut self.storages.tables[archetype.table_id()];
+            for (_, entity, bundle) in group {
+                let location = self.entities.meta[entity.id as usize].location;
+                let table_row = archetype.entity_table_row(location.index);
+                // SAFE: the entity was moved to an archetype that has every bundle component
+                unsafe {
+                    bundle_info.write_components(
+                        &mut self.storages.sparse_sets,
+                        entity,
+                        table,
+                        table_row,
+                        &bundle_status,
+                        bundle,
+                        change_tick,
+                    );
+                }
+            }
+        }
+
+        for (entity, bundle) in duplicates {
+            self.entity_mut(entity).insert_bundle(bundle);
+        }
+    }
+
+    /// Removes the components of a bundle from each of the given entities and drops them, like
+    /// calling [EntityMut::remove_bundle_intersection] on each of them. Entities that are in the
+    /// same archetype are moved together, see [World::insert_bundle_batch].
+    ///
+    /// # Panics
+    /// Panics if one of the entities does not exist.
+    ///
+    /// [EntityMut::remove_bundle_intersection]: crate::world::EntityMut::remove_bundle_intersection
+    pub fn remove_bundle_batch<B: Bundle>(&mut self, entities: &[Entity]) {
+        self.flush();
+        let change_tick = *self.change_tick.get_mut();
+        let mut batch = self.group_by_archetype(entities.iter().map(|entity| (*entity, ())));
+        let bundle_info = self.bundles.init_info::<B>(&mut self.components);
+
+        while let Some(source) = batch.last().map(|(archetype_id, ..)| *archetype_id) {
+            let start = batch
+                .iter()
+                .rposition(|(archetype_id, ..)| *archetype_id != source)
+                .map_or(0, |index| index + 1);
+            let group = batch.drain(start..);
+
+            // SAFE: the bundle components are registered and the source archetype exists
+            let destination = unsafe {
+                remove_bundle_from_archetype(
+                    &mut self.archetypes,
+                    &mut self.storages,
+                    &mut self.components,
+                    source,
+                    bundle_info,
+                    true,
+                )
+                .expect("intersections should always return a result")
+            };
+            if source == destination {
+                continue;
+            }
+
+            let mut moves = sort_by_table_row(&self.entities, &self.archetypes, group)
+                .into_iter()
+                .map(|(row, entity, _)| (row, entity))
+                .collect::<Vec<_>>();
+            moves.dedup();
+
+            let old_archetype = &self.archetypes[source];
+            for component_id in bundle_info.components().iter().cloned() {
+                if !old_archetype.contains(component_id) {
+                    continue;
+                }
+                let removed_components = self
+                    .removed_components
+                    .get_or_insert_with(component_id, Vec::new);
+                removed_components.extend(moves.iter().map(|(_, entity)| *entity));
+
+                // table components are dropped by the move
+                if let Some(StorageType::SparseSet) = old_archetype.get_storage_type(component_id) {
+                    let sparse_set = self.storages.sparse_sets.get_mut(component_id).unwrap();
+                    for (_, entity) in moves.iter() {
+                        sparse_set.remove(*entity);
+                    }
+                }
+            }
+
+            // SAFE: the entities are in `source` and `destination` is a subset of it
+            unsafe {
+                move_entities_unchecked(
+                    &mut self.entities,
+                    &mut self.archetypes,
+                    &mut self.storages.tables,
+                    source,
+                    destination,
+                    &moves,
+                    change_tick,
+                );
+            }
+        }
+    }
+
+    /// Pairs each item with the archetype of its entity, sorted by archetype
+    fn group_by_archetype<T>(
+        &self,
+        iter: impl IntoIterator<Item = (Entity, T)>,
+    ) -> Vec<(ArchetypeId, Entity, T)> {
+        let mut batch = iter
+            .into_iter()
+            .map(|(entity, value)| {
+                let location = self
+                    .entities
+                    .get(entity)
+                    .unwrap_or_else(|| panic!("Entity {:?} does not exist", entity));
+                (location.archetype_id, entity, value)
+            })
+            .collect::<Vec<_>>();
+        // stable, so repeated entities stay in order
+        batch.sort_by_key(|(archetype_id, ..)| archetype_id.index());
+        batch
+    }
+}
+
+/// Pairs each entity of an archetype with its current table row, sorted by row
+fn sort_by_table_row<T>(
+    entities: &Entities,
+    archetypes: &Archetypes,
+    group: impl Iterator<Item = (ArchetypeId, Entity, T)>,
+) -> Vec<(usize, Entity, T)> {
+    let mut group = group
+        .map(|(archetype_id, entity, value)| {
+            let location = entities.meta[entity.id as usize].location;
+            let row = archetypes[archetype_id].entity_table_row(location.index);
+            (row, entity, value)
+        })
+        .collect::<Vec<_>>();
+    group.sort_by_key(|(row, ..)| *row);
+    group
+}
+
+/// Moves entities from the `source` archetype to `destination` and updates their locations.
+/// Their table rows are moved together, values of table components `destination` doesn't have
+/// are dropped.
+///
+/// # Safety
+/// `moves` must be the unique entities of `source` with their table rows, sorted by row. Table
+/// components that `destination` has and `source` doesn't must be written immediately.
+unsafe fn move_entities_unchecked(
+    entities: &mut Entities,
+    archetypes: &mut Archetypes,
+    tables: &mut Tables,
+    source: ArchetypeId,
+    destination: ArchetypeId,
+    moves: &[(usize, Entity)],
+    change_tick: u32,
+) {
+    let old_archetype = &mut archetypes[source];
+    let old_table_id = old_archetype.table_id();
+    for (_, entity) in moves {
+        let location = entities.meta[entity.id as usize].location;
+        let result = old_archetype.swap_remove(location.index);
+        if let Some(swapped_entity) = result.swapped_entity {
+            entities.meta[swapped_entity.id as usize].location = location;
+        }
+    }
+
+    let new_archetype = &mut archetypes[destination];
+    let new_table_id = new_archetype.table_id();
+    new_archetype.reserve(moves.len());
+    if old_table_id == new_table_id {
+        for (table_row, entity) in moves {
+            entities.meta[entity.id as usize].location =
+                new_archetype.allocate(*entity, *table_row);
+        }
+        return;
+    }
+
+    let rows = moves.iter().map(|(row, _)| *row).collect::<Vec<_>>();
+    let (old_table, new_table) = tables.get_2_mut(old_table_id, new_table_id);
+    let result = old_table.move_rows_and_drop_missing_unchecked(&rows, new_table, change_tick);
+    for (i, (_, entity)) in moves.iter().enumerate() {
+        entities.meta[entity.id as usize].location =
+            new_archetype.allocate(*entity, result.new_row + i);
+    }
+    // entities of the old table that were swapped into a moved row
+    for (swapped_entity, table_row) in result.swapped_entities {
+        let location = entities.meta[swapped_entity.id as usize].location;
+        archetypes[location.archetype_id].set_entity_table_row(location.index, table_row);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::{
+        component::{ComponentDescriptor, StorageType},
+        world::World,
+    };
+
+    #[derive(Debug, PartialEq)]
+    struct Stunned(u32);
+    #[derive(Debug, PartialEq)]
+    struct Sparse(u32);
+
+    #[test]
+    fn insert_bundle_batch() {
+        let mut world = World::new();
+        world
+            .register_component(ComponentDescriptor::new::<Sparse>(StorageType::SparseSet))
+            .unwrap();
+        let a = world
+            .spawn_batch((0..8u32).map(|i| (i,)))
+            .collect::<Vec<_>>();
+        let b = world
+            .spawn_batch((0..4u32).map(|i| (i + 100, "b")))
+            .collect::<Vec<_>>();
+
+        // every other entity of `a` leaves its table, `b` already has some of the components
+        let mut batch = a
+            .iter()
+            .step_by(2)
+            .map(|entity| (*entity, (Stunned(1), Sparse(1))))
+            .collect::<Vec<_>>();
+        batch.push((b[0], (Stunned(2), Sparse(2))));
+        batch.push((a[0], (Stunned(3), Sparse(3))));
+        world.insert_bundle_batch(batch);
+        world.insert_bundle_batch(b.iter().map(|entity| (*entity, (Stunned(4),))));
+
+        for (i, entity) in a.iter().enumerate() {
+            let entity = world.entity(*entity);
+            assert_eq!(entity.get::<u32>(), Some(&(i as u32)));
+            let expected = match i {
+                0 => Some(3),
+                i if i % 2 == 0 => Some(1),
+                _ => None,
+            };
+            assert_eq!(entity.get::<Stunned>().map(|stunned| stunned.0), expected);
+            assert_eq!(entity.get::<Sparse>().map(|sparse| sparse.0), expected);
+        }
+        for (i, entity) in b.iter().enumerate() {
+            let entity = world.entity(*entity);
+            assert_eq!(entity.get::<u32>(), Some(&(i as u32 + 100)));
+            assert_eq!(entity.get::<&str>(), Some(&"b"));
+            assert_eq!(entity.get::<Stunned>(), Some(&Stunned(4)));
+        }
+        assert_eq!(world.query::<&Sparse>().iter(&world).count(), 5);
+    }
+
+    #[test]
+    fn remove_bundle_batch() {
+        let mut world = World::new();
+        world
+            .register_component(ComponentDescriptor::new::<Sparse>(StorageType::SparseSet))
+            .unwrap();
+        let entities = world
+            .spawn_batch((0..6u32).map(|i| (i, Stunned(i), Sparse(i))))
+            .collect::<Vec<_>>();
+
+        world.remove_bundle_batch::<(Stunned, Sparse)>(&entities[1..4]);
+        world.remove_bundle_batch::<(Stunned, Sparse)>(&entities[2..3]);
+
+        for (i, entity) in entities.iter().enumerate() {
+            let entity = world.entity(*entity);
+            let removed = (1..4).contains(&i);
+            assert_eq!(entity.get::<u32>(), Some(&(i as u32)));
+            assert_eq!(entity.contains::<Stunned>(), !removed);
+            assert_eq!(entity.contains::<Sparse>(), !removed);
+        }
+        assert_eq!(world.removed::<Stunned>().count(), 3);
+    }
+}
@@ -0,0 +1,300 @@
+use crate::{
+    archetype::ArchetypeId,
+    component::{Component, ComponentId, ComponentTicks, StorageType},
+    entity::Entity,
+    storage::BlobVec,
+    world::World,
+};
+use std::any::TypeId;
+
+struct BatchColumn {
+    component_id: ComponentId,
+    type_id: TypeId,
+    values: BlobVec,
+}
+
+/// Type erased component values for a batch of entities that all have the same components.
+///
+/// Unlike [World::spawn_batch], the components don't have to be known at compile time (ex: when
+/// they come from reflection). Values are pushed one component type at a time, the `n`th value
+/// of every component belongs to the `n`th entity. The batch is spawned with
+/// [World::spawn_component_batch].
+#[derive(Default)]
+pub struct ComponentBatch {
+    columns: Vec<BatchColumn>,
+}
+
+impl ComponentBatch {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Adds a component value for the next entity that doesn't have a `T` yet
+    pub fn push<T: Component>(&mut self, world: &mut World, mut value: T) {
+        let type_id = TypeId::of::<T>();
+        let index = match self
+            .columns
+            .iter()
+            .position(|column| column.type_id == type_id)
+        {
+            Some(index) => index,
+            None => {
+                let component_info = world.components.get_or_insert_info::<T>();
+                self.columns.push(BatchColumn {
+                    component_id: component_info.id(),
+                    type_id,
+                    values: BlobVec::new(component_info.layout(), component_info.drop(), 0),
+                });
+                self.columns.len() - 1
+            }
+        };
+        let values = &mut self.columns[index].values;
+        // BlobVec only grows by what is asked for
+        if values.len() == values.capacity() {
+            values.reserve_exact(values.capacity().max(4));
+        }
+        // SAFE: the column stores values of type T, the value is moved into it and forgotten
+        unsafe {
+            let row = values.push_uninit();
+            values.initialize_unchecked(row, (&mut value as *mut T).cast::<u8>());
+        }
+        std::mem::forget(value);
+    }
+
+    /// The number of entities in the batch
+    pub fn len(&self) -> usize {
+        self.columns
+            .iter()
+            .map(|column| column.values.len())
+            .max()
+            .unwrap_or(0)
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+impl World {
+    /// Spawns the entities of a [ComponentBatch] and returns them in batch order.
+    ///
+    /// The archetype and table of the batch's components are looked up once and every entity is
+    /// written into them directly, instead of moving each entity through an archetype per
+    /// inserted component.
+    ///
+    /// # Panics
+    /// Panics if the components of the batch don't all have a value for every entity.
+    pub fn spawn_component_batch(&mut self, batch: ComponentBatch) -> Vec<Entity> {
+        self.flush();
+        let len = batch.len();
+        self.entities.reserve(len as u32);
+        let entities = (0..len).map(|_| self.entities.alloc()).collect::<Vec<_>>();
+        // SAFE: the entities were just allocated, they aren't in an archetype yet
+        unsafe { self.write_component_batch(&entities, batch) };
+        entities
+    }
+
+    /// Inserts the components of a [ComponentBatch] into existing entities that don't have any
+    /// components yet (ex: entities spawned up front so other components can refer to them). The
+    /// `n`th entity gets the `n`th value of every component, like
+    /// [World::spawn_component_batch].
+    ///
+    /// # Panics
+    /// Panics if an entity doesn't exist, has components or appears twice, or if the batch
+    /// doesn't have a value of every component for each entity.
+    pub fn insert_component_batch(&mut self, entities: &[Entity], batch: ComponentBatch) {
+        self.flush();
+        assert_eq!(
+            entities.len(),
+            batch.len(),
+            "a batch needs a value for each entity"
+        );
+        for &entity in entities {
+            let location = self.entities.get(entity).expect("entity should exist");
+            let archetype = self.archetypes.empty_mut();
+            assert!(
+                location.archetype_id == ArchetypeId::empty()
+                    && archetype.entities().get(location.index) == Some(&entity),
+                "batch entities can't have components and can't appear twice"
+            );
+            let remove_result = archetype.swap_remove(location.index);
+            if let Some(swapped_entity) = remove_result.swapped_entity {
+                self.entities.meta[swapped_entity.id() as usize].location = location;
+            }
+            // SAFE: table rows stored in archetypes always exist
+            let moved_entity = unsafe {
+                self.storages.tables[archetype.table_id()]
+                    .swap_remove_unchecked(remove_result.table_row)
+            };
+            if let Some(moved_entity) = moved_entity {
+                let moved_location = self.entities.get(moved_entity).unwrap();
+                self.archetypes[moved_location.archetype_id]
+                    .set_entity_table_row(moved_location.index, remove_result.table_row);
+            }
+        }
+        // SAFE: the entities were removed from the empty archetype above
+        unsafe { self.write_component_batch(entities, batch) };
+    }
+
+    /// Writes the components of `batch` for `entities` into their archetype and table, and
+    /// points the entities there.
+    ///
+    /// # Safety
+    /// The entities must be allocated and not stored in any archetype
+    unsafe fn write_component_batch(&mut self, entities: &[Entity], mut batch: ComponentBatch) {
+        let len = entities.len();
+        assert!(
+            batch
+                .columns
+                .iter()
+                .all(|column| column.values.len() == len),
+            "every component of a batch needs a value for each entity"
+        );
+
+        // archetype and table identities use sorted component ids
+        batch.columns.sort_by_key(|column| column.component_id);
+        let mut table_components = Vec::new();
+        let mut sparse_set_components = Vec::new();
+        for column in batch.columns.iter() {
+            // SAFE: the component was registered when the column was created
+            let component_info = self.components.get_info_unchecked(column.component_id);
+            match component_info.storage_type() {
+                StorageType::Table => table_components.push(column.component_id),
+                StorageType::SparseSet => {
+                    self.storages.sparse_sets.get_or_insert(component_info);
+                    sparse_set_components.push(column.component_id);
+                }
+            }
+        }
+        // SAFE: the components exist
+        let table_id = self
+            .storages
+            .tables
+            .get_id_or_insert(&table_components, &self.components);
+        let archetype_id =
+            self.archetypes
+                .get_id_or_insert(table_id, table_components, sparse_set_components);
+
+        let archetype = self.archetypes.get_mut(archetype_id).unwrap();
+        let table = &mut self.storages.tables[table_id];
+        let sparse_sets = &mut self.storages.sparse_sets;
+        archetype.reserve(len);
+        table.reserve(len);
+        let change_tick = *self.change_tick.get_mut();
+
+        for (row, &entity) in entities.iter().enumerate() {
+            // every component of the archetype is written below, values are moved out of the
+            // batch columns, which forget them afterwards
+            let table_row = table.allocate(entity);
+            let location = archetype.allocate(entity, table_row);
+            for column in batch.columns.iter() {
+                let value = column.values.get_unchecked(row);
+                match table.get_column_mut(column.component_id) {
+                    Some(table_column) => table_column.initialize(
+                        table_row,
+                        value,
+                        ComponentTicks::new(change_tick),
+                        change_tick,
+                    ),
+                    None => sparse_sets.get_mut(column.component_id).unwrap().insert(
+                        entity,
+                        value,
+                        change_tick,
+                    ),
+                }
+            }
+            self.entities.meta[entity.id() as usize].location = location;
+        }
+
+        for column in batch.columns.iter_mut() {
+            // the values were moved into the world
+            column.values.set_len(0);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::component::ComponentDescriptor;
+
+    #[derive(Debug, PartialEq)]
+    struct Sparse(u32);
+
+    #[test]
+    fn spawn_component_batch() {
+        let mut world = World::new();
+        world
+            .register_component(ComponentDescriptor::new::<Sparse>(StorageType::SparseSet))
+            .unwrap();
+        world.spawn().insert_bundle((1u32, "existing"));
+
+        let mut batch = ComponentBatch::new();
+        for i in 0..3u32 {
+            batch.push(&mut world, i);
+            batch.push(&mut world, Sparse(i * 10));
+            batch.push(&mut world, format!("entity {}", i));
+        }
+        assert_eq!(batch.len(), 3);
+        let entities = world.spawn_component_batch(batch);
+
+        assert_eq!(entities.len(), 3);
+        for (i, entity) in entities.iter().enumerate() {
+            let entity = world.entity(*entity);
+            assert_eq!(entity.get::<u32>(), Some(&(i as u32)));
+            assert_eq!(entity.get::<Sparse>(), Some(&Sparse(i as u32 * 10)));
+            assert_eq!(entity.get::<String>(), Some(&format!("entity {}", i)));
+        }
+        let mut query = world.query::<(&u32, &String)>();
+        assert_eq!(query.iter(&world).count(), 3);
+    }
+
+    #[test]
+    fn insert_component_batch_into_empty_entities() {
+        let mut world = World::new();
+        let empty = world.spawn().id();
+        let entities = (0..3).map(|_| world.spawn().id()).collect::<Vec<_>>();
+        let reserved = world.entities().reserve_entity();
+
+        let mut batch = ComponentBatch::new();
+        for i in 0..3u32 {
+            batch.push(&mut world, i);
+            batch.push(&mut world, Sparse(i * 10));
+        }
+        // out of spawn order, so entities are swapped around in the empty archetype
+        world.insert_component_batch(&[entities[2], entities[0], reserved], batch);
+
+        assert_eq!(world.get::<u32>(entities[2]), Some(&0));
+        assert_eq!(world.get::<u32>(entities[0]), Some(&1));
+        assert_eq!(world.get::<Sparse>(reserved), Some(&Sparse(20)));
+        assert!(world.get::<u32>(entities[1]).is_none());
+        let mut batch = ComponentBatch::new();
+        batch.push(&mut world, 7u32);
+        batch.push(&mut world, 8u32);
+        world.insert_component_batch(&[entities[1], empty], batch);
+        assert_eq!(world.get::<u32>(entities[1]), Some(&7));
+        assert_eq!(world.get::<u32>(empty), Some(&8));
+        assert_eq!(world.archetypes().empty().len(), 0);
+    }
+
+    #[test]
+    #[should_panic]
+    fn insert_component_batch_into_entity_with_components() {
+        let mut world = World::new();
+        let entity = world.spawn().insert(1u32).id();
+        let mut batch = ComponentBatch::new();
+        batch.push(&mut world, 2u32);
+        world.insert_component_batch(&[entity], batch);
+    }
+
+    #[test]
+    #[should_panic]
+    fn spawn_incomplete_component_batch() {
+        let mut world = World::new();
+        let mut batch = ComponentBatch::new();
+        batch.push(&mut world, 1u32);
+        batch.push(&mut world, 2u32);
+        batch.push(&mut world, "only one");
+        world.spawn_component_batch(batch);
+    }
+}
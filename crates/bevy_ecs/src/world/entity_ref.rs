@@ -4,10 +4,10 @@ use crate::{
     change_detection::Ticks,
     component::{Component, ComponentId, ComponentTicks, Components, StorageType},
     entity::{Entities, Entity, EntityLocation},
-    storage::{SparseSet, Storages},
+    storage::{ColumnTicks, SparseSet, Storages},
     world::{Mut, World},
 };
-use std::any::TypeId;
+use std::{any::TypeId, ptr};
 
 pub struct EntityRef<'w> {
     world: &'w World,
@@ -79,10 +79,11 @@ impl<'w> EntityRef<'w> {
         change_tick: u32,
     ) -> Option<Mut<'w, T>> {
         get_component_and_ticks_with_type(self.world, TypeId::of::<T>(), self.entity, self.location)
-            .map(|(value, ticks)| Mut {
+            .map(|(value, ticks, column_ticks)| Mut {
                 value: &mut *value.cast::<T>(),
                 ticks: Ticks {
                     component_ticks: &mut *ticks,
+                    column_ticks: column_ticks.as_ref(),
                     last_change_tick,
                     change_tick,
                 },
@@ -162,10 +163,11 @@ impl<'w> EntityMut<'w> {
                 self.entity,
                 self.location,
             )
-            .map(|(value, ticks)| Mut {
+            .map(|(value, ticks, column_ticks)| Mut {
                 value: &mut *value.cast::<T>(),
                 ticks: Ticks {
                     component_ticks: &mut *ticks,
+                    column_ticks: column_ticks.as_ref(),
                     last_change_tick: self.world.last_change_tick(),
                     change_tick: self.world.change_tick(),
                 },
@@ -179,10 +181,11 @@ impl<'w> EntityMut<'w> {
     #[inline]
     pub unsafe fn get_unchecked_mut<T: Component>(&self) -> Option<Mut<'w, T>> {
         get_component_and_ticks_with_type(self.world, TypeId::of::<T>(), self.entity, self.location)
-            .map(|(value, ticks)| Mut {
+            .map(|(value, ticks, column_ticks)| Mut {
                 value: &mut *value.cast::<T>(),
                 ticks: Ticks {
                     component_ticks: &mut *ticks,
+                    column_ticks: column_ticks.as_ref(),
                     last_change_tick: self.world.last_change_tick(),
                     change_tick: self.world.read_change_tick(),
                 },
@@ -200,6 +203,7 @@ impl<'w> EntityMut<'w> {
             bundle_info: &BundleInfo,
             current_location: EntityLocation,
             entity: Entity,
+            change_tick: u32,
         ) -> (&'a Archetype, &'a Vec<ComponentStatus>, EntityLocation) {
             // SAFE: component ids in `bundle_info` and self.location are valid
             let new_archetype_id = add_bundle_to_archetype(
@@ -233,7 +237,7 @@ impl<'w> EntityMut<'w> {
                     // PERF: store "non bundle" components in edge, then just move those to avoid
                     // redundant copies
                     let move_result =
-                        old_table.move_to_superset_unchecked(old_table_row, new_table);
+                        old_table.move_to_superset_unchecked(old_table_row, new_table, change_tick);
 
                     let new_location =
                         archetypes[new_archetype_id].allocate(entity, move_result.new_row);
@@ -274,6 +278,7 @@ impl<'w> EntityMut<'w> {
                 bundle_info,
                 self.location,
                 self.entity,
+                change_tick,
             )
         };
         self.location = new_location;
@@ -296,6 +301,7 @@ impl<'w> EntityMut<'w> {
     }
 
     pub fn remove_bundle<T: Bundle>(&mut self) -> Option<T> {
+        let change_tick = self.world.change_tick();
         let archetypes = &mut self.world.archetypes;
         let storages = &mut self.world.storages;
         let components = &mut self.world.components;
@@ -357,8 +363,13 @@ impl<'w> EntityMut<'w> {
 
             // SAFE: table_row exists. All "missing" components have been extracted into the bundle
             // above and the caller takes ownership
-            let move_result =
-                unsafe { old_table.move_to_and_forget_missing_unchecked(old_table_row, new_table) };
+            let move_result = unsafe {
+                old_table.move_to_and_forget_missing_unchecked(
+                    old_table_row,
+                    new_table,
+                    change_tick,
+                )
+            };
 
             // SAFE: new_table_row is a valid position in new_archetype's table
             let new_location = unsafe { new_archetype.allocate(entity, move_result.new_row) };
@@ -381,6 +392,7 @@ impl<'w> EntityMut<'w> {
 
     /// Remove any components in the bundle that the entity has.
     pub fn remove_bundle_intersection<T: Bundle>(&mut self) {
+        let change_tick = self.world.change_tick();
         let archetypes = &mut self.world.archetypes;
         let storages = &mut self.world.storages;
         let components = &mut self.world.components;
@@ -441,8 +453,9 @@ impl<'w> EntityMut<'w> {
                 .get_2_mut(old_table_id, new_archetype.table_id());
 
             // SAFE: table_row exists
-            let move_result =
-                unsafe { old_table.move_to_and_drop_missing_unchecked(old_table_row, new_table) };
+            let move_result = unsafe {
+                old_table.move_to_and_drop_missing_unchecked(old_table_row, new_table, change_tick)
+            };
 
             // SAFE: new_table_row is a valid position in new_archetype's table
             let new_location = unsafe { new_archetype.allocate(entity, move_result.new_row) };
@@ -568,7 +581,7 @@ unsafe fn get_component_and_ticks(
     component_id: ComponentId,
     entity: Entity,
     location: EntityLocation,
-) -> Option<(*mut u8, *mut ComponentTicks)> {
+) -> Option<(*mut u8, *mut ComponentTicks, *const ColumnTicks)> {
     let archetype = &world.archetypes[location.archetype_id];
     let component_info = world.components.get_info_unchecked(component_id);
     match component_info.storage_type() {
@@ -580,13 +593,15 @@ unsafe fn get_component_and_ticks(
             Some((
                 components.get_data_unchecked(table_row),
                 components.get_ticks_mut_ptr_unchecked(table_row),
+                components.column_ticks() as *const ColumnTicks,
             ))
         }
         StorageType::SparseSet => world
             .storages
             .sparse_sets
             .get(component_id)
-            .and_then(|sparse_set| sparse_set.get_with_ticks(entity)),
+            .and_then(|sparse_set| sparse_set.get_with_ticks(entity))
+            .map(|(value, ticks)| (value, ticks, ptr::null())),
     }
 }
 
@@ -650,7 +665,7 @@ pub(crate) unsafe fn get_component_and_ticks_with_type(
     type_id: TypeId,
     entity: Entity,
     location: EntityLocation,
-) -> Option<(*mut u8, *mut ComponentTicks)> {
+) -> Option<(*mut u8, *mut ComponentTicks, *const ColumnTicks)> {
     let component_id = world.components.get_id(type_id)?;
     get_component_and_ticks(world, component_id, entity, location)
 }
@@ -769,7 +784,7 @@ pub(crate) unsafe fn add_bundle_to_archetype(
 ///
 /// # Safety
 /// `archetype_id` must exist and components in `bundle_info` must exist
-unsafe fn remove_bundle_from_archetype(
+pub(crate) unsafe fn remove_bundle_from_archetype(
     archetypes: &mut Archetypes,
     storages: &mut Storages,
     components: &mut Components,
@@ -1,8 +1,11 @@
+mod bulk_move;
+mod component_batch;
 mod entity_ref;
 mod pointer;
 mod spawn_batch;
 mod world_cell;
 
+pub use component_batch::*;
 pub use entity_ref::*;
 pub use pointer::*;
 pub use spawn_batch::*;
@@ -713,6 +716,7 @@ impl World {
             value: unsafe { &mut *ptr.cast::<T>() },
             ticks: Ticks {
                 component_ticks: &mut ticks,
+                column_ticks: None,
                 last_change_tick: self.last_change_tick(),
                 change_tick: self.change_tick(),
             },
@@ -754,6 +758,7 @@ impl World {
             value: &mut *column.get_data_ptr().cast::<T>().as_ptr(),
             ticks: Ticks {
                 component_ticks: &mut *column.get_ticks_mut_ptr_unchecked(0),
+                column_ticks: None,
                 last_change_tick: self.last_change_tick(),
                 change_tick: self.read_change_tick(),
             },
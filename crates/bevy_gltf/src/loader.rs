@@ -1,6 +1,6 @@
 use anyhow::Result;
 use bevy_asset::{
-    AssetIoError, AssetLoader, AssetPath, BoxedFuture, Handle, LoadContext, LoadedAsset,
+    AssetBytes, AssetIoError, AssetLoader, AssetPath, BoxedFuture, Handle, LoadContext, LoadedAsset,
 };
 use bevy_core::Name;
 use bevy_ecs::world::World;
@@ -104,77 +104,23 @@ async fn load_gltf<'a, 'b>(
         }
     }
 
+    // decode textures and convert primitives to meshes in parallel, they only depend on the
+    // buffers
+    let (primitive_meshes, textures) =
+        decode_meshes_and_textures(&gltf, &buffer_data, &linear_textures, load_context).await;
+
+    let mut primitive_meshes = primitive_meshes.into_iter();
     let mut meshes = vec![];
     let mut named_meshes = HashMap::new();
     for mesh in gltf.meshes() {
         let mut primitives = vec![];
         for primitive in mesh.primitives() {
             let primitive_label = primitive_label(&mesh, &primitive);
-            let reader = primitive.reader(|buffer| Some(&buffer_data[buffer.index()]));
-            let primitive_topology = get_primitive_topology(primitive.mode())?;
-
-            let mut mesh = Mesh::new(primitive_topology);
-
-            if let Some(vertex_attribute) = reader
-                .read_positions()
-                .map(|v| VertexAttributeValues::Float32x3(v.collect()))
-            {
-                mesh.set_attribute(Mesh::ATTRIBUTE_POSITION, vertex_attribute);
-            }
-
-            if let Some(vertex_attribute) = reader
-                .read_normals()
-                .map(|v| VertexAttributeValues::Float32x3(v.collect()))
-            {
-                mesh.set_attribute(Mesh::ATTRIBUTE_NORMAL, vertex_attribute);
-            }
-
-            if let Some(vertex_attribute) = reader
-                .read_tangents()
-                .map(|v| VertexAttributeValues::Float32x4(v.collect()))
-            {
-                mesh.set_attribute(Mesh::ATTRIBUTE_TANGENT, vertex_attribute);
-            }
-
-            if let Some(vertex_attribute) = reader
-                .read_tex_coords(0)
-                .map(|v| VertexAttributeValues::Float32x2(v.into_f32().collect()))
-            {
-                mesh.set_attribute(Mesh::ATTRIBUTE_UV_0, vertex_attribute);
-            } else {
-                let len = mesh.count_vertices();
-                let uvs = vec![[0.0, 0.0]; len];
-                bevy_log::debug!("missing `TEXCOORD_0` vertex attribute, loading zeroed out UVs");
-                mesh.set_attribute(Mesh::ATTRIBUTE_UV_0, uvs);
-            }
-
-            if let Some(vertex_attribute) = reader
-                .read_colors(0)
-                .map(|v| VertexAttributeValues::Float32x4(v.into_rgba_f32().collect()))
-            {
-                mesh.set_attribute(Mesh::ATTRIBUTE_COLOR, vertex_attribute);
-            }
-
-            if let Some(indices) = reader.read_indices() {
-                mesh.set_indices(Some(Indices::U32(indices.into_u32().collect())));
-            };
-
-            if mesh.attribute(Mesh::ATTRIBUTE_NORMAL).is_none() {
-                let vertex_count_before = mesh.count_vertices();
-                mesh.duplicate_vertices();
-                mesh.compute_flat_normals();
-                let vertex_count_after = mesh.count_vertices();
-
-                if vertex_count_before != vertex_count_after {
-                    bevy_log::debug!("Missing vertex normals in indexed geometry, computing them as flat. Vertex count increased from {} to {}", vertex_count_before, vertex_count_after);
-                } else {
-                    bevy_log::debug!(
-                        "Missing vertex normals in indexed geometry, computing them as flat."
-                    );
-                }
-            }
-
-            let mesh = load_context.set_labeled_asset(&primitive_label, LoadedAsset::new(mesh));
+            let primitive_mesh = primitive_meshes
+                .next()
+                .expect("a mesh is decoded for every primitive")?;
+            let mesh =
+                load_context.set_labeled_asset(&primitive_label, LoadedAsset::new(primitive_mesh));
             primitives.push(super::GltfPrimitive {
                 mesh,
                 material: primitive
@@ -193,6 +139,15 @@ async fn load_gltf<'a, 'b>(
         meshes.push(handle);
     }
 
+    for texture in textures {
+        match texture {
+            Ok((texture, label)) => {
+                load_context.set_labeled_asset(&label, LoadedAsset::new(texture));
+            }
+            Err(err) => warn!("Error loading GLTF texture: {}", err),
+        }
+    }
+
     let mut nodes_intermediate = vec![];
     let mut named_nodes_intermediate = HashMap::new();
     for node in gltf.nodes() {
@@ -241,38 +196,6 @@ async fn load_gltf<'a, 'b>(
         })
         .collect();
 
-    // TODO: use the threaded impl on wasm once wasm thread pool doesn't deadlock on it
-    #[cfg(target_arch = "wasm32")]
-    for gltf_texture in gltf.textures() {
-        let (texture, label) =
-            load_texture(gltf_texture, &buffer_data, &linear_textures, &load_context).await?;
-        load_context.set_labeled_asset(&label, LoadedAsset::new(texture));
-    }
-
-    #[cfg(not(target_arch = "wasm32"))]
-    load_context
-        .task_pool()
-        .scope(|scope| {
-            gltf.textures().for_each(|gltf_texture| {
-                let linear_textures = &linear_textures;
-                let load_context: &LoadContext = load_context;
-                let buffer_data = &buffer_data;
-                scope.spawn(async move {
-                    load_texture(gltf_texture, buffer_data, linear_textures, load_context).await
-                });
-            });
-        })
-        .into_iter()
-        .filter_map(|res| {
-            if let Err(err) = res.as_ref() {
-                warn!("Error loading GLTF texture: {}", err);
-            }
-            res.ok()
-        })
-        .for_each(|(texture, label)| {
-            load_context.set_labeled_asset(&label, LoadedAsset::new(texture));
-        });
-
     let mut scenes = vec![];
     let mut named_scenes = HashMap::new();
     for scene in gltf.scenes() {
@@ -320,9 +243,143 @@ async fn load_gltf<'a, 'b>(
     Ok(())
 }
 
+/// The results of [`decode_meshes_and_textures`]: a mesh for every primitive of every mesh, in
+/// order, and the decoded textures
+type DecodedData = (
+    Vec<Result<Mesh, GltfError>>,
+    Vec<Result<(Texture, String), GltfError>>,
+);
+
+/// The work spawned by [`decode_meshes_and_textures`]
+#[cfg(not(target_arch = "wasm32"))]
+enum DecodeResult {
+    Mesh(Result<Mesh, GltfError>),
+    Texture(Result<(Texture, String), GltfError>),
+}
+
+async fn decode_meshes_and_textures(
+    gltf: &gltf::Gltf,
+    buffer_data: &[AssetBytes],
+    linear_textures: &HashSet<usize>,
+    load_context: &LoadContext<'_>,
+) -> DecodedData {
+    let primitives = || gltf.meshes().flat_map(|mesh| mesh.primitives());
+
+    // TODO: use the threaded impl on wasm once wasm thread pool doesn't deadlock on it
+    #[cfg(target_arch = "wasm32")]
+    {
+        let meshes = primitives()
+            .map(|primitive| load_primitive(&primitive, buffer_data))
+            .collect();
+        let mut textures = Vec::new();
+        for gltf_texture in gltf.textures() {
+            textures
+                .push(load_texture(gltf_texture, buffer_data, linear_textures, load_context).await);
+        }
+        (meshes, textures)
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    {
+        let results = load_context.task_pool().scope(|scope| {
+            // textures are spawned first as decoding them usually takes the longest
+            for gltf_texture in gltf.textures() {
+                scope.spawn(async move {
+                    DecodeResult::Texture(
+                        load_texture(gltf_texture, buffer_data, linear_textures, load_context)
+                            .await,
+                    )
+                });
+            }
+            for primitive in primitives() {
+                scope.spawn(
+                    async move { DecodeResult::Mesh(load_primitive(&primitive, buffer_data)) },
+                );
+            }
+        });
+
+        // scope results are in spawn order, so meshes stay in primitive order
+        let mut meshes = Vec::new();
+        let mut textures = Vec::new();
+        for result in results {
+            match result {
+                DecodeResult::Mesh(mesh) => meshes.push(mesh),
+                DecodeResult::Texture(texture) => textures.push(texture),
+            }
+        }
+        (meshes, textures)
+    }
+}
+
+fn load_primitive(primitive: &Primitive, buffer_data: &[AssetBytes]) -> Result<Mesh, GltfError> {
+    let reader = primitive.reader(|buffer| Some(buffer_data[buffer.index()].as_ref()));
+    let primitive_topology = get_primitive_topology(primitive.mode())?;
+
+    let mut mesh = Mesh::new(primitive_topology);
+
+    if let Some(vertex_attribute) = reader
+        .read_positions()
+        .map(|v| VertexAttributeValues::Float32x3(v.collect()))
+    {
+        mesh.set_attribute(Mesh::ATTRIBUTE_POSITION, vertex_attribute);
+    }
+
+    if let Some(vertex_attribute) = reader
+        .read_normals()
+        .map(|v| VertexAttributeValues::Float32x3(v.collect()))
+    {
+        mesh.set_attribute(Mesh::ATTRIBUTE_NORMAL, vertex_attribute);
+    }
+
+    if let Some(vertex_attribute) = reader
+        .read_tangents()
+        .map(|v| VertexAttributeValues::Float32x4(v.collect()))
+    {
+        mesh.set_attribute(Mesh::ATTRIBUTE_TANGENT, vertex_attribute);
+    }
+
+    if let Some(vertex_attribute) = reader
+        .read_tex_coords(0)
+        .map(|v| VertexAttributeValues::Float32x2(v.into_f32().collect()))
+    {
+        mesh.set_attribute(Mesh::ATTRIBUTE_UV_0, vertex_attribute);
+    } else {
+        let len = mesh.count_vertices();
+        let uvs = vec![[0.0, 0.0]; len];
+        bevy_log::debug!("missing `TEXCOORD_0` vertex attribute, loading zeroed out UVs");
+        mesh.set_attribute(Mesh::ATTRIBUTE_UV_0, uvs);
+    }
+
+    if let Some(vertex_attribute) = reader
+        .read_colors(0)
+        .map(|v| VertexAttributeValues::Float32x4(v.into_rgba_f32().collect()))
+    {
+        mesh.set_attribute(Mesh::ATTRIBUTE_COLOR, vertex_attribute);
+    }
+
+    if let Some(indices) = reader.read_indices() {
+        mesh.set_indices(Some(Indices::U32(indices.into_u32().collect())));
+    };
+
+    if mesh.attribute(Mesh::ATTRIBUTE_NORMAL).is_none() {
+        let vertex_count_before = mesh.count_vertices();
+        mesh.duplicate_vertices();
+        mesh.compute_flat_normals();
+        let vertex_count_after = mesh.count_vertices();
+
+        if vertex_count_before != vertex_count_after {
+            bevy_log::debug!("Missing vertex normals in indexed geometry, computing them as flat. Vertex count increased from {} to {}", vertex_count_before, vertex_count_after);
+        } else {
+            bevy_log::debug!("Missing vertex normals in indexed geometry, computing them as flat.");
+        }
+    }
+
+    Ok(mesh)
+}
+
 async fn load_texture<'a>(
     gltf_texture: gltf::Texture<'a>,
-    buffer_data: &[Vec<u8>],
+    buffer_data: &[AssetBytes],
     linear_textures: &HashSet<usize>,
     load_context: &LoadContext<'a>,
 ) -> Result<(Texture, String), GltfError> {
@@ -446,7 +503,7 @@ fn load_node(
     gltf_node: &gltf::Node,
     world_builder: &mut WorldChildBuilder,
     load_context: &mut LoadContext,
-    buffer_data: &[Vec<u8>],
+    buffer_data: &[AssetBytes],
 ) -> Result<(), GltfError> {
     let transform = gltf_node.transform();
     let mut gltf_error = None;
@@ -461,9 +518,7 @@ fn load_node(
 
     // create camera node
     if let Some(camera) = gltf_node.camera() {
-        node.insert(VisibleEntities {
-            ..Default::default()
-        });
+        node.insert(VisibleEntities::default());
 
         match camera.projection() {
             gltf::camera::Projection::Orthographic(orthographic) => {
@@ -646,7 +701,7 @@ async fn load_buffers(
     gltf: &gltf::Gltf,
     load_context: &LoadContext<'_>,
     asset_path: &Path,
-) -> Result<Vec<Vec<u8>>, GltfError> {
+) -> Result<Vec<AssetBytes>, GltfError> {
     const OCTET_STREAM_URI: &str = "application/octet-stream";
 
     let mut buffer_data = Vec::new();
@@ -658,20 +713,24 @@ async fn load_buffers(
                     .unwrap();
                 let uri = uri.as_ref();
                 let buffer_bytes = match DataUri::parse(uri) {
-                    Ok(data_uri) if data_uri.mime_type == OCTET_STREAM_URI => data_uri.decode()?,
+                    Ok(data_uri) if data_uri.mime_type == OCTET_STREAM_URI => {
+                        data_uri.decode()?.into()
+                    }
                     Ok(_) => return Err(GltfError::BufferFormatUnsupported),
                     Err(()) => {
                         // TODO: Remove this and add dep
                         let buffer_path = asset_path.parent().unwrap().join(uri);
-                        let buffer_bytes = load_context.read_asset_bytes(buffer_path).await?;
-                        buffer_bytes
+                        // only the declared length is used, the file may hold more data
+                        load_context
+                            .read_asset_bytes_range(buffer_path, 0..buffer.length() as u64)
+                            .await?
                     }
                 };
                 buffer_data.push(buffer_bytes);
             }
             gltf::buffer::Source::Bin => {
                 if let Some(blob) = gltf.blob.as_deref() {
-                    buffer_data.push(blob.into());
+                    buffer_data.push(blob.to_vec().into());
                 } else {
                     return Err(GltfError::MissingBlob);
                 }
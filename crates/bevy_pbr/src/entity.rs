@@ -4,7 +4,7 @@ use bevy_ecs::bundle::Bundle;
 use bevy_render::{
     draw::Draw,
     mesh::Mesh,
-    pipeline::{RenderPipeline, RenderPipelines},
+    pipeline::{Instanced, RenderPipeline, RenderPipelines},
     prelude::Visible,
     render_graph::base::MainPass,
 };
@@ -40,6 +40,39 @@ impl Default for PbrBundle {
     }
 }
 
+/// A component bundle for "pbr mesh" entities drawn through the instanced path. Entities that
+/// share a mesh and material are drawn with a single draw call.
+#[derive(Bundle)]
+pub struct InstancedPbrBundle {
+    pub mesh: Handle<Mesh>,
+    pub material: Handle<StandardMaterial>,
+    pub main_pass: MainPass,
+    pub draw: Draw,
+    pub visible: Visible,
+    pub instanced: Instanced,
+    pub render_pipelines: RenderPipelines,
+    pub transform: Transform,
+    pub global_transform: GlobalTransform,
+}
+
+impl Default for InstancedPbrBundle {
+    fn default() -> Self {
+        Self {
+            render_pipelines: RenderPipelines::from_pipelines(vec![RenderPipeline::new(
+                PBR_PIPELINE_HANDLE.typed(),
+            )]),
+            mesh: Default::default(),
+            visible: Default::default(),
+            material: Default::default(),
+            main_pass: Default::default(),
+            draw: Default::default(),
+            instanced: Default::default(),
+            transform: Default::default(),
+            global_transform: Default::default(),
+        }
+    }
+}
+
 /// A component bundle for "light" entities
 #[derive(Debug, Bundle, Default)]
 pub struct PointLightBundle {
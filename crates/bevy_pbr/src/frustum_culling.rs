@@ -0,0 +1,113 @@
+use crate::material::StandardMaterial;
+use bevy_asset::{AssetEvent, Assets, Handle, HandleId};
+use bevy_ecs::{
+    prelude::{Commands, Entity, EventReader, Query, Res, ResMut, With},
+    query::AUTO_BATCH_SIZE,
+};
+use bevy_render::{
+    camera::{Aabb, ActiveCameras, Camera, Frustum},
+    draw::OutsideFrustum,
+    mesh::Mesh,
+};
+use bevy_tasks::ComputeTaskPool;
+use bevy_transform::components::GlobalTransform;
+use bevy_utils::HashMap;
+use std::sync::Mutex;
+
+/// The model space bounding boxes of all [`Mesh`] assets, kept up to date by
+/// [`mesh_aabb_system`].
+#[derive(Debug, Default)]
+pub struct MeshAabbs {
+    aabbs: HashMap<HandleId, Aabb>,
+}
+
+impl MeshAabbs {
+    pub fn get(&self, handle: &Handle<Mesh>) -> Option<&Aabb> {
+        self.aabbs.get(&handle.id)
+    }
+}
+
+pub fn mesh_aabb_system(
+    mut mesh_aabbs: ResMut<MeshAabbs>,
+    meshes: Res<Assets<Mesh>>,
+    mut mesh_events: EventReader<AssetEvent<Mesh>>,
+) {
+    for event in mesh_events.iter() {
+        match event {
+            AssetEvent::Created { handle } | AssetEvent::Modified { handle } => {
+                match meshes.get(handle).and_then(Mesh::compute_aabb) {
+                    Some(aabb) => mesh_aabbs.aabbs.insert(handle.id, aabb),
+                    None => mesh_aabbs.aabbs.remove(&handle.id),
+                };
+            }
+            AssetEvent::Removed { handle } => {
+                mesh_aabbs.aabbs.remove(&handle.id);
+            }
+        }
+    }
+}
+
+/// Marks [`StandardMaterial`] meshes that are outside the frustum of every active camera with
+/// [`OutsideFrustum`]. Meshes without a known bounding box are never culled.
+#[allow(clippy::type_complexity)]
+pub fn mesh_frustum_culling_system(
+    mut commands: Commands,
+    task_pool: Option<Res<ComputeTaskPool>>,
+    active_cameras: Res<ActiveCameras>,
+    mesh_aabbs: Res<MeshAabbs>,
+    cameras: Query<(&Camera, &GlobalTransform)>,
+    mut meshes: Query<
+        (
+            Entity,
+            &Handle<Mesh>,
+            &GlobalTransform,
+            Option<&OutsideFrustum>,
+        ),
+        With<Handle<StandardMaterial>>,
+    >,
+) {
+    let frustums = active_cameras
+        .iter()
+        .filter_map(|active_camera| active_camera.entity)
+        .filter_map(|entity| cameras.get(entity).ok())
+        .map(|(camera, transform)| Frustum::from_camera(&camera.projection_matrix, transform))
+        .collect::<Vec<_>>();
+    if frustums.is_empty() {
+        return;
+    }
+
+    // only entities whose visibility flips are recorded, so the lock is rarely contended
+    let changes = Mutex::new(Vec::new());
+    let cull = |(entity, mesh, transform, outside_frustum): (
+        Entity,
+        &Handle<Mesh>,
+        &GlobalTransform,
+        Option<&OutsideFrustum>,
+    )| {
+        let visible = match mesh_aabbs.get(mesh) {
+            Some(aabb) => {
+                let aabb = aabb.transformed_by(&transform.compute_matrix());
+                frustums
+                    .iter()
+                    .any(|frustum| frustum.intersects_aabb(&aabb))
+            }
+            None => true,
+        };
+        if visible == outside_frustum.is_some() {
+            changes.lock().unwrap().push((entity, visible));
+        }
+    };
+
+    match task_pool {
+        Some(task_pool) => meshes.par_for_each_mut(&task_pool, AUTO_BATCH_SIZE, cull),
+        None => meshes.for_each_mut(cull),
+    }
+
+    for (entity, visible) in changes.into_inner().unwrap() {
+        if visible {
+            commands.entity(entity).remove::<OutsideFrustum>();
+        } else {
+            commands.entity(entity).insert(OutsideFrustum);
+        }
+    }
+}
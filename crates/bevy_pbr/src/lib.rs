@@ -1,10 +1,12 @@
 pub mod render_graph;
 
 mod entity;
+mod frustum_culling;
 mod light;
 mod material;
 
 pub use entity::*;
+pub use frustum_culling::*;
 pub use light::*;
 pub use material::*;
 
@@ -19,8 +21,9 @@ pub mod prelude {
 
 use bevy_app::prelude::*;
 use bevy_asset::{AddAsset, Assets, Handle};
-use bevy_ecs::system::IntoSystem;
-use bevy_render::{prelude::Color, shader};
+use bevy_ecs::{schedule::ParallelSystemDescriptorCoercion, system::IntoSystem};
+use bevy_render::{prelude::Color, shader, RenderSystem};
+use bevy_transform::TransformSystem;
 use material::StandardMaterial;
 use render_graph::add_pbr_graph;
 
@@ -36,7 +39,16 @@ impl Plugin for PbrPlugin {
                 CoreStage::PostUpdate,
                 shader::asset_shader_defs_system::<StandardMaterial>.system(),
             )
-            .init_resource::<AmbientLight>();
+            .add_system_to_stage(CoreStage::PostUpdate, mesh_aabb_system.system())
+            .add_system_to_stage(
+                CoreStage::PostUpdate,
+                mesh_frustum_culling_system
+                    .system()
+                    .after(TransformSystem::TransformPropagate)
+                    .before(RenderSystem::VisibleEntities),
+            )
+            .init_resource::<AmbientLight>()
+            .init_resource::<MeshAabbs>();
         add_pbr_graph(app.world_mut());
 
         // add default StandardMaterial
@@ -73,55 +73,62 @@ layout(std140, set = 1, binding = 0) uniform Lights {
     DirectionalLight DirectionalLights[MAX_DIRECTIONAL_LIGHTS];
 };
 
-layout(set = 3, binding = 0) uniform StandardMaterial_base_color {
+// instanced draws have no per entity Transform bind group, so the material moves down a set
+#ifdef INSTANCED
+#    define MATERIAL_SET 2
+#else
+#    define MATERIAL_SET 3
+#endif
+
+layout(set = MATERIAL_SET, binding = 0) uniform StandardMaterial_base_color {
     vec4 base_color;
 };
 
 #ifdef STANDARDMATERIAL_BASE_COLOR_TEXTURE
-layout(set = 3, binding = 1) uniform texture2D StandardMaterial_base_color_texture;
-layout(set = 3,
+layout(set = MATERIAL_SET, binding = 1) uniform texture2D StandardMaterial_base_color_texture;
+layout(set = MATERIAL_SET,
        binding = 2) uniform sampler StandardMaterial_base_color_texture_sampler;
 #endif
 
 #ifndef STANDARDMATERIAL_UNLIT
 
-layout(set = 3, binding = 3) uniform StandardMaterial_roughness {
+layout(set = MATERIAL_SET, binding = 3) uniform StandardMaterial_roughness {
     float perceptual_roughness;
 };
 
-layout(set = 3, binding = 4) uniform StandardMaterial_metallic {
+layout(set = MATERIAL_SET, binding = 4) uniform StandardMaterial_metallic {
     float metallic;
 };
 
 #    ifdef STANDARDMATERIAL_METALLIC_ROUGHNESS_TEXTURE
-layout(set = 3, binding = 5) uniform texture2D StandardMaterial_metallic_roughness_texture;
-layout(set = 3,
+layout(set = MATERIAL_SET, binding = 5) uniform texture2D StandardMaterial_metallic_roughness_texture;
+layout(set = MATERIAL_SET,
        binding = 6) uniform sampler StandardMaterial_metallic_roughness_texture_sampler;
 #    endif
 
-layout(set = 3, binding = 7) uniform StandardMaterial_reflectance {
+layout(set = MATERIAL_SET, binding = 7) uniform StandardMaterial_reflectance {
     float reflectance;
 };
 
 #    ifdef STANDARDMATERIAL_NORMAL_MAP
-layout(set = 3, binding = 8) uniform texture2D StandardMaterial_normal_map;
-layout(set = 3,
+layout(set = MATERIAL_SET, binding = 8) uniform texture2D StandardMaterial_normal_map;
+layout(set = MATERIAL_SET,
        binding = 9) uniform sampler StandardMaterial_normal_map_sampler;
 #    endif
 
 #    if defined(STANDARDMATERIAL_OCCLUSION_TEXTURE)
-layout(set = 3, binding = 10) uniform texture2D StandardMaterial_occlusion_texture;
-layout(set = 3,
+layout(set = MATERIAL_SET, binding = 10) uniform texture2D StandardMaterial_occlusion_texture;
+layout(set = MATERIAL_SET,
        binding = 11) uniform sampler StandardMaterial_occlusion_texture_sampler;
 #    endif
 
-layout(set = 3, binding = 12) uniform StandardMaterial_emissive {
+layout(set = MATERIAL_SET, binding = 12) uniform StandardMaterial_emissive {
     vec4 emissive;
 };
 
 #    if defined(STANDARDMATERIAL_EMISSIVE_TEXTURE)
-layout(set = 3, binding = 13) uniform texture2D StandardMaterial_emissive_texture;
-layout(set = 3,
+layout(set = MATERIAL_SET, binding = 13) uniform texture2D StandardMaterial_emissive_texture;
+layout(set = MATERIAL_SET,
        binding = 14) uniform sampler StandardMaterial_emissive_texture_sampler;
 #    endif
 
@@ -8,6 +8,13 @@ layout(location = 2) in vec2 Vertex_Uv;
 layout(location = 3) in vec4 Vertex_Tangent;
 #endif
 
+#ifdef INSTANCED
+layout(location = 4) in vec4 I_Model_Col0;
+layout(location = 5) in vec4 I_Model_Col1;
+layout(location = 6) in vec4 I_Model_Col2;
+layout(location = 7) in vec4 I_Model_Col3;
+#endif
+
 layout(location = 0) out vec3 v_WorldPosition;
 layout(location = 1) out vec3 v_WorldNormal;
 layout(location = 2) out vec2 v_Uv;
@@ -20,11 +27,16 @@ layout(set = 0, binding = 0) uniform CameraViewProj {
 layout(location = 3) out vec4 v_WorldTangent;
 #endif
 
+#ifndef INSTANCED
 layout(set = 2, binding = 0) uniform Transform {
     mat4 Model;
 };
+#endif
 
 void main() {
+#ifdef INSTANCED
+    mat4 Model = mat4(I_Model_Col0, I_Model_Col1, I_Model_Col2, I_Model_Col3);
+#endif
     vec4 world_position = Model * vec4(Vertex_Position, 1.0);
     v_WorldPosition = world_position.xyz;
     v_WorldNormal = mat3(Model) * Vertex_Normal;
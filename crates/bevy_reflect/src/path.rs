@@ -1,6 +1,9 @@
-use std::num::ParseIntError;
+use std::{
+    num::ParseIntError,
+    sync::atomic::{AtomicUsize, Ordering},
+};
 
-use crate::{Reflect, ReflectMut, ReflectRef};
+use crate::{Reflect, ReflectMut, ReflectRef, Struct};
 use thiserror::Error;
 
 #[derive(Debug, PartialEq, Eq, Error)]
@@ -202,6 +205,263 @@ impl GetPath for dyn Reflect {
     }
 }
 
+/// A path that is parsed once and can then be applied to many values, for paths that are used
+/// every frame, like animation targets.
+///
+/// Struct field names are resolved to field indices the first time the path is applied to a
+/// struct, so applying it again to a value of the same type skips the string lookups.
+///
+/// ```
+/// # use bevy_reflect::{Reflect, ReflectPath};
+/// #[derive(Reflect)]
+/// struct Foo {
+///     bar: Vec<f32>,
+/// }
+///
+/// let path = ReflectPath::parse("bar[1]").unwrap();
+/// let mut foo = Foo { bar: vec![1.0, 2.0] };
+/// *path.element_mut::<f32>(&mut foo).unwrap() = 3.0;
+/// assert_eq!(foo.bar[1], 3.0);
+/// ```
+#[derive(Debug)]
+pub struct ReflectPath {
+    segments: Vec<PathSegment>,
+}
+
+#[derive(Debug)]
+struct PathSegment {
+    access: Access,
+    /// The index in the path string, used for errors
+    index: usize,
+}
+
+#[derive(Debug)]
+enum Access {
+    /// A struct field or a tuple struct field
+    Field {
+        name: String,
+        tuple_index: Option<usize>,
+        /// The last resolved struct field index. This is only a hint, it is checked against the
+        /// field name before it is used.
+        field_index: AtomicUsize,
+    },
+    ListIndex(usize),
+}
+
+impl ReflectPath {
+    pub fn parse(path: &str) -> Result<Self, ReflectPathError<'_>> {
+        let mut segments = Vec::new();
+        let mut index = 0;
+        while let Some(token) = next_token(path, &mut index) {
+            let current_index = index;
+            let access = match token {
+                Token::Dot => {
+                    if let Some(Token::Ident(value)) = next_token(path, &mut index) {
+                        Access::field(value)
+                    } else {
+                        return Err(ReflectPathError::ExpectedIdent {
+                            index: current_index,
+                        });
+                    }
+                }
+                Token::OpenBracket => {
+                    let list_index = if let Some(Token::Ident(value)) = next_token(path, &mut index)
+                    {
+                        value.parse::<usize>()?
+                    } else {
+                        return Err(ReflectPathError::ExpectedIdent {
+                            index: current_index,
+                        });
+                    };
+
+                    if let Some(Token::CloseBracket) = next_token(path, &mut index) {
+                    } else {
+                        return Err(ReflectPathError::ExpectedToken {
+                            index: current_index,
+                            token: "]",
+                        });
+                    }
+                    Access::ListIndex(list_index)
+                }
+                Token::CloseBracket => {
+                    return Err(ReflectPathError::UnexpectedToken {
+                        index: current_index,
+                        token: "]",
+                    })
+                }
+                Token::Ident(value) => Access::field(value),
+            };
+            segments.push(PathSegment {
+                access,
+                index: current_index,
+            });
+        }
+
+        Ok(ReflectPath { segments })
+    }
+
+    pub fn reflect_element<'r, 's>(
+        &'s self,
+        root: &'r dyn Reflect,
+    ) -> Result<&'r dyn Reflect, ReflectPathError<'s>> {
+        let mut current = root;
+        for segment in self.segments.iter() {
+            current = segment.read(current)?;
+        }
+        Ok(current)
+    }
+
+    pub fn reflect_element_mut<'r, 's>(
+        &'s self,
+        root: &'r mut dyn Reflect,
+    ) -> Result<&'r mut dyn Reflect, ReflectPathError<'s>> {
+        let mut current = root;
+        for segment in self.segments.iter() {
+            current = segment.read_mut(current)?;
+        }
+        Ok(current)
+    }
+
+    pub fn element<'r, 's, T: Reflect>(
+        &'s self,
+        root: &'r dyn Reflect,
+    ) -> Result<&'r T, ReflectPathError<'s>> {
+        self.reflect_element(root).and_then(|p| {
+            p.downcast_ref::<T>()
+                .ok_or(ReflectPathError::InvalidDowncast)
+        })
+    }
+
+    pub fn element_mut<'r, 's, T: Reflect>(
+        &'s self,
+        root: &'r mut dyn Reflect,
+    ) -> Result<&'r mut T, ReflectPathError<'s>> {
+        self.reflect_element_mut(root).and_then(|p| {
+            p.downcast_mut::<T>()
+                .ok_or(ReflectPathError::InvalidDowncast)
+        })
+    }
+}
+
+impl Access {
+    fn field(name: &str) -> Self {
+        Access::Field {
+            name: name.to_string(),
+            tuple_index: name.parse::<usize>().ok(),
+            field_index: AtomicUsize::new(0),
+        }
+    }
+}
+
+impl PathSegment {
+    fn read<'r, 's>(
+        &'s self,
+        current: &'r dyn Reflect,
+    ) -> Result<&'r dyn Reflect, ReflectPathError<'s>> {
+        let index = self.index;
+        match (&self.access, current.reflect_ref()) {
+            (
+                Access::Field {
+                    name, field_index, ..
+                },
+                ReflectRef::Struct(reflect_struct),
+            ) => {
+                let field_index = resolve_field(reflect_struct, name, field_index, index)?;
+                Ok(reflect_struct.field_at(field_index).unwrap())
+            }
+            (
+                Access::Field {
+                    name, tuple_index, ..
+                },
+                ReflectRef::TupleStruct(reflect_struct),
+            ) => {
+                let tuple_index = parse_tuple_index(name, *tuple_index)?;
+                Ok(reflect_struct.field(tuple_index).ok_or(
+                    ReflectPathError::InvalidTupleStructIndex {
+                        index,
+                        tuple_struct_index: tuple_index,
+                    },
+                )?)
+            }
+            (Access::Field { .. }, _) => Err(ReflectPathError::ExpectedStruct { index }),
+            (Access::ListIndex(list_index), ReflectRef::List(reflect_list)) => Ok(reflect_list
+                .get(*list_index)
+                .ok_or(ReflectPathError::InvalidListIndex {
+                    index,
+                    list_index: *list_index,
+                })?),
+            (Access::ListIndex(_), _) => Err(ReflectPathError::ExpectedList { index }),
+        }
+    }
+
+    fn read_mut<'r, 's>(
+        &'s self,
+        current: &'r mut dyn Reflect,
+    ) -> Result<&'r mut dyn Reflect, ReflectPathError<'s>> {
+        let index = self.index;
+        match (&self.access, current.reflect_mut()) {
+            (
+                Access::Field {
+                    name, field_index, ..
+                },
+                ReflectMut::Struct(reflect_struct),
+            ) => {
+                let field_index = resolve_field(reflect_struct, name, field_index, index)?;
+                Ok(reflect_struct.field_at_mut(field_index).unwrap())
+            }
+            (
+                Access::Field {
+                    name, tuple_index, ..
+                },
+                ReflectMut::TupleStruct(reflect_struct),
+            ) => {
+                let tuple_index = parse_tuple_index(name, *tuple_index)?;
+                Ok(reflect_struct.field_mut(tuple_index).ok_or(
+                    ReflectPathError::InvalidTupleStructIndex {
+                        index,
+                        tuple_struct_index: tuple_index,
+                    },
+                )?)
+            }
+            (Access::Field { .. }, _) => Err(ReflectPathError::ExpectedStruct { index }),
+            (Access::ListIndex(list_index), ReflectMut::List(reflect_list)) => Ok(reflect_list
+                .get_mut(*list_index)
+                .ok_or(ReflectPathError::InvalidListIndex {
+                    index,
+                    list_index: *list_index,
+                })?),
+            (Access::ListIndex(_), _) => Err(ReflectPathError::ExpectedList { index }),
+        }
+    }
+}
+
+/// The parsed index of a tuple struct field
+fn parse_tuple_index(name: &str, tuple_index: Option<usize>) -> Result<usize, ParseIntError> {
+    match tuple_index {
+        Some(tuple_index) => Ok(tuple_index),
+        // reparse to report the same error as `GetPath`
+        None => name.parse::<usize>(),
+    }
+}
+
+/// Finds the index of the field called `name`, trying the cached index first
+fn resolve_field<'s>(
+    reflect_struct: &dyn Struct,
+    name: &'s str,
+    cached: &AtomicUsize,
+    index: usize,
+) -> Result<usize, ReflectPathError<'s>> {
+    let field_index = cached.load(Ordering::Relaxed);
+    if reflect_struct.name_at(field_index) == Some(name) {
+        return Ok(field_index);
+    }
+    let field_index = (0..reflect_struct.field_len())
+        .find(|i| reflect_struct.name_at(*i) == Some(name))
+        .ok_or(ReflectPathError::InvalidField { index, field: name })?;
+    cached.store(field_index, Ordering::Relaxed);
+    Ok(field_index)
+}
+
 fn read_field<'r, 'p>(
     current: &'r dyn Reflect,
     field: &'p str,
@@ -307,7 +567,7 @@ fn next_token<'a>(path: &'a str, index: &mut usize) -> Option<Token<'a>> {
 #[cfg(test)]
 #[allow(clippy::float_cmp, clippy::approx_constant)]
 mod tests {
-    use super::GetPath;
+    use super::{GetPath, ReflectPath};
     use crate as bevy_reflect;
     use crate::*;
     #[test]
@@ -384,4 +644,102 @@ mod tests {
             Err(ReflectPathError::IndexParseError(_))
         ));
     }
+
+    #[test]
+    fn parsed_reflect_path() {
+        #[derive(Reflect)]
+        struct A {
+            w: usize,
+            x: Vec<B>,
+            y: C,
+        }
+
+        #[derive(Reflect)]
+        struct B {
+            foo: usize,
+            bar: f32,
+        }
+
+        #[derive(Reflect)]
+        struct C(f32, usize);
+
+        let mut a = A {
+            w: 1,
+            x: vec![B { foo: 2, bar: 3.0 }, B { foo: 4, bar: 5.0 }],
+            y: C(6.0, 7),
+        };
+
+        let path = ReflectPath::parse("x[1].bar").unwrap();
+        assert_eq!(*path.element::<f32>(&a).unwrap(), 5.0);
+        *path.element_mut::<f32>(&mut a).unwrap() = 8.0;
+        assert_eq!(a.x[1].bar, 8.0);
+        assert_eq!(*path.element::<f32>(&a).unwrap(), 8.0);
+        assert_eq!(
+            *ReflectPath::parse("y.1")
+                .unwrap()
+                .element::<usize>(&a)
+                .unwrap(),
+            7
+        );
+
+        // the cached field index is checked against the name, so values with a different
+        // field order still work
+        let path = ReflectPath::parse("foo").unwrap();
+        let mut first = DynamicStruct::default();
+        first.insert("bar", 1.0f32);
+        first.insert("foo", 2usize);
+        let mut second = DynamicStruct::default();
+        second.insert("foo", 3usize);
+        assert_eq!(*path.element::<usize>(&first).unwrap(), 2);
+        assert_eq!(*path.element::<usize>(&second).unwrap(), 3);
+        assert_eq!(*path.element::<usize>(&first).unwrap(), 2);
+
+        assert_eq!(
+            ReflectPath::parse("w.notreal")
+                .unwrap()
+                .reflect_element(&a)
+                .err()
+                .unwrap(),
+            ReflectPathError::ExpectedStruct { index: 2 }
+        );
+        let path = ReflectPath::parse("x[0].notreal").unwrap();
+        assert_eq!(
+            path.reflect_element(&a).err().unwrap(),
+            ReflectPathError::InvalidField {
+                index: 5,
+                field: "notreal"
+            }
+        );
+        assert_eq!(
+            ReflectPath::parse("x[2]")
+                .unwrap()
+                .reflect_element(&a)
+                .err()
+                .unwrap(),
+            ReflectPathError::InvalidListIndex {
+                index: 2,
+                list_index: 2
+            }
+        );
+        assert_eq!(
+            ReflectPath::parse("x..").err().unwrap(),
+            ReflectPathError::ExpectedIdent { index: 2 }
+        );
+        assert_eq!(
+            ReflectPath::parse("w[0]")
+                .unwrap()
+                .reflect_element(&a)
+                .err()
+                .unwrap(),
+            ReflectPathError::ExpectedList { index: 2 }
+        );
+        assert!(matches!(
+            ReflectPath::parse("x[badindex]"),
+            Err(ReflectPathError::IndexParseError(_))
+        ));
+        assert!(matches!(
+            ReflectPath::parse("y.bad").unwrap().reflect_element(&a),
+            Err(ReflectPathError::IndexParseError(_))
+        ));
+    }
 }
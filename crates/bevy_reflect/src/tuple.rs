@@ -85,6 +85,11 @@ impl DynamicTuple {
         self.name = name;
     }
 
+    /// Creates a tuple from its fields, using `name` instead of generating one per inserted field.
+    pub fn from_boxed_fields(name: String, fields: Vec<Box<dyn Reflect>>) -> Self {
+        DynamicTuple { name, fields }
+    }
+
     pub fn insert_boxed(&mut self, value: Box<dyn Reflect>) {
         self.fields.push(value);
         self.generate_name();
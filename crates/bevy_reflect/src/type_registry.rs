@@ -254,6 +254,26 @@ impl<T: for<'a> Deserialize<'a> + Reflect> FromType<T> for ReflectDeserialize {
     }
 }
 
+/// Creates the default value of a type. Registered with `#[reflect(Default)]`.
+#[derive(Clone)]
+pub struct ReflectDefault {
+    default: fn() -> Box<dyn Reflect>,
+}
+
+impl ReflectDefault {
+    pub fn default(&self) -> Box<dyn Reflect> {
+        (self.default)()
+    }
+}
+
+impl<T: Reflect + Default> FromType<T> for ReflectDefault {
+    fn from_type() -> Self {
+        ReflectDefault {
+            default: || Box::new(T::default()),
+        }
+    }
+}
+
 #[cfg(test)]
 mod test {
     use crate::TypeRegistration;
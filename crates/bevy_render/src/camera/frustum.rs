@@ -0,0 +1,117 @@
+use bevy_math::{Mat4, Vec3, Vec4};
+use bevy_transform::components::GlobalTransform;
+
+/// An axis-aligned bounding box, stored as its center and half extents.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct Aabb {
+    pub center: Vec3,
+    pub half_extents: Vec3,
+}
+
+impl Aabb {
+    pub fn from_min_max(min: Vec3, max: Vec3) -> Self {
+        Aabb {
+            center: (max + min) * 0.5,
+            half_extents: (max - min) * 0.5,
+        }
+    }
+
+    pub fn min(&self) -> Vec3 {
+        self.center - self.half_extents
+    }
+
+    pub fn max(&self) -> Vec3 {
+        self.center + self.half_extents
+    }
+
+    /// Returns the smallest [`Aabb`] containing this box after it was transformed by `matrix`.
+    pub fn transformed_by(&self, matrix: &Mat4) -> Aabb {
+        let center = matrix.transform_point3(self.center);
+        let half_extents = matrix.x_axis.truncate().abs() * self.half_extents.x
+            + matrix.y_axis.truncate().abs() * self.half_extents.y
+            + matrix.z_axis.truncate().abs() * self.half_extents.z;
+        Aabb {
+            center,
+            half_extents,
+        }
+    }
+}
+
+/// The six planes bounding a camera's view volume, in world space.
+///
+/// Each plane is stored as `(normal, distance)` in a [`Vec4`], with the normal pointing into the
+/// view volume.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct Frustum {
+    pub planes: [Vec4; 6],
+}
+
+impl Frustum {
+    /// Extracts the frustum of a view-projection matrix whose clip space depth ranges from 0 to 1,
+    /// like the ones produced by the camera projections.
+    pub fn from_view_projection(view_projection: &Mat4) -> Self {
+        let rows = view_projection.transpose();
+        let (row0, row1, row2, row3) = (rows.x_axis, rows.y_axis, rows.z_axis, rows.w_axis);
+        let mut planes = [
+            row3 + row0,
+            row3 - row0,
+            row3 + row1,
+            row3 - row1,
+            row2,
+            row3 - row2,
+        ];
+        for plane in planes.iter_mut() {
+            *plane /= plane.truncate().length();
+        }
+        Frustum { planes }
+    }
+
+    /// Builds the frustum of a camera from its projection matrix and transform.
+    pub fn from_camera(projection_matrix: &Mat4, camera_transform: &GlobalTransform) -> Self {
+        let view_projection = *projection_matrix * camera_transform.compute_matrix().inverse();
+        Self::from_view_projection(&view_projection)
+    }
+
+    /// Returns `false` if `aabb` (in world space) is entirely outside of the frustum. Boxes close
+    /// to a corner of the frustum may be reported as intersecting even if they are not.
+    pub fn intersects_aabb(&self, aabb: &Aabb) -> bool {
+        self.planes.iter().all(|plane| {
+            let normal = plane.truncate();
+            let radius = aabb.half_extents.dot(normal.abs());
+            normal.dot(aabb.center) + plane.w >= -radius
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn perspective_frustum_culls_boxes_behind_and_beside() {
+        let projection = Mat4::perspective_rh(std::f32::consts::FRAC_PI_2, 1.0, 0.1, 100.0);
+        // looking down -Z from the origin
+        let frustum = Frustum::from_camera(&projection, &GlobalTransform::identity());
+        let unit_box = |center: Vec3| Aabb {
+            center,
+            half_extents: Vec3::splat(0.5),
+        };
+
+        assert!(frustum.intersects_aabb(&unit_box(Vec3::new(0.0, 0.0, -10.0))));
+        assert!(frustum.intersects_aabb(&unit_box(Vec3::new(9.0, 0.0, -10.0))));
+        assert!(!frustum.intersects_aabb(&unit_box(Vec3::new(0.0, 0.0, 10.0))));
+        assert!(!frustum.intersects_aabb(&unit_box(Vec3::new(20.0, 0.0, -10.0))));
+        assert!(!frustum.intersects_aabb(&unit_box(Vec3::new(0.0, 0.0, -200.0))));
+    }
+
+    #[test]
+    fn transformed_aabb_contains_rotated_box() {
+        let aabb = Aabb::from_min_max(Vec3::new(-1.0, -1.0, -1.0), Vec3::new(1.0, 1.0, 1.0));
+        let matrix = Mat4::from_rotation_y(std::f32::consts::FRAC_PI_4);
+        let transformed = aabb.transformed_by(&matrix);
+        let expected = std::f32::consts::SQRT_2;
+        assert!((transformed.half_extents.x - expected).abs() < 1e-5);
+        assert!((transformed.half_extents.y - 1.0).abs() < 1e-5);
+        assert!((transformed.half_extents.z - expected).abs() < 1e-5);
+    }
+}
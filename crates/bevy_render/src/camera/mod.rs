@@ -1,10 +1,12 @@
 mod active_cameras;
 #[allow(clippy::module_inception)]
 mod camera;
+mod frustum;
 mod projection;
 mod visible_entities;
 
 pub use active_cameras::*;
 pub use camera::*;
+pub use frustum::*;
 pub use projection::*;
 pub use visible_entities::*;
@@ -1,11 +1,19 @@
 use super::{Camera, DepthCalculation};
 use crate::{draw::OutsideFrustum, prelude::Visible};
 use bevy_core::FloatOrd;
-use bevy_ecs::{entity::Entity, query::Without, reflect::ReflectComponent, system::Query};
+use bevy_ecs::{
+    entity::Entity,
+    query::Without,
+    reflect::ReflectComponent,
+    system::{Query, Res},
+    world::Mut,
+};
 use bevy_reflect::Reflect;
+use bevy_tasks::ComputeTaskPool;
 use bevy_transform::prelude::GlobalTransform;
+use std::mem;
 
-#[derive(Debug)]
+#[derive(Debug, Clone, Copy)]
 pub struct VisibleEntity {
     pub entity: Entity,
     pub order: FloatOrd,
@@ -16,6 +24,12 @@ pub struct VisibleEntity {
 pub struct VisibleEntities {
     #[reflect(ignore)]
     pub value: Vec<VisibleEntity>,
+    /// Sort keys of the entities collected this frame, kept around to avoid reallocating
+    #[reflect(ignore)]
+    sort_keys: Vec<(u64, VisibleEntity)>,
+    /// Second buffer for [`radix_sort`]
+    #[reflect(ignore)]
+    sort_scratch: Vec<(u64, VisibleEntity)>,
 }
 
 impl VisibleEntities {
@@ -200,64 +214,231 @@ mod rendering_mask_tests {
     }
 }
 
+/// Buffers are only shrunk once their capacity is this many times larger than what was needed
+const SHRINK_FACTOR: usize = 2;
+
+/// Buffers with at most this capacity are never shrunk
+const MIN_SHRINK_CAPACITY: usize = 64;
+
+/// Lists with fewer entities are sorted with a comparison sort instead of [`radix_sort`]
+const RADIX_SORT_THRESHOLD: usize = 64;
+
+/// Maps `order` to a `u32` whose integer ordering matches the ordering of [`FloatOrd`]
+fn order_key(order: FloatOrd) -> u32 {
+    // FloatOrd treats NaN as the smallest value
+    if order.0.is_nan() {
+        return 0;
+    }
+    // adding 0.0 turns -0.0 into 0.0, which FloatOrd considers equal
+    let bits = (order.0 + 0.0).to_bits();
+    if bits >> 31 == 1 {
+        // negative floats are ordered backwards and below all positive floats
+        !bits
+    } else {
+        bits | 1 << 31
+    }
+}
+
+/// A stable LSD radix sort over the low 40 bits of the keys, using `scratch` as the second buffer.
+/// The sorted values end up in `keys`.
+fn radix_sort(keys: &mut Vec<(u64, VisibleEntity)>, scratch: &mut Vec<(u64, VisibleEntity)>) {
+    if keys.len() < RADIX_SORT_THRESHOLD {
+        keys.sort_by_key(|(key, _)| *key);
+        return;
+    }
+
+    for shift in (0..40).step_by(8) {
+        let mut offsets = [0usize; 256];
+        for (key, _) in keys.iter() {
+            offsets[(key >> shift) as usize & 0xff] += 1;
+        }
+        // every key has the same digit, so this pass wouldn't move anything
+        if offsets.iter().any(|&count| count == keys.len()) {
+            continue;
+        }
+
+        let mut offset = 0;
+        for digit_offset in offsets.iter_mut() {
+            let count = *digit_offset;
+            *digit_offset = offset;
+            offset += count;
+        }
+
+        scratch.clear();
+        scratch.resize(keys.len(), keys[0]);
+        for keyed in keys.iter() {
+            let digit = (keyed.0 >> shift) as usize & 0xff;
+            scratch[offsets[digit]] = *keyed;
+            offsets[digit] += 1;
+        }
+        mem::swap(keys, scratch);
+    }
+}
+
+fn shrink_if_oversized<T>(buffer: &mut Vec<T>, needed: usize) {
+    if buffer.capacity() > MIN_SHRINK_CAPACITY && buffer.capacity() > needed * SHRINK_FACTOR {
+        buffer.truncate(needed);
+        buffer.shrink_to_fit();
+    }
+}
+
+/// Collects the entities visible to each camera into its [`VisibleEntities`], opaque entities
+/// sorted front-to-back followed by transparent entities sorted back-to-front.
+///
+/// Cameras are processed in parallel on the [`ComputeTaskPool`] when it is available.
 pub fn visible_entities_system(
+    task_pool: Option<Res<ComputeTaskPool>>,
     mut camera_query: Query<(
         &Camera,
         &GlobalTransform,
         &mut VisibleEntities,
         Option<&RenderLayers>,
     )>,
-    visible_query: Query<(Entity, &Visible, Option<&RenderLayers>), Without<OutsideFrustum>>,
-    visible_transform_query: Query<&GlobalTransform, Without<OutsideFrustum>>,
+    visible_query: Query<
+        (
+            Entity,
+            &Visible,
+            Option<&RenderLayers>,
+            Option<&GlobalTransform>,
+        ),
+        Without<OutsideFrustum>,
+    >,
 ) {
-    for (camera, camera_global_transform, mut visible_entities, maybe_camera_mask) in
-        camera_query.iter_mut()
-    {
-        visible_entities.value.clear();
-        let camera_position = camera_global_transform.translation;
-        let camera_mask = maybe_camera_mask.copied().unwrap_or_default();
-
-        let mut no_transform_order = 0.0;
-        let mut transparent_entities = Vec::new();
-        for (entity, visible, maybe_entity_mask) in visible_query.iter() {
-            if !visible.is_visible {
-                continue;
-            }
+    let visible_query = &visible_query;
+    let update_camera =
+        |(camera, camera_global_transform, mut visible_entities, maybe_camera_mask): (
+            &Camera,
+            &GlobalTransform,
+            Mut<VisibleEntities>,
+            Option<&RenderLayers>,
+        )| {
+            let camera_position = camera_global_transform.translation;
+            let camera_mask = maybe_camera_mask.copied().unwrap_or_default();
+            let VisibleEntities {
+                value,
+                sort_keys,
+                sort_scratch,
+            } = &mut *visible_entities;
+
+            sort_keys.clear();
+            let mut no_transform_order = 0.0;
+            // iterating in table order (instead of looking up each entity's transform) keeps memory
+            // access sequential
+            for (entity, visible, maybe_entity_mask, maybe_global_transform) in visible_query.iter()
+            {
+                if !visible.is_visible {
+                    continue;
+                }
+
+                let entity_mask = maybe_entity_mask.copied().unwrap_or_default();
+                if !camera_mask.intersects(&entity_mask) {
+                    continue;
+                }
 
-            let entity_mask = maybe_entity_mask.copied().unwrap_or_default();
-            if !camera_mask.intersects(&entity_mask) {
-                continue;
+                let order = if let Some(global_transform) = maybe_global_transform {
+                    let position = global_transform.translation;
+                    // smaller distances are sorted to lower indices by using the distance from the
+                    // camera
+                    FloatOrd(match camera.depth_calculation {
+                        DepthCalculation::ZDifference => camera_position.z - position.z,
+                        DepthCalculation::Distance => (camera_position - position).length_squared(),
+                    })
+                } else {
+                    let order = FloatOrd(no_transform_order);
+                    no_transform_order += 0.1;
+                    order
+                };
+
+                // sort opaque entities front-to-back, then transparent entities back-to-front
+                let key = if visible.is_transparent {
+                    1u64 << 32 | order_key(-order) as u64
+                } else {
+                    order_key(order) as u64
+                };
+                sort_keys.push((key, VisibleEntity { entity, order }));
             }
 
-            let order = if let Ok(global_transform) = visible_transform_query.get(entity) {
-                let position = global_transform.translation;
-                // smaller distances are sorted to lower indices by using the distance from the
-                // camera
-                FloatOrd(match camera.depth_calculation {
-                    DepthCalculation::ZDifference => camera_position.z - position.z,
-                    DepthCalculation::Distance => (camera_position - position).length_squared(),
-                })
-            } else {
-                let order = FloatOrd(no_transform_order);
-                no_transform_order += 0.1;
-                order
-            };
-
-            if visible.is_transparent {
-                transparent_entities.push(VisibleEntity { entity, order })
-            } else {
-                visible_entities.value.push(VisibleEntity { entity, order })
+            radix_sort(sort_keys, sort_scratch);
+
+            value.clear();
+            value.extend(sort_keys.iter().map(|(_, visible_entity)| *visible_entity));
+
+            // don't hold on to memory needed for a single busy frame
+            let len = value.len();
+            shrink_if_oversized(value, len);
+            shrink_if_oversized(sort_keys, len);
+            shrink_if_oversized(sort_scratch, len);
+        };
+
+    match task_pool {
+        Some(task_pool) => camera_query.par_for_each_mut(&task_pool, 1, update_camera),
+        None => camera_query.for_each_mut(update_camera),
+    }
+}
+
+#[cfg(test)]
+mod sort_tests {
+    use super::*;
+
+    fn keyed(key: u64, id: u32) -> (u64, VisibleEntity) {
+        (
+            key,
+            VisibleEntity {
+                entity: Entity::new(id),
+                order: FloatOrd(0.0),
+            },
+        )
+    }
+
+    #[test]
+    fn order_key_matches_float_ord() {
+        let values = [
+            f32::NAN,
+            f32::NEG_INFINITY,
+            -1000.5,
+            -1.0,
+            -f32::MIN_POSITIVE,
+            -0.0,
+            0.0,
+            f32::MIN_POSITIVE,
+            0.25,
+            1.0,
+            1000.5,
+            f32::INFINITY,
+        ];
+        for a in values.iter() {
+            for b in values.iter() {
+                assert_eq!(
+                    order_key(FloatOrd(*a)).cmp(&order_key(FloatOrd(*b))),
+                    FloatOrd(*a).cmp(&FloatOrd(*b)),
+                    "{} vs {}",
+                    a,
+                    b
+                );
             }
         }
+    }
 
-        // sort opaque entities front-to-back
-        visible_entities.value.sort_by_key(|e| e.order);
+    #[test]
+    fn radix_sort_is_stable() {
+        // a simple LCG gives us enough keys to take the radix path with plenty of duplicates
+        let mut state = 12345u64;
+        let mut keys = (0..1000)
+            .map(|id| {
+                state = state.wrapping_mul(6364136223846793005).wrapping_add(1);
+                keyed((state >> 24) & 0xff_ffff_00ff, id)
+            })
+            .collect::<Vec<_>>();
+        let mut expected = keys.clone();
+        expected.sort_by_key(|(key, _)| *key);
 
-        // sort transparent entities front-to-back
-        transparent_entities.sort_by_key(|e| -e.order);
-        visible_entities.value.extend(transparent_entities);
+        radix_sort(&mut keys, &mut Vec::new());
 
-        // TODO: check for big changes in visible entities len() vs capacity() (ex: 2x) and resize
-        // to prevent holding unneeded memory
+        let to_ids = |keys: &[(u64, VisibleEntity)]| {
+            keys.iter()
+                .map(|(key, e)| (*key, e.entity.id()))
+                .collect::<Vec<_>>()
+        };
+        assert_eq!(to_ids(&keys), to_ids(&expected));
     }
 }
@@ -14,6 +14,7 @@ use bevy_ecs::{
     system::{Query, Res, ResMut, SystemParam},
 };
 use bevy_reflect::Reflect;
+use bevy_tasks::AsyncComputeTaskPool;
 use std::{ops::Range, sync::Arc};
 use thiserror::Error;
 
@@ -161,6 +162,8 @@ pub enum DrawError {
     BufferAllocationFailure,
     #[error("the given asset does not have any render resources")]
     MissingAssetRenderResources,
+    #[error("pipeline is still being compiled")]
+    PipelineNotReady,
 }
 
 #[derive(SystemParam)]
@@ -171,6 +174,9 @@ pub struct DrawContext<'a> {
     pub pipeline_compiler: ResMut<'a, PipelineCompiler>,
     pub render_resource_context: Res<'a, Box<dyn RenderResourceContext>>,
     pub shared_buffers: ResMut<'a, SharedBuffers>,
+    /// When present, new pipelines are compiled on this pool and
+    /// [`DrawContext::set_pipeline`] returns [`DrawError::PipelineNotReady`] until they are done
+    pub task_pool: Option<Res<'a, AsyncComputeTaskPool>>,
     #[system_param(ignore)]
     pub current_pipeline: Option<Handle<PipelineDescriptor>>,
 }
@@ -197,18 +203,39 @@ impl<'a> DrawContext<'a> {
         {
             specialized_pipeline
         } else {
-            self.pipeline_compiler.compile_pipeline(
+            self.compile_pipeline(pipeline_handle, specialization)
+                .ok_or(DrawError::PipelineNotReady)?
+        };
+
+        draw.set_pipeline(&specialized_pipeline);
+        self.current_pipeline = Some(specialized_pipeline.clone_weak());
+        Ok(())
+    }
+
+    fn compile_pipeline(
+        &mut self,
+        pipeline_handle: &Handle<PipelineDescriptor>,
+        specialization: &PipelineSpecialization,
+    ) -> Option<Handle<PipelineDescriptor>> {
+        #[cfg(not(target_arch = "wasm32"))]
+        if let Some(task_pool) = self.task_pool.as_ref() {
+            return self.pipeline_compiler.compile_pipeline_async(
+                task_pool,
                 &**self.render_resource_context,
                 &mut self.pipelines,
                 &mut self.shaders,
                 pipeline_handle,
                 specialization,
-            )
-        };
+            );
+        }
 
-        draw.set_pipeline(&specialized_pipeline);
-        self.current_pipeline = Some(specialized_pipeline.clone_weak());
-        Ok(())
+        Some(self.pipeline_compiler.compile_pipeline(
+            &**self.render_resource_context,
+            &mut self.pipelines,
+            &mut self.shaders,
+            pipeline_handle,
+            specialization,
+        ))
     }
 
     pub fn get_pipeline_descriptor(&self) -> Result<&PipelineDescriptor, DrawError> {
@@ -31,7 +31,7 @@ pub mod prelude {
         entity::*,
         mesh::{shape, Mesh},
         pass::ClearColor,
-        pipeline::RenderPipelines,
+        pipeline::{Instanced, RenderPipelines},
         shader::Shader,
         texture::Texture,
     };
@@ -47,14 +47,16 @@ use camera::{
     RenderLayers, ScalingMode, VisibleEntities, WindowOrigin,
 };
 use pipeline::{
-    IndexFormat, PipelineCompiler, PipelineDescriptor, PipelineSpecialization, PrimitiveTopology,
-    ShaderSpecialization, VertexBufferLayout,
+    IndexFormat, Instanced, PipelineCompiler, PipelineDescriptor, PipelineSpecialization,
+    PrimitiveTopology, ShaderSpecialization, VertexBufferLayout,
 };
 use render_graph::{
     base::{self, BaseRenderGraphConfig, MainPass},
     RenderGraph,
 };
-use renderer::{AssetRenderResourceBindings, RenderResourceBindings, RenderResourceContext};
+use renderer::{
+    AssetRenderResourceBindings, RenderResourceBindings, RenderResourceContext, StagingRing,
+};
 use shader::ShaderLoader;
 #[cfg(feature = "hdr")]
 use texture::HdrTextureLoader;
@@ -66,10 +68,15 @@ use texture::HdrTextureLoader;
     feature = "bmp"
 ))]
 use texture::ImageTextureLoader;
+#[cfg(feature = "ktx2")]
+use texture::Ktx2TextureLoader;
 
 #[derive(Debug, Hash, PartialEq, Eq, Clone, SystemLabel)]
 pub enum RenderSystem {
     VisibleEntities,
+    /// Draws [`Instanced`](pipeline::Instanced) entities, writing their instance buffer to the
+    /// [`StagingRing`](renderer::StagingRing)
+    DrawInstanced,
 }
 
 /// The names of "render" App stages
@@ -117,6 +124,10 @@ impl Plugin for RenderPlugin {
         {
             app.init_asset_loader::<HdrTextureLoader>();
         }
+        #[cfg(feature = "ktx2")]
+        {
+            app.init_asset_loader::<Ktx2TextureLoader>();
+        }
 
         app.add_stage_after(
             AssetStage::AssetEvents,
@@ -154,6 +165,7 @@ impl Plugin for RenderPlugin {
         .register_type::<Visible>()
         .register_type::<OutsideFrustum>()
         .register_type::<RenderPipelines>()
+        .register_type::<Instanced>()
         .register_type::<OrthographicProjection>()
         .register_type::<PerspectiveProjection>()
         .register_type::<MainPass>()
@@ -173,6 +185,7 @@ impl Plugin for RenderPlugin {
         .init_resource::<Msaa>()
         .init_resource::<RenderResourceBindings>()
         .init_resource::<AssetRenderResourceBindings>()
+        .init_resource::<StagingRing>()
         .init_resource::<ActiveCameras>()
         .add_startup_system_to_stage(
             StartupStage::PreStartup,
@@ -218,13 +231,33 @@ impl Plugin for RenderPlugin {
             RenderStage::RenderGraphSystems,
             render_graph::render_graph_schedule_executor_system.exclusive_system(),
         )
+        .add_system_to_stage(
+            RenderStage::Draw,
+            pipeline::pipeline_warm_up_system.system(),
+        )
         .add_system_to_stage(
             RenderStage::Draw,
             pipeline::draw_render_pipelines_system.system(),
         )
+        .add_system_to_stage(
+            RenderStage::Draw,
+            pipeline::draw_instanced_render_pipelines_system
+                .system()
+                .label(RenderSystem::DrawInstanced),
+        )
+        .add_system_to_stage(
+            RenderStage::Draw,
+            renderer::staging_ring_finish_system
+                .system()
+                .after(RenderSystem::DrawInstanced),
+        )
         .add_system_to_stage(
             RenderStage::PostRender,
             shader::clear_shader_defs_system.system(),
+        )
+        .add_system_to_stage(
+            RenderStage::PostRender,
+            renderer::staging_ring_begin_system.system(),
         );
 
         if let Some(ref config) = self.base_render_graph_config {
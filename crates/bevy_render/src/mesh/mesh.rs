@@ -1,8 +1,13 @@
 mod conversions;
 
 use crate::{
+    camera::Aabb,
     pipeline::{IndexFormat, PrimitiveTopology, RenderPipelines, VertexFormat},
-    renderer::{BufferInfo, BufferUsage, RenderResourceContext, RenderResourceId},
+    render_graph::CommandQueue,
+    renderer::{
+        BufferInfo, BufferUsage, DynamicBuffer, RenderResourceContext, RenderResourceId,
+        SharedBuffers, StagingRing,
+    },
 };
 use bevy_asset::{AssetEvent, Assets, Handle};
 use bevy_core::cast_slice;
@@ -10,7 +15,7 @@ use bevy_ecs::{
     entity::Entity,
     event::EventReader,
     query::{Changed, With},
-    system::{Local, Query, QuerySet, Res},
+    system::{Local, Query, QuerySet, Res, ResMut},
     world::Mut,
 };
 use bevy_math::*;
@@ -229,6 +234,7 @@ pub struct Mesh {
     /// which allows easy stable VertexBuffers (i.e. same buffer order)
     attributes: BTreeMap<Cow<'static, str>, VertexAttributeValues>,
     indices: Option<Indices>,
+    dynamic: bool,
 }
 
 /// Contains geometry in the form of a mesh.
@@ -275,6 +281,7 @@ impl Mesh {
             primitive_topology,
             attributes: Default::default(),
             indices: None,
+            dynamic: false,
         }
     }
 
@@ -282,6 +289,18 @@ impl Mesh {
         self.primitive_topology
     }
 
+    /// Whether the mesh keeps its gpu buffers when it is modified. See [`Mesh::set_dynamic`].
+    pub fn is_dynamic(&self) -> bool {
+        self.dynamic
+    }
+
+    /// Dynamic meshes keep their gpu buffers when they are modified and only upload the parts of
+    /// their vertex and index data that changed. Use this for meshes that are modified every
+    /// frame, like procedurally deformed meshes. Other meshes get new buffers on each change.
+    pub fn set_dynamic(&mut self, dynamic: bool) {
+        self.dynamic = dynamic;
+    }
+
     /// Sets the data for a vertex attribute (position, normal etc.). The name will
     /// often be one of the associated constants such as [`Mesh::ATTRIBUTE_POSITION`]
     pub fn set_attribute(
@@ -364,6 +383,14 @@ impl Mesh {
     }
 
     pub fn get_vertex_buffer_data(&self) -> Vec<u8> {
+        let mut attributes_interleaved_buffer = Vec::new();
+        self.write_vertex_buffer_data(&mut attributes_interleaved_buffer);
+        attributes_interleaved_buffer
+    }
+
+    /// Writes the interleaved vertex data into `attributes_interleaved_buffer`, replacing its
+    /// contents but reusing its allocation.
+    pub fn write_vertex_buffer_data(&self, attributes_interleaved_buffer: &mut Vec<u8>) {
         let mut vertex_size = 0;
         for attribute_values in self.attributes.values() {
             let vertex_format = VertexFormat::from(attribute_values);
@@ -371,7 +398,8 @@ impl Mesh {
         }
 
         let vertex_count = self.count_vertices();
-        let mut attributes_interleaved_buffer = vec![0; vertex_count * vertex_size];
+        attributes_interleaved_buffer.clear();
+        attributes_interleaved_buffer.resize(vertex_count * vertex_size, 0);
         // bundle into interleaved buffers
         let mut attribute_offset = 0;
         for attribute_values in self.attributes.values() {
@@ -388,8 +416,6 @@ impl Mesh {
 
             attribute_offset += attribute_size;
         }
-
-        attributes_interleaved_buffer
     }
 
     /// Duplicates the vertex attributes so that no vertices are shared.
@@ -445,6 +471,19 @@ impl Mesh {
         }
     }
 
+    /// Computes the bounding box of the mesh's [`Mesh::ATTRIBUTE_POSITION`]s in model space.
+    ///
+    /// Returns `None` if the mesh has no positions or they aren't of type `float3`.
+    pub fn compute_aabb(&self) -> Option<Aabb> {
+        let positions = self.attribute(Mesh::ATTRIBUTE_POSITION)?.as_float3()?;
+        let mut positions = positions.iter().map(|position| Vec3::from(*position));
+        let first = positions.next()?;
+        let (min, max) = positions.fold((first, first), |(min, max), position| {
+            (min.min(position), max.max(position))
+        });
+        Some(Aabb::from_min_max(min, max))
+    }
+
     /// Calculates the [`Mesh::ATTRIBUTE_NORMAL`] of a mesh.
     ///
     /// Panics if [`Indices`] are set.
@@ -500,9 +539,23 @@ pub struct MeshEntities {
     entities: HashSet<Entity>,
 }
 
+/// The gpu buffers of a [dynamic](Mesh::set_dynamic) mesh
+struct DynamicMeshBuffers {
+    vertex_buffer: Option<DynamicBuffer>,
+    index_buffer: Option<DynamicBuffer>,
+    /// What the entities of the mesh were last set up with, they only need to be updated when it
+    /// changes
+    layout: VertexBufferLayout,
+    primitive_topology: PrimitiveTopology,
+    index_format: Option<IndexFormat>,
+}
+
 #[derive(Default)]
 pub struct MeshResourceProviderState {
     mesh_entities: HashMap<Handle<Mesh>, MeshEntities>,
+    dynamic_meshes: HashMap<Handle<Mesh>, DynamicMeshBuffers>,
+    /// Reused for the interleaved vertex data of dynamic meshes
+    vertex_data: Vec<u8>,
 }
 
 #[allow(clippy::type_complexity)]
@@ -510,6 +563,8 @@ pub fn mesh_resource_provider_system(
     mut state: Local<MeshResourceProviderState>,
     render_resource_context: Res<Box<dyn RenderResourceContext>>,
     meshes: Res<Assets<Mesh>>,
+    staging_ring: Res<StagingRing>,
+    mut shared_buffers: Option<ResMut<SharedBuffers>>,
     mut mesh_events: EventReader<AssetEvent<Mesh>>,
     mut queries: QuerySet<(
         Query<&mut RenderPipelines, With<Handle<Mesh>>>,
@@ -525,10 +580,14 @@ pub fn mesh_resource_provider_system(
             }
             AssetEvent::Modified { ref handle } => {
                 changed_meshes.insert(handle.clone_weak());
-                remove_current_mesh_resources(render_resource_context, handle);
+                // dynamic meshes update their buffers in place
+                if !state.dynamic_meshes.contains_key(handle) {
+                    remove_current_mesh_resources(render_resource_context, handle);
+                }
             }
             AssetEvent::Removed { ref handle } => {
                 remove_current_mesh_resources(render_resource_context, handle);
+                state.dynamic_meshes.remove(handle);
                 // if mesh was modified and removed in the same update, ignore the modification
                 // events are ordered so future modification events are ok
                 changed_meshes.remove(handle);
@@ -539,36 +598,26 @@ pub fn mesh_resource_provider_system(
     // update changed mesh data
     for changed_mesh_handle in changed_meshes.iter() {
         if let Some(mesh) = meshes.get(changed_mesh_handle) {
-            // TODO: check for individual buffer changes in non-interleaved mode
-            if let Some(data) = mesh.get_index_buffer_bytes() {
-                let index_buffer = render_resource_context.create_buffer_with_data(
-                    BufferInfo {
-                        buffer_usage: BufferUsage::INDEX,
-                        ..Default::default()
-                    },
-                    &data,
-                );
-
-                render_resource_context.set_asset_resource(
-                    changed_mesh_handle,
-                    RenderResourceId::Buffer(index_buffer),
-                    INDEX_BUFFER_ASSET_INDEX,
-                );
-            }
-
-            let interleaved_buffer = mesh.get_vertex_buffer_data();
-            if !interleaved_buffer.is_empty() {
-                render_resource_context.set_asset_resource(
+            // uploads into existing buffers are copied by the shared buffers node
+            if let (true, Some(shared_buffers)) = (mesh.is_dynamic(), &mut shared_buffers) {
+                let state = &mut *state;
+                let entities_changed = update_dynamic_mesh(
+                    render_resource_context,
+                    &staging_ring,
+                    shared_buffers.command_queue_mut(),
+                    &mut state.dynamic_meshes,
+                    &mut state.vertex_data,
+                    mesh,
                     changed_mesh_handle,
-                    RenderResourceId::Buffer(render_resource_context.create_buffer_with_data(
-                        BufferInfo {
-                            buffer_usage: BufferUsage::VERTEX,
-                            ..Default::default()
-                        },
-                        &interleaved_buffer,
-                    )),
-                    VERTEX_ATTRIBUTE_BUFFER_ID,
                 );
+                if !entities_changed {
+                    continue;
+                }
+            } else {
+                if state.dynamic_meshes.remove(changed_mesh_handle).is_some() {
+                    remove_current_mesh_resources(render_resource_context, changed_mesh_handle);
+                }
+                create_mesh_buffers(render_resource_context, mesh, changed_mesh_handle);
             }
 
             if let Some(mesh_entities) = state.mesh_entities.get_mut(changed_mesh_handle) {
@@ -599,6 +648,124 @@ pub fn mesh_resource_provider_system(
     }
 }
 
+fn create_mesh_buffers(
+    render_resource_context: &dyn RenderResourceContext,
+    mesh: &Mesh,
+    handle: &Handle<Mesh>,
+) {
+    // TODO: check for individual buffer changes in non-interleaved mode
+    if let Some(data) = mesh.get_index_buffer_bytes() {
+        let index_buffer = render_resource_context.create_buffer_with_data(
+            BufferInfo {
+                buffer_usage: BufferUsage::INDEX,
+                ..Default::default()
+            },
+            &data,
+        );
+
+        render_resource_context.set_asset_resource(
+            handle,
+            RenderResourceId::Buffer(index_buffer),
+            INDEX_BUFFER_ASSET_INDEX,
+        );
+    }
+
+    let interleaved_buffer = mesh.get_vertex_buffer_data();
+    if !interleaved_buffer.is_empty() {
+        render_resource_context.set_asset_resource(
+            handle,
+            RenderResourceId::Buffer(render_resource_context.create_buffer_with_data(
+                BufferInfo {
+                    buffer_usage: BufferUsage::VERTEX,
+                    ..Default::default()
+                },
+                &interleaved_buffer,
+            )),
+            VERTEX_ATTRIBUTE_BUFFER_ID,
+        );
+    }
+}
+
+/// Uploads the changes of a dynamic mesh into its buffers, creating them if needed. Returns
+/// whether the entities using the mesh have to be updated.
+fn update_dynamic_mesh(
+    render_resource_context: &dyn RenderResourceContext,
+    staging_ring: &StagingRing,
+    command_queue: &mut CommandQueue,
+    dynamic_meshes: &mut HashMap<Handle<Mesh>, DynamicMeshBuffers>,
+    vertex_data: &mut Vec<u8>,
+    mesh: &Mesh,
+    handle: &Handle<Mesh>,
+) -> bool {
+    let layout = mesh.get_vertex_buffer_layout();
+    let index_format = mesh.indices().map(IndexFormat::from);
+    let buffers = dynamic_meshes
+        .entry(handle.clone_weak())
+        .or_insert_with(|| DynamicMeshBuffers {
+            vertex_buffer: None,
+            index_buffer: None,
+            layout: layout.clone(),
+            primitive_topology: mesh.primitive_topology,
+            index_format,
+        });
+
+    let mut entities_changed = buffers.layout != layout
+        || buffers.primitive_topology != mesh.primitive_topology
+        || buffers.index_format != index_format;
+    buffers.layout = layout;
+    buffers.primitive_topology = mesh.primitive_topology;
+    buffers.index_format = index_format;
+
+    mesh.write_vertex_buffer_data(vertex_data);
+    let mut update_buffer = |buffer: &mut Option<DynamicBuffer>,
+                             usage: BufferUsage,
+                             data: Option<&[u8]>,
+                             index: u64| {
+        let data = data.filter(|data| !data.is_empty());
+        let created = match (buffer.is_some(), data) {
+            (true, Some(data)) => !buffer.as_mut().unwrap().update(
+                render_resource_context,
+                staging_ring,
+                command_queue,
+                data,
+            ),
+            (false, Some(data)) => {
+                *buffer = Some(DynamicBuffer::new(render_resource_context, usage, data));
+                true
+            }
+            (true, None) => {
+                buffer.take().unwrap().remove(render_resource_context);
+                render_resource_context.remove_asset_resource(handle, index);
+                entities_changed = true;
+                false
+            }
+            (false, None) => false,
+        };
+        if created {
+            let buffer = buffer.as_ref().unwrap().buffer;
+            render_resource_context.set_asset_resource(
+                handle,
+                RenderResourceId::Buffer(buffer),
+                index,
+            );
+            entities_changed = true;
+        }
+    };
+    update_buffer(
+        &mut buffers.index_buffer,
+        BufferUsage::INDEX,
+        mesh.get_index_buffer_bytes(),
+        INDEX_BUFFER_ASSET_INDEX,
+    );
+    update_buffer(
+        &mut buffers.vertex_buffer,
+        BufferUsage::VERTEX,
+        Some(&vertex_data[..]),
+        VERTEX_ATTRIBUTE_BUFFER_ID,
+    );
+    entities_changed
+}
+
 fn update_entity_mesh(
     render_resource_context: &dyn RenderResourceContext,
     mesh: &Mesh,
@@ -0,0 +1,333 @@
+use super::{
+    render_pipelines::update_pipeline_specializations, InputStepMode, RenderPipeline,
+    RenderPipelines, VertexAttribute, VertexBufferLayout, VertexFormat,
+};
+use crate::{
+    camera::RenderLayers,
+    draw::{Draw, DrawContext, DrawError, OutsideFrustum},
+    mesh::{Indices, Mesh},
+    prelude::{Msaa, Visible},
+    renderer::{BufferUsage, DynamicBuffer, RenderResourceBindings, StagingRing},
+};
+use bevy_asset::{Assets, Handle, HandleId};
+use bevy_core::cast_slice;
+use bevy_ecs::{
+    entity::Entity,
+    query::{With, Without},
+    reflect::ReflectComponent,
+    system::{Local, Query, Res, ResMut},
+};
+use bevy_reflect::Reflect;
+use bevy_transform::components::GlobalTransform;
+use bevy_utils::{AHasher, HashMap};
+use std::{
+    hash::{Hash, Hasher},
+    ops::Range,
+};
+
+/// The vertex buffer slot the instance buffer is bound to. Slot 0 holds the mesh vertex buffer.
+pub const INSTANCE_BUFFER_SLOT: u32 = 1;
+
+/// The per instance attributes provided by the instance buffer: the columns of the entity's
+/// [`GlobalTransform`] matrix
+pub const INSTANCE_MODEL_ATTRIBUTES: [&str; 4] = [
+    "I_Model_Col0",
+    "I_Model_Col1",
+    "I_Model_Col2",
+    "I_Model_Col3",
+];
+
+/// The shader def set on the pipelines of [`Instanced`] entities
+pub const INSTANCED_SHADER_DEF: &str = "INSTANCED";
+
+const INSTANCE_FLOATS: usize = 16;
+
+/// A component that draws an entity through the instanced path.
+///
+/// Visible entities that share a mesh, asset bindings (ex: a material) and pipeline
+/// specialization are merged into a single instanced draw call. Their pipelines are specialized
+/// with [`INSTANCED_SHADER_DEF`] and must read the model matrix from the
+/// [`INSTANCE_MODEL_ATTRIBUTES`] vertex attributes instead of a per entity `Transform` uniform.
+#[derive(Debug, Default, Clone, Reflect)]
+#[reflect(Component)]
+pub struct Instanced;
+
+/// The layout of the instance buffer written by [`draw_instanced_render_pipelines_system`]
+pub fn instance_buffer_layout() -> VertexBufferLayout {
+    let format = VertexFormat::Float32x4;
+    VertexBufferLayout {
+        name: "Instance".into(),
+        stride: format.get_size() * INSTANCE_MODEL_ATTRIBUTES.len() as u64,
+        step_mode: InputStepMode::Instance,
+        attributes: INSTANCE_MODEL_ATTRIBUTES
+            .iter()
+            .enumerate()
+            .map(|(i, name)| VertexAttribute {
+                name: (*name).into(),
+                format,
+                offset: format.get_size() * i as u64,
+                shader_location: 0,
+            })
+            .collect(),
+    }
+}
+
+struct InstanceBatch {
+    representative: Entity,
+    mesh: HandleId,
+    assets: Vec<HandleId>,
+    render_layers: Option<RenderLayers>,
+    pipelines: Vec<RenderPipeline>,
+    instances: Vec<f32>,
+    instance_range: Range<u32>,
+}
+
+impl InstanceBatch {
+    fn matches(
+        &self,
+        mesh: HandleId,
+        render_layers: Option<RenderLayers>,
+        render_pipelines: &RenderPipelines,
+    ) -> bool {
+        self.mesh == mesh
+            && self.render_layers == render_layers
+            && self.pipelines.len() == render_pipelines.pipelines.len()
+            && self
+                .pipelines
+                .iter()
+                .zip(render_pipelines.pipelines.iter())
+                .all(|(a, b)| a.pipeline == b.pipeline && a.specialization == b.specialization)
+            && self.assets.len() == render_pipelines.bindings.iter_assets().count()
+            && render_pipelines
+                .bindings
+                .iter_assets()
+                .all(|(handle, _)| self.assets.contains(&handle.id))
+    }
+}
+
+/// Hashes the mesh and asset bindings of an entity. Asset bindings are unordered, so their hashes
+/// are combined commutatively.
+fn batch_key(mesh: HandleId, bindings: &RenderResourceBindings) -> u64 {
+    let mut hasher = AHasher::default();
+    mesh.hash(&mut hasher);
+    bindings
+        .iter_assets()
+        .fold(hasher.finish(), |key, (handle, _)| {
+            let mut hasher = AHasher::default();
+            handle.id.hash(&mut hasher);
+            key.wrapping_add(hasher.finish())
+        })
+}
+
+#[derive(Default)]
+pub struct InstancingState {
+    batches: Vec<InstanceBatch>,
+    batch_lookup: HashMap<u64, Vec<usize>>,
+    instance_data: Vec<f32>,
+    instance_buffer: Option<DynamicBuffer>,
+}
+
+/// Groups visible [`Instanced`] entities into batches, packs their transforms into a single
+/// instance buffer and records one instanced draw per batch on the batch's first entity
+#[allow(clippy::type_complexity)]
+pub fn draw_instanced_render_pipelines_system(
+    mut state: Local<InstancingState>,
+    mut draw_context: DrawContext,
+    mut render_resource_bindings: ResMut<RenderResourceBindings>,
+    msaa: Res<Msaa>,
+    meshes: Res<Assets<Mesh>>,
+    staging_ring: Res<StagingRing>,
+    mut query: Query<
+        (
+            Entity,
+            &mut Draw,
+            &mut RenderPipelines,
+            &Handle<Mesh>,
+            &Visible,
+            &GlobalTransform,
+            Option<&RenderLayers>,
+        ),
+        (With<Instanced>, Without<OutsideFrustum>),
+    >,
+) {
+    let state = &mut *state;
+    state.batches.clear();
+    state.batch_lookup.clear();
+
+    for (entity, _draw, mut render_pipelines, mesh_handle, visible, global_transform, layers) in
+        query.iter_mut()
+    {
+        // don't render if the mesh isn't loaded yet
+        if !visible.is_visible || meshes.get(mesh_handle).is_none() {
+            continue;
+        }
+
+        let render_pipelines = &mut *render_pipelines;
+        for render_pipeline in render_pipelines.pipelines.iter_mut() {
+            let shader_defs = &mut render_pipeline
+                .specialization
+                .shader_specialization
+                .shader_defs;
+            if !shader_defs.contains(INSTANCED_SHADER_DEF) {
+                shader_defs.insert(INSTANCED_SHADER_DEF.to_string());
+            }
+        }
+        update_pipeline_specializations(
+            render_pipelines,
+            &msaa,
+            &draw_context.asset_render_resource_bindings,
+        );
+
+        let model = global_transform.compute_matrix().to_cols_array();
+        let render_layers = layers.copied();
+        let batches = &mut state.batches;
+        // transparent entities are depth sorted individually, so they are never merged
+        let candidates = if visible.is_transparent {
+            None
+        } else {
+            Some(
+                state
+                    .batch_lookup
+                    .entry(batch_key(mesh_handle.id, &render_pipelines.bindings))
+                    .or_insert_with(Vec::new),
+            )
+        };
+
+        let existing_batch = candidates.as_ref().and_then(|candidates| {
+            candidates.iter().copied().find(|index| {
+                batches[*index].matches(mesh_handle.id, render_layers, render_pipelines)
+            })
+        });
+        match existing_batch {
+            Some(index) => batches[index].instances.extend_from_slice(&model),
+            None => {
+                if let Some(candidates) = candidates {
+                    candidates.push(batches.len());
+                }
+                batches.push(InstanceBatch {
+                    representative: entity,
+                    mesh: mesh_handle.id,
+                    assets: render_pipelines
+                        .bindings
+                        .iter_assets()
+                        .map(|(handle, _)| handle.id)
+                        .collect(),
+                    render_layers,
+                    pipelines: render_pipelines.pipelines.clone(),
+                    instances: model.to_vec(),
+                    instance_range: 0..0,
+                });
+            }
+        }
+    }
+
+    // pack every batch into one contiguous instance buffer
+    state.instance_data.clear();
+    for batch in state.batches.iter_mut() {
+        let start = (state.instance_data.len() / INSTANCE_FLOATS) as u32;
+        state.instance_data.extend_from_slice(&batch.instances);
+        let end = (state.instance_data.len() / INSTANCE_FLOATS) as u32;
+        batch.instance_range = start..end;
+    }
+
+    // the instance buffer is kept across frames, only the blocks of instances that changed are
+    // copied into it by the shared buffers node
+    let render_resource_context = &**draw_context.render_resource_context;
+    if state.instance_data.is_empty() {
+        if let Some(instance_buffer) = state.instance_buffer.take() {
+            instance_buffer.remove(render_resource_context);
+        }
+        return;
+    }
+    let instance_data = cast_slice(&state.instance_data);
+    let instance_buffer = match state.instance_buffer {
+        Some(ref mut instance_buffer) => {
+            instance_buffer.update(
+                render_resource_context,
+                &staging_ring,
+                draw_context.shared_buffers.command_queue_mut(),
+                instance_data,
+            );
+            instance_buffer.buffer
+        }
+        None => {
+            let instance_buffer =
+                DynamicBuffer::new(render_resource_context, BufferUsage::VERTEX, instance_data);
+            state.instance_buffer.get_or_insert(instance_buffer).buffer
+        }
+    };
+
+    for batch in state.batches.iter() {
+        let (_, mut draw, mut render_pipelines, mesh_handle, _, _, _) =
+            if let Ok(item) = query.get_mut(batch.representative) {
+                item
+            } else {
+                continue;
+            };
+        let mesh = meshes.get(mesh_handle).unwrap();
+        let index_range = match mesh.indices() {
+            Some(Indices::U32(indices)) => Some(0..indices.len() as u32),
+            Some(Indices::U16(indices)) => Some(0..indices.len() as u32),
+            None => None,
+        };
+
+        let render_pipelines = &mut *render_pipelines;
+        for render_pipeline in render_pipelines.pipelines.iter() {
+            let render_resource_bindings = &mut [
+                &mut render_pipelines.bindings,
+                &mut render_resource_bindings,
+            ];
+            match draw_context.set_pipeline(
+                &mut draw,
+                &render_pipeline.pipeline,
+                &render_pipeline.specialization,
+            ) {
+                Ok(()) => {}
+                // skip drawing until the pipeline is compiled
+                Err(DrawError::PipelineNotReady) => continue,
+                Err(err) => panic!("{}", err),
+            }
+            draw_context
+                .set_bind_groups_from_bindings(&mut draw, render_resource_bindings)
+                .unwrap();
+            draw_context
+                .set_vertex_buffers_from_bindings(&mut draw, &[&render_pipelines.bindings])
+                .unwrap();
+            draw.set_vertex_buffer(INSTANCE_BUFFER_SLOT, instance_buffer, 0);
+
+            if let Some(indices) = index_range.clone() {
+                draw.draw_indexed(indices, 0, batch.instance_range.clone());
+            } else {
+                draw.draw(
+                    0..mesh.count_vertices() as u32,
+                    batch.instance_range.clone(),
+                )
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn instance_buffer_layout_packs_model_matrix() {
+        let layout = instance_buffer_layout();
+        assert_eq!(layout.step_mode, InputStepMode::Instance);
+        assert_eq!(
+            layout.stride,
+            (INSTANCE_FLOATS * std::mem::size_of::<f32>()) as u64
+        );
+        let offsets = layout
+            .attributes
+            .iter()
+            .map(|attribute| attribute.offset)
+            .collect::<Vec<_>>();
+        assert_eq!(offsets, vec![0, 16, 32, 48]);
+        assert!(layout
+            .attributes
+            .iter()
+            .all(|attribute| attribute.name.starts_with("I_")));
+    }
+}
@@ -1,9 +1,11 @@
 mod bind_group;
 mod binding;
+mod instancing;
 #[allow(clippy::module_inception)]
 mod pipeline;
 mod pipeline_compiler;
 mod pipeline_layout;
+mod pipeline_manifest;
 mod render_pipelines;
 mod state_descriptors;
 mod vertex_buffer_descriptor;
@@ -11,9 +13,11 @@ mod vertex_format;
 
 pub use bind_group::*;
 pub use binding::*;
+pub use instancing::*;
 pub use pipeline::*;
 pub use pipeline_compiler::*;
 pub use pipeline_layout::*;
+pub use pipeline_manifest::*;
 pub use render_pipelines::*;
 pub use state_descriptors::*;
 pub use vertex_buffer_descriptor::*;
@@ -1,16 +1,18 @@
 use super::{state_descriptors::PrimitiveTopology, IndexFormat, PipelineDescriptor};
 use crate::{
-    pipeline::{BindType, VertexBufferLayout},
+    pipeline::{instance_buffer_layout, BindType, InputStepMode, VertexBufferLayout},
     renderer::RenderResourceContext,
-    shader::{Shader, ShaderError},
+    shader::{Shader, ShaderCache, ShaderError},
 };
 use bevy_asset::{Assets, Handle};
 use bevy_reflect::{Reflect, ReflectDeserialize};
 use bevy_utils::{HashMap, HashSet};
 use once_cell::sync::Lazy;
 use serde::{Deserialize, Serialize};
+#[cfg(not(target_arch = "wasm32"))]
+use {crate::shader::ShaderSource, bevy_tasks::TaskPool, parking_lot::Mutex, std::sync::Arc};
 
-#[derive(Clone, Eq, PartialEq, Debug, Reflect)]
+#[derive(Clone, Eq, PartialEq, Debug, Reflect, Serialize, Deserialize)]
 #[reflect(PartialEq)]
 pub struct PipelineSpecialization {
     pub shader_specialization: ShaderSpecialization,
@@ -59,14 +61,42 @@ struct SpecializedPipeline {
     specialization: PipelineSpecialization,
 }
 
+/// A shader specialization being compiled on a task pool. The task fills `result` when it is done.
+#[cfg(not(target_arch = "wasm32"))]
+#[derive(Debug)]
+struct PendingShader {
+    specialization: ShaderSpecialization,
+    result: Arc<Mutex<Option<Result<Shader, ShaderError>>>>,
+}
+
 #[derive(Debug, Default)]
 pub struct PipelineCompiler {
     specialized_shaders: HashMap<Handle<Shader>, Vec<SpecializedShader>>,
     specialized_shader_pipelines: HashMap<Handle<Shader>, Vec<Handle<PipelineDescriptor>>>,
     specialized_pipelines: HashMap<Handle<PipelineDescriptor>, Vec<SpecializedPipeline>>,
+    #[cfg(not(target_arch = "wasm32"))]
+    pending_shaders: HashMap<Handle<Shader>, Vec<PendingShader>>,
+    shader_cache: Option<ShaderCache>,
 }
 
 impl PipelineCompiler {
+    /// Caches compiled shaders on disk with the given [`ShaderCache`], see
+    /// [`PipelineCompiler::set_shader_cache`]
+    pub fn with_shader_cache(mut self, shader_cache: ShaderCache) -> Self {
+        self.shader_cache = Some(shader_cache);
+        self
+    }
+
+    /// Sets the on-disk cache consulted before compiling GLSL shaders to SPIR-V. Shaders compiled
+    /// afterwards are written to it.
+    pub fn set_shader_cache(&mut self, shader_cache: Option<ShaderCache>) {
+        self.shader_cache = shader_cache;
+    }
+
+    pub fn shader_cache(&self) -> Option<&ShaderCache> {
+        self.shader_cache.as_ref()
+    }
+
     fn compile_shader(
         &mut self,
         render_resource_context: &dyn RenderResourceContext,
@@ -97,8 +127,12 @@ impl PipelineCompiler {
                 .iter()
                 .cloned()
                 .collect::<Vec<String>>();
-            let compiled_shader =
-                render_resource_context.get_specialized_shader(shader, Some(&shader_def_vec))?;
+            let compiled_shader = specialize_shader(
+                self.shader_cache.as_ref(),
+                render_resource_context,
+                shader,
+                &shader_def_vec,
+            )?;
             let specialized_handle = shaders.add(compiled_shader);
             let weak_specialized_handle = specialized_handle.clone_weak();
             specialized_shaders.push(SpecializedShader {
@@ -210,13 +244,41 @@ impl PipelineCompiler {
             ..Default::default()
         };
 
-        for shader_vertex_attribute in pipeline_layout.vertex_buffer_descriptors.iter() {
-            let shader_vertex_attribute = shader_vertex_attribute
+        // instance rate attributes ("I_" prefixed) are sourced from the instance buffer written by
+        // the instanced draw path instead of the mesh
+        let instance_vertex_buffer_layout = instance_buffer_layout();
+        let mut compiled_instance_buffer_descriptor = VertexBufferLayout {
+            name: instance_vertex_buffer_layout.name.clone(),
+            step_mode: InputStepMode::Instance,
+            stride: instance_vertex_buffer_layout.stride,
+            ..Default::default()
+        };
+
+        for shader_vertex_buffer_layout in pipeline_layout.vertex_buffer_descriptors.iter() {
+            let shader_vertex_attribute = shader_vertex_buffer_layout
                 .attributes
                 .get(0)
                 .expect("Reflected layout has no attributes.");
 
-            if let Some(target_vertex_attribute) = mesh_vertex_buffer_layout
+            if shader_vertex_buffer_layout.step_mode == InputStepMode::Instance {
+                if let Some(target_instance_attribute) = instance_vertex_buffer_layout
+                    .attributes
+                    .iter()
+                    .find(|x| x.name == shader_vertex_attribute.name)
+                {
+                    let mut compiled_instance_attribute = target_instance_attribute.clone();
+                    compiled_instance_attribute.shader_location =
+                        shader_vertex_attribute.shader_location;
+                    compiled_instance_buffer_descriptor
+                        .attributes
+                        .push(compiled_instance_attribute);
+                } else {
+                    panic!(
+                        "Instance attribute {} is required by shader, but not supplied by the instance buffer.",
+                        shader_vertex_attribute.name,
+                    );
+                }
+            } else if let Some(target_vertex_attribute) = mesh_vertex_buffer_layout
                 .attributes
                 .iter()
                 .find(|x| x.name == shader_vertex_attribute.name)
@@ -236,11 +298,14 @@ impl PipelineCompiler {
             }
         }
 
-        // TODO: add other buffers (like instancing) here
         let mut vertex_buffer_descriptors = Vec::<VertexBufferLayout>::default();
         if !pipeline_layout.vertex_buffer_descriptors.is_empty() {
             vertex_buffer_descriptors.push(compiled_vertex_buffer_descriptor);
         }
+        // the instance buffer is always bound to slot 1, see `INSTANCE_BUFFER_SLOT`
+        if !compiled_instance_buffer_descriptor.attributes.is_empty() {
+            vertex_buffer_descriptors.push(compiled_instance_buffer_descriptor);
+        }
 
         pipeline_layout.vertex_buffer_descriptors = vertex_buffer_descriptors;
         specialized_descriptor.multisample.count = pipeline_specialization.sample_count;
@@ -280,6 +345,136 @@ impl PipelineCompiler {
         weak_specialized_pipeline_handle
     }
 
+    /// Like [`PipelineCompiler::compile_pipeline`], but GLSL shader stages are compiled to SPIR-V on
+    /// `task_pool` instead of blocking the caller. Returns `None` while any stage (or its source
+    /// asset) is not ready yet; once they all are, the pipeline is created on a later call.
+    #[cfg(not(target_arch = "wasm32"))]
+    pub fn compile_pipeline_async(
+        &mut self,
+        task_pool: &TaskPool,
+        render_resource_context: &dyn RenderResourceContext,
+        pipelines: &mut Assets<PipelineDescriptor>,
+        shaders: &mut Assets<Shader>,
+        source_pipeline: &Handle<PipelineDescriptor>,
+        pipeline_specialization: &PipelineSpecialization,
+    ) -> Option<Handle<PipelineDescriptor>> {
+        if let Some(specialized_pipeline) =
+            self.get_specialized_pipeline(source_pipeline, pipeline_specialization)
+        {
+            return Some(specialized_pipeline);
+        }
+
+        let shader_stages = &pipelines.get(source_pipeline)?.shader_stages;
+        let vertex = shader_stages.vertex.clone_weak();
+        let fragment = shader_stages.fragment.as_ref().map(Handle::clone_weak);
+        let shader_specialization = &pipeline_specialization.shader_specialization;
+        // poll both stages before bailing out, so they compile in parallel
+        let vertex_ready = self.poll_shader(task_pool, shaders, &vertex, shader_specialization);
+        let fragment_ready = fragment.map_or(true, |fragment| {
+            self.poll_shader(task_pool, shaders, &fragment, shader_specialization)
+        });
+        if !vertex_ready || !fragment_ready {
+            return None;
+        }
+
+        Some(self.compile_pipeline(
+            render_resource_context,
+            pipelines,
+            shaders,
+            source_pipeline,
+            pipeline_specialization,
+        ))
+    }
+
+    /// Returns true if `shader_handle` can be specialized without compiling GLSL. Otherwise starts
+    /// compiling it on `task_pool`, or collects the compiled shader once that task is done.
+    #[cfg(not(target_arch = "wasm32"))]
+    fn poll_shader(
+        &mut self,
+        task_pool: &TaskPool,
+        shaders: &mut Assets<Shader>,
+        shader_handle: &Handle<Shader>,
+        shader_specialization: &ShaderSpecialization,
+    ) -> bool {
+        let shader = if let Some(shader) = shaders.get(shader_handle) {
+            shader
+        } else {
+            return false;
+        };
+        if let ShaderSource::Spirv(_) = shader.source {
+            return true;
+        }
+        let is_specialized =
+            self.specialized_shaders
+                .get(shader_handle)
+                .map_or(false, |specialized_shaders| {
+                    specialized_shaders.iter().any(|specialized_shader| {
+                        specialized_shader.specialization == *shader_specialization
+                    })
+                });
+        if is_specialized {
+            return true;
+        }
+
+        let pending_shaders = self
+            .pending_shaders
+            .entry(shader_handle.clone_weak())
+            .or_insert_with(Vec::new);
+        if let Some(index) = pending_shaders
+            .iter()
+            .position(|pending_shader| pending_shader.specialization == *shader_specialization)
+        {
+            let result = pending_shaders[index].result.lock().take();
+            if let Some(result) = result {
+                pending_shaders.swap_remove(index);
+                let compiled_shader = result.unwrap_or_else(|e| panic_shader_error(e));
+                self.specialized_shaders
+                    .entry(shader_handle.clone_weak())
+                    .or_insert_with(Vec::new)
+                    .push(SpecializedShader {
+                        shader: shaders.add(compiled_shader),
+                        specialization: shader_specialization.clone(),
+                    });
+                true
+            } else {
+                false
+            }
+        } else {
+            let result = Arc::new(Mutex::new(None));
+            let task_result = result.clone();
+            let shader = shader.clone();
+            let shader_cache = self.shader_cache.clone();
+            let shader_def_vec = shader_specialization
+                .shader_defs
+                .iter()
+                .cloned()
+                .collect::<Vec<String>>();
+            task_pool
+                .spawn(async move {
+                    let compiled_shader = shader_cache
+                        .as_ref()
+                        .and_then(|shader_cache| shader_cache.load(&shader, &shader_def_vec))
+                        .map(Ok)
+                        .unwrap_or_else(|| {
+                            let compiled_shader = shader.get_spirv_shader(Some(&shader_def_vec));
+                            if let (Some(shader_cache), Ok(compiled_shader)) =
+                                (shader_cache.as_ref(), compiled_shader.as_ref())
+                            {
+                                shader_cache.store(&shader, &shader_def_vec, compiled_shader);
+                            }
+                            compiled_shader
+                        });
+                    *task_result.lock() = Some(compiled_shader);
+                })
+                .detach();
+            pending_shaders.push(PendingShader {
+                specialization: shader_specialization.clone(),
+                result,
+            });
+            false
+        }
+    }
+
     pub fn iter_compiled_pipelines(
         &self,
         pipeline_handle: Handle<PipelineDescriptor>,
@@ -293,6 +488,22 @@ impl PipelineCompiler {
             })
     }
 
+    /// Iterates the source pipeline and specialization of every compiled pipeline
+    pub fn iter_specializations(
+        &self,
+    ) -> impl Iterator<Item = (&Handle<PipelineDescriptor>, &PipelineSpecialization)> {
+        self.specialized_pipelines
+            .iter()
+            .map(|(source_pipeline, specialized_pipelines)| {
+                specialized_pipelines
+                    .iter()
+                    .map(move |specialized_pipeline| {
+                        (source_pipeline, &specialized_pipeline.specialization)
+                    })
+            })
+            .flatten()
+    }
+
     pub fn iter_all_compiled_pipelines(&self) -> impl Iterator<Item = &Handle<PipelineDescriptor>> {
         self.specialized_pipelines
             .values()
@@ -313,6 +524,10 @@ impl PipelineCompiler {
         shaders: &mut Assets<Shader>,
         render_resource_context: &dyn RenderResourceContext,
     ) -> Result<(), ShaderError> {
+        // compilations started from the old source are stale
+        #[cfg(not(target_arch = "wasm32"))]
+        self.pending_shaders.remove(shader);
+
         if let Some(specialized_shaders) = self.specialized_shaders.get_mut(shader) {
             for specialized_shader in specialized_shaders {
                 // Recompile specialized shader. If it fails, we bail immediately.
@@ -322,11 +537,12 @@ impl PipelineCompiler {
                     .iter()
                     .cloned()
                     .collect::<Vec<String>>();
-                let new_handle =
-                    shaders.add(render_resource_context.get_specialized_shader(
-                        shaders.get(shader).unwrap(),
-                        Some(&shader_def_vec),
-                    )?);
+                let new_handle = shaders.add(specialize_shader(
+                    self.shader_cache.as_ref(),
+                    render_resource_context,
+                    shaders.get(shader).unwrap(),
+                    &shader_def_vec,
+                )?);
 
                 // Replace handle and remove old from assets.
                 let old_handle = std::mem::replace(&mut specialized_shader.shader, new_handle);
@@ -357,6 +573,31 @@ impl PipelineCompiler {
     }
 }
 
+/// Specializes `shader` with the render resource context, going through `shader_cache` first
+fn specialize_shader(
+    shader_cache: Option<&ShaderCache>,
+    render_resource_context: &dyn RenderResourceContext,
+    shader: &Shader,
+    shader_defs: &[String],
+) -> Result<Shader, ShaderError> {
+    #[cfg(not(target_arch = "wasm32"))]
+    if let Some(cached_shader) =
+        shader_cache.and_then(|shader_cache| shader_cache.load(shader, shader_defs))
+    {
+        return Ok(cached_shader);
+    }
+
+    let compiled_shader =
+        render_resource_context.get_specialized_shader(shader, Some(shader_defs))?;
+    #[cfg(not(target_arch = "wasm32"))]
+    if let Some(shader_cache) = shader_cache {
+        shader_cache.store(shader, shader_defs, &compiled_shader);
+    }
+    #[cfg(target_arch = "wasm32")]
+    let _ = shader_cache;
+    Ok(compiled_shader)
+}
+
 fn panic_shader_error(error: ShaderError) -> ! {
     let msg = error.to_string();
     let msg = msg
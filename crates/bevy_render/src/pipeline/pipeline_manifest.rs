@@ -0,0 +1,276 @@
+use super::{PipelineCompiler, PipelineDescriptor, PipelineSpecialization};
+use crate::{renderer::RenderResourceContext, shader::Shader};
+use bevy_asset::{AssetServer, Assets, Handle, HandleId, LoadState};
+use bevy_ecs::system::{Res, ResMut};
+use bevy_tasks::AsyncComputeTaskPool;
+use bevy_utils::tracing::warn;
+use serde::{Deserialize, Serialize};
+use std::path::{Path, PathBuf};
+use thiserror::Error;
+
+/// A specialization of a source pipeline compiled during a previous session
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct PipelineManifestEntry {
+    pub pipeline: HandleId,
+    pub specialization: PipelineSpecialization,
+}
+
+/// The list of pipeline specializations an app compiled, used to compile them ahead of time on
+/// the next launch
+#[derive(Debug, Clone, Default, PartialEq, Serialize, Deserialize)]
+pub struct PipelineManifest {
+    pub pipelines: Vec<PipelineManifestEntry>,
+}
+
+#[derive(Error, Debug)]
+pub enum PipelineManifestError {
+    #[error("failed to access the pipeline manifest")]
+    Io(#[from] std::io::Error),
+    #[error("invalid pipeline manifest")]
+    Ron(#[from] ron::Error),
+}
+
+impl PipelineManifest {
+    /// Records every pipeline specialization compiled by `pipeline_compiler`
+    pub fn from_compiler(pipeline_compiler: &PipelineCompiler) -> Self {
+        Self {
+            pipelines: pipeline_compiler
+                .iter_specializations()
+                .map(|(pipeline, specialization)| PipelineManifestEntry {
+                    pipeline: pipeline.id,
+                    specialization: specialization.clone(),
+                })
+                .collect(),
+        }
+    }
+
+    pub fn load(path: &Path) -> Result<Self, PipelineManifestError> {
+        let bytes = std::fs::read(path)?;
+        Ok(ron::de::from_bytes(&bytes)?)
+    }
+
+    pub fn save(&self, path: &Path) -> Result<(), PipelineManifestError> {
+        let ron = ron::ser::to_string_pretty(self, Default::default())?;
+        std::fs::write(path, ron)?;
+        Ok(())
+    }
+}
+
+/// Compiles the pipelines recorded in a [`PipelineManifest`] file before they are first drawn.
+///
+/// Insert this resource to warm up pipelines (ex: behind a loading screen): entries are compiled
+/// on the [`AsyncComputeTaskPool`] as soon as their pipeline and shader assets are loaded, see
+/// [`PipelineWarmUp::is_done`]. Whenever new pipelines get compiled, the manifest file is
+/// rewritten with every pipeline compiled so far, so the next launch can warm them up too.
+#[derive(Debug)]
+pub struct PipelineWarmUp {
+    path: PathBuf,
+    loaded: bool,
+    pending: Vec<PipelineManifestEntry>,
+    total: usize,
+    recorded_count: usize,
+}
+
+impl PipelineWarmUp {
+    pub fn new(path: impl Into<PathBuf>) -> Self {
+        Self {
+            path: path.into(),
+            loaded: false,
+            pending: Vec::new(),
+            total: 0,
+            recorded_count: 0,
+        }
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    /// Returns true once every pipeline in the manifest has been compiled or skipped
+    pub fn is_done(&self) -> bool {
+        self.loaded && self.pending.is_empty()
+    }
+
+    /// The fraction of manifest pipelines that are ready, between 0.0 and 1.0
+    pub fn progress(&self) -> f32 {
+        if self.total == 0 {
+            return if self.loaded { 1.0 } else { 0.0 };
+        }
+        (self.total - self.pending.len()) as f32 / self.total as f32
+    }
+
+    fn load_manifest(&mut self) {
+        self.loaded = true;
+        match PipelineManifest::load(&self.path) {
+            Ok(manifest) => self.pending = manifest.pipelines,
+            Err(PipelineManifestError::Io(err)) if err.kind() == std::io::ErrorKind::NotFound => {}
+            Err(err) => warn!(
+                "ignoring pipeline manifest {}: {}",
+                self.path.display(),
+                err
+            ),
+        }
+        self.total = self.pending.len();
+    }
+}
+
+/// The state of a manifest pipeline's source assets
+enum EntryState {
+    Ready,
+    Loading,
+    Missing,
+}
+
+fn entry_state(
+    entry: &PipelineManifestEntry,
+    pipelines: &Assets<PipelineDescriptor>,
+    shaders: &Assets<Shader>,
+    asset_server: Option<&AssetServer>,
+) -> EntryState {
+    let asset_state = |id: HandleId, is_loaded: bool| {
+        if is_loaded {
+            return EntryState::Ready;
+        }
+        match (id, asset_server) {
+            // loaded assets keep their id across runs, so wait for them to finish loading
+            (HandleId::AssetPathId(_), Some(asset_server))
+                if matches!(
+                    asset_server.get_load_state(id),
+                    LoadState::Queued | LoadState::Loading
+                ) =>
+            {
+                EntryState::Loading
+            }
+            // added assets are either created at startup or have an id unique to their session
+            _ => EntryState::Missing,
+        }
+    };
+
+    let descriptor = match pipelines.get(entry.pipeline) {
+        Some(descriptor) => descriptor,
+        None => return asset_state(entry.pipeline, false),
+    };
+    for shader in descriptor.shader_stages.iter() {
+        match asset_state(shader.id, shaders.contains(shader.id)) {
+            EntryState::Ready => {}
+            state => return state,
+        }
+    }
+    EntryState::Ready
+}
+
+/// Compiles pending [`PipelineWarmUp`] pipelines and records newly compiled ones to its manifest
+#[allow(clippy::too_many_arguments)]
+pub fn pipeline_warm_up_system(
+    warm_up: Option<ResMut<PipelineWarmUp>>,
+    mut pipeline_compiler: ResMut<PipelineCompiler>,
+    mut pipelines: ResMut<Assets<PipelineDescriptor>>,
+    mut shaders: ResMut<Assets<Shader>>,
+    render_resource_context: Res<Box<dyn RenderResourceContext>>,
+    task_pool: Option<Res<AsyncComputeTaskPool>>,
+    asset_server: Option<Res<AssetServer>>,
+) {
+    let mut warm_up = if let Some(warm_up) = warm_up {
+        warm_up
+    } else {
+        return;
+    };
+    if !warm_up.loaded {
+        warm_up.load_manifest();
+        warm_up.recorded_count = pipeline_compiler.iter_all_compiled_pipelines().count();
+    }
+
+    let render_resource_context = &**render_resource_context;
+    let asset_server = asset_server.as_deref();
+    warm_up.pending.retain(|entry| {
+        let source_pipeline = Handle::<PipelineDescriptor>::weak(entry.pipeline);
+        match entry_state(entry, &pipelines, &shaders, asset_server) {
+            EntryState::Loading => return true,
+            EntryState::Missing => return false,
+            EntryState::Ready => {}
+        }
+
+        #[cfg(not(target_arch = "wasm32"))]
+        if let Some(task_pool) = task_pool.as_ref() {
+            return pipeline_compiler
+                .compile_pipeline_async(
+                    task_pool,
+                    render_resource_context,
+                    &mut pipelines,
+                    &mut shaders,
+                    &source_pipeline,
+                    &entry.specialization,
+                )
+                .is_none();
+        }
+
+        if pipeline_compiler
+            .get_specialized_pipeline(&source_pipeline, &entry.specialization)
+            .is_none()
+        {
+            pipeline_compiler.compile_pipeline(
+                render_resource_context,
+                &mut pipelines,
+                &mut shaders,
+                &source_pipeline,
+                &entry.specialization,
+            );
+        }
+        false
+    });
+    #[cfg(target_arch = "wasm32")]
+    let _ = task_pool;
+
+    // rewrite the manifest once the warm up is done and pipelines it didn't know about appeared
+    let compiled_count = pipeline_compiler.iter_all_compiled_pipelines().count();
+    if warm_up.pending.is_empty() && compiled_count != warm_up.recorded_count {
+        warm_up.recorded_count = compiled_count;
+        if let Err(err) = PipelineManifest::from_compiler(&pipeline_compiler).save(&warm_up.path) {
+            warn!(
+                "failed to write pipeline manifest {}: {}",
+                warm_up.path.display(),
+                err
+            );
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pipeline::{InputStepMode, PrimitiveTopology, VertexBufferLayout};
+
+    #[test]
+    fn manifest_roundtrip() {
+        let mut specialization = PipelineSpecialization {
+            primitive_topology: PrimitiveTopology::LineList,
+            sample_count: 4,
+            vertex_buffer_layout: VertexBufferLayout {
+                name: "Mesh".into(),
+                stride: 12,
+                step_mode: InputStepMode::Vertex,
+                attributes: Vec::new(),
+            },
+            ..Default::default()
+        };
+        specialization
+            .shader_specialization
+            .shader_defs
+            .insert("STANDARDMATERIAL_ALBEDO_TEXTURE".to_string());
+        specialization
+            .dynamic_bindings
+            .insert("Transform".to_string());
+        let manifest = PipelineManifest {
+            pipelines: vec![PipelineManifestEntry {
+                pipeline: HandleId::from("shaders/custom.pipeline"),
+                specialization,
+            }],
+        };
+
+        let path =
+            std::env::temp_dir().join(format!("bevy_pipeline_manifest_{}.ron", std::process::id()));
+        manifest.save(&path).unwrap();
+        assert_eq!(PipelineManifest::load(&path).unwrap(), manifest);
+        let _ = std::fs::remove_file(&path);
+    }
+}
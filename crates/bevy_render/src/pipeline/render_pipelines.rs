@@ -1,9 +1,9 @@
-use super::{PipelineDescriptor, PipelineSpecialization};
+use super::{Instanced, PipelineDescriptor, PipelineSpecialization};
 use crate::{
-    draw::{Draw, DrawContext, OutsideFrustum},
+    draw::{Draw, DrawContext, DrawError, OutsideFrustum},
     mesh::{Indices, Mesh},
     prelude::{Msaa, Visible},
-    renderer::RenderResourceBindings,
+    renderer::{AssetRenderResourceBindings, RenderResourceBindings},
 };
 use bevy_asset::{Assets, Handle};
 use bevy_ecs::{
@@ -82,6 +82,39 @@ impl Default for RenderPipelines {
     }
 }
 
+/// Syncs the msaa sample count and dynamic bindings of each [`RenderPipeline`] with its
+/// [`RenderResourceBindings`]
+pub(crate) fn update_pipeline_specializations(
+    render_pipelines: &mut RenderPipelines,
+    msaa: &Msaa,
+    asset_render_resource_bindings: &AssetRenderResourceBindings,
+) {
+    for pipeline in render_pipelines.pipelines.iter_mut() {
+        pipeline.specialization.sample_count = msaa.samples;
+        if pipeline.dynamic_bindings_generation
+            != render_pipelines.bindings.dynamic_bindings_generation()
+        {
+            pipeline.specialization.dynamic_bindings = render_pipelines
+                .bindings
+                .iter_dynamic_bindings()
+                .map(|name| name.to_string())
+                .collect::<HashSet<String>>();
+            pipeline.dynamic_bindings_generation =
+                render_pipelines.bindings.dynamic_bindings_generation();
+            for (handle, _) in render_pipelines.bindings.iter_assets() {
+                if let Some(bindings) = asset_render_resource_bindings.get_untyped(handle) {
+                    for binding in bindings.iter_dynamic_bindings() {
+                        pipeline
+                            .specialization
+                            .dynamic_bindings
+                            .insert(binding.to_string());
+                    }
+                }
+            }
+        }
+    }
+}
+
 pub fn draw_render_pipelines_system(
     mut draw_context: DrawContext,
     mut render_resource_bindings: ResMut<RenderResourceBindings>,
@@ -89,7 +122,7 @@ pub fn draw_render_pipelines_system(
     meshes: Res<Assets<Mesh>>,
     mut query: Query<
         (&mut Draw, &mut RenderPipelines, &Handle<Mesh>, &Visible),
-        Without<OutsideFrustum>,
+        (Without<OutsideFrustum>, Without<Instanced>),
     >,
 ) {
     for (mut draw, mut render_pipelines, mesh_handle, visible) in query.iter_mut() {
@@ -111,46 +144,27 @@ pub fn draw_render_pipelines_system(
         };
 
         let render_pipelines = &mut *render_pipelines;
-        for pipeline in render_pipelines.pipelines.iter_mut() {
-            pipeline.specialization.sample_count = msaa.samples;
-            if pipeline.dynamic_bindings_generation
-                != render_pipelines.bindings.dynamic_bindings_generation()
-            {
-                pipeline.specialization.dynamic_bindings = render_pipelines
-                    .bindings
-                    .iter_dynamic_bindings()
-                    .map(|name| name.to_string())
-                    .collect::<HashSet<String>>();
-                pipeline.dynamic_bindings_generation =
-                    render_pipelines.bindings.dynamic_bindings_generation();
-                for (handle, _) in render_pipelines.bindings.iter_assets() {
-                    if let Some(bindings) = draw_context
-                        .asset_render_resource_bindings
-                        .get_untyped(handle)
-                    {
-                        for binding in bindings.iter_dynamic_bindings() {
-                            pipeline
-                                .specialization
-                                .dynamic_bindings
-                                .insert(binding.to_string());
-                        }
-                    }
-                }
-            }
-        }
+        update_pipeline_specializations(
+            render_pipelines,
+            &msaa,
+            &draw_context.asset_render_resource_bindings,
+        );
 
         for render_pipeline in render_pipelines.pipelines.iter_mut() {
             let render_resource_bindings = &mut [
                 &mut render_pipelines.bindings,
                 &mut render_resource_bindings,
             ];
-            draw_context
-                .set_pipeline(
-                    &mut draw,
-                    &render_pipeline.pipeline,
-                    &render_pipeline.specialization,
-                )
-                .unwrap();
+            match draw_context.set_pipeline(
+                &mut draw,
+                &render_pipeline.pipeline,
+                &render_pipeline.specialization,
+            ) {
+                Ok(()) => {}
+                // skip drawing until the pipeline is compiled
+                Err(DrawError::PipelineNotReady) => continue,
+                Err(err) => panic!("{}", err),
+            }
             draw_context
                 .set_bind_groups_from_bindings(&mut draw, render_resource_bindings)
                 .unwrap();
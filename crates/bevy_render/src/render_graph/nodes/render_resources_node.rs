@@ -1,10 +1,11 @@
 use crate::{
-    pipeline::RenderPipelines,
+    pipeline::{Instanced, RenderPipelines},
     prelude::Visible,
     render_graph::{CommandQueue, Node, ResourceSlots, SystemNode},
     renderer::{
-        self, BufferInfo, BufferMapMode, BufferUsage, RenderContext, RenderResourceBinding,
-        RenderResourceBindings, RenderResourceContext, RenderResourceHints,
+        self, BufferInfo, BufferUsage, RenderContext, RenderResourceBinding,
+        RenderResourceBindings, RenderResourceContext, RenderResourceHints, StagingAllocation,
+        StagingRing,
     },
     texture,
 };
@@ -13,7 +14,7 @@ use bevy_app::EventReader;
 use bevy_asset::{Asset, AssetEvent, Assets, Handle, HandleId};
 use bevy_ecs::{
     entity::Entity,
-    query::{Changed, Or, With},
+    query::{Added, Changed, Or, With, Without},
     system::{BoxedSystem, IntoSystem, Local, Query, QuerySet, RemovedComponents, Res, ResMut},
     world::World,
 };
@@ -29,14 +30,24 @@ struct QueuedBufferWrite {
     size: usize,
 }
 
-/// Used to track items in a gpu buffer in an "array" style
+/// A gpu buffer holding a contiguous range of a [`BufferArray`]'s items
+#[derive(Debug)]
+struct BufferArrayChunk {
+    buffer: BufferId,
+    first_index: usize,
+    capacity: usize,
+}
+
+/// Used to track items in gpu buffers in an "array" style. Capacity grows geometrically by adding
+/// chunks (each as large as all previous chunks combined), so existing items never move and their
+/// bindings stay valid.
 #[derive(Debug)]
 struct BufferArray<I> {
     item_size: usize,
     buffer_capacity: usize,
     min_capacity: usize,
     len: usize,
-    buffer: Option<BufferId>,
+    chunks: Vec<BufferArrayChunk>,
     free_indices: Vec<usize>,
     indices: HashMap<I, usize>,
 }
@@ -48,7 +59,7 @@ impl<I: Hash + Eq> BufferArray<I> {
             len: 0,
             buffer_capacity: 0,
             min_capacity,
-            buffer: None,
+            chunks: Vec::new(),
             free_indices: Vec::new(),
             indices: HashMap::default(),
         }
@@ -69,14 +80,27 @@ impl<I: Hash + Eq> BufferArray<I> {
         }
     }
 
+    /// Returns the buffer that holds the item at `index` and the item's offset in that buffer
+    fn locate(&self, index: usize) -> (BufferId, usize) {
+        let chunk = self
+            .chunks
+            .iter()
+            .rev()
+            .find(|chunk| chunk.first_index <= index)
+            .unwrap();
+        debug_assert!(index < chunk.first_index + chunk.capacity);
+        (chunk.buffer, (index - chunk.first_index) * self.item_size)
+    }
+
     pub fn get_binding(&self, id: I) -> Option<RenderResourceBinding> {
-        self.indices
-            .get(&id)
-            .map(|index| RenderResourceBinding::Buffer {
-                buffer: self.buffer.unwrap(),
-                dynamic_index: Some((index * self.item_size) as u32),
+        self.indices.get(&id).map(|index| {
+            let (buffer, offset) = self.locate(*index);
+            RenderResourceBinding::Buffer {
+                buffer,
+                dynamic_index: Some(offset as u32),
                 range: 0..self.item_size as u64,
-            })
+            }
+        })
     }
 
     pub fn remove_binding(&mut self, id: I) {
@@ -86,36 +110,32 @@ impl<I: Hash + Eq> BufferArray<I> {
         }
     }
 
+    /// Adds chunks until every assigned index fits. Returns true if a chunk was added.
     pub fn resize(&mut self, render_resource_context: &dyn RenderResourceContext) -> bool {
-        if self.len <= self.buffer_capacity {
-            return false;
+        let mut resized = false;
+        while self.len > self.buffer_capacity {
+            self.allocate_chunk(render_resource_context);
+            resized = true;
         }
 
-        self.allocate_buffer(render_resource_context);
         // TODO: allow shrinking
-        true
+        resized
     }
 
-    pub fn allocate_buffer(&mut self, render_resource_context: &dyn RenderResourceContext) {
-        if let Some(old_buffer) = self.buffer.take() {
-            render_resource_context.remove_buffer(old_buffer);
-        }
-
-        let new_len = if self.buffer_capacity == 0 {
-            self.min_capacity.max(self.len)
-        } else {
-            self.min_capacity.max(self.len * 2)
-        };
-
-        let size = new_len * self.item_size;
+    fn allocate_chunk(&mut self, render_resource_context: &dyn RenderResourceContext) {
+        let capacity = self.min_capacity.max(self.buffer_capacity).max(1);
         let buffer = render_resource_context.create_buffer(BufferInfo {
-            size,
+            size: capacity * self.item_size,
             buffer_usage: BufferUsage::COPY_DST | BufferUsage::UNIFORM,
             ..Default::default()
         });
 
-        self.buffer = Some(buffer);
-        self.buffer_capacity = new_len;
+        self.chunks.push(BufferArrayChunk {
+            buffer,
+            first_index: self.buffer_capacity,
+            capacity,
+        });
+        self.buffer_capacity += capacity;
     }
 }
 
@@ -124,8 +144,6 @@ where
     T: renderer::RenderResources,
 {
     buffer_arrays: Vec<Option<BufferArray<I>>>,
-    staging_buffer: Option<BufferId>,
-    staging_buffer_size: usize,
     required_staging_buffer_size: usize,
     current_staging_buffer_offset: usize,
     queued_buffer_writes: Vec<QueuedBufferWrite>,
@@ -139,8 +157,6 @@ where
     fn default() -> Self {
         Self {
             buffer_arrays: Default::default(),
-            staging_buffer: Default::default(),
-            staging_buffer_size: 0,
             current_staging_buffer_offset: 0,
             queued_buffer_writes: Vec::new(),
             required_staging_buffer_size: 0,
@@ -183,63 +199,24 @@ where
     }
 
     /// Find a spot for the given RenderResources in each uniform's BufferArray and prepare space in
-    /// the staging buffer
+    /// the staging buffer. Space is reserved for a whole (aligned) item so that writes to adjacent
+    /// items can be copied together.
     fn prepare_uniform_buffers(&mut self, id: I, render_resources: &T) {
         for (i, render_resource) in render_resources.iter().enumerate() {
             if let Some(RenderResourceType::Buffer) = render_resource.resource_type() {
-                let size = render_resource.buffer_byte_len().unwrap();
                 if let Some(buffer_array) = &mut self.buffer_arrays[i] {
                     buffer_array.get_or_assign_index(id);
-                    self.required_staging_buffer_size += size;
+                    self.required_staging_buffer_size += buffer_array.item_size;
                 }
             }
         }
     }
 
-    /// Resize BufferArray buffers if they aren't large enough
-    fn resize_buffer_arrays(
-        &mut self,
-        render_resource_context: &dyn RenderResourceContext,
-    ) -> bool {
-        let mut resized = false;
+    /// Grow BufferArrays that aren't large enough. Growing never moves existing items, so only
+    /// changed items need to be written.
+    fn resize_buffer_arrays(&mut self, render_resource_context: &dyn RenderResourceContext) {
         for buffer_array in self.buffer_arrays.iter_mut().flatten() {
-            resized |= buffer_array.resize(render_resource_context);
-        }
-
-        resized
-    }
-
-    fn set_required_staging_buffer_size_to_max(&mut self) {
-        let mut new_size = 0;
-        for buffer_array in self.buffer_arrays.iter().flatten() {
-            new_size += buffer_array.item_size * buffer_array.len;
-        }
-
-        if new_size > self.required_staging_buffer_size {
-            self.required_staging_buffer_size = new_size;
-        }
-    }
-
-    /// Update the staging buffer to provide enough space to copy data to target buffers.
-    fn resize_staging_buffer(&mut self, render_resource_context: &dyn RenderResourceContext) {
-        // TODO: allow staging buffer to scale down
-        if self.required_staging_buffer_size > self.staging_buffer_size {
-            if let Some(staging_buffer) = self.staging_buffer {
-                render_resource_context.remove_buffer(staging_buffer);
-            }
-
-            if self.required_staging_buffer_size > 0 {
-                let staging_buffer = render_resource_context.create_buffer(BufferInfo {
-                    buffer_usage: BufferUsage::COPY_SRC | BufferUsage::MAP_WRITE,
-                    size: self.required_staging_buffer_size,
-                    ..Default::default()
-                });
-                self.staging_buffer = Some(staging_buffer);
-            } else {
-                self.staging_buffer = None;
-            }
-
-            self.staging_buffer_size = self.required_staging_buffer_size;
+            buffer_array.resize(render_resource_context);
         }
     }
 
@@ -265,6 +242,13 @@ where
                 let aligned_size = render_resource_context.get_aligned_uniform_size(size, false);
                 let buffer_array = self.buffer_arrays[i].as_mut().unwrap();
                 let range = 0..aligned_size as u64;
+                // dynamic uniforms copy their whole slot (including alignment padding), which lets
+                // writes to adjacent slots coalesce into one copy
+                let copy_size = if dynamic_uniforms {
+                    buffer_array.item_size
+                } else {
+                    size
+                };
                 let (target_buffer, target_offset) = if dynamic_uniforms {
                     let binding = buffer_array.get_binding(id).unwrap();
                     let dynamic_index = if let RenderResourceBinding::Buffer {
@@ -276,8 +260,13 @@ where
                     } else {
                         panic!("Dynamic index should always be set.");
                     };
-                    render_resource_bindings.set(render_resource_name, binding);
-                    (buffer_array.buffer.unwrap(), dynamic_index)
+                    let buffer = binding.get_buffer().unwrap();
+                    // avoid invalidating bind groups (and reallocating the name) for unchanged
+                    // bindings
+                    if render_resource_bindings.get(render_resource_name) != Some(&binding) {
+                        render_resource_bindings.set(render_resource_name, binding);
+                    }
+                    (buffer, dynamic_index)
                 } else {
                     let mut matching_buffer = None;
                     if let Some(binding) = render_resource_bindings.get(render_resource_name) {
@@ -333,27 +322,49 @@ where
                     buffer: target_buffer,
                     target_offset: target_offset as usize,
                     source_offset: self.current_staging_buffer_offset,
-                    size,
+                    size: copy_size,
                 });
-                self.current_staging_buffer_offset += size;
+                self.current_staging_buffer_offset += copy_size;
             }
         }
     }
 
+    /// Queues copies from the staging allocation to the target buffers. Writes that are contiguous
+    /// in both the staging allocation and their target buffer are merged into a single copy.
     fn copy_staging_buffer_to_final_buffers(
         &mut self,
         command_queue: &mut CommandQueue,
-        staging_buffer: BufferId,
+        staging: StagingAllocation,
     ) {
-        for queued_buffer_write in self.queued_buffer_writes.drain(..) {
+        self.queued_buffer_writes
+            .sort_unstable_by_key(|write| (write.buffer, write.target_offset));
+        let mut queued_buffer_writes = self.queued_buffer_writes.drain(..);
+        let mut current = if let Some(write) = queued_buffer_writes.next() {
+            write
+        } else {
+            return;
+        };
+        let mut copy = |write: &QueuedBufferWrite| {
             command_queue.copy_buffer_to_buffer(
-                staging_buffer,
-                queued_buffer_write.source_offset as u64,
-                queued_buffer_write.buffer,
-                queued_buffer_write.target_offset as u64,
-                queued_buffer_write.size as u64,
+                staging.buffer,
+                (staging.offset + write.source_offset) as u64,
+                write.buffer,
+                write.target_offset as u64,
+                write.size as u64,
             )
+        };
+        for write in queued_buffer_writes {
+            if write.buffer == current.buffer
+                && write.target_offset == current.target_offset + current.size
+                && write.source_offset == current.source_offset + current.size
+            {
+                current.size += write.size;
+            } else {
+                copy(&current);
+                current = write;
+            }
         }
+        copy(&current);
     }
 }
 
@@ -432,11 +443,17 @@ impl<I, T: RenderResources> Default for RenderResourcesNodeState<I, T> {
 fn render_resources_node_system<T: RenderResources>(
     mut state: Local<RenderResourcesNodeState<Entity, T>>,
     mut entities_waiting_for_textures: Local<Vec<Entity>>,
+    staging_ring: Res<StagingRing>,
     render_resource_context: Res<Box<dyn RenderResourceContext>>,
     removed: RemovedComponents<T>,
+    // instanced draws don't read per entity uniforms, so instanced entities don't get any
+    newly_instanced: Query<Entity, (With<T>, Added<Instanced>)>,
     mut queries: QuerySet<(
-        Query<(Entity, &T, &Visible, &mut RenderPipelines), Or<(Changed<T>, Changed<Visible>)>>,
-        Query<(Entity, &T, &Visible, &mut RenderPipelines)>,
+        Query<
+            (Entity, &T, &Visible, &mut RenderPipelines),
+            (Or<(Changed<T>, Changed<Visible>)>, Without<Instanced>),
+        >,
+        Query<(Entity, &T, &Visible, &mut RenderPipelines), Without<Instanced>>,
     )>,
 ) {
     let state = state.deref_mut();
@@ -448,7 +465,7 @@ fn render_resources_node_system<T: RenderResources>(
         uniform_buffer_arrays.initialize(first, render_resource_context);
     }
 
-    for entity in removed.iter() {
+    for entity in removed.iter().chain(newly_instanced.iter()) {
         uniform_buffer_arrays.remove_bindings(entity);
     }
 
@@ -481,62 +498,37 @@ fn render_resources_node_system<T: RenderResources>(
         }
     }
 
-    let resized = uniform_buffer_arrays.resize_buffer_arrays(render_resource_context);
-    if resized {
-        uniform_buffer_arrays.set_required_staging_buffer_size_to_max()
-    }
-    uniform_buffer_arrays.resize_staging_buffer(render_resource_context);
+    uniform_buffer_arrays.resize_buffer_arrays(render_resource_context);
 
-    if let Some(staging_buffer) = state.uniform_buffer_arrays.staging_buffer {
-        render_resource_context.map_buffer(staging_buffer, BufferMapMode::Write);
+    let required_staging_buffer_size = uniform_buffer_arrays.required_staging_buffer_size;
+    if required_staging_buffer_size > 0 {
+        let staging = staging_ring.allocate(render_resource_context, required_staging_buffer_size);
         render_resource_context.write_mapped_buffer(
-            staging_buffer,
-            0..state.uniform_buffer_arrays.staging_buffer_size as u64,
+            staging.buffer,
+            staging.offset as u64..(staging.offset + staging.size) as u64,
             &mut |mut staging_buffer, _render_resource_context| {
-                // if the buffer array was resized, write all entities to the new buffer, otherwise
-                // only write changes
-                if resized {
-                    for (entity, uniforms, visible, mut render_pipelines) in
-                        queries.q1_mut().iter_mut()
-                    {
-                        if !visible.is_visible {
-                            continue;
-                        }
-
-                        state.uniform_buffer_arrays.write_uniform_buffers(
-                            entity,
-                            &uniforms,
-                            state.dynamic_uniforms,
-                            render_resource_context,
-                            &mut render_pipelines.bindings,
-                            &mut staging_buffer,
-                        );
+                // only changed entities are written: their slots are the only dirty ones
+                for (entity, uniforms, visible, mut render_pipelines) in queries.q0_mut().iter_mut()
+                {
+                    if !visible.is_visible {
+                        continue;
                     }
-                } else {
-                    for (entity, uniforms, visible, mut render_pipelines) in
-                        queries.q0_mut().iter_mut()
-                    {
-                        if !visible.is_visible {
-                            continue;
-                        }
 
-                        state.uniform_buffer_arrays.write_uniform_buffers(
-                            entity,
-                            &uniforms,
-                            state.dynamic_uniforms,
-                            render_resource_context,
-                            &mut render_pipelines.bindings,
-                            &mut staging_buffer,
-                        );
-                    }
+                    state.uniform_buffer_arrays.write_uniform_buffers(
+                        entity,
+                        &uniforms,
+                        state.dynamic_uniforms,
+                        render_resource_context,
+                        &mut render_pipelines.bindings,
+                        &mut staging_buffer,
+                    );
                 }
             },
         );
-        render_resource_context.unmap_buffer(staging_buffer);
 
         state
             .uniform_buffer_arrays
-            .copy_staging_buffer_to_final_buffers(&mut state.command_queue, staging_buffer);
+            .copy_staging_buffer_to_final_buffers(&mut state.command_queue, staging);
     }
 }
 
@@ -618,6 +610,7 @@ fn asset_render_resources_node_system<T: RenderResources + Asset>(
     assets: Res<Assets<T>>,
     mut asset_events: EventReader<AssetEvent<T>>,
     mut asset_render_resource_bindings: ResMut<AssetRenderResourceBindings>,
+    staging_ring: Res<StagingRing>,
     render_resource_context: Res<Box<dyn RenderResourceContext>>,
     removed_handles: RemovedComponents<Handle<T>>,
     mut queries: QuerySet<(
@@ -694,60 +687,34 @@ fn asset_render_resources_node_system<T: RenderResources + Asset>(
         }
     }
 
-    let resized = uniform_buffer_arrays.resize_buffer_arrays(render_resource_context);
-    if resized {
-        // full asset copy needed, make sure there is also space for unchanged assets
-        for (asset_handle, asset) in assets.iter() {
-            if !changed_assets.contains_key(&asset_handle) {
-                uniform_buffer_arrays.prepare_uniform_buffers(asset_handle, asset);
-            }
-        }
-        uniform_buffer_arrays.set_required_staging_buffer_size_to_max()
-    }
-    uniform_buffer_arrays.resize_staging_buffer(render_resource_context);
+    uniform_buffer_arrays.resize_buffer_arrays(render_resource_context);
 
-    if let Some(staging_buffer) = state.uniform_buffer_arrays.staging_buffer {
-        render_resource_context.map_buffer(staging_buffer, BufferMapMode::Write);
+    let required_staging_buffer_size = uniform_buffer_arrays.required_staging_buffer_size;
+    if required_staging_buffer_size > 0 {
+        let staging = staging_ring.allocate(render_resource_context, required_staging_buffer_size);
         render_resource_context.write_mapped_buffer(
-            staging_buffer,
-            0..state.uniform_buffer_arrays.staging_buffer_size as u64,
+            staging.buffer,
+            staging.offset as u64..(staging.offset + staging.size) as u64,
             &mut |mut staging_buffer, _render_resource_context| {
-                if resized {
-                    for (asset_handle, asset) in assets.iter() {
-                        let mut render_resource_bindings = asset_render_resource_bindings
-                            .get_or_insert_mut(&Handle::<T>::weak(asset_handle));
-                        // TODO: only setup buffer if we haven't seen this handle before
-                        state.uniform_buffer_arrays.write_uniform_buffers(
-                            asset_handle,
-                            &asset,
-                            state.dynamic_uniforms,
-                            render_resource_context,
-                            &mut render_resource_bindings,
-                            &mut staging_buffer,
-                        );
-                    }
-                } else {
-                    for (asset_handle, asset) in changed_assets.iter() {
-                        let mut render_resource_bindings = asset_render_resource_bindings
-                            .get_or_insert_mut(&Handle::<T>::weak(*asset_handle));
-                        // TODO: only setup buffer if we haven't seen this handle before
-                        state.uniform_buffer_arrays.write_uniform_buffers(
-                            *asset_handle,
-                            &asset,
-                            state.dynamic_uniforms,
-                            render_resource_context,
-                            &mut render_resource_bindings,
-                            &mut staging_buffer,
-                        );
-                    }
+                for (asset_handle, asset) in changed_assets.iter() {
+                    let mut render_resource_bindings = asset_render_resource_bindings
+                        .get_or_insert_mut(&Handle::<T>::weak(*asset_handle));
+                    // TODO: only setup buffer if we haven't seen this handle before
+                    state.uniform_buffer_arrays.write_uniform_buffers(
+                        *asset_handle,
+                        &asset,
+                        state.dynamic_uniforms,
+                        render_resource_context,
+                        &mut render_resource_bindings,
+                        &mut staging_buffer,
+                    );
                 }
             },
         );
-        render_resource_context.unmap_buffer(staging_buffer);
 
         state
             .uniform_buffer_arrays
-            .copy_staging_buffer_to_final_buffers(&mut state.command_queue, staging_buffer);
+            .copy_staging_buffer_to_final_buffers(&mut state.command_queue, staging);
     }
 
     // update removed entity asset mapping
@@ -809,3 +776,48 @@ where
 
     success
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::renderer::HeadlessRenderResourceContext;
+
+    #[test]
+    fn buffer_array_growth_keeps_existing_bindings() {
+        let context = HeadlessRenderResourceContext::default();
+        let mut buffer_array = BufferArray::<u32>::new(256, 2);
+        buffer_array.get_or_assign_index(0);
+        buffer_array.get_or_assign_index(1);
+        assert!(buffer_array.resize(&context));
+        let first_bindings = (0..2)
+            .map(|id| buffer_array.get_binding(id).unwrap())
+            .collect::<Vec<_>>();
+
+        for id in 2..7 {
+            buffer_array.get_or_assign_index(id);
+        }
+        assert!(buffer_array.resize(&context));
+        assert!(!buffer_array.resize(&context));
+        assert_eq!(buffer_array.buffer_capacity, 8);
+        assert_eq!(buffer_array.chunks.len(), 3);
+
+        // items that were already assigned keep their buffer and offset
+        for id in 0..2 {
+            assert_eq!(
+                buffer_array.get_binding(id).unwrap(),
+                first_bindings[id as usize]
+            );
+        }
+
+        // item 6 lives in the third chunk (items 4..8)
+        let third_chunk = buffer_array.chunks[2].buffer;
+        assert_eq!(
+            buffer_array.get_binding(6),
+            Some(RenderResourceBinding::Buffer {
+                buffer: third_chunk,
+                dynamic_index: Some(2 * 256),
+                range: 0..256,
+            })
+        );
+    }
+}
@@ -33,7 +33,11 @@ impl Node for TextureCopyNode {
                         }
 
                         let texture_descriptor: TextureDescriptor = texture.into();
-                        let width = texture.size.width as usize;
+                        // compressed textures are copied in rows of blocks
+                        let (block_width, block_height) = texture.format.block_dimensions();
+                        let width = ((texture.size.width + block_width - 1) / block_width) as usize;
+                        let height =
+                            ((texture.size.height + block_height - 1) / block_height) as usize;
                         let aligned_width =
                             render_context.resources().get_aligned_texture_size(width);
                         let format_size = texture.format.pixel_size();
@@ -41,7 +45,7 @@ impl Node for TextureCopyNode {
                             0;
                             format_size
                                 * aligned_width
-                                * texture.size.height as usize
+                                * height
                                 * texture.size.depth_or_array_layers
                                     as usize
                         ];
@@ -1,6 +1,6 @@
 use bevy_utils::Uuid;
 
-#[derive(Copy, Clone, Hash, Eq, PartialEq, Debug)]
+#[derive(Copy, Clone, Hash, Eq, PartialEq, Ord, PartialOrd, Debug)]
 pub struct BufferId(Uuid);
 
 impl BufferId {
@@ -0,0 +1,178 @@
+use super::{BufferId, BufferInfo, BufferUsage, StagingRing, COPY_BUFFER_ALIGNMENT};
+use crate::{render_graph::CommandQueue, renderer::RenderResourceContext};
+use std::ops::Range;
+
+/// Changed data is found and uploaded in blocks of this many bytes
+const BLOCK_SIZE: usize = 256;
+
+/// A gpu buffer that is kept when its data changes, along with a copy of what was uploaded to it,
+/// so only the blocks that changed are uploaded.
+#[derive(Debug)]
+pub(crate) struct DynamicBuffer {
+    pub buffer: BufferId,
+    usage: BufferUsage,
+    /// Mirrors the whole gpu buffer
+    contents: Vec<u8>,
+    /// Scratch space for the changed ranges of the last update
+    changed: Vec<Range<usize>>,
+}
+
+impl DynamicBuffer {
+    pub fn new(
+        render_resource_context: &dyn RenderResourceContext,
+        usage: BufferUsage,
+        data: &[u8],
+    ) -> Self {
+        let capacity = align(data.len()).next_power_of_two();
+        let mut contents = Vec::with_capacity(capacity);
+        contents.extend_from_slice(data);
+        contents.resize(capacity, 0);
+        let buffer = render_resource_context.create_buffer_with_data(
+            BufferInfo {
+                buffer_usage: usage | BufferUsage::COPY_DST,
+                ..Default::default()
+            },
+            &contents,
+        );
+        DynamicBuffer {
+            buffer,
+            usage,
+            contents,
+            changed: Vec::new(),
+        }
+    }
+
+    /// Uploads the blocks of `data` that differ from the last upload. Returns `false` if the data
+    /// doesn't fit and the buffer was recreated with a new id instead.
+    pub fn update(
+        &mut self,
+        render_resource_context: &dyn RenderResourceContext,
+        staging_ring: &StagingRing,
+        command_queue: &mut CommandQueue,
+        data: &[u8],
+    ) -> bool {
+        let len = align(data.len());
+        if len > self.contents.len() {
+            render_resource_context.remove_buffer(self.buffer);
+            *self = DynamicBuffer::new(render_resource_context, self.usage, data);
+            return false;
+        }
+
+        self.find_changed_ranges(data);
+        let size = self.changed.iter().map(|range| range.len()).sum::<usize>();
+        if size == 0 {
+            return true;
+        }
+        for range in self.changed.iter() {
+            let end = range.end.min(data.len());
+            self.contents[range.start..end].copy_from_slice(&data[range.start..end]);
+        }
+
+        let staging = staging_ring.allocate(render_resource_context, size);
+        let contents = &self.contents;
+        let changed = &self.changed;
+        render_resource_context.write_mapped_buffer(
+            staging.buffer,
+            staging.offset as u64..(staging.offset + staging.size) as u64,
+            &mut |staging_data, _renderer| {
+                let mut offset = 0;
+                for range in changed.iter() {
+                    staging_data[offset..offset + range.len()]
+                        .copy_from_slice(&contents[range.clone()]);
+                    offset += range.len();
+                }
+            },
+        );
+        let mut offset = staging.offset;
+        for range in self.changed.iter() {
+            command_queue.copy_buffer_to_buffer(
+                staging.buffer,
+                offset as u64,
+                self.buffer,
+                range.start as u64,
+                range.len() as u64,
+            );
+            offset += range.len();
+        }
+        true
+    }
+
+    /// Collects runs of blocks where `data` differs from `contents` into `changed`. Ranges are
+    /// aligned for buffer copies and can extend past the end of `data`.
+    fn find_changed_ranges(&mut self, data: &[u8]) {
+        self.changed.clear();
+        let mut run_start = None;
+        let len = align(data.len());
+        for block_start in (0..len).step_by(BLOCK_SIZE) {
+            let data_end = (block_start + BLOCK_SIZE).min(data.len());
+            if data[block_start..data_end] != self.contents[block_start..data_end] {
+                run_start.get_or_insert(block_start);
+            } else if let Some(run_start) = run_start.take() {
+                self.changed.push(run_start..block_start);
+            }
+        }
+        if let Some(run_start) = run_start {
+            self.changed.push(run_start..len);
+        }
+    }
+
+    pub fn remove(self, render_resource_context: &dyn RenderResourceContext) {
+        render_resource_context.remove_buffer(self.buffer);
+    }
+}
+
+fn align(size: usize) -> usize {
+    (size + COPY_BUFFER_ALIGNMENT - 1) & !(COPY_BUFFER_ALIGNMENT - 1)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::renderer::HeadlessRenderResourceContext;
+
+    fn update(buffer: &mut DynamicBuffer, data: &[u8]) -> (bool, Vec<Range<usize>>) {
+        let context = HeadlessRenderResourceContext::default();
+        let kept = buffer.update(
+            &context,
+            &StagingRing::default(),
+            &mut CommandQueue::default(),
+            data,
+        );
+        (kept, buffer.changed.clone())
+    }
+
+    #[test]
+    fn uploads_only_changed_blocks() {
+        let context = HeadlessRenderResourceContext::default();
+        let mut data = vec![1u8; BLOCK_SIZE * 4 + 6];
+        let mut buffer = DynamicBuffer::new(&context, BufferUsage::VERTEX, &data);
+        let id = buffer.buffer;
+        assert_eq!(buffer.contents.len(), BLOCK_SIZE * 8);
+
+        assert_eq!(update(&mut buffer, &data), (true, vec![]));
+
+        data[3] = 2;
+        data[BLOCK_SIZE + 1] = 2;
+        data[BLOCK_SIZE * 3] = 2;
+        data[BLOCK_SIZE * 4 + 5] = 2;
+        assert_eq!(
+            update(&mut buffer, &data),
+            (
+                true,
+                vec![0..BLOCK_SIZE * 2, BLOCK_SIZE * 3..BLOCK_SIZE * 4 + 8]
+            )
+        );
+        assert_eq!(&buffer.contents[..data.len()], &data[..]);
+        assert_eq!(buffer.buffer, id);
+
+        // shrinking keeps the buffer
+        assert_eq!(update(&mut buffer, &data[..BLOCK_SIZE]), (true, vec![]));
+        assert_eq!(buffer.buffer, id);
+
+        // growing past the capacity recreates it
+        let (kept, _) = update(&mut buffer, &vec![1u8; BLOCK_SIZE * 8 + 1]);
+        assert!(!kept);
+        assert_ne!(buffer.buffer, id);
+        assert_eq!(buffer.contents.len(), BLOCK_SIZE * 16);
+    }
+}
@@ -1,14 +1,18 @@
 mod bind_group;
 mod buffer;
+mod dynamic_buffer;
 #[allow(clippy::module_inception)]
 mod render_resource;
 mod render_resource_bindings;
 mod shared_buffers;
+mod staging_ring;
 mod texture;
 
 pub use bind_group::*;
 pub use buffer::*;
+pub(crate) use dynamic_buffer::DynamicBuffer;
 pub use render_resource::*;
 pub use render_resource_bindings::*;
 pub use shared_buffers::*;
+pub use staging_ring::*;
 pub use texture::*;
@@ -0,0 +1,290 @@
+use super::{BufferId, BufferInfo};
+use crate::renderer::{BufferMapMode, BufferUsage, RenderResourceContext};
+use bevy_ecs::system::{Res, ResMut};
+use parking_lot::RwLock;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+
+/// Copies between buffers must be aligned to this many bytes
+pub const COPY_BUFFER_ALIGNMENT: usize = 4;
+/// Mapped ranges of buffers must start at offsets aligned to this many bytes
+pub const MAP_ALIGNMENT: usize = 8;
+
+/// A range of staging memory sub-allocated from a [`StagingRing`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct StagingAllocation {
+    pub buffer: BufferId,
+    pub offset: usize,
+    pub size: usize,
+}
+
+#[derive(Debug)]
+struct StagingChunk {
+    buffer: BufferId,
+    size: usize,
+    offset: AtomicUsize,
+    mapped: AtomicBool,
+}
+
+impl StagingChunk {
+    fn new(buffer: BufferId, size: usize) -> Self {
+        StagingChunk {
+            buffer,
+            size,
+            offset: AtomicUsize::new(0),
+            mapped: AtomicBool::new(true),
+        }
+    }
+
+    /// Bumps the offset by `size` if the chunk has room for it
+    fn try_allocate(&self, size: usize) -> Option<usize> {
+        let chunk_size = self.size;
+        self.offset
+            .fetch_update(Ordering::Relaxed, Ordering::Relaxed, |offset| {
+                Some(offset + size).filter(|end| *end <= chunk_size)
+            })
+            .ok()
+    }
+}
+
+#[derive(Debug, Default)]
+struct StagingFrame {
+    /// Allocations only take the write lock to map the frame's buffer or add a chunk
+    chunks: RwLock<Vec<StagingChunk>>,
+}
+
+/// A frame indexed ring of staging buffers shared by every uniform upload.
+///
+/// Each frame sub-allocates from its own staging buffer, so writers never wait on a buffer the
+/// gpu may still be copying from. Allocation only needs shared access, so the systems that write
+/// to the ring can run in parallel. The frame's buffer is mapped once on its first allocation and
+/// unmapped once before the render graph runs. If a frame runs out of space, an extra chunk is
+/// created for it; the next time the frame comes around its chunks are merged into one buffer.
+#[derive(Debug)]
+pub struct StagingRing {
+    frames: Vec<StagingFrame>,
+    current_frame: usize,
+    min_chunk_size: usize,
+}
+
+impl Default for StagingRing {
+    fn default() -> Self {
+        StagingRing::new(3, 64 * 1024)
+    }
+}
+
+impl StagingRing {
+    pub fn new(frame_count: usize, min_chunk_size: usize) -> Self {
+        assert!(frame_count > 0, "a StagingRing needs at least one frame");
+        Self {
+            frames: (0..frame_count).map(|_| StagingFrame::default()).collect(),
+            current_frame: 0,
+            min_chunk_size,
+        }
+    }
+
+    /// Reserves `size` bytes of mapped staging memory for the current frame. The returned range
+    /// can be written with [`RenderResourceContext::write_mapped_buffer`] until
+    /// [`StagingRing::finish_frame`] is called.
+    pub fn allocate(
+        &self,
+        render_resource_context: &dyn RenderResourceContext,
+        size: usize,
+    ) -> StagingAllocation {
+        let size = align_staging_size(size);
+        let frame = &self.frames[self.current_frame];
+        {
+            let chunks = frame.chunks.read();
+            if let Some(chunk) = chunks.last() {
+                if chunk.mapped.load(Ordering::Acquire) {
+                    if let Some(offset) = chunk.try_allocate(size) {
+                        return StagingAllocation {
+                            buffer: chunk.buffer,
+                            offset,
+                            size,
+                        };
+                    }
+                }
+            }
+        }
+
+        // another writer may have mapped the buffer or added a chunk since the read lock was
+        // released
+        let mut chunks = frame.chunks.write();
+        if let Some(chunk) = chunks.last() {
+            if !chunk.mapped.load(Ordering::Acquire) {
+                render_resource_context.map_buffer(chunk.buffer, BufferMapMode::Write);
+                chunk.mapped.store(true, Ordering::Release);
+            }
+            if let Some(offset) = chunk.try_allocate(size) {
+                return StagingAllocation {
+                    buffer: chunk.buffer,
+                    offset,
+                    size,
+                };
+            }
+        }
+        let chunk_size = self.min_chunk_size.max(size);
+        let chunk = StagingChunk::new(
+            create_staging_buffer(render_resource_context, chunk_size),
+            chunk_size,
+        );
+        let offset = chunk.try_allocate(size).unwrap();
+        let allocation = StagingAllocation {
+            buffer: chunk.buffer,
+            offset,
+            size,
+        };
+        chunks.push(chunk);
+        allocation
+    }
+
+    /// Unmaps the current frame's staging buffers so queued copies can read from them
+    pub fn finish_frame(&mut self, render_resource_context: &dyn RenderResourceContext) {
+        for chunk in self.frames[self.current_frame].chunks.get_mut().iter_mut() {
+            if *chunk.mapped.get_mut() {
+                render_resource_context.unmap_buffer(chunk.buffer);
+                *chunk.mapped.get_mut() = false;
+            }
+        }
+    }
+
+    /// Moves on to the next frame of the ring, recycling its staging buffers
+    pub fn begin_frame(&mut self, render_resource_context: &dyn RenderResourceContext) {
+        self.current_frame = (self.current_frame + 1) % self.frames.len();
+        let chunks = self.frames[self.current_frame].chunks.get_mut();
+        if chunks.len() > 1 {
+            // the frame overflowed last time around: replace its chunks with a single buffer
+            // large enough for all of them
+            let size = chunks.iter().map(|chunk| chunk.size).sum();
+            for mut chunk in chunks.drain(..) {
+                if *chunk.mapped.get_mut() {
+                    render_resource_context.unmap_buffer(chunk.buffer);
+                }
+                render_resource_context.remove_buffer(chunk.buffer);
+            }
+            chunks.push(StagingChunk::new(
+                create_staging_buffer(render_resource_context, size),
+                size,
+            ));
+        } else if let Some(chunk) = chunks.first_mut() {
+            *chunk.offset.get_mut() = 0;
+        }
+    }
+}
+
+fn create_staging_buffer(
+    render_resource_context: &dyn RenderResourceContext,
+    size: usize,
+) -> BufferId {
+    render_resource_context.create_buffer(BufferInfo {
+        size,
+        buffer_usage: BufferUsage::MAP_WRITE | BufferUsage::COPY_SRC,
+        mapped_at_creation: true,
+    })
+}
+
+/// Rounds sizes up so every allocation starts at a valid offset for both copies and mapping
+fn align_staging_size(size: usize) -> usize {
+    (size + MAP_ALIGNMENT - 1) & !(MAP_ALIGNMENT - 1)
+}
+
+/// Unmaps the current frame of the [`StagingRing`] after all render graph systems wrote to it
+pub fn staging_ring_finish_system(
+    mut staging_ring: ResMut<StagingRing>,
+    render_resource_context: Res<Box<dyn RenderResourceContext>>,
+) {
+    staging_ring.finish_frame(&**render_resource_context);
+}
+
+/// Advances the [`StagingRing`] once the frame has been rendered
+pub fn staging_ring_begin_system(
+    mut staging_ring: ResMut<StagingRing>,
+    render_resource_context: Res<Box<dyn RenderResourceContext>>,
+) {
+    staging_ring.begin_frame(&**render_resource_context);
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::renderer::HeadlessRenderResourceContext;
+    use std::sync::Arc;
+
+    #[test]
+    fn sub_allocates_within_a_frame() {
+        let context = HeadlessRenderResourceContext::default();
+        let ring = StagingRing::new(2, 256);
+        let a = ring.allocate(&context, 64);
+        let b = ring.allocate(&context, 30);
+        let c = ring.allocate(&context, 4);
+        assert_eq!(a.buffer, b.buffer);
+        assert_eq!((a.offset, b.offset, c.offset), (0, 64, 96));
+        assert_eq!(b.size, 32);
+    }
+
+    #[test]
+    fn frames_use_separate_buffers_and_merge_overflow() {
+        let context = HeadlessRenderResourceContext::default();
+        let mut ring = StagingRing::new(2, 128);
+        let first = ring.allocate(&context, 128);
+        let overflow = ring.allocate(&context, 64);
+        assert_ne!(first.buffer, overflow.buffer);
+        ring.finish_frame(&context);
+
+        ring.begin_frame(&context);
+        let second = ring.allocate(&context, 16);
+        assert_ne!(second.buffer, first.buffer);
+        assert_ne!(second.buffer, overflow.buffer);
+        ring.finish_frame(&context);
+
+        // frame 0 comes around again with its two chunks merged
+        ring.begin_frame(&context);
+        let merged = ring.allocate(&context, 256);
+        assert_eq!(merged.offset, 0);
+        assert_eq!(context.get_buffer_info(merged.buffer).unwrap().size, 256);
+        assert!(context.get_buffer_info(first.buffer).is_none());
+        ring.finish_frame(&context);
+
+        // frame 1 reuses its buffer from the start
+        ring.begin_frame(&context);
+        assert_eq!(ring.allocate(&context, 16), second);
+    }
+
+    #[test]
+    fn offsets_stay_map_aligned() {
+        let context = HeadlessRenderResourceContext::default();
+        let ring = StagingRing::new(1, 256);
+        let a = ring.allocate(&context, 4);
+        let b = ring.allocate(&context, 12);
+        let c = ring.allocate(&context, 2);
+        assert_eq!((a.offset, b.offset, c.offset), (0, 8, 24));
+        assert_eq!((a.size, b.size, c.size), (8, 16, 8));
+    }
+
+    #[test]
+    fn allocates_from_many_threads() {
+        let context = Arc::new(HeadlessRenderResourceContext::default());
+        let ring = Arc::new(StagingRing::new(1, 1024));
+        let threads = (0..4)
+            .map(|_| {
+                let (context, ring) = (context.clone(), ring.clone());
+                std::thread::spawn(move || {
+                    (0..100)
+                        .map(|i| ring.allocate(&*context, 4 + i % 3 * 8))
+                        .collect::<Vec<_>>()
+                })
+            })
+            .collect::<Vec<_>>();
+        let mut allocations = threads
+            .into_iter()
+            .flat_map(|thread| thread.join().unwrap())
+            .collect::<Vec<_>>();
+        allocations.sort_by_key(|allocation| (allocation.buffer, allocation.offset));
+        for pair in allocations.windows(2) {
+            assert_eq!(pair[0].offset % MAP_ALIGNMENT, 0);
+            if pair[0].buffer == pair[1].buffer {
+                assert!(pair[0].offset + pair[0].size <= pair[1].offset);
+            }
+        }
+    }
+}
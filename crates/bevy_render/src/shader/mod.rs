@@ -1,11 +1,13 @@
 #[allow(clippy::module_inception)]
 mod shader;
+mod shader_cache;
 mod shader_defs;
 
 #[cfg(not(target_arch = "wasm32"))]
 mod shader_reflect;
 
 pub use shader::*;
+pub use shader_cache::*;
 pub use shader_defs::*;
 
 #[cfg(not(target_arch = "wasm32"))]
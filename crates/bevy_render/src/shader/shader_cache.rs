@@ -0,0 +1,169 @@
+use super::{Shader, ShaderSource, ShaderStage};
+use std::path::{Path, PathBuf};
+
+/// Bump this whenever the compiled output for the same source and defs may change (ex: a shaderc
+/// upgrade), so stale cache entries are ignored
+const SHADER_CACHE_VERSION: u64 = 1;
+
+const FNV_OFFSET_BASIS: u64 = 0xcbf2_9ce4_8422_2325;
+const FNV_PRIME: u64 = 0x0000_0100_0000_01b3;
+
+/// An on-disk cache of GLSL shaders compiled to SPIR-V.
+///
+/// Entries are keyed by the shader stage, its source and its sorted shader defs, so a warm start
+/// can skip GLSL compilation entirely. Failing to read or write the cache is never an error: the
+/// shader is simply compiled again.
+#[derive(Debug, Clone)]
+pub struct ShaderCache {
+    directory: PathBuf,
+}
+
+impl ShaderCache {
+    pub fn new(directory: impl Into<PathBuf>) -> Self {
+        Self {
+            directory: directory.into(),
+        }
+    }
+
+    pub fn directory(&self) -> &Path {
+        &self.directory
+    }
+
+    /// The cache key of `shader` compiled with `shader_defs`. Only GLSL shaders are cached.
+    /// The key is stable across runs and platforms, so it must not use a randomly seeded hasher.
+    pub fn key(shader: &Shader, shader_defs: &[String]) -> Option<u64> {
+        let source = match shader.source {
+            ShaderSource::Glsl(ref source) => source,
+            ShaderSource::Spirv(_) => return None,
+        };
+        let stage: u8 = match shader.stage {
+            ShaderStage::Vertex => 0,
+            ShaderStage::Fragment => 1,
+            ShaderStage::Compute => 2,
+        };
+
+        let mut shader_defs = shader_defs.iter().collect::<Vec<_>>();
+        shader_defs.sort();
+
+        let mut hash = fnv1a(FNV_OFFSET_BASIS, &SHADER_CACHE_VERSION.to_le_bytes());
+        hash = fnv1a(hash, &[stage]);
+        hash = fnv1a(hash, source.as_bytes());
+        for shader_def in shader_defs {
+            // separate defs so ["AB"] and ["A", "B"] hash differently
+            hash = fnv1a(hash, &[0]);
+            hash = fnv1a(hash, shader_def.as_bytes());
+        }
+        Some(hash)
+    }
+
+    fn path(&self, key: u64) -> PathBuf {
+        self.directory.join(format!("{:016x}.spv", key))
+    }
+
+    /// Returns the cached SPIR-V version of `shader` compiled with `shader_defs`, if there is one
+    #[cfg(not(target_arch = "wasm32"))]
+    pub fn load(&self, shader: &Shader, shader_defs: &[String]) -> Option<Shader> {
+        let key = Self::key(shader, shader_defs)?;
+        let bytes = std::fs::read(self.path(key)).ok()?;
+        // a truncated write leaves a partial file behind, which must not be trusted
+        if bytes.is_empty() || bytes.len() % 4 != 0 {
+            return None;
+        }
+        Some(Shader::new(
+            shader.stage,
+            ShaderSource::spirv_from_bytes(&bytes),
+        ))
+    }
+
+    /// Stores `compiled`, the SPIR-V version of `shader` compiled with `shader_defs`
+    #[cfg(not(target_arch = "wasm32"))]
+    pub fn store(&self, shader: &Shader, shader_defs: &[String], compiled: &Shader) {
+        let words = match compiled.source {
+            ShaderSource::Spirv(ref words) => words,
+            ShaderSource::Glsl(_) => return,
+        };
+        let key = if let Some(key) = Self::key(shader, shader_defs) {
+            key
+        } else {
+            return;
+        };
+        let bytes = words
+            .iter()
+            .flat_map(|word| word.to_le_bytes().to_vec())
+            .collect::<Vec<u8>>();
+
+        // write to a temporary file first so concurrent readers never see a partial entry
+        let path = self.path(key);
+        let temp_path = path.with_extension(format!("spv.{}.tmp", std::process::id()));
+        let result = std::fs::create_dir_all(&self.directory)
+            .and_then(|_| std::fs::write(&temp_path, &bytes))
+            .and_then(|_| std::fs::rename(&temp_path, &path));
+        if let Err(err) = result {
+            bevy_utils::tracing::debug!("failed to write shader cache entry {:?}: {}", path, err);
+            let _ = std::fs::remove_file(&temp_path);
+        }
+    }
+}
+
+fn fnv1a(mut hash: u64, bytes: &[u8]) -> u64 {
+    for byte in bytes {
+        hash ^= *byte as u64;
+        hash = hash.wrapping_mul(FNV_PRIME);
+    }
+    hash
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn key_ignores_shader_def_order() {
+        let shader = Shader::from_glsl(ShaderStage::Vertex, "void main() {}");
+        let defs = |defs: &[&str]| defs.iter().map(|def| def.to_string()).collect::<Vec<_>>();
+        assert_eq!(
+            ShaderCache::key(&shader, &defs(&["A", "B"])),
+            ShaderCache::key(&shader, &defs(&["B", "A"]))
+        );
+        assert_ne!(
+            ShaderCache::key(&shader, &defs(&["AB"])),
+            ShaderCache::key(&shader, &defs(&["A", "B"]))
+        );
+        let fragment = Shader::from_glsl(ShaderStage::Fragment, "void main() {}");
+        assert_ne!(
+            ShaderCache::key(&shader, &[]),
+            ShaderCache::key(&fragment, &[])
+        );
+        assert_eq!(
+            ShaderCache::key(
+                &Shader::new(ShaderStage::Vertex, ShaderSource::Spirv(vec![])),
+                &[]
+            ),
+            None
+        );
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[test]
+    fn stores_and_loads_spirv() {
+        let directory =
+            std::env::temp_dir().join(format!("bevy_shader_cache_{}", std::process::id()));
+        let cache = ShaderCache::new(&directory);
+        let shader = Shader::from_glsl(ShaderStage::Fragment, "void main() {}");
+        let defs = vec!["FOO".to_string()];
+        assert!(cache.load(&shader, &defs).is_none());
+
+        // a minimal module header: magic number, version, generator, bound, schema
+        let compiled = Shader::new(
+            ShaderStage::Fragment,
+            ShaderSource::Spirv(vec![0x0723_0203, 0x0001_0000, 0, 1, 0]),
+        );
+        cache.store(&shader, &defs, &compiled);
+        let loaded = cache.load(&shader, &defs).unwrap();
+        assert_eq!(loaded.source, compiled.source);
+        assert_eq!(loaded.stage, ShaderStage::Fragment);
+        assert!(cache.load(&shader, &[]).is_none());
+
+        let _ = std::fs::remove_dir_all(&directory);
+    }
+}
@@ -0,0 +1,156 @@
+use super::{Extent3d, Texture, TextureDimension, TextureError, TextureFormat};
+use anyhow::Result;
+use bevy_asset::{AssetLoader, LoadContext, LoadedAsset};
+use bevy_utils::BoxedFuture;
+use std::convert::TryInto;
+
+const KTX2_IDENTIFIER: [u8; 12] = [
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A,
+];
+// identifier, 9 u32 fields and the data format, key/value and supercompression indices
+const HEADER_SIZE: usize = 80;
+const LEVEL_INDEX_ENTRY_SIZE: usize = 24;
+
+/// Loads KTX2 textures holding GPU compressed (BCn or ETC2) or RGBA8 data as Texture assets.
+///
+/// The data is uploaded as is, without decoding it on the CPU. Only the first mip level is
+/// loaded and Basis Universal payloads (which need transcoding) are not supported.
+#[derive(Clone, Default)]
+pub struct Ktx2TextureLoader;
+
+impl AssetLoader for Ktx2TextureLoader {
+    fn load<'a>(
+        &'a self,
+        bytes: &'a [u8],
+        load_context: &'a mut LoadContext,
+    ) -> BoxedFuture<'a, Result<()>> {
+        Box::pin(async move {
+            let texture = ktx2_buffer_to_texture(bytes)?;
+            load_context.set_default_asset(LoadedAsset::new(texture));
+            Ok(())
+        })
+    }
+
+    fn extensions(&self) -> &[&str] {
+        &["ktx2"]
+    }
+}
+
+/// Reads the first mip level of a KTX2 file
+pub fn ktx2_buffer_to_texture(buffer: &[u8]) -> Result<Texture, TextureError> {
+    if buffer.len() < HEADER_SIZE || buffer[0..12] != KTX2_IDENTIFIER {
+        return Err(TextureError::InvalidKtx2("not a KTX2 file"));
+    }
+    let read_u32 =
+        |offset: usize| u32::from_le_bytes(buffer[offset..offset + 4].try_into().unwrap());
+    let read_u64 =
+        |offset: usize| u64::from_le_bytes(buffer[offset..offset + 8].try_into().unwrap());
+
+    let vk_format = read_u32(12);
+    let width = read_u32(20);
+    let height = read_u32(24).max(1);
+    let depth = read_u32(28);
+    let layers = read_u32(32).max(1);
+    let faces = read_u32(36);
+    let supercompression = read_u32(44);
+
+    if supercompression != 0 {
+        return Err(TextureError::InvalidKtx2(
+            "unsupported supercompression scheme",
+        ));
+    }
+    if depth > 1 {
+        return Err(TextureError::InvalidKtx2("3d textures are not supported"));
+    }
+    let format = match vk_format {
+        // Basis Universal (UASTC) textures don't declare a GPU format
+        0 => {
+            return Err(TextureError::InvalidKtx2(
+                "Basis Universal textures need transcoding",
+            ))
+        }
+        37 => TextureFormat::Rgba8Unorm,
+        43 => TextureFormat::Rgba8UnormSrgb,
+        131 | 133 => TextureFormat::Bc1RgbaUnorm,
+        132 | 134 => TextureFormat::Bc1RgbaUnormSrgb,
+        135 => TextureFormat::Bc2RgbaUnorm,
+        136 => TextureFormat::Bc2RgbaUnormSrgb,
+        137 => TextureFormat::Bc3RgbaUnorm,
+        138 => TextureFormat::Bc3RgbaUnormSrgb,
+        139 => TextureFormat::Bc4RUnorm,
+        140 => TextureFormat::Bc4RSnorm,
+        141 => TextureFormat::Bc5RgUnorm,
+        142 => TextureFormat::Bc5RgSnorm,
+        143 => TextureFormat::Bc6hRgbUfloat,
+        144 => TextureFormat::Bc6hRgbSfloat,
+        145 => TextureFormat::Bc7RgbaUnorm,
+        146 => TextureFormat::Bc7RgbaUnormSrgb,
+        147 => TextureFormat::Etc2RgbUnorm,
+        148 => TextureFormat::Etc2RgbUnormSrgb,
+        149 => TextureFormat::Etc2RgbA1Unorm,
+        150 => TextureFormat::Etc2RgbA1UnormSrgb,
+        151 => TextureFormat::Etc2RgbA8Unorm,
+        152 => TextureFormat::Etc2RgbA8UnormSrgb,
+        _ => return Err(TextureError::InvalidKtx2("unsupported texture format")),
+    };
+
+    // the first entry of the level index describes the base level
+    if buffer.len() < HEADER_SIZE + LEVEL_INDEX_ENTRY_SIZE {
+        return Err(TextureError::InvalidKtx2("missing level index"));
+    }
+    let offset = read_u64(HEADER_SIZE) as usize;
+    let length = read_u64(HEADER_SIZE + 8) as usize;
+    let array_layers = layers * faces.max(1);
+    if length != format.layer_size(width, height) * array_layers as usize {
+        return Err(TextureError::InvalidKtx2(
+            "level size doesn't match its format",
+        ));
+    }
+    let data = offset
+        .checked_add(length)
+        .and_then(|end| buffer.get(offset..end))
+        .ok_or(TextureError::InvalidKtx2("level data is out of bounds"))?;
+
+    Ok(Texture {
+        data: data.to_vec(),
+        size: Extent3d::new(width, height, array_layers),
+        format,
+        dimension: TextureDimension::D2,
+        ..Default::default()
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn ktx2(vk_format: u32, width: u32, height: u32, data: &[u8]) -> Vec<u8> {
+        let mut bytes = KTX2_IDENTIFIER.to_vec();
+        // format, type size, width, height, depth, layers, faces, levels, supercompression
+        for field in [vk_format, 1, width, height, 0, 0, 1, 1, 0].iter() {
+            bytes.extend_from_slice(&field.to_le_bytes());
+        }
+        // data format, key/value and supercompression global data indices
+        bytes.resize(HEADER_SIZE, 0);
+        let offset = (HEADER_SIZE + LEVEL_INDEX_ENTRY_SIZE) as u64;
+        for field in [offset, data.len() as u64, data.len() as u64].iter() {
+            bytes.extend_from_slice(&field.to_le_bytes());
+        }
+        bytes.extend_from_slice(data);
+        bytes
+    }
+
+    #[test]
+    fn loads_compressed_level() {
+        // 8x4 pixels are two 8 byte BC1 blocks
+        let data = (0..16).collect::<Vec<u8>>();
+        let texture = ktx2_buffer_to_texture(&ktx2(133, 8, 4, &data)).unwrap();
+        assert_eq!(texture.format, TextureFormat::Bc1RgbaUnorm);
+        assert_eq!(texture.size, Extent3d::new(8, 4, 1));
+        assert_eq!(texture.data, data);
+
+        assert!(ktx2_buffer_to_texture(&ktx2(133, 8, 8, &data)).is_err());
+        assert!(ktx2_buffer_to_texture(&ktx2(0, 8, 4, &data)).is_err());
+        assert!(ktx2_buffer_to_texture(b"not a texture").is_err());
+    }
+}
@@ -1,6 +1,8 @@
 #[cfg(feature = "hdr")]
 mod hdr_texture_loader;
 mod image_texture_loader;
+#[cfg(feature = "ktx2")]
+mod ktx2_texture_loader;
 mod sampler_descriptor;
 #[allow(clippy::module_inception)]
 mod texture;
@@ -12,6 +14,8 @@ pub(crate) mod image_texture_conversion;
 #[cfg(feature = "hdr")]
 pub use hdr_texture_loader::*;
 pub use image_texture_loader::*;
+#[cfg(feature = "ktx2")]
+pub use ktx2_texture_loader::*;
 pub use sampler_descriptor::*;
 pub use texture::*;
 pub use texture_descriptor::*;
@@ -221,6 +221,12 @@ impl Texture {
     /// Load a bytes buffer in a [`Texture`], according to type `image_type`, using the `image`
     /// crate`
     pub fn from_buffer(buffer: &[u8], image_type: ImageType) -> Result<Texture, TextureError> {
+        // KTX2 textures hold GPU ready data, which is used without decoding it
+        #[cfg(feature = "ktx2")]
+        if let ImageType::MimeType("image/ktx2") | ImageType::Extension("ktx2") = image_type {
+            return super::ktx2_buffer_to_texture(buffer);
+        }
+
         let format = match image_type {
             ImageType::MimeType(mime_type) => match mime_type {
                 "image/png" => Ok(image::ImageFormat::Png),
@@ -288,6 +294,8 @@ pub enum TextureError {
     InvalidImageExtension(String),
     #[error("failed to load an image: {0}")]
     ImageError(#[from] image::ImageError),
+    #[error("invalid KTX2 texture: {0}")]
+    InvalidKtx2(&'static str),
 }
 
 /// Type of a raw image buffer
@@ -154,9 +154,33 @@ pub enum TextureFormat {
     Depth32Float = 35,
     Depth24Plus = 36,
     Depth24PlusStencil8 = 37,
+
+    // Block compressed formats, see [`TextureFormat::block_dimensions`]. Using these requires the
+    // matching texture compression feature of the render backend.
+    Bc1RgbaUnorm = 38,
+    Bc1RgbaUnormSrgb = 39,
+    Bc2RgbaUnorm = 40,
+    Bc2RgbaUnormSrgb = 41,
+    Bc3RgbaUnorm = 42,
+    Bc3RgbaUnormSrgb = 43,
+    Bc4RUnorm = 44,
+    Bc4RSnorm = 45,
+    Bc5RgUnorm = 46,
+    Bc5RgSnorm = 47,
+    Bc6hRgbUfloat = 48,
+    Bc6hRgbSfloat = 49,
+    Bc7RgbaUnorm = 50,
+    Bc7RgbaUnormSrgb = 51,
+    Etc2RgbUnorm = 52,
+    Etc2RgbUnormSrgb = 53,
+    Etc2RgbA1Unorm = 54,
+    Etc2RgbA1UnormSrgb = 55,
+    Etc2RgbA8Unorm = 56,
+    Etc2RgbA8UnormSrgb = 57,
 }
 
 impl TextureFormat {
+    /// The size of a pixel, or of a block of pixels for compressed formats
     pub fn pixel_info(&self) -> PixelInfo {
         let type_size = match self {
             // 8bit
@@ -204,6 +228,28 @@ impl TextureFormat {
             TextureFormat::Rg11b10Float => 4,
             TextureFormat::Depth24Plus => 3, // FIXME is this correct?
             TextureFormat::Depth24PlusStencil8 => 4,
+
+            // 4x4 blocks
+            TextureFormat::Bc1RgbaUnorm
+            | TextureFormat::Bc1RgbaUnormSrgb
+            | TextureFormat::Bc4RUnorm
+            | TextureFormat::Bc4RSnorm
+            | TextureFormat::Etc2RgbUnorm
+            | TextureFormat::Etc2RgbUnormSrgb
+            | TextureFormat::Etc2RgbA1Unorm
+            | TextureFormat::Etc2RgbA1UnormSrgb => 8,
+            TextureFormat::Bc2RgbaUnorm
+            | TextureFormat::Bc2RgbaUnormSrgb
+            | TextureFormat::Bc3RgbaUnorm
+            | TextureFormat::Bc3RgbaUnormSrgb
+            | TextureFormat::Bc5RgUnorm
+            | TextureFormat::Bc5RgSnorm
+            | TextureFormat::Bc6hRgbUfloat
+            | TextureFormat::Bc6hRgbSfloat
+            | TextureFormat::Bc7RgbaUnorm
+            | TextureFormat::Bc7RgbaUnormSrgb
+            | TextureFormat::Etc2RgbA8Unorm
+            | TextureFormat::Etc2RgbA8UnormSrgb => 16,
         };
 
         let components = match self {
@@ -249,6 +295,9 @@ impl TextureFormat {
             | TextureFormat::Depth32Float
             | TextureFormat::Depth24Plus
             | TextureFormat::Depth24PlusStencil8 => 1,
+
+            // compressed blocks
+            _ => 1,
         };
 
         PixelInfo {
@@ -261,6 +310,29 @@ impl TextureFormat {
         let info = self.pixel_info();
         info.type_size * info.num_components
     }
+
+    /// The width and height of the blocks `pixel_size` applies to, `(1, 1)` for uncompressed
+    /// formats
+    pub fn block_dimensions(&self) -> (u32, u32) {
+        if self.is_compressed() {
+            (4, 4)
+        } else {
+            (1, 1)
+        }
+    }
+
+    pub fn is_compressed(&self) -> bool {
+        // compressed formats are declared last
+        *self >= TextureFormat::Bc1RgbaUnorm
+    }
+
+    /// The number of bytes needed to store a single layer of `width` x `height` pixels
+    pub fn layer_size(&self, width: u32, height: u32) -> usize {
+        let (block_width, block_height) = self.block_dimensions();
+        let blocks_x = (width + block_width - 1) / block_width;
+        let blocks_y = (height + block_height - 1) / block_height;
+        blocks_x as usize * blocks_y as usize * self.pixel_size()
+    }
 }
 
 impl Default for TextureFormat {
@@ -1,5 +1,5 @@
 use crate::{
-    draw::DrawContext,
+    draw::{DrawContext, DrawError},
     mesh::Indices,
     pipeline::{PipelineDescriptor, PipelineSpecialization, RenderPipeline},
     prelude::*,
@@ -101,13 +101,16 @@ pub fn draw_wireframes_system(
         render_pipeline.dynamic_bindings_generation =
             render_pipelines.bindings.dynamic_bindings_generation();
 
-        draw_context
-            .set_pipeline(
-                &mut draw,
-                &render_pipeline.pipeline,
-                &render_pipeline.specialization,
-            )
-            .unwrap();
+        match draw_context.set_pipeline(
+            &mut draw,
+            &render_pipeline.pipeline,
+            &render_pipeline.specialization,
+        ) {
+            Ok(()) => {}
+            // skip drawing until the pipeline is compiled
+            Err(DrawError::PipelineNotReady) => return,
+            Err(err) => panic!("{}", err),
+        }
         draw_context
             .set_bind_groups_from_bindings(&mut draw, &mut [&mut render_pipelines.bindings])
             .unwrap();
@@ -0,0 +1,496 @@
+use crate::{serde::SceneDeserializer, DynamicScene, Entity};
+use bevy_reflect::{
+    DynamicList, DynamicMap, DynamicStruct, DynamicTuple, DynamicTupleStruct, Reflect,
+    ReflectDefault, ReflectDeserialize, ReflectRef, TypeRegistration, TypeRegistry,
+    TypeRegistryArc,
+};
+use bevy_utils::HashMap;
+use bincode::Options;
+use serde::de::DeserializeSeed;
+use std::convert::TryInto;
+use thiserror::Error;
+
+/// The first bytes of every binary scene
+pub const BINARY_SCENE_MAGIC: [u8; 4] = *b"BSCN";
+/// The binary scene format version written by [`serialize_binary_scene`]
+pub const BINARY_SCENE_VERSION: u32 = 1;
+
+const KIND_VALUE: u8 = 0;
+const KIND_STRUCT: u8 = 1;
+const KIND_TUPLE_STRUCT: u8 = 2;
+const KIND_TUPLE: u8 = 3;
+const KIND_LIST: u8 = 4;
+const KIND_MAP: u8 = 5;
+
+#[derive(Error, Debug)]
+pub enum BinarySceneError {
+    #[error("not a binary scene")]
+    InvalidMagic,
+    #[error("unsupported binary scene version {0}")]
+    UnsupportedVersion(u32),
+    #[error("binary scene is truncated or corrupt")]
+    Corrupt,
+    #[error("scene contains the unregistered type `{type_name}`. consider registering the type using `app.register_type::<T>()`")]
+    UnregisteredType { type_name: String },
+    #[error("type `{type_name}` does not support ReflectValue serialization")]
+    NotSerializable { type_name: String },
+    #[error("type `{type_name}` is missing `#[reflect_value(Deserialize)]`")]
+    NotDeserializable { type_name: String },
+    #[error("invalid value in binary scene: {0}")]
+    Value(#[from] bincode::Error),
+    #[error("invalid ron scene: {0}")]
+    Ron(#[from] ron::Error),
+}
+
+fn value_options() -> impl Options {
+    bincode::DefaultOptions::new()
+}
+
+/// Serializes a scene to the binary scene format.
+///
+/// A binary scene starts with a table of every type and field name it uses, values refer to the
+/// table by index. Plain data types are stored by their `Serialize` impl, so they are decoded
+/// straight into their concrete type without building a dynamic value for their fields. These are
+/// reflected values (ex: `Vec3`) and types registered with `#[reflect(Serialize, Deserialize)]`.
+/// Dynamic values of such types (ex: components of a scene built from a world) are converted to
+/// the concrete type first if it is also registered with `#[reflect(Default)]`.
+pub fn serialize_binary_scene(
+    scene: &DynamicScene,
+    type_registry: &TypeRegistry,
+) -> Result<Vec<u8>, BinarySceneError> {
+    let mut writer = BinarySceneWriter {
+        type_registry,
+        strings: Vec::new(),
+        string_indices: HashMap::default(),
+        body: Vec::new(),
+    };
+    write_varint(&mut writer.body, scene.entities.len() as u64);
+    for entity in scene.entities.iter() {
+        write_varint(&mut writer.body, entity.entity as u64);
+        write_varint(&mut writer.body, entity.components.len() as u64);
+        for component in entity.components.iter() {
+            writer.write_value(&**component)?;
+        }
+    }
+
+    let mut bytes = Vec::with_capacity(writer.body.len() + 64);
+    bytes.extend_from_slice(&BINARY_SCENE_MAGIC);
+    bytes.extend_from_slice(&BINARY_SCENE_VERSION.to_le_bytes());
+    write_varint(&mut bytes, writer.strings.len() as u64);
+    for string in writer.strings.iter() {
+        write_varint(&mut bytes, string.len() as u64);
+        bytes.extend_from_slice(string.as_bytes());
+    }
+    bytes.extend_from_slice(&writer.body);
+    Ok(bytes)
+}
+
+/// Reads a scene written by [`serialize_binary_scene`]
+pub fn deserialize_binary_scene(
+    bytes: &[u8],
+    type_registry: &TypeRegistry,
+) -> Result<DynamicScene, BinarySceneError> {
+    if bytes.len() < 8 || bytes[0..4] != BINARY_SCENE_MAGIC {
+        return Err(BinarySceneError::InvalidMagic);
+    }
+    let version = u32::from_le_bytes(bytes[4..8].try_into().unwrap());
+    if version != BINARY_SCENE_VERSION {
+        return Err(BinarySceneError::UnsupportedVersion(version));
+    }
+
+    let mut reader = BinarySceneReader {
+        bytes: &bytes[8..],
+        type_registry,
+        strings: Vec::new(),
+        registrations: Vec::new(),
+    };
+    let string_count = reader.read_len()?;
+    reader.strings.reserve(string_count);
+    for _ in 0..string_count {
+        let len = reader.read_len()?;
+        let string =
+            std::str::from_utf8(reader.read_bytes(len)?).map_err(|_| BinarySceneError::Corrupt)?;
+        reader.strings.push(string);
+    }
+    reader.registrations = vec![None; string_count];
+
+    let entity_count = reader.read_len()?;
+    let mut entities = Vec::with_capacity(entity_count);
+    for _ in 0..entity_count {
+        let entity = reader.read_varint()? as u32;
+        let component_count = reader.read_len()?;
+        let mut components = Vec::with_capacity(component_count);
+        for _ in 0..component_count {
+            components.push(reader.read_value()?);
+        }
+        entities.push(Entity { entity, components });
+    }
+    if !reader.bytes.is_empty() {
+        return Err(BinarySceneError::Corrupt);
+    }
+    Ok(DynamicScene { entities })
+}
+
+/// Converts a RON scene (as read by [`SceneLoader`](crate::SceneLoader)) to the binary scene
+/// format
+pub fn ron_scene_to_binary(
+    ron: &[u8],
+    type_registry: &TypeRegistryArc,
+) -> Result<Vec<u8>, BinarySceneError> {
+    let type_registry = type_registry.read();
+    let mut deserializer = ron::de::Deserializer::from_bytes(ron)?;
+    let scene = SceneDeserializer {
+        type_registry: &*type_registry,
+    }
+    .deserialize(&mut deserializer)?;
+    serialize_binary_scene(&scene, &*type_registry)
+}
+
+/// Converts a binary scene back to RON
+pub fn binary_scene_to_ron(
+    bytes: &[u8],
+    type_registry: &TypeRegistryArc,
+) -> Result<String, BinarySceneError> {
+    let scene = deserialize_binary_scene(bytes, &*type_registry.read())?;
+    Ok(scene.serialize_ron(type_registry)?)
+}
+
+struct BinarySceneWriter<'a> {
+    type_registry: &'a TypeRegistry,
+    strings: Vec<String>,
+    string_indices: HashMap<String, u64>,
+    body: Vec<u8>,
+}
+
+impl<'a> BinarySceneWriter<'a> {
+    fn write_string(&mut self, string: &str) {
+        let index = match self.string_indices.get(string) {
+            Some(index) => *index,
+            None => {
+                let index = self.strings.len() as u64;
+                self.strings.push(string.to_string());
+                self.string_indices.insert(string.to_string(), index);
+                index
+            }
+        };
+        write_varint(&mut self.body, index);
+    }
+
+    fn write_value(&mut self, value: &dyn Reflect) -> Result<(), BinarySceneError> {
+        self.write_string(value.type_name());
+        if self.write_plain_data(value)? {
+            return Ok(());
+        }
+        match value.reflect_ref() {
+            ReflectRef::Value(value) => {
+                let type_name = value.type_name().to_string();
+                return Err(match value.serializable() {
+                    Some(_) => BinarySceneError::NotDeserializable { type_name },
+                    None => BinarySceneError::NotSerializable { type_name },
+                });
+            }
+            ReflectRef::Struct(value) => {
+                self.body.push(KIND_STRUCT);
+                write_varint(&mut self.body, value.field_len() as u64);
+                for (i, field) in value.iter_fields().enumerate() {
+                    self.write_string(value.name_at(i).unwrap());
+                    self.write_value(field)?;
+                }
+            }
+            ReflectRef::TupleStruct(value) => {
+                self.body.push(KIND_TUPLE_STRUCT);
+                write_varint(&mut self.body, value.field_len() as u64);
+                for field in value.iter_fields() {
+                    self.write_value(field)?;
+                }
+            }
+            ReflectRef::Tuple(value) => {
+                self.body.push(KIND_TUPLE);
+                write_varint(&mut self.body, value.field_len() as u64);
+                for field in value.iter_fields() {
+                    self.write_value(field)?;
+                }
+            }
+            ReflectRef::List(value) => {
+                self.body.push(KIND_LIST);
+                write_varint(&mut self.body, value.len() as u64);
+                for item in value.iter() {
+                    self.write_value(item)?;
+                }
+            }
+            ReflectRef::Map(value) => {
+                self.body.push(KIND_MAP);
+                write_varint(&mut self.body, value.len() as u64);
+                for (key, value) in value.iter() {
+                    self.write_value(key)?;
+                    self.write_value(value)?;
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Writes `value` as a single serialized value if its type can be deserialized directly.
+    /// Returns `false` without writing anything otherwise.
+    fn write_plain_data(&mut self, value: &dyn Reflect) -> Result<bool, BinarySceneError> {
+        let registration = match self.type_registry.get_with_name(value.type_name()) {
+            Some(registration) if registration.data::<ReflectDeserialize>().is_some() => {
+                registration
+            }
+            _ => return Ok(false),
+        };
+        let payload = if let Some(serializable) = value.serializable() {
+            value_options().serialize(serializable.borrow())?
+        } else if let Some(reflect_default) = registration.data::<ReflectDefault>() {
+            let mut concrete = reflect_default.default();
+            concrete.apply(value);
+            match concrete.serializable() {
+                Some(serializable) => value_options().serialize(serializable.borrow())?,
+                None => return Ok(false),
+            }
+        } else {
+            return Ok(false);
+        };
+        self.body.push(KIND_VALUE);
+        write_varint(&mut self.body, payload.len() as u64);
+        self.body.extend_from_slice(&payload);
+        Ok(true)
+    }
+}
+
+struct BinarySceneReader<'a> {
+    bytes: &'a [u8],
+    type_registry: &'a TypeRegistry,
+    strings: Vec<&'a str>,
+    /// The registrations of the table strings that are type names, looked up on first use
+    registrations: Vec<Option<&'a TypeRegistration>>,
+}
+
+impl<'a> BinarySceneReader<'a> {
+    fn read_u8(&mut self) -> Result<u8, BinarySceneError> {
+        let (byte, rest) = self.bytes.split_first().ok_or(BinarySceneError::Corrupt)?;
+        self.bytes = rest;
+        Ok(*byte)
+    }
+
+    fn read_varint(&mut self) -> Result<u64, BinarySceneError> {
+        let mut value = 0u64;
+        for shift in (0..64).step_by(7) {
+            let byte = self.read_u8()?;
+            value |= ((byte & 0x7f) as u64) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(value);
+            }
+        }
+        Err(BinarySceneError::Corrupt)
+    }
+
+    /// Reads a length, which can't be longer than the rest of the file
+    fn read_len(&mut self) -> Result<usize, BinarySceneError> {
+        let len = self.read_varint()?;
+        if len > self.bytes.len() as u64 {
+            return Err(BinarySceneError::Corrupt);
+        }
+        Ok(len as usize)
+    }
+
+    fn read_bytes(&mut self, len: usize) -> Result<&'a [u8], BinarySceneError> {
+        if len > self.bytes.len() {
+            return Err(BinarySceneError::Corrupt);
+        }
+        let (bytes, rest) = self.bytes.split_at(len);
+        self.bytes = rest;
+        Ok(bytes)
+    }
+
+    fn read_string(&mut self) -> Result<(usize, &'a str), BinarySceneError> {
+        let index = self.read_varint()? as usize;
+        let string = self
+            .strings
+            .get(index)
+            .copied()
+            .ok_or(BinarySceneError::Corrupt)?;
+        Ok((index, string))
+    }
+
+    fn read_value(&mut self) -> Result<Box<dyn Reflect>, BinarySceneError> {
+        let (type_index, type_name) = self.read_string()?;
+        let kind = self.read_u8()?;
+        match kind {
+            KIND_VALUE => {
+                let registration = match self.registrations[type_index] {
+                    Some(registration) => registration,
+                    None => {
+                        let registration =
+                            self.type_registry.get_with_name(type_name).ok_or_else(|| {
+                                BinarySceneError::UnregisteredType {
+                                    type_name: type_name.to_string(),
+                                }
+                            })?;
+                        self.registrations[type_index] = Some(registration);
+                        registration
+                    }
+                };
+                let reflect_deserialize =
+                    registration.data::<ReflectDeserialize>().ok_or_else(|| {
+                        BinarySceneError::NotDeserializable {
+                            type_name: type_name.to_string(),
+                        }
+                    })?;
+                let len = self.read_len()?;
+                let payload = self.read_bytes(len)?;
+                let mut deserializer = bincode::Deserializer::from_slice(payload, value_options());
+                Ok(reflect_deserialize.deserialize(&mut deserializer)?)
+            }
+            KIND_STRUCT => {
+                let mut value = DynamicStruct::default();
+                value.set_name(type_name.to_string());
+                for _ in 0..self.read_len()? {
+                    let (_, field_name) = self.read_string()?;
+                    let field = self.read_value()?;
+                    value.insert_boxed(field_name, field);
+                }
+                Ok(Box::new(value))
+            }
+            KIND_TUPLE_STRUCT => {
+                let mut value = DynamicTupleStruct::default();
+                value.set_name(type_name.to_string());
+                for _ in 0..self.read_len()? {
+                    value.insert_boxed(self.read_value()?);
+                }
+                Ok(Box::new(value))
+            }
+            KIND_TUPLE => {
+                let len = self.read_len()?;
+                let mut fields = Vec::with_capacity(len);
+                for _ in 0..len {
+                    fields.push(self.read_value()?);
+                }
+                Ok(Box::new(DynamicTuple::from_boxed_fields(
+                    type_name.to_string(),
+                    fields,
+                )))
+            }
+            KIND_LIST => {
+                let mut value = DynamicList::default();
+                value.set_name(type_name.to_string());
+                for _ in 0..self.read_len()? {
+                    value.push_box(self.read_value()?);
+                }
+                Ok(Box::new(value))
+            }
+            KIND_MAP => {
+                let mut value = DynamicMap::default();
+                value.set_name(type_name.to_string());
+                for _ in 0..self.read_len()? {
+                    let key = self.read_value()?;
+                    value.insert_boxed(key, self.read_value()?);
+                }
+                Ok(Box::new(value))
+            }
+            _ => Err(BinarySceneError::Corrupt),
+        }
+    }
+}
+
+fn write_varint(bytes: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        bytes.push(value as u8 | 0x80);
+        value >>= 7;
+    }
+    bytes.push(value as u8);
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use serde::{Deserialize, Serialize};
+
+    #[derive(Reflect, Default)]
+    struct Named {
+        name: String,
+        values: Vec<u32>,
+        pair: (f32, bool),
+    }
+
+    #[test]
+    fn binary_scene_roundtrip() {
+        let type_registry = TypeRegistryArc::default();
+        {
+            let mut type_registry = type_registry.write();
+            type_registry.register::<Named>();
+            type_registry.register::<String>();
+            type_registry.register::<u32>();
+            type_registry.register::<f32>();
+            type_registry.register::<bool>();
+        }
+
+        let scene = DynamicScene {
+            entities: vec![Entity {
+                entity: 3,
+                components: vec![
+                    Box::new(Named {
+                        name: "cube".to_string(),
+                        values: vec![1, 300, 70000],
+                        pair: (0.5, true),
+                    }),
+                    Box::new(7u32),
+                ],
+            }],
+        };
+        let check = |scene: &DynamicScene| {
+            assert_eq!(scene.entities.len(), 1);
+            assert_eq!(scene.entities[0].entity, 3);
+            let components = &scene.entities[0].components;
+            assert_eq!(components.len(), 2);
+            let mut named = Named::default();
+            named.apply(&*components[0]);
+            assert_eq!(named.name, "cube");
+            assert_eq!(named.values, vec![1, 300, 70000]);
+            assert_eq!(named.pair, (0.5, true));
+            assert_eq!(components[1].downcast_ref::<u32>(), Some(&7));
+        };
+
+        let bytes = serialize_binary_scene(&scene, &*type_registry.read()).unwrap();
+        check(&deserialize_binary_scene(&bytes, &*type_registry.read()).unwrap());
+
+        let ron = binary_scene_to_ron(&bytes, &type_registry).unwrap();
+        let converted = ron_scene_to_binary(ron.as_bytes(), &type_registry).unwrap();
+        check(&deserialize_binary_scene(&converted, &*type_registry.read()).unwrap());
+
+        assert!(matches!(
+            deserialize_binary_scene(&bytes[..bytes.len() - 1], &*type_registry.read()),
+            Err(BinarySceneError::Corrupt)
+        ));
+    }
+
+    #[derive(Reflect, Default, Serialize, Deserialize, Debug, PartialEq)]
+    #[reflect(Serialize, Deserialize, Default)]
+    struct Plain {
+        position: (f32, f32),
+        id: u32,
+    }
+
+    #[test]
+    fn plain_data_decodes_into_concrete_type() {
+        let type_registry = TypeRegistryArc::default();
+        type_registry.write().register::<Plain>();
+
+        let plain = Plain {
+            position: (1.0, -2.0),
+            id: 9,
+        };
+        let scene = DynamicScene {
+            entities: vec![Entity {
+                entity: 0,
+                // scenes built from a world hold dynamic clones of their components
+                components: vec![plain.clone_value(), plain.clone_value()],
+            }],
+        };
+        let bytes = serialize_binary_scene(&scene, &*type_registry.read()).unwrap();
+        let decoded = deserialize_binary_scene(&bytes, &*type_registry.read()).unwrap();
+        for component in decoded.entities[0].components.iter() {
+            assert_eq!(component.downcast_ref::<Plain>(), Some(&plain));
+        }
+    }
+}
@@ -1,12 +1,16 @@
-use crate::{serde::SceneSerializer, Scene, SceneSpawnError};
+use crate::{
+    serde::SceneSerializer, serialize_binary_scene, BinarySceneError, Scene, SceneSpawnError,
+};
 use anyhow::Result;
 use bevy_ecs::{
     entity::EntityMap,
     reflect::{ReflectComponent, ReflectMapEntities},
-    world::World,
+    world::{ComponentBatch, World},
 };
-use bevy_reflect::{Reflect, TypeRegistryArc, TypeUuid};
+use bevy_reflect::{Reflect, TypeRegistration, TypeRegistry, TypeRegistryArc, TypeUuid};
+use bevy_utils::HashMap;
 use serde::Serialize;
+use std::any::TypeId;
 
 #[derive(Default, TypeUuid)]
 #[uuid = "749479b1-fb8c-4ff8-a775-623aa76014f5"]
@@ -65,31 +69,52 @@ impl DynamicScene {
     ) -> Result<(), SceneSpawnError> {
         let registry = world.get_resource::<TypeRegistryArc>().unwrap().clone();
         let type_registry = registry.read();
+
+        // entities that don't exist yet are spawned in batches of entities with the same
+        // components, the others get their components added or applied one by one
+        let mut batch_indices: HashMap<Vec<TypeId>, usize> = HashMap::default();
+        let mut batches: Vec<Vec<&Entity>> = Vec::new();
         for scene_entity in self.entities.iter() {
-            let entity = *entity_map
-                .entry(bevy_ecs::entity::Entity::new(scene_entity.entity))
-                .or_insert_with(|| world.spawn().id());
+            let scene_entity_id = bevy_ecs::entity::Entity::new(scene_entity.entity);
+            if let Ok(entity) = entity_map.get(scene_entity_id) {
+                Self::write_components(world, entity, scene_entity, &type_registry)?;
+                continue;
+            }
+            let mut type_ids = Vec::with_capacity(scene_entity.components.len());
             for component in scene_entity.components.iter() {
-                let registration = type_registry
-                    .get_with_name(component.type_name())
-                    .ok_or_else(|| SceneSpawnError::UnregisteredType {
-                        type_name: component.type_name().to_string(),
-                    })?;
-                let reflect_component =
-                    registration.data::<ReflectComponent>().ok_or_else(|| {
-                        SceneSpawnError::UnregisteredComponent {
-                            type_name: component.type_name().to_string(),
-                        }
-                    })?;
-                if world
-                    .entity(entity)
-                    .contains_type_id(registration.type_id())
-                {
-                    reflect_component.apply_component(world, entity, &**component);
-                } else {
-                    reflect_component.add_component(world, entity, &**component);
+                let (registration, _) = component_registration(&type_registry, &**component)?;
+                type_ids.push(registration.type_id());
+            }
+            let mut sorted_type_ids = type_ids.clone();
+            sorted_type_ids.sort();
+            sorted_type_ids.dedup();
+            if type_ids.is_empty() || sorted_type_ids.len() != type_ids.len() {
+                // the same component more than once: the later values replace the earlier ones
+                let entity = world.spawn().id();
+                entity_map.insert(scene_entity_id, entity);
+                Self::write_components(world, entity, scene_entity, &type_registry)?;
+                continue;
+            }
+            let index = *batch_indices.entry(type_ids).or_insert_with(|| {
+                batches.push(Vec::new());
+                batches.len() - 1
+            });
+            batches[index].push(scene_entity);
+        }
+
+        for scene_entities in batches {
+            let mut batch = ComponentBatch::new();
+            for scene_entity in scene_entities.iter() {
+                for component in scene_entity.components.iter() {
+                    let (_, reflect_component) =
+                        component_registration(&type_registry, &**component)?;
+                    reflect_component.add_component_to_batch(world, &**component, &mut batch);
                 }
             }
+            let entities = world.spawn_component_batch(batch);
+            for (scene_entity, entity) in scene_entities.iter().zip(entities) {
+                entity_map.insert(bevy_ecs::entity::Entity::new(scene_entity.entity), entity);
+            }
         }
 
         for registration in type_registry.iter() {
@@ -103,10 +128,56 @@ impl DynamicScene {
         Ok(())
     }
 
+    fn write_components(
+        world: &mut World,
+        entity: bevy_ecs::entity::Entity,
+        scene_entity: &Entity,
+        type_registry: &TypeRegistry,
+    ) -> Result<(), SceneSpawnError> {
+        for component in scene_entity.components.iter() {
+            let (registration, reflect_component) =
+                component_registration(type_registry, &**component)?;
+            if world
+                .entity(entity)
+                .contains_type_id(registration.type_id())
+            {
+                reflect_component.apply_component(world, entity, &**component);
+            } else {
+                reflect_component.add_component(world, entity, &**component);
+            }
+        }
+        Ok(())
+    }
+
     // TODO: move to AssetSaver when it is implemented
     pub fn serialize_ron(&self, registry: &TypeRegistryArc) -> Result<String, ron::Error> {
         serialize_ron(SceneSerializer::new(self, registry))
     }
+
+    // TODO: move to AssetSaver when it is implemented
+    pub fn serialize_binary(
+        &self,
+        registry: &TypeRegistryArc,
+    ) -> Result<Vec<u8>, BinarySceneError> {
+        serialize_binary_scene(self, &*registry.read())
+    }
+}
+
+fn component_registration<'a>(
+    type_registry: &'a TypeRegistry,
+    component: &dyn Reflect,
+) -> Result<(&'a TypeRegistration, &'a ReflectComponent), SceneSpawnError> {
+    let registration = type_registry
+        .get_with_name(component.type_name())
+        .ok_or_else(|| SceneSpawnError::UnregisteredType {
+            type_name: component.type_name().to_string(),
+        })?;
+    let reflect_component = registration.data::<ReflectComponent>().ok_or_else(|| {
+        SceneSpawnError::UnregisteredComponent {
+            type_name: component.type_name().to_string(),
+        }
+    })?;
+    Ok((registration, reflect_component))
 }
 
 pub fn serialize_ron<S>(serialize: S) -> Result<String, ron::Error>
@@ -1,3 +1,4 @@
+mod binary_scene;
 mod command;
 mod dynamic_scene;
 mod scene;
@@ -5,6 +6,7 @@ mod scene_loader;
 mod scene_spawner;
 pub mod serde;
 
+pub use binary_scene::*;
 pub use command::*;
 pub use dynamic_scene::*;
 pub use scene::*;
@@ -30,6 +32,7 @@ impl Plugin for ScenePlugin {
         app.add_asset::<DynamicScene>()
             .add_asset::<Scene>()
             .init_asset_loader::<SceneLoader>()
+            .init_asset_loader::<BinarySceneLoader>()
             .init_resource::<SceneSpawner>()
             .add_system_to_stage(
                 CoreStage::PreUpdate,
@@ -1,4 +1,4 @@
-use crate::serde::SceneDeserializer;
+use crate::{deserialize_binary_scene, serde::SceneDeserializer};
 use anyhow::Result;
 use bevy_asset::{AssetLoader, LoadContext, LoadedAsset};
 use bevy_ecs::world::{FromWorld, World};
@@ -41,3 +41,36 @@ impl AssetLoader for SceneLoader {
         &["scn", "scn.ron"]
     }
 }
+
+/// Loads scenes written by [`serialize_binary_scene`](crate::serialize_binary_scene)
+#[derive(Debug)]
+pub struct BinarySceneLoader {
+    type_registry: TypeRegistryArc,
+}
+
+impl FromWorld for BinarySceneLoader {
+    fn from_world(world: &mut World) -> Self {
+        let type_registry = world.get_resource::<TypeRegistryArc>().unwrap();
+        BinarySceneLoader {
+            type_registry: (&*type_registry).clone(),
+        }
+    }
+}
+
+impl AssetLoader for BinarySceneLoader {
+    fn load<'a>(
+        &'a self,
+        bytes: &'a [u8],
+        load_context: &'a mut LoadContext,
+    ) -> BoxedFuture<'a, Result<()>> {
+        Box::pin(async move {
+            let scene = deserialize_binary_scene(bytes, &*self.type_registry.read())?;
+            load_context.set_default_asset(LoadedAsset::new(scene));
+            Ok(())
+        })
+    }
+
+    fn extensions(&self) -> &[&str] {
+        &["scnb", "scn.bin"]
+    }
+}
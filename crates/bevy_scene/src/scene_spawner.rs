@@ -2,13 +2,14 @@ use crate::{DynamicScene, Scene};
 use bevy_app::{Events, ManualEventReader};
 use bevy_asset::{AssetEvent, Assets, Handle};
 use bevy_ecs::{
+    archetype::{Archetype, ArchetypeId},
     entity::{Entity, EntityMap},
     reflect::{ReflectComponent, ReflectMapEntities},
-    world::{Mut, World},
+    world::{ComponentBatch, Mut, World},
 };
-use bevy_reflect::TypeRegistryArc;
+use bevy_reflect::{TypeRegistry, TypeRegistryArc};
 use bevy_transform::prelude::Parent;
-use bevy_utils::{tracing::error, HashMap};
+use bevy_utils::{tracing::error, Duration, HashMap, Instant};
 use thiserror::Error;
 use uuid::Uuid;
 
@@ -17,6 +18,29 @@ struct InstanceInfo {
     entity_map: EntityMap,
 }
 
+/// How far the spawning of a scene instance got, when it is spread over several frames
+#[derive(Debug, Default)]
+struct SpawnProgress {
+    /// Filled with an empty entity for every scene entity before the first chunk is spawned
+    entity_map: EntityMap,
+    reserved: bool,
+    archetype_index: usize,
+    entity_index: usize,
+}
+
+impl SpawnProgress {
+    /// Despawns the entities of an instance that won't be finished
+    fn despawn(self, world: &mut World) {
+        for entity in self.entity_map.values() {
+            world.despawn(entity);
+        }
+    }
+}
+
+/// The number of entities of an archetype that are spawned together. The spawn time budget is
+/// checked between chunks.
+const SPAWN_CHUNK_SIZE: usize = 1024;
+
 #[derive(Copy, Clone, Debug, Eq, PartialEq, Hash)]
 pub struct InstanceId(Uuid);
 
@@ -36,6 +60,8 @@ pub struct SceneSpawner {
     scenes_to_spawn: Vec<(Handle<Scene>, InstanceId)>,
     scenes_to_despawn: Vec<Handle<DynamicScene>>,
     scenes_with_parent: Vec<(InstanceId, Entity)>,
+    spawn_budget: Option<Duration>,
+    spawn_progress: HashMap<InstanceId, SpawnProgress>,
 }
 
 #[derive(Error, Debug)]
@@ -68,6 +94,18 @@ impl SceneSpawner {
         instance_id
     }
 
+    /// Limits the time [`SceneSpawner::spawn_queued_scenes`] spends spawning [`Scene`]s each
+    /// frame, so big scenes stream in over several frames instead of stalling one. At least one
+    /// chunk of entities is spawned per frame. An instance is only ready (see
+    /// [`SceneSpawner::instance_is_ready`]) once all of its entities are spawned and mapped.
+    pub fn set_spawn_budget(&mut self, budget: Option<Duration>) {
+        self.spawn_budget = budget;
+    }
+
+    pub fn spawn_budget(&self) -> Option<Duration> {
+        self.spawn_budget
+    }
+
     pub fn despawn(&mut self, scene_handle: Handle<DynamicScene>) {
         self.scenes_to_despawn.push(scene_handle);
     }
@@ -131,79 +169,153 @@ impl SceneSpawner {
         world: &mut World,
         scene_handle: Handle<Scene>,
     ) -> Result<InstanceId, SceneSpawnError> {
-        self.spawn_sync_internal(world, scene_handle, InstanceId::new())
+        let instance_id = InstanceId::new();
+        self.spawn_sync_internal(world, scene_handle, instance_id, None)?;
+        Ok(instance_id)
     }
 
+    /// Spawns the instance, or the part of it that is left from previous frames. Returns false if
+    /// `deadline` passed before the instance was fully spawned.
+    ///
+    /// Every entity of the instance is spawned empty up front, so the entity references of each
+    /// chunk are mapped as soon as it is spawned. Entities of an instance that can't be finished
+    /// are despawned.
     fn spawn_sync_internal(
         &mut self,
         world: &mut World,
         scene_handle: Handle<Scene>,
         instance_id: InstanceId,
-    ) -> Result<InstanceId, SceneSpawnError> {
-        let mut instance_info = InstanceInfo {
-            entity_map: EntityMap::default(),
-        };
+        deadline: Option<Instant>,
+    ) -> Result<bool, SceneSpawnError> {
+        let mut progress = self.spawn_progress.remove(&instance_id).unwrap_or_default();
         let type_registry = world.get_resource::<TypeRegistryArc>().unwrap().clone();
         let type_registry = type_registry.read();
         world.resource_scope(|world, scenes: Mut<Assets<Scene>>| {
-            let scene =
-                scenes
-                    .get(&scene_handle)
-                    .ok_or_else(|| SceneSpawnError::NonExistentRealScene {
+            let scene = match scenes.get(&scene_handle) {
+                Some(scene) => scene,
+                None => {
+                    progress.despawn(world);
+                    return Err(SceneSpawnError::NonExistentRealScene {
                         handle: scene_handle.clone(),
-                    })?;
-
-            for archetype in scene.world.archetypes().iter() {
-                for scene_entity in archetype.entities() {
-                    let entity = *instance_info
-                        .entity_map
-                        .entry(*scene_entity)
-                        .or_insert_with(|| world.spawn().id());
-                    for component_id in archetype.components() {
-                        let component_info = scene
-                            .world
-                            .components()
-                            .get_info(component_id)
-                            .expect("component_ids in archetypes should have ComponentInfo");
-
-                        let reflect_component = type_registry
-                            .get(component_info.type_id().unwrap())
-                            .ok_or_else(|| SceneSpawnError::UnregisteredType {
-                                type_name: component_info.name().to_string(),
-                            })
-                            .and_then(|registration| {
-                                registration.data::<ReflectComponent>().ok_or_else(|| {
-                                    SceneSpawnError::UnregisteredComponent {
-                                        type_name: component_info.name().to_string(),
-                                    }
-                                })
-                            })?;
-                        reflect_component.copy_component(
-                            &scene.world,
-                            world,
-                            *scene_entity,
-                            entity,
-                        );
+                    });
+                }
+            };
+
+            let archetypes = scene.world.archetypes();
+            if !progress.reserved {
+                for archetype in archetypes.iter() {
+                    for scene_entity in archetype.entities() {
+                        progress
+                            .entity_map
+                            .insert(*scene_entity, world.spawn().id());
                     }
                 }
+                progress.reserved = true;
             }
-            for registration in type_registry.iter() {
-                if let Some(map_entities_reflect) = registration.data::<ReflectMapEntities>() {
-                    map_entities_reflect
-                        .map_entities(world, &instance_info.entity_map)
-                        .unwrap();
+
+            let mut spawned_chunk = false;
+            while progress.archetype_index < archetypes.len() {
+                let archetype = archetypes
+                    .get(ArchetypeId::new(progress.archetype_index))
+                    .unwrap();
+                let entity_count = archetype.entities().len();
+                if progress.entity_index >= entity_count {
+                    progress.archetype_index += 1;
+                    progress.entity_index = 0;
+                    continue;
+                }
+                if spawned_chunk && deadline.map_or(false, |deadline| Instant::now() >= deadline) {
+                    self.spawn_progress.insert(instance_id, progress);
+                    return Ok(false);
                 }
+
+                let end = (progress.entity_index + SPAWN_CHUNK_SIZE).min(entity_count);
+                if let Err(err) = Self::spawn_archetype_entities(
+                    world,
+                    &scene.world,
+                    archetype,
+                    progress.entity_index..end,
+                    &type_registry,
+                    &progress.entity_map,
+                ) {
+                    progress.despawn(world);
+                    return Err(err);
+                }
+                progress.entity_index = end;
+                spawned_chunk = true;
             }
+
+            let instance_info = InstanceInfo {
+                entity_map: progress.entity_map,
+            };
             self.spawned_instances.insert(instance_id, instance_info);
             let spawned = self
                 .spawned_scenes
                 .entry(scene_handle)
                 .or_insert_with(Vec::new);
             spawned.push(instance_id);
-            Ok(instance_id)
+            Ok(true)
         })
     }
 
+    /// Inserts the components of the scene entities of `archetype` in `range` into their already
+    /// spawned entities as one batch, so each target table is written directly instead of moving
+    /// every entity once per component. Their entity references are mapped right away.
+    fn spawn_archetype_entities(
+        world: &mut World,
+        scene_world: &World,
+        archetype: &Archetype,
+        range: std::ops::Range<usize>,
+        type_registry: &TypeRegistry,
+        entity_map: &EntityMap,
+    ) -> Result<(), SceneSpawnError> {
+        let scene_entities = &archetype.entities()[range];
+        let mut batch = ComponentBatch::new();
+        for component_id in archetype.components() {
+            let component_info = scene_world
+                .components()
+                .get_info(component_id)
+                .expect("component_ids in archetypes should have ComponentInfo");
+
+            let reflect_component = type_registry
+                .get(component_info.type_id().unwrap())
+                .ok_or_else(|| SceneSpawnError::UnregisteredType {
+                    type_name: component_info.name().to_string(),
+                })
+                .and_then(|registration| {
+                    registration.data::<ReflectComponent>().ok_or_else(|| {
+                        SceneSpawnError::UnregisteredComponent {
+                            type_name: component_info.name().to_string(),
+                        }
+                    })
+                })?;
+            for scene_entity in scene_entities {
+                let component = reflect_component
+                    .reflect_component(scene_world, *scene_entity)
+                    .unwrap();
+                reflect_component.add_component_to_batch(world, component, &mut batch);
+            }
+        }
+
+        // entities without components are already complete
+        if batch.is_empty() {
+            return Ok(());
+        }
+        let entities = scene_entities
+            .iter()
+            .map(|scene_entity| entity_map.get(*scene_entity).unwrap())
+            .collect::<Vec<_>>();
+        world.insert_component_batch(&entities, batch);
+        for registration in type_registry.iter() {
+            if let Some(map_entities_reflect) = registration.data::<ReflectMapEntities>() {
+                map_entities_reflect
+                    .map_specific_entities(world, entity_map, &entities)
+                    .unwrap();
+            }
+        }
+        Ok(())
+    }
+
     pub fn update_spawned_scenes(
         &mut self,
         world: &mut World,
@@ -247,11 +359,25 @@ impl SceneSpawner {
             }
         }
 
-        let scenes_to_spawn = std::mem::take(&mut self.scenes_to_spawn);
+        let deadline = self.spawn_budget.map(|budget| Instant::now() + budget);
+        let mut scenes_to_spawn = std::mem::take(&mut self.scenes_to_spawn).into_iter();
 
-        for (scene_handle, instance_id) in scenes_to_spawn {
-            match self.spawn_sync_internal(world, scene_handle, instance_id) {
-                Ok(_) => {}
+        let mut spawned_any = false;
+        while let Some((scene_handle, instance_id)) = scenes_to_spawn.next() {
+            if spawned_any && deadline.map_or(false, |deadline| Instant::now() >= deadline) {
+                self.scenes_to_spawn.push((scene_handle, instance_id));
+                self.scenes_to_spawn.extend(scenes_to_spawn);
+                break;
+            }
+            spawned_any = true;
+            match self.spawn_sync_internal(world, scene_handle.clone(), instance_id, deadline) {
+                Ok(true) => {}
+                Ok(false) => {
+                    // out of time, the rest is spawned next frame starting with this instance
+                    self.scenes_to_spawn.push((scene_handle, instance_id));
+                    self.scenes_to_spawn.extend(scenes_to_spawn);
+                    break;
+                }
                 Err(SceneSpawnError::NonExistentRealScene { handle }) => {
                     self.scenes_to_spawn.push((handle, instance_id))
                 }
@@ -324,3 +450,113 @@ pub fn scene_spawner_system(world: &mut World) {
         scene_spawner.set_scene_instance_parent_sync(world);
     });
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ScenePlugin;
+    use bevy_app::App;
+    use bevy_asset::AssetPlugin;
+    use bevy_tasks::{IoTaskPool, TaskPool};
+    use bevy_transform::prelude::Transform;
+
+    /// Three chunks of children after the root, each frame only spawns one chunk
+    const CHILD_COUNT: usize = 2 * SPAWN_CHUNK_SIZE + 10;
+
+    fn budgeted_spawn() -> (App, Handle<Scene>, InstanceId, Entity, Vec<Entity>) {
+        let mut app = App::build();
+        app.insert_resource(IoTaskPool(TaskPool::new()))
+            .add_plugin(AssetPlugin)
+            .add_plugin(ScenePlugin)
+            .register_type::<Transform>()
+            .register_type::<Parent>();
+
+        let mut scene_world = World::new();
+        let root = scene_world.spawn().insert(Transform::identity()).id();
+        let children = (0..CHILD_COUNT)
+            .map(|i| {
+                scene_world
+                    .spawn()
+                    .insert_bundle((Transform::from_xyz(i as f32, 0.0, 0.0), Parent(root)))
+                    .id()
+            })
+            .collect::<Vec<_>>();
+        let scene = app
+            .world_mut()
+            .get_resource_mut::<Assets<Scene>>()
+            .unwrap()
+            .add(Scene::new(scene_world));
+
+        let instance_id = {
+            let mut scene_spawner = app.world_mut().get_resource_mut::<SceneSpawner>().unwrap();
+            scene_spawner.set_spawn_budget(Some(Duration::from_secs(0)));
+            scene_spawner.spawn(scene.clone())
+        };
+        (app.app, scene, instance_id, root, children)
+    }
+
+    #[test]
+    fn budgeted_spawn_resumes_across_frames() {
+        let (mut app, _scene, instance_id, root, children) = budgeted_spawn();
+        for spawned_children in [0, SPAWN_CHUNK_SIZE, 2 * SPAWN_CHUNK_SIZE].iter() {
+            app.update();
+            let scene_spawner = app.world.get_resource::<SceneSpawner>().unwrap();
+            assert!(!scene_spawner.instance_is_ready(instance_id));
+            // every entity exists up front, the spawned chunks already point at the new root
+            let entity_map = &scene_spawner.spawn_progress[&instance_id].entity_map;
+            assert_eq!(entity_map.values().count(), CHILD_COUNT + 1);
+            let spawned_root = entity_map.get(root).unwrap();
+            assert!(app.world.get::<Transform>(spawned_root).is_some());
+            let parents = app
+                .world
+                .query::<&Parent>()
+                .iter(&app.world)
+                .map(|parent| parent.0)
+                .collect::<Vec<_>>();
+            assert_eq!(parents.len(), *spawned_children);
+            assert!(parents.iter().all(|parent| *parent == spawned_root));
+        }
+        app.update();
+
+        let scene_spawner = app.world.get_resource::<SceneSpawner>().unwrap();
+        assert!(scene_spawner.instance_is_ready(instance_id));
+        let entity_map = &scene_spawner.spawned_instances[&instance_id].entity_map;
+        assert_eq!(entity_map.values().count(), CHILD_COUNT + 1);
+        let spawned_root = entity_map.get(root).unwrap();
+        assert!(app.world.get::<Parent>(spawned_root).is_none());
+        for (i, child) in children.into_iter().enumerate() {
+            let spawned_child = entity_map.get(child).unwrap();
+            assert_eq!(
+                app.world.get::<Parent>(spawned_child).unwrap().0,
+                spawned_root
+            );
+            assert_eq!(
+                app.world
+                    .get::<Transform>(spawned_child)
+                    .unwrap()
+                    .translation
+                    .x,
+                i as f32
+            );
+        }
+    }
+
+    #[test]
+    fn removing_the_scene_despawns_a_partial_instance() {
+        let (mut app, scene, instance_id, _, _) = budgeted_spawn();
+        let entity_count = app.world.entities().len();
+        app.update();
+        app.update();
+        assert!(app.world.entities().len() > entity_count);
+
+        app.world
+            .get_resource_mut::<Assets<Scene>>()
+            .unwrap()
+            .remove(&scene);
+        app.update();
+        let scene_spawner = app.world.get_resource::<SceneSpawner>().unwrap();
+        assert!(!scene_spawner.instance_is_ready(instance_id));
+        assert!(!scene_spawner.spawn_progress.contains_key(&instance_id));
+        assert_eq!(app.world.entities().len(), entity_count);
+    }
+}
@@ -1,5 +1,5 @@
 use crate::{
-    render::SPRITE_PIPELINE_HANDLE, sprite::Sprite, ColorMaterial, TextureAtlas,
+    render::SPRITE_PIPELINE_HANDLE, sprite::Sprite, BatchedSprite, ColorMaterial, TextureAtlas,
     TextureAtlasSprite, QUAD_HANDLE, SPRITE_SHEET_PIPELINE_HANDLE,
 };
 use bevy_asset::Handle;
@@ -84,3 +84,68 @@ impl Default for SpriteSheetBundle {
         }
     }
 }
+
+/// A Bundle of components for drawing a sprite through the [`BatchedSprite`] path, which draws
+/// every visible sprite of the same material with a single draw call
+#[derive(Bundle, Clone)]
+pub struct BatchedSpriteBundle {
+    pub sprite: Sprite,
+    pub material: Handle<ColorMaterial>,
+    pub batched: BatchedSprite,
+    pub main_pass: MainPass,
+    pub draw: Draw,
+    pub visible: Visible,
+    pub transform: Transform,
+    pub global_transform: GlobalTransform,
+}
+
+impl Default for BatchedSpriteBundle {
+    fn default() -> Self {
+        Self {
+            visible: Visible {
+                is_transparent: true,
+                ..Default::default()
+            },
+            batched: BatchedSprite,
+            main_pass: MainPass,
+            draw: Default::default(),
+            sprite: Default::default(),
+            material: Default::default(),
+            transform: Default::default(),
+            global_transform: Default::default(),
+        }
+    }
+}
+
+/// A Bundle of components for drawing a single sprite from a sprite sheet through the
+/// [`BatchedSprite`] path, which draws every visible sprite of the same `TextureAtlas` with a
+/// single draw call
+#[derive(Bundle, Clone)]
+pub struct BatchedSpriteSheetBundle {
+    pub sprite: TextureAtlasSprite,
+    pub texture_atlas: Handle<TextureAtlas>,
+    pub batched: BatchedSprite,
+    pub main_pass: MainPass,
+    pub draw: Draw,
+    pub visible: Visible,
+    pub transform: Transform,
+    pub global_transform: GlobalTransform,
+}
+
+impl Default for BatchedSpriteSheetBundle {
+    fn default() -> Self {
+        Self {
+            visible: Visible {
+                is_transparent: true,
+                ..Default::default()
+            },
+            batched: BatchedSprite,
+            main_pass: MainPass,
+            draw: Default::default(),
+            sprite: Default::default(),
+            texture_atlas: Default::default(),
+            transform: Default::default(),
+            global_transform: Default::default(),
+        }
+    }
+}
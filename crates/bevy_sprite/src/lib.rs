@@ -13,8 +13,8 @@ mod texture_atlas_builder;
 pub mod prelude {
     #[doc(hidden)]
     pub use crate::{
-        entity::{SpriteBundle, SpriteSheetBundle},
-        ColorMaterial, Sprite, SpriteResizeMode, TextureAtlas, TextureAtlasSprite,
+        entity::{BatchedSpriteBundle, BatchedSpriteSheetBundle, SpriteBundle, SpriteSheetBundle},
+        BatchedSprite, ColorMaterial, Sprite, SpriteResizeMode, TextureAtlas, TextureAtlasSprite,
     };
 }
 
@@ -40,6 +40,7 @@ use bevy_render::{
     pipeline::PipelineDescriptor,
     render_graph::RenderGraph,
     shader::{asset_shader_defs_system, Shader},
+    RenderStage,
 };
 use sprite::sprite_system;
 
@@ -72,6 +73,7 @@ impl Plugin for SpritePlugin {
             .add_asset::<TextureAtlas>()
             .register_type::<Sprite>()
             .register_type::<SpriteResizeMode>()
+            .register_type::<BatchedSprite>()
             .add_system_to_stage(CoreStage::PostUpdate, sprite_system.system())
             .add_system_to_stage(
                 CoreStage::PostUpdate,
@@ -80,6 +82,10 @@ impl Plugin for SpritePlugin {
             .add_system_to_stage(
                 CoreStage::PostUpdate,
                 asset_shader_defs_system::<ColorMaterial>.system(),
+            )
+            .add_system_to_stage(
+                RenderStage::Draw,
+                render::draw_sprite_batches_system.system(),
             );
 
         let sprite_settings = app
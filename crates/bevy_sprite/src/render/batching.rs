@@ -0,0 +1,369 @@
+use crate::{
+    ColorMaterial, Rect, Sprite, TextureAtlas, TextureAtlasSprite, SPRITE_BATCH_PIPELINE_HANDLE,
+    SPRITE_SHEET_BATCH_PIPELINE_HANDLE,
+};
+use bevy_asset::{Assets, Handle, HandleId};
+use bevy_core::{cast_slice, FloatOrd, Pod, Zeroable};
+use bevy_ecs::{
+    entity::Entity,
+    query::{With, Without},
+    reflect::ReflectComponent,
+    system::{Local, Query, Res, ResMut},
+};
+use bevy_math::{Mat4, Vec2};
+use bevy_reflect::Reflect;
+use bevy_render::{
+    draw::{Draw, DrawContext, DrawError, OutsideFrustum},
+    pipeline::{
+        IndexFormat, InputStepMode, PipelineSpecialization, VertexAttribute, VertexBufferLayout,
+        VertexFormat,
+    },
+    prelude::{Msaa, Visible},
+    renderer::{BufferId, BufferInfo, BufferUsage, RenderResourceBindings},
+};
+use bevy_transform::components::GlobalTransform;
+use std::ops::Range;
+
+/// A component that draws a [`Sprite`] or a [`TextureAtlasSprite`] through the batched path.
+///
+/// Visible batched sprites are grouped by [`ColorMaterial`] or [`TextureAtlas`], their quads are
+/// written into a vertex buffer shared by every batch and each batch is drawn with a single draw
+/// call. Batched sprites don't have a mesh or `RenderPipelines`, see
+/// [`BatchedSpriteBundle`](crate::entity::BatchedSpriteBundle) and
+/// [`BatchedSpriteSheetBundle`](crate::entity::BatchedSpriteSheetBundle).
+#[derive(Debug, Default, Clone, Reflect)]
+#[reflect(Component)]
+pub struct BatchedSprite;
+
+#[repr(C)]
+#[derive(Default, Clone, Copy, PartialEq, Pod, Zeroable)]
+struct SpriteVertex {
+    position: [f32; 3],
+    uv: [f32; 2],
+    color: [f32; 4],
+}
+
+/// The layout of the vertices written by [`draw_sprite_batches_system`]
+pub fn sprite_batch_vertex_layout() -> VertexBufferLayout {
+    let mut offset = 0;
+    VertexBufferLayout {
+        name: "SpriteBatch".into(),
+        stride: std::mem::size_of::<SpriteVertex>() as u64,
+        step_mode: InputStepMode::Vertex,
+        attributes: [
+            ("Vertex_Position", VertexFormat::Float32x3),
+            ("Vertex_Uv", VertexFormat::Float32x2),
+            ("Vertex_Color", VertexFormat::Float32x4),
+        ]
+        .iter()
+        .map(|(name, format)| {
+            let attribute = VertexAttribute {
+                name: (*name).into(),
+                format: *format,
+                offset,
+                shader_location: 0,
+            };
+            offset += format.get_size();
+            attribute
+        })
+        .collect(),
+    }
+}
+
+#[derive(Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+enum SpriteBatchKey {
+    Material(HandleId),
+    TextureAtlas(HandleId),
+}
+
+struct QueuedSprite {
+    key: SpriteBatchKey,
+    depth: FloatOrd,
+    entity: Entity,
+    quad: usize,
+}
+
+struct SpriteBatch {
+    key: SpriteBatchKey,
+    /// The back-most sprite of the batch, the batch is drawn in its place
+    representative: Entity,
+    quads: Range<u32>,
+}
+
+#[derive(Default)]
+pub struct SpriteBatchState {
+    queued: Vec<QueuedSprite>,
+    quads: Vec<[SpriteVertex; 4]>,
+    batches: Vec<SpriteBatch>,
+    vertex_data: Vec<SpriteVertex>,
+    uploaded_vertex_data: Vec<SpriteVertex>,
+    vertex_buffer: Option<BufferId>,
+    index_buffer: Option<BufferId>,
+    index_buffer_quads: u32,
+}
+
+/// The corners of a quad in the order of the sprite quad mesh, with the quad's y axis pointing up
+const CORNERS: [Vec2; 4] = [
+    Vec2::new(-0.5, -0.5),
+    Vec2::new(-0.5, 0.5),
+    Vec2::new(0.5, 0.5),
+    Vec2::new(0.5, -0.5),
+];
+
+fn quad(model: &Mat4, size: Vec2, uvs: [Vec2; 4], color: [f32; 4]) -> [SpriteVertex; 4] {
+    let mut quad = [SpriteVertex::default(); 4];
+    for ((vertex, corner), uv) in quad.iter_mut().zip(CORNERS.iter()).zip(uvs.iter()) {
+        vertex.position = model.transform_point3((*corner * size).extend(0.0)).into();
+        vertex.uv = (*uv).into();
+        vertex.color = color;
+    }
+    quad
+}
+
+fn sprite_uvs(sprite: &Sprite) -> [Vec2; 4] {
+    // matches the uv flipping of `sprite.vert`
+    let epsilon = f32::EPSILON;
+    let mut uvs = [
+        Vec2::new(0.0, 1.0),
+        Vec2::new(0.0, 0.0),
+        Vec2::new(1.0, 0.0),
+        Vec2::new(1.0, 1.0),
+    ];
+    for uv in uvs.iter_mut() {
+        if sprite.flip_x {
+            uv.x = 1.0 - uv.x - epsilon;
+        }
+        if sprite.flip_y {
+            uv.y = 1.0 - uv.y - epsilon;
+        }
+    }
+    uvs
+}
+
+fn atlas_uvs(sprite: &TextureAtlasSprite, rect: &Rect, atlas_size: Vec2) -> [Vec2; 4] {
+    // matches the corner shuffling of `sprite_sheet.vert`
+    let [mut bottom_left, mut top_left, mut top_right, mut bottom_right] = [
+        Vec2::new(rect.min.x, rect.max.y),
+        rect.min,
+        Vec2::new(rect.max.x, rect.min.y),
+        rect.max,
+    ];
+    if sprite.flip_x {
+        std::mem::swap(&mut bottom_left, &mut bottom_right);
+        std::mem::swap(&mut top_left, &mut top_right);
+    }
+    if sprite.flip_y {
+        std::mem::swap(&mut bottom_left, &mut top_left);
+        std::mem::swap(&mut bottom_right, &mut top_right);
+    }
+    [
+        bottom_left / atlas_size,
+        top_left / atlas_size,
+        top_right / atlas_size,
+        bottom_right / atlas_size,
+    ]
+}
+
+/// Sorts visible [`BatchedSprite`]s by material or texture atlas and then back to front, packs
+/// their quads into a single vertex buffer and records one draw per batch on the batch's
+/// back-most sprite.
+///
+/// Sprites are sorted by their `z` translation. Batches of different materials are drawn in the
+/// place of their back-most sprite, so the sprites of two overlapping batches don't interleave.
+#[allow(clippy::too_many_arguments, clippy::type_complexity)]
+pub fn draw_sprite_batches_system(
+    mut state: Local<SpriteBatchState>,
+    mut draw_context: DrawContext,
+    mut render_resource_bindings: ResMut<RenderResourceBindings>,
+    msaa: Res<Msaa>,
+    materials: Res<Assets<ColorMaterial>>,
+    texture_atlases: Res<Assets<TextureAtlas>>,
+    mut draws: Query<&mut Draw, With<BatchedSprite>>,
+    sprites: Query<
+        (
+            Entity,
+            &Sprite,
+            &Handle<ColorMaterial>,
+            &Visible,
+            &GlobalTransform,
+        ),
+        (With<BatchedSprite>, Without<OutsideFrustum>),
+    >,
+    sheet_sprites: Query<
+        (
+            Entity,
+            &TextureAtlasSprite,
+            &Handle<TextureAtlas>,
+            &Visible,
+            &GlobalTransform,
+        ),
+        (With<BatchedSprite>, Without<OutsideFrustum>),
+    >,
+) {
+    let state = &mut *state;
+    state.queued.clear();
+    state.quads.clear();
+    state.batches.clear();
+
+    for (entity, sprite, material, visible, global_transform) in sprites.iter() {
+        if !visible.is_visible || !materials.contains(material) {
+            continue;
+        }
+        state.queued.push(QueuedSprite {
+            key: SpriteBatchKey::Material(material.id),
+            depth: FloatOrd(global_transform.translation.z),
+            entity,
+            quad: state.quads.len(),
+        });
+        state.quads.push(quad(
+            &global_transform.compute_matrix(),
+            sprite.size,
+            sprite_uvs(sprite),
+            [1.0; 4],
+        ));
+    }
+
+    for (entity, sprite, atlas_handle, visible, global_transform) in sheet_sprites.iter() {
+        if !visible.is_visible {
+            continue;
+        }
+        let (atlas, rect) = match texture_atlases
+            .get(atlas_handle)
+            .and_then(|atlas| Some((atlas, atlas.textures.get(sprite.index as usize)?)))
+        {
+            Some(atlas_and_rect) => atlas_and_rect,
+            None => continue,
+        };
+        state.queued.push(QueuedSprite {
+            key: SpriteBatchKey::TextureAtlas(atlas_handle.id),
+            depth: FloatOrd(global_transform.translation.z),
+            entity,
+            quad: state.quads.len(),
+        });
+        state.quads.push(quad(
+            &global_transform.compute_matrix(),
+            Vec2::new(rect.width(), rect.height()),
+            atlas_uvs(sprite, rect, atlas.size),
+            sprite.color.as_linear_rgba_f32(),
+        ));
+    }
+
+    state
+        .queued
+        .sort_unstable_by_key(|queued| (queued.key, queued.depth));
+
+    // pack the quads of every batch, in batch order, into one contiguous vertex buffer
+    state.vertex_data.clear();
+    for (index, queued) in state.queued.iter().enumerate() {
+        match state.batches.last_mut() {
+            Some(batch) if batch.key == queued.key => batch.quads.end += 1,
+            _ => state.batches.push(SpriteBatch {
+                key: queued.key,
+                representative: queued.entity,
+                quads: index as u32..index as u32 + 1,
+            }),
+        }
+        state
+            .vertex_data
+            .extend_from_slice(&state.quads[queued.quad]);
+    }
+
+    let render_resource_context = &**draw_context.render_resource_context;
+    // only reallocate the vertex buffer when a sprite changed
+    if state.vertex_data != state.uploaded_vertex_data {
+        if let Some(vertex_buffer) = state.vertex_buffer.take() {
+            render_resource_context.remove_buffer(vertex_buffer);
+        }
+        if !state.vertex_data.is_empty() {
+            state.vertex_buffer = Some(render_resource_context.create_buffer_with_data(
+                BufferInfo {
+                    buffer_usage: BufferUsage::VERTEX,
+                    ..Default::default()
+                },
+                cast_slice(&state.vertex_data),
+            ));
+        }
+        std::mem::swap(&mut state.vertex_data, &mut state.uploaded_vertex_data);
+    }
+
+    let quad_count = state.queued.len() as u32;
+    if state.index_buffer_quads < quad_count {
+        if let Some(index_buffer) = state.index_buffer.take() {
+            render_resource_context.remove_buffer(index_buffer);
+        }
+        state.index_buffer_quads = quad_count.next_power_of_two();
+        let indices = (0..state.index_buffer_quads)
+            .flat_map(|quad| {
+                let base = quad * 4;
+                vec![base, base + 2, base + 1, base, base + 3, base + 2]
+            })
+            .collect::<Vec<u32>>();
+        state.index_buffer = Some(render_resource_context.create_buffer_with_data(
+            BufferInfo {
+                buffer_usage: BufferUsage::INDEX,
+                ..Default::default()
+            },
+            cast_slice(&indices),
+        ));
+    }
+
+    let (vertex_buffer, index_buffer) = match (state.vertex_buffer, state.index_buffer) {
+        (Some(vertex_buffer), Some(index_buffer)) => (vertex_buffer, index_buffer),
+        _ => return,
+    };
+
+    let vertex_layout = sprite_batch_vertex_layout();
+    let quad_stride = vertex_layout.stride * 4;
+    for batch in state.batches.iter() {
+        let mut draw = if let Ok(draw) = draws.get_mut(batch.representative) {
+            draw
+        } else {
+            continue;
+        };
+
+        let mut specialization = PipelineSpecialization {
+            sample_count: msaa.samples,
+            vertex_buffer_layout: vertex_layout.clone(),
+            ..Default::default()
+        };
+        let pipeline = match batch.key {
+            SpriteBatchKey::Material(material) => {
+                // the material can't be gone, sprites without a loaded material were skipped
+                if materials.get(material).unwrap().texture.is_some() {
+                    specialization
+                        .shader_specialization
+                        .shader_defs
+                        .insert("COLORMATERIAL_TEXTURE".to_string());
+                }
+                SPRITE_BATCH_PIPELINE_HANDLE
+            }
+            SpriteBatchKey::TextureAtlas(_) => SPRITE_SHEET_BATCH_PIPELINE_HANDLE,
+        };
+        match draw_context.set_pipeline(&mut draw, &pipeline.typed(), &specialization) {
+            Ok(()) => {}
+            // skip drawing until the pipeline is compiled
+            Err(DrawError::PipelineNotReady) => continue,
+            Err(err) => panic!("{}", err),
+        }
+        draw_context
+            .set_bind_groups_from_bindings(&mut draw, &mut [&mut render_resource_bindings])
+            .unwrap();
+        let asset_bind_groups = match batch.key {
+            SpriteBatchKey::Material(material) => draw_context
+                .set_asset_bind_groups(&mut draw, &Handle::<ColorMaterial>::weak(material)),
+            SpriteBatchKey::TextureAtlas(atlas) => {
+                draw_context.set_asset_bind_groups(&mut draw, &Handle::<TextureAtlas>::weak(atlas))
+            }
+        };
+        match asset_bind_groups {
+            Ok(()) => {}
+            // the material or atlas render resources are created later in the frame
+            Err(DrawError::MissingAssetRenderResources) => continue,
+            Err(err) => panic!("{}", err),
+        }
+
+        draw.set_vertex_buffer(0, vertex_buffer, batch.quads.start as u64 * quad_stride);
+        draw.set_index_buffer(index_buffer, 0, IndexFormat::Uint32);
+        draw.draw_indexed(0..batch.quads.len() as u32 * 6, 0, 0..1);
+    }
+}
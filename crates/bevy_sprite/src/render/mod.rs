@@ -1,3 +1,7 @@
+mod batching;
+
+pub use batching::*;
+
 use crate::{ColorMaterial, Sprite, TextureAtlas, TextureAtlasSprite};
 use bevy_asset::{Assets, HandleUntyped};
 use bevy_reflect::TypeUuid;
@@ -18,7 +22,14 @@ pub const SPRITE_PIPELINE_HANDLE: HandleUntyped =
 pub const SPRITE_SHEET_PIPELINE_HANDLE: HandleUntyped =
     HandleUntyped::weak_from_u64(PipelineDescriptor::TYPE_UUID, 9016885805180281612);
 
-pub fn build_sprite_sheet_pipeline(shaders: &mut Assets<Shader>) -> PipelineDescriptor {
+pub const SPRITE_BATCH_PIPELINE_HANDLE: HandleUntyped =
+    HandleUntyped::weak_from_u64(PipelineDescriptor::TYPE_UUID, 4603034802771883346);
+
+pub const SPRITE_SHEET_BATCH_PIPELINE_HANDLE: HandleUntyped =
+    HandleUntyped::weak_from_u64(PipelineDescriptor::TYPE_UUID, 13405488430539894547);
+
+/// The depth, blend and primitive states shared by every sprite pipeline
+fn sprite_pipeline_descriptor(shader_stages: ShaderStages) -> PipelineDescriptor {
     PipelineDescriptor {
         depth_stencil: Some(DepthStencilState {
             format: TextureFormat::Depth32Float,
@@ -61,73 +72,62 @@ pub fn build_sprite_sheet_pipeline(shaders: &mut Assets<Shader>) -> PipelineDesc
             clamp_depth: false,
             conservative: false,
         },
-        ..PipelineDescriptor::new(ShaderStages {
-            vertex: shaders.add(Shader::from_glsl(
-                ShaderStage::Vertex,
-                include_str!("sprite_sheet.vert"),
-            )),
-            fragment: Some(shaders.add(Shader::from_glsl(
-                ShaderStage::Fragment,
-                include_str!("sprite_sheet.frag"),
-            ))),
-        })
+        ..PipelineDescriptor::new(shader_stages)
     }
 }
 
+pub fn build_sprite_sheet_pipeline(shaders: &mut Assets<Shader>) -> PipelineDescriptor {
+    sprite_pipeline_descriptor(ShaderStages {
+        vertex: shaders.add(Shader::from_glsl(
+            ShaderStage::Vertex,
+            include_str!("sprite_sheet.vert"),
+        )),
+        fragment: Some(shaders.add(Shader::from_glsl(
+            ShaderStage::Fragment,
+            include_str!("sprite_sheet.frag"),
+        ))),
+    })
+}
+
 pub fn build_sprite_pipeline(shaders: &mut Assets<Shader>) -> PipelineDescriptor {
-    PipelineDescriptor {
-        depth_stencil: Some(DepthStencilState {
-            format: TextureFormat::Depth32Float,
-            depth_write_enabled: true,
-            depth_compare: CompareFunction::LessEqual,
-            stencil: StencilState {
-                front: StencilFaceState::IGNORE,
-                back: StencilFaceState::IGNORE,
-                read_mask: 0,
-                write_mask: 0,
-            },
-            bias: DepthBiasState {
-                constant: 0,
-                slope_scale: 0.0,
-                clamp: 0.0,
-            },
-        }),
-        color_target_states: vec![ColorTargetState {
-            format: TextureFormat::default(),
-            blend: Some(BlendState {
-                color: BlendComponent {
-                    src_factor: BlendFactor::SrcAlpha,
-                    dst_factor: BlendFactor::OneMinusSrcAlpha,
-                    operation: BlendOperation::Add,
-                },
-                alpha: BlendComponent {
-                    src_factor: BlendFactor::One,
-                    dst_factor: BlendFactor::One,
-                    operation: BlendOperation::Add,
-                },
-            }),
-            write_mask: ColorWrite::ALL,
-        }],
-        primitive: PrimitiveState {
-            topology: PrimitiveTopology::TriangleList,
-            strip_index_format: None,
-            front_face: FrontFace::Ccw,
-            cull_mode: None,
-            polygon_mode: PolygonMode::Fill,
-            clamp_depth: false,
-            conservative: false,
-        },
-        ..PipelineDescriptor::new(ShaderStages {
-            vertex: shaders.add(Shader::from_glsl(
-                ShaderStage::Vertex,
-                include_str!("sprite.vert"),
-            )),
-            fragment: Some(shaders.add(Shader::from_glsl(
-                ShaderStage::Fragment,
-                include_str!("sprite.frag"),
-            ))),
-        })
-    }
+    sprite_pipeline_descriptor(ShaderStages {
+        vertex: shaders.add(Shader::from_glsl(
+            ShaderStage::Vertex,
+            include_str!("sprite.vert"),
+        )),
+        fragment: Some(shaders.add(Shader::from_glsl(
+            ShaderStage::Fragment,
+            include_str!("sprite.frag"),
+        ))),
+    })
+}
+
+/// The pipeline of [`BatchedSprite`] batches of a [`ColorMaterial`]
+pub fn build_sprite_batch_pipeline(shaders: &mut Assets<Shader>) -> PipelineDescriptor {
+    sprite_pipeline_descriptor(ShaderStages {
+        vertex: shaders.add(Shader::from_glsl(
+            ShaderStage::Vertex,
+            include_str!("sprite_batch.vert"),
+        )),
+        fragment: Some(shaders.add(Shader::from_glsl(
+            ShaderStage::Fragment,
+            include_str!("sprite.frag"),
+        ))),
+    })
+}
+
+/// The pipeline of [`BatchedSprite`] batches of a [`TextureAtlas`]
+pub fn build_sprite_sheet_batch_pipeline(shaders: &mut Assets<Shader>) -> PipelineDescriptor {
+    sprite_pipeline_descriptor(ShaderStages {
+        vertex: shaders.add(Shader::from_glsl(
+            ShaderStage::Vertex,
+            include_str!("sprite_batch.vert"),
+        )),
+        fragment: Some(shaders.add(Shader::from_glsl(
+            ShaderStage::Fragment,
+            include_str!("sprite_sheet.frag"),
+        ))),
+    })
 }
 
 pub mod node {
@@ -170,4 +170,12 @@ pub(crate) fn add_sprite_graph(
         SPRITE_SHEET_PIPELINE_HANDLE,
         build_sprite_sheet_pipeline(shaders),
     );
+    pipelines.set_untracked(
+        SPRITE_BATCH_PIPELINE_HANDLE,
+        build_sprite_batch_pipeline(shaders),
+    );
+    pipelines.set_untracked(
+        SPRITE_SHEET_BATCH_PIPELINE_HANDLE,
+        build_sprite_sheet_batch_pipeline(shaders),
+    );
 }
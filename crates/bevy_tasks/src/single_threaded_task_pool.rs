@@ -26,6 +26,10 @@ impl TaskPoolBuilder {
         self
     }
 
+    pub fn work_stealing(self, _work_stealing: bool) -> Self {
+        self
+    }
+
     pub fn build(self) -> TaskPool {
         TaskPool::new_internal()
     }
@@ -1,4 +1,5 @@
 use std::{
+    cell::Cell,
     future::Future,
     mem,
     pin::Pin,
@@ -6,6 +7,7 @@ use std::{
     thread::{self, JoinHandle},
 };
 
+use event_listener::Event;
 use futures_lite::{future, pin};
 
 use crate::Task;
@@ -21,6 +23,8 @@ pub struct TaskPoolBuilder {
     /// Allows customizing the name of the threads - helpful for debugging. If set, threads will
     /// be named <thread_name> (<thread_index>), i.e. "MyThreadPool (2)"
     thread_name: Option<String>,
+    /// If set, every thread gets its own queue and idle threads steal from the others
+    work_stealing: bool,
 }
 
 impl TaskPoolBuilder {
@@ -49,12 +53,24 @@ impl TaskPoolBuilder {
         self
     }
 
+    /// Give every thread of the pool its own task queue instead of sharing a single one.
+    ///
+    /// Tasks spawned from a pool thread stay on that thread's queue, and threads that run out of
+    /// work take tasks from the other queues. This avoids contention on the shared queue when
+    /// many threads spawn many small tasks, e.g. in [`ParallelIterator`](crate::ParallelIterator)
+    /// or system executors.
+    pub fn work_stealing(mut self, work_stealing: bool) -> Self {
+        self.work_stealing = work_stealing;
+        self
+    }
+
     /// Creates a new ThreadPoolBuilder based on the current options.
     pub fn build(self) -> TaskPool {
         TaskPool::new_internal(
             self.num_threads,
             self.stack_size,
             self.thread_name.as_deref(),
+            self.work_stealing,
         )
     }
 }
@@ -79,16 +95,31 @@ impl Drop for TaskPoolInner {
     }
 }
 
+thread_local! {
+    /// The pool (identified by the address of its executors) and queue index owned by the
+    /// current thread, if it is a thread of a work-stealing pool
+    static WORKER: Cell<Option<(usize, usize)>> = Cell::new(None);
+}
+
+/// Runs at most one task, trying every executor once starting after `index`
+fn steal(executors: &[async_executor::Executor], index: usize) -> bool {
+    (1..executors.len()).any(|offset| executors[(index + offset) % executors.len()].try_tick())
+}
+
 /// A thread pool for executing tasks. Tasks are futures that are being automatically driven by
 /// the pool on threads owned by the pool.
 #[derive(Debug, Clone)]
 pub struct TaskPool {
-    /// The executor for the pool
+    /// The executors for the pool. There is a single shared one unless the pool uses work
+    /// stealing, in which case there is one per thread.
     ///
     /// This has to be separate from TaskPoolInner because we have to create an Arc<Executor> to
     /// pass into the worker threads, and we must create the worker threads before we can create
     /// the Vec<Task<T>> contained within TaskPoolInner
-    executor: Arc<async_executor::Executor<'static>>,
+    executors: Arc<[async_executor::Executor<'static>]>,
+
+    /// Notified whenever a task is spawned in a work-stealing pool, so idle threads can steal it
+    work_available: Arc<Event>,
 
     /// Inner state of the pool
     inner: Arc<TaskPoolInner>,
@@ -108,16 +139,26 @@ impl TaskPool {
         num_threads: Option<usize>,
         stack_size: Option<usize>,
         thread_name: Option<&str>,
+        work_stealing: bool,
     ) -> Self {
         let (shutdown_tx, shutdown_rx) = async_channel::unbounded::<()>();
 
-        let executor = Arc::new(async_executor::Executor::new());
-
         let num_threads = num_threads.unwrap_or_else(num_cpus::get);
 
+        let executors: Arc<[async_executor::Executor<'static>]> = if work_stealing {
+            (0..num_threads.max(1))
+                .map(|_| async_executor::Executor::new())
+                .collect()
+        } else {
+            Arc::new([async_executor::Executor::new()])
+        };
+        let work_available = Arc::new(Event::new());
+        let pool_id = executors.as_ptr() as usize;
+
         let threads = (0..num_threads)
             .map(|i| {
-                let ex = Arc::clone(&executor);
+                let executors = Arc::clone(&executors);
+                let work_available = Arc::clone(&work_available);
                 let shutdown_rx = shutdown_rx.clone();
 
                 let thread_name = if let Some(thread_name) = thread_name {
@@ -134,16 +175,46 @@ impl TaskPool {
 
                 thread_builder
                     .spawn(move || {
-                        let shutdown_future = ex.run(shutdown_rx.recv());
-                        // Use unwrap_err because we expect a Closed error
-                        future::block_on(shutdown_future).unwrap_err();
+                        if !work_stealing {
+                            let shutdown_future = executors[0].run(shutdown_rx.recv());
+                            // Use unwrap_err because we expect a Closed error
+                            future::block_on(shutdown_future).unwrap_err();
+                            return;
+                        }
+
+                        WORKER.with(|worker| worker.set(Some((pool_id, i))));
+                        let executor = &executors[i];
+                        loop {
+                            while executor.try_tick() || steal(&executors, i) {}
+
+                            // Register before checking again so a task spawned in between
+                            // still wakes this thread up
+                            let listener = work_available.listen();
+                            if steal(&executors, i) {
+                                continue;
+                            }
+
+                            // Sleep in our own executor (running anything spawned onto it)
+                            // until another queue has work or the pool shuts down
+                            let shutdown = future::block_on(executor.run(future::or(
+                                async { shutdown_rx.recv().await.is_err() },
+                                async {
+                                    listener.await;
+                                    false
+                                },
+                            )));
+                            if shutdown {
+                                break;
+                            }
+                        }
                     })
                     .expect("Failed to spawn thread.")
             })
             .collect();
 
         Self {
-            executor,
+            executors,
+            work_available,
             inner: Arc::new(TaskPoolInner {
                 threads,
                 shutdown_tx,
@@ -151,6 +222,15 @@ impl TaskPool {
         }
     }
 
+    /// The index of the executor tasks spawned from the current thread should go to
+    fn home_executor(&self) -> Option<usize> {
+        let pool_id = self.executors.as_ptr() as usize;
+        WORKER.with(|worker| match worker.get() {
+            Some((id, index)) if id == pool_id => Some(index),
+            _ => None,
+        })
+    }
+
     /// Return the number of threads owned by the task pool
     pub fn thread_num(&self) -> usize {
         self.inner.threads.len()
@@ -171,12 +251,18 @@ impl TaskPool {
             // before this function returns. However, rust has no way of knowing
             // this so we must convert to 'static here to appease the compiler as it is unable to
             // validate safety.
-            let executor: &async_executor::Executor = &*self.executor;
-            let executor: &'scope async_executor::Executor = unsafe { mem::transmute(executor) };
+            let executors: &[async_executor::Executor] = &*self.executors;
+            let executors: &'scope [async_executor::Executor] =
+                unsafe { mem::transmute(executors) };
             let local_executor: &'scope async_executor::LocalExecutor =
                 unsafe { mem::transmute(local_executor) };
+            let work_available: &'scope Event = unsafe { mem::transmute(&*self.work_available) };
+            let home_executor = self.home_executor();
             let mut scope = Scope {
-                executor,
+                executors,
+                work_available,
+                home_executor,
+                next_executor: home_executor.unwrap_or(0),
                 local_executor,
                 spawned: Vec::new(),
             };
@@ -219,7 +305,10 @@ impl TaskPool {
                         break result;
                     };
 
-                    self.executor.try_tick();
+                    let home = home_executor.unwrap_or(0);
+                    if !self.executors[home].try_tick() {
+                        steal(&self.executors, home);
+                    }
                     local_executor.try_tick();
                 }
             }
@@ -233,7 +322,12 @@ impl TaskPool {
     where
         T: Send + 'static,
     {
-        Task::new(self.executor.spawn(future))
+        let index = self.home_executor().unwrap_or(0);
+        let task = self.executors[index].spawn(future);
+        if self.executors.len() > 1 {
+            self.work_available.notify(1);
+        }
+        Task::new(task)
     }
 
     pub fn spawn_local<T>(&self, future: impl Future<Output = T> + 'static) -> Task<T>
@@ -252,14 +346,31 @@ impl Default for TaskPool {
 
 #[derive(Debug)]
 pub struct Scope<'scope, T> {
-    executor: &'scope async_executor::Executor<'scope>,
+    executors: &'scope [async_executor::Executor<'scope>],
+    work_available: &'scope Event,
+    /// The executor owned by the thread that created this scope, if it is a thread of the pool
+    home_executor: Option<usize>,
+    /// Where the next task goes when the scope was created outside of the pool
+    next_executor: usize,
     local_executor: &'scope async_executor::LocalExecutor<'scope>,
     spawned: Vec<async_executor::Task<T>>,
 }
 
 impl<'scope, T: Send + 'scope> Scope<'scope, T> {
     pub fn spawn<Fut: Future<Output = T> + 'scope + Send>(&mut self, f: Fut) {
-        let task = self.executor.spawn(f);
+        let index = match self.home_executor {
+            Some(index) => index,
+            None => {
+                // Spread tasks over all queues so every thread starts on its own work
+                let index = self.next_executor;
+                self.next_executor = (index + 1) % self.executors.len();
+                index
+            }
+        };
+        let task = self.executors[index].spawn(f);
+        if self.executors.len() > 1 {
+            self.work_available.notify(1);
+        }
         self.spawned.push(task);
     }
 
@@ -309,6 +420,44 @@ mod tests {
         assert_eq!(count.load(Ordering::Relaxed), 100);
     }
 
+    #[test]
+    fn test_work_stealing() {
+        let pool = TaskPoolBuilder::new()
+            .num_threads(4)
+            .work_stealing(true)
+            .build();
+
+        let count = Arc::new(AtomicI32::new(0));
+
+        let outputs = pool.scope(|scope| {
+            for i in 0..100 {
+                let count_clone = count.clone();
+                scope.spawn(async move {
+                    count_clone.fetch_add(1, Ordering::Relaxed);
+                    i
+                });
+            }
+        });
+
+        assert_eq!(outputs, (0..100).collect::<Vec<_>>());
+        assert_eq!(count.load(Ordering::Relaxed), 100);
+
+        // scopes created from inside the pool spawn onto the calling thread's queue
+        let pool = Arc::new(pool);
+        let inner_pool = pool.clone();
+        let nested = future::block_on(pool.spawn(async move {
+            inner_pool
+                .scope(|scope| {
+                    for i in 0..10 {
+                        scope.spawn(async move { i * 2 });
+                    }
+                })
+                .into_iter()
+                .sum::<i32>()
+        }));
+        assert_eq!(nested, 90);
+    }
+
     #[test]
     fn test_mixed_spawn_local_and_spawn() {
         let pool = TaskPool::new();
@@ -35,6 +35,18 @@ impl FontAtlasSet {
         self.font_atlases.iter()
     }
 
+    /// Removes the atlases for which `evict` returns `true`. Returns how many were removed.
+    pub fn remove_atlases(&mut self, mut evict: impl FnMut(&FontAtlas) -> bool) -> usize {
+        let mut removed = 0;
+        self.font_atlases.retain(|_, font_atlases| {
+            let len = font_atlases.len();
+            font_atlases.retain(|font_atlas| !evict(font_atlas));
+            removed += len - font_atlases.len();
+            !font_atlases.is_empty()
+        });
+        removed
+    }
+
     pub fn has_glyph(&self, glyph_id: GlyphId, glyph_position: Point, font_size: f32) -> bool {
         self.font_atlases
             .get(&FloatOrd(font_size))
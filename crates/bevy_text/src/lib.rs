@@ -44,6 +44,7 @@ impl Plugin for TextPlugin {
             .init_asset_loader::<FontLoader>()
             .insert_resource(DefaultTextPipeline::default())
             .add_system_to_stage(CoreStage::PostUpdate, text2d_system.system())
+            .add_system_to_stage(CoreStage::Last, text_pipeline_cleanup_system.system())
             .add_system_to_stage(RenderStage::Draw, text2d::draw_text2d_system.system());
     }
 }
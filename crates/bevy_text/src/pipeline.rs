@@ -2,22 +2,38 @@ use std::hash::Hash;
 
 use ab_glyph::{PxScale, ScaleFont};
 use bevy_asset::{Assets, Handle, HandleId};
+use bevy_core::FloatOrd;
+use bevy_ecs::{
+    query::With,
+    system::{Query, RemovedComponents, Res, ResMut},
+};
 use bevy_math::Size;
 use bevy_render::prelude::Texture;
 use bevy_sprite::TextureAtlas;
-use bevy_utils::HashMap;
+use bevy_utils::{HashMap, HashSet};
 
 use glyph_brush_layout::{FontId, SectionText};
 
 use crate::{
-    error::TextError, glyph_brush::GlyphBrush, scale_value, Font, FontAtlasSet, PositionedGlyph,
-    TextAlignment, TextSection,
+    error::TextError, glyph_brush::GlyphBrush, scale_value, DefaultTextPipeline, Font,
+    FontAtlasSet, PositionedGlyph, Text, TextAlignment, TextSection,
 };
 
 pub struct TextPipeline<ID> {
     brush: GlyphBrush,
     glyph_map: HashMap<ID, TextLayoutInfo>,
     map_font_id: HashMap<HandleId, FontId>,
+    layout_cache: HashMap<TextLayoutKey, CachedTextLayout>,
+    atlas_last_used: HashMap<HandleId, u64>,
+    /// Incremented every time text is queued, used to find the least recently used layouts and
+    /// atlases
+    tick: u64,
+    /// How many laid out texts are kept to be reused by text with the same sections, alignment
+    /// and bounds
+    pub layout_cache_capacity: usize,
+    /// How much memory font atlases can use before the atlases that no queued text uses anymore
+    /// are freed, see [`TextPipeline::evict_font_atlases`]
+    pub max_font_atlas_bytes: usize,
 }
 
 impl<ID> Default for TextPipeline<ID> {
@@ -26,10 +42,30 @@ impl<ID> Default for TextPipeline<ID> {
             brush: GlyphBrush::default(),
             glyph_map: Default::default(),
             map_font_id: Default::default(),
+            layout_cache: Default::default(),
+            atlas_last_used: Default::default(),
+            tick: 0,
+            layout_cache_capacity: 1024,
+            max_font_atlas_bytes: 64 * 1024 * 1024,
         }
     }
 }
 
+/// Everything the glyphs of a text layout depend on. Colors are not part of it, they are only
+/// looked up when the text is drawn.
+#[derive(PartialEq, Eq, Hash)]
+struct TextLayoutKey {
+    sections: Vec<(HandleId, FloatOrd, String)>,
+    alignment: (u8, u8),
+    bounds: (FloatOrd, FloatOrd),
+}
+
+struct CachedTextLayout {
+    layout: TextLayoutInfo,
+    last_used: u64,
+}
+
+#[derive(Clone)]
 pub struct TextLayoutInfo {
     pub glyphs: Vec<PositionedGlyph>,
     pub size: Size,
@@ -48,6 +84,11 @@ impl<ID: Hash + Eq> TextPipeline<ID> {
         self.glyph_map.get(id)
     }
 
+    /// Forgets the layout of a text, so that the atlases it uses can be evicted
+    pub fn remove_glyphs(&mut self, id: &ID) -> Option<TextLayoutInfo> {
+        self.glyph_map.remove(id)
+    }
+
     #[allow(clippy::too_many_arguments)]
     pub fn queue_text(
         &mut self,
@@ -61,7 +102,16 @@ impl<ID: Hash + Eq> TextPipeline<ID> {
         texture_atlases: &mut Assets<TextureAtlas>,
         textures: &mut Assets<Texture>,
     ) -> Result<(), TextError> {
+        self.tick += 1;
         let mut scaled_fonts = Vec::new();
+        let mut key = TextLayoutKey {
+            sections: Vec::with_capacity(sections.len()),
+            alignment: (
+                text_alignment.horizontal as u8,
+                text_alignment.vertical as u8,
+            ),
+            bounds: (FloatOrd(bounds.width), FloatOrd(bounds.height)),
+        };
         let sections = sections
             .iter()
             .map(|section| {
@@ -72,6 +122,11 @@ impl<ID: Hash + Eq> TextPipeline<ID> {
                 let font_size = scale_value(section.style.font_size, scale_factor);
 
                 scaled_fonts.push(ab_glyph::Font::as_scaled(&font.font, font_size));
+                key.sections.push((
+                    section.style.font.id,
+                    FloatOrd(font_size),
+                    section.value.clone(),
+                ));
 
                 let section = SectionText {
                     font_id,
@@ -83,18 +138,27 @@ impl<ID: Hash + Eq> TextPipeline<ID> {
             })
             .collect::<Result<Vec<_>, _>>()?;
 
+        if let Some(cached) = self.layout_cache.get_mut(&key) {
+            cached.last_used = self.tick;
+            for glyph in cached.layout.glyphs.iter() {
+                self.atlas_last_used
+                    .insert(glyph.atlas_info.texture_atlas.id, self.tick);
+            }
+            self.glyph_map.insert(id, cached.layout.clone());
+            return Ok(());
+        }
+
         let section_glyphs = self
             .brush
             .compute_glyphs(&sections, bounds, text_alignment)?;
 
         if section_glyphs.is_empty() {
-            self.glyph_map.insert(
-                id,
-                TextLayoutInfo {
-                    glyphs: Vec::new(),
-                    size: Size::new(0., 0.),
-                },
-            );
+            let layout = TextLayoutInfo {
+                glyphs: Vec::new(),
+                size: Size::new(0., 0.),
+            };
+            self.cache_layout(key, layout.clone());
+            self.glyph_map.insert(id, layout);
             return Ok(());
         }
 
@@ -123,8 +187,132 @@ impl<ID: Hash + Eq> TextPipeline<ID> {
             textures,
         )?;
 
-        self.glyph_map.insert(id, TextLayoutInfo { glyphs, size });
+        for glyph in glyphs.iter() {
+            self.atlas_last_used
+                .insert(glyph.atlas_info.texture_atlas.id, self.tick);
+        }
+        let layout = TextLayoutInfo { glyphs, size };
+        self.cache_layout(key, layout.clone());
+        self.glyph_map.insert(id, layout);
 
         Ok(())
     }
+
+    fn cache_layout(&mut self, key: TextLayoutKey, layout: TextLayoutInfo) {
+        if self.layout_cache_capacity == 0 {
+            return;
+        }
+        if self.layout_cache.len() >= self.layout_cache_capacity {
+            // evict the least recently used quarter at once so that a full cache doesn't have to
+            // be searched for every new layout. Entries never share a tick.
+            let evicted = (self.layout_cache_capacity / 4).max(1);
+            let mut last_used = self
+                .layout_cache
+                .values()
+                .map(|cached| cached.last_used)
+                .collect::<Vec<_>>();
+            let (_, threshold, _) = last_used.select_nth_unstable(evicted - 1);
+            let threshold = *threshold;
+            self.layout_cache
+                .retain(|_, cached| cached.last_used > threshold);
+        }
+        self.layout_cache.insert(
+            key,
+            CachedTextLayout {
+                layout,
+                last_used: self.tick,
+            },
+        );
+    }
+
+    /// Frees the least recently used font atlases while all atlases together take more than
+    /// [`TextPipeline::max_font_atlas_bytes`]. Atlases with glyphs of currently queued text are
+    /// never freed, their glyphs are added again the next time text uses them.
+    pub fn evict_font_atlases(
+        &mut self,
+        font_atlas_set_storage: &mut Assets<FontAtlasSet>,
+        texture_atlases: &Assets<TextureAtlas>,
+    ) {
+        let atlas_bytes = |handle: &Handle<TextureAtlas>| {
+            texture_atlases.get(handle).map_or(0, |texture_atlas| {
+                texture_atlas.size.x as usize * texture_atlas.size.y as usize * 4
+            })
+        };
+        let storage: &Assets<FontAtlasSet> = font_atlas_set_storage;
+        let font_atlases = move || {
+            storage.iter().flat_map(|(set_id, set)| {
+                set.iter()
+                    .flat_map(|(_, font_atlases)| font_atlases.iter())
+                    .map(move |font_atlas| (set_id, &font_atlas.texture_atlas))
+            })
+        };
+        let mut total_bytes = font_atlases()
+            .map(|(_, handle)| atlas_bytes(handle))
+            .sum::<usize>();
+        if total_bytes <= self.max_font_atlas_bytes {
+            return;
+        }
+
+        let used = self
+            .glyph_map
+            .values()
+            .flat_map(|layout| layout.glyphs.iter())
+            .map(|glyph| glyph.atlas_info.texture_atlas.id)
+            .collect::<HashSet<_>>();
+        let mut unused = font_atlases()
+            .filter(|(_, handle)| !used.contains(&handle.id))
+            .map(|(set_id, handle)| {
+                let last_used = self.atlas_last_used.get(&handle.id).copied().unwrap_or(0);
+                (last_used, set_id, handle.id, atlas_bytes(handle))
+            })
+            .collect::<Vec<_>>();
+        unused.sort_by_key(|(last_used, ..)| *last_used);
+
+        let mut evicted = HashSet::default();
+        let mut evicted_sets = HashSet::default();
+        for (_, set_id, atlas_id, bytes) in unused {
+            if total_bytes <= self.max_font_atlas_bytes {
+                break;
+            }
+            total_bytes -= bytes;
+            evicted.insert(atlas_id);
+            evicted_sets.insert(set_id);
+        }
+        if evicted.is_empty() {
+            return;
+        }
+
+        for set_id in evicted_sets {
+            if let Some(set) = font_atlas_set_storage.get_mut(set_id) {
+                set.remove_atlases(|font_atlas| evicted.contains(&font_atlas.texture_atlas.id));
+            }
+        }
+        self.layout_cache.retain(|_, cached| {
+            !cached
+                .layout
+                .glyphs
+                .iter()
+                .any(|glyph| evicted.contains(&glyph.atlas_info.texture_atlas.id))
+        });
+        self.atlas_last_used
+            .retain(|atlas_id, _| !evicted.contains(atlas_id));
+    }
+}
+
+/// Forgets the layouts of removed text and frees font atlases over the memory budget of the
+/// [`DefaultTextPipeline`]
+pub fn text_pipeline_cleanup_system(
+    mut text_pipeline: ResMut<DefaultTextPipeline>,
+    removed_text: RemovedComponents<Text>,
+    text_query: Query<(), With<Text>>,
+    mut font_atlas_set_storage: ResMut<Assets<FontAtlasSet>>,
+    texture_atlases: Res<Assets<TextureAtlas>>,
+) {
+    for entity in removed_text.iter() {
+        // the text may have been inserted again after it was removed
+        if text_query.get(entity).is_err() {
+            text_pipeline.remove_glyphs(&entity);
+        }
+    }
+    text_pipeline.evict_font_atlases(&mut font_atlas_set_storage, &texture_atlases);
 }
@@ -7,7 +7,7 @@ use bevy_ecs::{
 };
 use bevy_math::{Size, Vec3};
 use bevy_render::{
-    draw::{DrawContext, Drawable, OutsideFrustum},
+    draw::{DrawContext, DrawError, Drawable, OutsideFrustum},
     mesh::Mesh,
     prelude::{Draw, Msaa, Texture, Visible},
     render_graph::base::MainPass,
@@ -115,7 +115,11 @@ pub fn draw_text2d_system(
                 alignment_offset,
             };
 
-            drawable_text.draw(&mut draw, &mut context).unwrap();
+            match drawable_text.draw(&mut draw, &mut context) {
+                // the text is drawn once its pipeline is compiled
+                Ok(()) | Err(DrawError::PipelineNotReady) => {}
+                Err(err) => panic!("{}", err),
+            }
         }
     }
 }
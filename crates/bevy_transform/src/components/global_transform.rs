@@ -1,7 +1,8 @@
 use super::Transform;
 use bevy_ecs::reflect::ReflectComponent;
 use bevy_math::{Mat3, Mat4, Quat, Vec3};
-use bevy_reflect::Reflect;
+use bevy_reflect::{Reflect, ReflectDefault, ReflectDeserialize};
+use serde::{Deserialize, Serialize};
 use std::ops::Mul;
 
 /// Describe the position of an entity relative to the reference frame.
@@ -33,8 +34,8 @@ use std::ops::Mul;
 /// This system runs in stage [`CoreStage::PostUpdate`](crate::CoreStage::PostUpdate). If you
 /// update the[`Transform`] of an entity in this stage or after, you will notice a 1 frame lag
 /// before the [`GlobalTransform`] is updated.
-#[derive(Debug, PartialEq, Clone, Copy, Reflect)]
-#[reflect(Component, PartialEq)]
+#[derive(Debug, PartialEq, Clone, Copy, Reflect, Serialize, Deserialize)]
+#[reflect(Component, PartialEq, Serialize, Deserialize, Default)]
 pub struct GlobalTransform {
     pub translation: Vec3,
     pub rotation: Quat,
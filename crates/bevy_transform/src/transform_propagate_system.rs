@@ -1,55 +1,111 @@
 use crate::components::{Children, GlobalTransform, Parent, Transform};
 use bevy_ecs::{
     entity::Entity,
-    query::{Changed, With, Without},
-    system::Query,
+    query::{Changed, With, Without, AUTO_BATCH_SIZE},
+    system::{Local, Query, Res},
+    world::Mut,
 };
+use bevy_tasks::ComputeTaskPool;
+use bevy_utils::HashSet;
 
 /// Update [`GlobalTransform`] component of entities based on entity hierarchy and
 /// [`Transform`] component.
+///
+/// Only subtrees containing a changed [`Transform`] are visited. Separate root entities are
+/// propagated in parallel on the [`ComputeTaskPool`] when it is available.
 pub fn transform_propagate_system(
+    task_pool: Option<Res<ComputeTaskPool>>,
+    mut dirty_ancestors: Local<HashSet<Entity>>,
     mut root_query: Query<
         (Entity, Option<&Children>, &Transform, &mut GlobalTransform),
         Without<Parent>,
     >,
-    mut transform_query: Query<(&Transform, &mut GlobalTransform), With<Parent>>,
+    transform_query: Query<(&Transform, &mut GlobalTransform, &Parent)>,
     changed_transform_query: Query<Entity, Changed<Transform>>,
     children_query: Query<Option<&Children>, (With<Parent>, With<GlobalTransform>)>,
+    parent_query: Query<&Parent>,
 ) {
-    for (entity, children, transform, mut global_transform) in root_query.iter_mut() {
+    if changed_transform_query.iter().next().is_none() {
+        return;
+    }
+
+    // Mark every ancestor of a changed entity, so untouched subtrees can be skipped entirely
+    dirty_ancestors.clear();
+    for entity in changed_transform_query.iter() {
+        let mut current = entity;
+        while let Ok(parent) = parent_query.get(current) {
+            if !dirty_ancestors.insert(parent.0) {
+                break;
+            }
+            current = parent.0;
+        }
+    }
+
+    let dirty_ancestors = &*dirty_ancestors;
+    let changed_transform_query = &changed_transform_query;
+    let transform_query = &transform_query;
+    let children_query = &children_query;
+    let propagate_root = |(entity, children, transform, mut global_transform): (
+        Entity,
+        Option<&Children>,
+        &Transform,
+        Mut<GlobalTransform>,
+    )| {
         let mut changed = false;
         if changed_transform_query.get(entity).is_ok() {
             *global_transform = GlobalTransform::from(*transform);
             changed = true;
+        } else if !dirty_ancestors.contains(&entity) {
+            return;
         }
 
         if let Some(children) = children {
             for child in children.0.iter() {
                 propagate_recursive(
                     &global_transform,
-                    &changed_transform_query,
-                    &mut transform_query,
-                    &children_query,
+                    dirty_ancestors,
+                    changed_transform_query,
+                    transform_query,
+                    children_query,
+                    entity,
                     *child,
                     changed,
                 );
             }
         }
+    };
+
+    match task_pool {
+        Some(task_pool) => root_query.par_for_each_mut(&task_pool, AUTO_BATCH_SIZE, propagate_root),
+        None => root_query.for_each_mut(propagate_root),
     }
 }
 
+#[allow(clippy::too_many_arguments)]
 fn propagate_recursive(
     parent: &GlobalTransform,
+    dirty_ancestors: &HashSet<Entity>,
     changed_transform_query: &Query<Entity, Changed<Transform>>,
-    transform_query: &mut Query<(&Transform, &mut GlobalTransform), With<Parent>>,
+    transform_query: &Query<(&Transform, &mut GlobalTransform, &Parent)>,
     children_query: &Query<Option<&Children>, (With<Parent>, With<GlobalTransform>)>,
+    expected_parent: Entity,
     entity: Entity,
     mut changed: bool,
 ) {
     changed |= changed_transform_query.get(entity).is_ok();
+    if !changed && !dirty_ancestors.contains(&entity) {
+        return;
+    }
 
     let global_matrix = {
-        if let Ok((transform, mut global_transform)) = transform_query.get_mut(entity) {
+        // SAFE: an entity is only visited from the entity its `Parent` points to, and each root
+        // is visited by a single task, so no two tasks access the same GlobalTransform
+        if let Ok((transform, mut global_transform, actual_parent)) =
+            unsafe { transform_query.get_unchecked(entity) }
+        {
+            if actual_parent.0 != expected_parent {
+                return;
+            }
             if changed {
                 *global_transform = parent.mul_transform(*transform);
             }
@@ -63,9 +119,11 @@ fn propagate_recursive(
         for child in children.0.iter() {
             propagate_recursive(
                 &global_matrix,
+                dirty_ancestors,
                 changed_transform_query,
                 transform_query,
                 children_query,
+                entity,
                 *child,
                 changed,
             );
@@ -83,6 +141,7 @@ mod test {
 
     use super::*;
     use crate::hierarchy::{parent_update_system, BuildChildren, BuildWorldChildren};
+    use bevy_tasks::TaskPool;
 
     #[test]
     fn did_propagate() {
@@ -190,4 +249,66 @@ mod test {
             GlobalTransform::from_xyz(1.0, 0.0, 0.0) * Transform::from_xyz(0.0, 0.0, 3.0)
         );
     }
+
+    #[test]
+    fn did_propagate_in_parallel_and_skip_unchanged() {
+        let mut world = World::default();
+        world.insert_resource(ComputeTaskPool(TaskPool::default()));
+
+        let mut update_stage = SystemStage::parallel();
+        update_stage.add_system(parent_update_system.system());
+        update_stage.add_system(transform_propagate_system.system());
+
+        let mut schedule = Schedule::default();
+        schedule.add_stage("update", update_stage);
+
+        let mut roots = Vec::new();
+        let mut children = Vec::new();
+        for i in 0..100 {
+            let root = world
+                .spawn()
+                .insert_bundle((
+                    Transform::from_xyz(i as f32, 0.0, 0.0),
+                    GlobalTransform::identity(),
+                ))
+                .with_children(|parent| {
+                    children.push(
+                        parent
+                            .spawn_bundle((
+                                Transform::from_xyz(0.0, 1.0, 0.0),
+                                GlobalTransform::identity(),
+                            ))
+                            .id(),
+                    );
+                })
+                .id();
+            roots.push(root);
+        }
+        schedule.run(&mut world);
+
+        for (i, child) in children.iter().enumerate() {
+            assert_eq!(
+                *world.get::<GlobalTransform>(*child).unwrap(),
+                GlobalTransform::from_xyz(i as f32, 1.0, 0.0)
+            );
+        }
+
+        // Only the first child moves: its sibling subtrees must keep their values
+        world
+            .get_mut::<Transform>(children[0])
+            .unwrap()
+            .translation
+            .y = 5.0;
+        *world.get_mut::<GlobalTransform>(children[1]).unwrap() = GlobalTransform::identity();
+        schedule.run(&mut world);
+
+        assert_eq!(
+            *world.get::<GlobalTransform>(children[0]).unwrap(),
+            GlobalTransform::from_xyz(0.0, 5.0, 0.0)
+        );
+        assert_eq!(
+            *world.get::<GlobalTransform>(children[1]).unwrap(),
+            GlobalTransform::identity()
+        );
+    }
 }
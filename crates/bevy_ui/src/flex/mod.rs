@@ -62,7 +62,8 @@ impl FlexSurface {
             stretch.new_node(stretch_style, Vec::new()).unwrap()
         });
 
-        if !added {
+        // setting a style marks the node and its ancestors for layout, even if it is the same
+        if !added && self.stretch.style(*stretch_node).unwrap() != &stretch_style {
             self.stretch
                 .set_style(*stretch_node, stretch_style)
                 .unwrap();
@@ -138,18 +139,16 @@ without UI components as a child of an entity with UI components, results may be
                 .unwrap()
         });
 
-        stretch
-            .set_style(
-                *node,
-                stretch::style::Style {
-                    size: stretch::geometry::Size {
-                        width: stretch::style::Dimension::Points(window.physical_width() as f32),
-                        height: stretch::style::Dimension::Points(window.physical_height() as f32),
-                    },
-                    ..Default::default()
-                },
-            )
-            .unwrap();
+        let style = stretch::style::Style {
+            size: stretch::geometry::Size {
+                width: stretch::style::Dimension::Points(window.physical_width() as f32),
+                height: stretch::style::Dimension::Points(window.physical_height() as f32),
+            },
+            ..Default::default()
+        };
+        if stretch.style(*node).unwrap() != &style {
+            stretch.set_style(*node, style).unwrap();
+        }
     }
 
     pub fn set_window_children(
@@ -161,17 +160,27 @@ without UI components as a child of an entity with UI components, results may be
         let child_nodes = children
             .map(|e| *self.entity_to_stretch.get(&e).unwrap())
             .collect::<Vec<stretch::node::Node>>();
-        self.stretch
-            .set_children(*stretch_node, child_nodes)
-            .unwrap();
+        if self.stretch.children(*stretch_node).unwrap() != child_nodes {
+            self.stretch
+                .set_children(*stretch_node, child_nodes)
+                .unwrap();
+        }
     }
 
-    pub fn compute_window_layouts(&mut self) {
+    /// Computes the layout of the windows that have a node which changed since their last layout.
+    /// Returns `false` if no layout was computed.
+    pub fn compute_window_layouts(&mut self) -> bool {
+        let mut computed = false;
         for window_node in self.window_nodes.values() {
-            self.stretch
-                .compute_layout(*window_node, stretch::geometry::Size::undefined())
-                .unwrap();
+            // changes mark the changed node and all of its ancestors dirty
+            if self.stretch.dirty(*window_node).unwrap() {
+                self.stretch
+                    .compute_layout(*window_node, stretch::geometry::Size::undefined())
+                    .unwrap();
+                computed = true;
+            }
         }
+        computed
     }
 
     pub fn get_layout(&self, entity: Entity) -> Result<&stretch::result::Layout, FlexError> {
@@ -222,7 +231,8 @@ pub fn flex_node_system(
         1.
     };
 
-    if scale_factor_events.iter().next_back().is_some() {
+    let scale_factor_changed = scale_factor_events.iter().next_back().is_some();
+    if scale_factor_changed {
         update_changed(
             &mut *flex_surface,
             logical_to_physical_factor,
@@ -266,21 +276,28 @@ pub fn flex_node_system(
         flex_surface.update_children(entity, &children);
     }
 
-    // compute layouts
-    flex_surface.compute_window_layouts();
+    // compute layouts. unchanged layouts are still converted to the new logical sizes when the
+    // scale factor changed
+    if !flex_surface.compute_window_layouts() && !scale_factor_changed {
+        return;
+    }
 
     let physical_to_logical_factor = 1. / logical_to_physical_factor;
 
     let to_logical = |v| (physical_to_logical_factor * v as f64) as f32;
 
-    // PERF: try doing this incrementally
+    // only write the nodes whose layout moved them, so that unchanged nodes don't trigger
+    // transform propagation and uniform updates
     for (entity, mut node, mut transform, parent) in node_transform_query.iter_mut() {
         let layout = flex_surface.get_layout(entity).unwrap();
-        node.size = Vec2::new(
+        let size = Vec2::new(
             to_logical(layout.size.width),
             to_logical(layout.size.height),
         );
-        let position = &mut transform.translation;
+        if node.size != size {
+            node.size = size;
+        }
+        let mut position = transform.translation;
         position.x = to_logical(layout.location.x + layout.size.width / 2.0);
         position.y = to_logical(layout.location.y + layout.size.height / 2.0);
         if let Some(parent) = parent {
@@ -289,5 +306,8 @@ pub fn flex_node_system(
                 position.y -= to_logical(parent_layout.size.height / 2.0);
             }
         }
+        if transform.translation != position {
+            transform.translation = position;
+        }
     }
 }
@@ -7,7 +7,7 @@ use bevy_ecs::{
 };
 use bevy_math::Size;
 use bevy_render::{
-    draw::{Draw, DrawContext, Drawable, OutsideFrustum},
+    draw::{Draw, DrawContext, DrawError, Drawable, OutsideFrustum},
     mesh::Mesh,
     prelude::{Msaa, Visible},
     renderer::RenderResourceBindings,
@@ -178,7 +178,11 @@ pub fn draw_text_system(
                 alignment_offset: (node.size / -2.0).extend(0.0),
             };
 
-            drawable_text.draw(&mut draw, &mut context).unwrap();
+            match drawable_text.draw(&mut draw, &mut context) {
+                // the text is drawn once its pipeline is compiled
+                Ok(()) | Err(DrawError::PipelineNotReady) => {}
+                Err(err) => panic!("{}", err),
+            }
         }
     }
 }
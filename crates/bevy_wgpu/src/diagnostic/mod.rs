@@ -1,2 +1,6 @@
+mod render_graph_diagnostics_plugin;
 mod wgpu_resource_diagnostics_plugin;
+pub use render_graph_diagnostics_plugin::{
+    RenderGraphDiagnosticsPlugin, RenderGraphDiagnosticsState,
+};
 pub use wgpu_resource_diagnostics_plugin::WgpuResourceDiagnosticsPlugin;
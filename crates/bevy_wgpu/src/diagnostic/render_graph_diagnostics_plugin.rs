@@ -0,0 +1,83 @@
+use crate::renderer::RenderGraphTimings;
+use bevy_app::prelude::*;
+use bevy_diagnostic::{ChromeTrace, Diagnostic, DiagnosticId, Diagnostics};
+use bevy_ecs::system::{IntoSystem, ResMut};
+use bevy_utils::HashMap;
+use std::borrow::Cow;
+
+/// Adds an "encode time" diagnostic for every render graph node. With
+/// [`WgpuFeature::TimestampQuery`](crate::WgpuFeature::TimestampQuery) enabled, also adds a "gpu
+/// time" diagnostic for every node, which requires waiting on the GPU at the end of each frame.
+///
+/// If the app has a [ChromeTrace], every run of a node is also added to it.
+#[derive(Default)]
+pub struct RenderGraphDiagnosticsPlugin;
+
+/// State used by the [RenderGraphDiagnosticsPlugin]
+#[derive(Default)]
+pub struct RenderGraphDiagnosticsState {
+    /// The encode and gpu time diagnostics of each node
+    diagnostic_ids: HashMap<Cow<'static, str>, (DiagnosticId, DiagnosticId)>,
+}
+
+impl RenderGraphDiagnosticsState {
+    /// The ids of the encode and gpu time diagnostics of the node with the given name, once it
+    /// has run
+    pub fn diagnostic_ids(&self, node_name: &str) -> Option<(DiagnosticId, DiagnosticId)> {
+        self.diagnostic_ids.get(node_name).copied()
+    }
+}
+
+impl Plugin for RenderGraphDiagnosticsPlugin {
+    fn build(&self, app: &mut AppBuilder) {
+        app.init_resource::<RenderGraphTimings>()
+            .init_resource::<RenderGraphDiagnosticsState>()
+            .add_system_to_stage(CoreStage::First, Self::diagnostic_system.system());
+    }
+}
+
+impl RenderGraphDiagnosticsPlugin {
+    /// Records the nodes that ran in the last frame
+    pub fn diagnostic_system(
+        mut diagnostics: ResMut<Diagnostics>,
+        mut timings: ResMut<RenderGraphTimings>,
+        mut state: ResMut<RenderGraphDiagnosticsState>,
+        mut trace: Option<ResMut<ChromeTrace>>,
+    ) {
+        for timing in timings.drain() {
+            let gpu_ms = timing
+                .gpu_time
+                .map(|gpu_time| gpu_time.as_secs_f64() * 1000.0);
+            if let Some(trace) = &mut trace {
+                let gpu_args = [("gpu_ms", gpu_ms.unwrap_or_default())];
+                let args: &[_] = if gpu_ms.is_some() { &gpu_args } else { &[] };
+                trace.add_span(
+                    &timing.name,
+                    "render_graph",
+                    timing.thread,
+                    timing.start,
+                    timing.end,
+                    args,
+                );
+            }
+
+            let (encode_id, gpu_id) = match state.diagnostic_ids.get(&timing.name) {
+                Some(ids) => *ids,
+                None => {
+                    let ids = (DiagnosticId::default(), DiagnosticId::default());
+                    diagnostics
+                        .add(Diagnostic::new(ids.0, timing.name.clone(), 20).with_suffix("s"));
+                    diagnostics.add(
+                        Diagnostic::new(ids.1, format!("{} gpu", timing.name), 20).with_suffix("s"),
+                    );
+                    state.diagnostic_ids.insert(timing.name.clone(), ids);
+                    ids
+                }
+            };
+            diagnostics.add_measurement(encode_id, timing.run_time().as_secs_f64());
+            if let Some(gpu_time) = timing.gpu_time {
+                diagnostics.add_measurement(gpu_id, gpu_time.as_secs_f64());
+            }
+        }
+    }
+}
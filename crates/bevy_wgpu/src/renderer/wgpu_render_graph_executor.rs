@@ -1,21 +1,109 @@
 use super::{WgpuRenderContext, WgpuRenderResourceContext};
 use bevy_ecs::world::World;
 use bevy_render::{
-    render_graph::{Edge, NodeId, ResourceSlots, StageBorrow},
+    render_graph::{Edge, NodeId, OrderedJobBorrow, ResourceSlots, StageBorrow},
     renderer::RenderResourceContext,
 };
-use bevy_utils::HashMap;
-use parking_lot::RwLock;
-use std::sync::Arc;
+use bevy_tasks::ComputeTaskPool;
+use bevy_utils::{Duration, HashMap, Instant};
+use futures_lite::future;
+use std::{
+    borrow::Cow,
+    sync::Arc,
+    thread::{self, ThreadId},
+};
 
-#[derive(Debug)]
+/// When a render graph node ran during one run of the graph.
+#[derive(Debug, Clone)]
+pub struct NodeTiming {
+    pub id: NodeId,
+    pub name: Cow<'static, str>,
+    /// The thread the node was encoded on
+    pub thread: ThreadId,
+    pub start: Instant,
+    pub end: Instant,
+    /// How long the GPU took to run the commands encoded by the node. Only measured if the
+    /// device has [`wgpu::Features::TIMESTAMP_QUERY`].
+    pub gpu_time: Option<Duration>,
+}
+
+impl NodeTiming {
+    /// How long the node took to encode its commands
+    pub fn run_time(&self) -> Duration {
+        self.end - self.start
+    }
+}
+
+/// Timings of the render graph nodes that ran since the last [RenderGraphTimings::drain].
+///
+/// Nodes are only measured while this resource exists. Measuring GPU times waits for the GPU to
+/// finish each frame before the next one is encoded.
+#[derive(Debug, Default)]
+pub struct RenderGraphTimings {
+    timings: Vec<NodeTiming>,
+}
+
+impl RenderGraphTimings {
+    pub fn iter(&self) -> impl Iterator<Item = &NodeTiming> {
+        self.timings.iter()
+    }
+
+    pub fn drain(&mut self) -> impl Iterator<Item = NodeTiming> + '_ {
+        self.timings.drain(..)
+    }
+
+    pub fn len(&self) -> usize {
+        self.timings.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.timings.is_empty()
+    }
+}
+
+impl Extend<NodeTiming> for RenderGraphTimings {
+    fn extend<T: IntoIterator<Item = NodeTiming>>(&mut self, iter: T) {
+        self.timings.extend(iter);
+    }
+}
+
+/// Encodes the jobs of each render graph stage in parallel on the [`ComputeTaskPool`], one
+/// command buffer per thread.
+///
+/// Jobs are split between threads by how long their nodes took to encode on the previous run, so
+/// that a single expensive job doesn't end up sharing a thread with most of the others.
+#[derive(Debug, Default)]
 pub struct WgpuRenderGraphExecutor {
-    pub max_thread_count: usize,
+    /// The maximum number of threads encoding a stage. Uses every thread of the
+    /// [`ComputeTaskPool`] if `None`.
+    pub max_thread_count: Option<usize>,
+    /// How long each node took to encode on the last run
+    node_times: HashMap<NodeId, Duration>,
+    /// Timings of the last run, if the world has a [RenderGraphTimings] resource
+    timings: Vec<NodeTiming>,
+    timestamps: Option<GpuTimestamps>,
+}
+
+/// Timestamp queries written before and after each node, and the buffer they are resolved into
+#[derive(Debug)]
+struct GpuTimestamps {
+    query_set: wgpu::QuerySet,
+    buffer: wgpu::Buffer,
+    /// The number of queries in `query_set`
+    count: u32,
+}
+
+/// The result of encoding a group of jobs on one thread
+struct EncodedJobs {
+    command_buffer: Option<wgpu::CommandBuffer>,
+    node_outputs: HashMap<NodeId, ResourceSlots>,
+    node_times: Vec<(NodeId, Instant, Instant)>,
+    thread: ThreadId,
 }
 
 impl WgpuRenderGraphExecutor {
     pub fn execute(
-        &self,
+        &mut self,
         world: &World,
         device: Arc<wgpu::Device>,
         queue: &mut wgpu::Queue,
@@ -30,75 +118,293 @@ impl WgpuRenderGraphExecutor {
                 .unwrap()
                 .clone()
         };
-        let node_outputs: Arc<RwLock<HashMap<NodeId, ResourceSlots>>> = Default::default();
+        let task_pool = world.get_resource::<ComputeTaskPool>();
+        let thread_count = task_pool
+            .map_or(1, |task_pool| task_pool.thread_num())
+            .min(self.max_thread_count.unwrap_or(usize::MAX))
+            .max(1);
+
+        // the name and first timestamp query of each node, while timings are recorded
+        self.timings.clear();
+        let node_info = if world.contains_resource::<RenderGraphTimings>() {
+            let node_states = stages
+                .iter()
+                .flat_map(|stage| stage.jobs.iter())
+                .flat_map(|job| job.node_states.iter());
+            let node_info = node_states
+                .enumerate()
+                .map(|(i, node_state)| {
+                    let name = node_state
+                        .name
+                        .clone()
+                        .unwrap_or(Cow::Borrowed(node_state.type_name));
+                    (node_state.id, (name, i as u32 * 2))
+                })
+                .collect::<HashMap<_, _>>();
+            if device.features().contains(wgpu::Features::TIMESTAMP_QUERY) {
+                self.reserve_timestamps(&device, node_info.len() as u32 * 2);
+            }
+            Some(node_info)
+        } else {
+            None
+        };
+        let queries = match (&node_info, &self.timestamps) {
+            (Some(node_info), Some(timestamps)) => Some((&timestamps.query_set, node_info)),
+            _ => None,
+        };
+
+        // outputs of previous stages are only read while a stage is encoded, outputs of nodes in
+        // the same stage come from earlier nodes of the same job
+        let mut node_outputs = HashMap::<NodeId, ResourceSlots>::default();
         for stage in stages.iter_mut() {
-            // TODO: sort jobs and slice by "amount of work" / weights
-            // stage.jobs.sort_by_key(|j| j.node_states.len());
-
-            let (sender, receiver) = crossbeam_channel::bounded(self.max_thread_count);
-            let chunk_size = (stage.jobs.len() + self.max_thread_count - 1) / self.max_thread_count; // divide ints rounding remainder up
-            let mut actual_thread_count = 0;
-            // crossbeam_utils::thread::scope(|s| {
-            for jobs_chunk in stage.jobs.chunks_mut(chunk_size) {
-                let sender = sender.clone();
-                let world = &*world;
-                actual_thread_count += 1;
-                let device = device.clone();
-                let render_resource_context = render_resource_context.clone();
-                let node_outputs = node_outputs.clone();
-                // s.spawn(move |_| {
-                let mut render_context = WgpuRenderContext::new(device, render_resource_context);
-                for job in jobs_chunk.iter_mut() {
-                    for node_state in job.node_states.iter_mut() {
-                        // bind inputs from connected node outputs
-                        for (i, mut input_slot) in node_state.input_slots.iter_mut().enumerate() {
-                            if let Edge::SlotEdge {
-                                output_node,
-                                output_index,
-                                ..
-                            } = node_state.edges.get_input_slot_edge(i).unwrap()
-                            {
-                                let node_outputs = node_outputs.read();
-                                let outputs = if let Some(outputs) = node_outputs.get(output_node) {
-                                    outputs
-                                } else {
-                                    panic!("Node inputs not set.")
-                                };
-
-                                let output_resource =
-                                    outputs.get(*output_index).expect("Output should be set.");
-                                input_slot.resource = Some(output_resource);
-                            } else {
-                                panic!("No edge connected to input.")
-                            }
+            let job_groups = self.group_jobs(&mut stage.jobs, thread_count);
+            let results = match task_pool {
+                Some(task_pool) if job_groups.len() > 1 => {
+                    let node_outputs = &node_outputs;
+                    task_pool.scope(|scope| {
+                        for jobs in job_groups {
+                            let device = device.clone();
+                            let render_resource_context = render_resource_context.clone();
+                            scope.spawn(async move {
+                                encode_jobs(
+                                    world,
+                                    device,
+                                    render_resource_context,
+                                    jobs,
+                                    node_outputs,
+                                    queries,
+                                )
+                            });
                         }
-                        node_state.node.update(
+                    })
+                }
+                _ => job_groups
+                    .into_iter()
+                    .map(|jobs| {
+                        encode_jobs(
                             world,
-                            &mut render_context,
-                            &node_state.input_slots,
-                            &mut node_state.output_slots,
-                        );
-
-                        node_outputs
-                            .write()
-                            .insert(node_state.id, node_state.output_slots.clone());
+                            device.clone(),
+                            render_resource_context.clone(),
+                            jobs,
+                            &node_outputs,
+                            queries,
+                        )
+                    })
+                    .collect(),
+            };
+
+            let mut command_buffers = Vec::with_capacity(results.len());
+            for result in results {
+                command_buffers.extend(result.command_buffer);
+                node_outputs.extend(result.node_outputs);
+                for (id, start, end) in result.node_times {
+                    self.node_times.insert(id, end - start);
+                    if let Some(node_info) = &node_info {
+                        self.timings.push(NodeTiming {
+                            id,
+                            name: node_info[&id].0.clone(),
+                            thread: result.thread,
+                            start,
+                            end,
+                            gpu_time: None,
+                        });
                     }
                 }
-                sender.send(render_context.finish()).unwrap();
-                // });
             }
-            // })
-            // .unwrap();
-
-            let mut command_buffers = Vec::new();
-            for _i in 0..actual_thread_count {
-                let command_buffer = receiver.recv().unwrap();
-                if let Some(command_buffer) = command_buffer {
-                    command_buffers.push(command_buffer);
+            queue.submit(command_buffers);
+        }
+
+        if let (Some(node_info), Some(timestamps)) = (&node_info, &self.timestamps) {
+            read_gpu_times(&device, queue, timestamps, node_info, &mut self.timings);
+        }
+    }
+
+    /// Takes the timings of the last run
+    pub fn drain_timings(&mut self) -> impl Iterator<Item = NodeTiming> + '_ {
+        self.timings.drain(..)
+    }
+
+    /// Makes sure there are at least `count` timestamp queries
+    fn reserve_timestamps(&mut self, device: &wgpu::Device, count: u32) {
+        if let Some(timestamps) = &self.timestamps {
+            if timestamps.count >= count {
+                return;
+            }
+        }
+        let count = count.next_power_of_two();
+        self.timestamps = Some(GpuTimestamps {
+            query_set: device.create_query_set(&wgpu::QuerySetDescriptor {
+                label: Some("render_graph_timestamps"),
+                ty: wgpu::QueryType::Timestamp,
+                count,
+            }),
+            buffer: device.create_buffer(&wgpu::BufferDescriptor {
+                label: Some("render_graph_timestamps"),
+                size: count as u64 * std::mem::size_of::<u64>() as u64,
+                usage: wgpu::BufferUsage::COPY_DST | wgpu::BufferUsage::MAP_READ,
+                mapped_at_creation: false,
+            }),
+            count,
+        });
+    }
+
+    /// Splits the jobs of a stage into at most `thread_count` groups of similar total encoding
+    /// time, by giving the slowest remaining job to the group with the least work
+    fn group_jobs<'a, 'b>(
+        &self,
+        jobs: &'b mut [OrderedJobBorrow<'a>],
+        thread_count: usize,
+    ) -> Vec<Vec<&'b mut OrderedJobBorrow<'a>>> {
+        let group_count = thread_count.min(jobs.len());
+        if group_count <= 1 {
+            return vec![jobs.iter_mut().collect()];
+        }
+
+        let mut weighted_jobs = jobs
+            .iter_mut()
+            .map(|job| {
+                // nodes that haven't run yet count as the cheapest possible node
+                let weight = job
+                    .node_states
+                    .iter()
+                    .map(|node_state| {
+                        self.node_times
+                            .get(&node_state.id)
+                            .map_or(1, |time| time.as_nanos().max(1))
+                    })
+                    .sum::<u128>();
+                (weight, job)
+            })
+            .collect::<Vec<_>>();
+        weighted_jobs.sort_by(|(a, _), (b, _)| b.cmp(a));
+
+        let mut groups = (0..group_count)
+            .map(|_| (0u128, Vec::new()))
+            .collect::<Vec<_>>();
+        for (weight, job) in weighted_jobs {
+            let (group_weight, group) = groups
+                .iter_mut()
+                .min_by_key(|(group_weight, _)| *group_weight)
+                .unwrap();
+            *group_weight += weight;
+            group.push(job);
+        }
+        groups.into_iter().map(|(_, group)| group).collect()
+    }
+}
+
+/// Resolves the timestamp queries of the last run and waits for them to add GPU times to `timings`
+fn read_gpu_times(
+    device: &wgpu::Device,
+    queue: &mut wgpu::Queue,
+    timestamps: &GpuTimestamps,
+    node_info: &HashMap<NodeId, (Cow<'static, str>, u32)>,
+    timings: &mut [NodeTiming],
+) {
+    let count = node_info.len() as u32 * 2;
+    if count == 0 {
+        return;
+    }
+    let mut command_encoder =
+        device.create_command_encoder(&wgpu::CommandEncoderDescriptor { label: None });
+    command_encoder.resolve_query_set(&timestamps.query_set, 0..count, &timestamps.buffer, 0);
+    queue.submit(Some(command_encoder.finish()));
+
+    let buffer_slice = timestamps
+        .buffer
+        .slice(..count as u64 * std::mem::size_of::<u64>() as u64);
+    let mapping = buffer_slice.map_async(wgpu::MapMode::Read);
+    device.poll(wgpu::Maintain::Wait);
+    if future::block_on(mapping).is_err() {
+        return;
+    }
+    {
+        let data = buffer_slice.get_mapped_range();
+        let ticks = data
+            .chunks_exact(std::mem::size_of::<u64>())
+            .map(|bytes| {
+                let mut tick = [0; 8];
+                tick.copy_from_slice(bytes);
+                u64::from_ne_bytes(tick)
+            })
+            .collect::<Vec<_>>();
+        let period = queue.get_timestamp_period() as f64;
+        for timing in timings.iter_mut() {
+            let query = node_info[&timing.id].1 as usize;
+            let elapsed = ticks[query + 1].saturating_sub(ticks[query]);
+            timing.gpu_time = Some(Duration::from_nanos((elapsed as f64 * period) as u64));
+        }
+    }
+    timestamps.buffer.unmap();
+}
+
+fn encode_jobs(
+    world: &World,
+    device: Arc<wgpu::Device>,
+    render_resource_context: WgpuRenderResourceContext,
+    jobs: Vec<&mut OrderedJobBorrow>,
+    stage_inputs: &HashMap<NodeId, ResourceSlots>,
+    queries: Option<(&wgpu::QuerySet, &HashMap<NodeId, (Cow<'static, str>, u32)>)>,
+) -> EncodedJobs {
+    let mut render_context = WgpuRenderContext::new(device, render_resource_context);
+    let mut node_outputs = HashMap::<NodeId, ResourceSlots>::default();
+    let mut node_times = Vec::new();
+    for job in jobs {
+        for node_state in job.node_states.iter_mut() {
+            // bind inputs from connected node outputs
+            for (i, mut input_slot) in node_state.input_slots.iter_mut().enumerate() {
+                if let Edge::SlotEdge {
+                    output_node,
+                    output_index,
+                    ..
+                } = node_state.edges.get_input_slot_edge(i).unwrap()
+                {
+                    let outputs = if let Some(outputs) = node_outputs
+                        .get(output_node)
+                        .or_else(|| stage_inputs.get(output_node))
+                    {
+                        outputs
+                    } else {
+                        panic!("Node inputs not set.")
+                    };
+
+                    let output_resource =
+                        outputs.get(*output_index).expect("Output should be set.");
+                    input_slot.resource = Some(output_resource);
+                } else {
+                    panic!("No edge connected to input.")
                 }
             }
+            let query =
+                queries.map(|(query_set, node_info)| (query_set, node_info[&node_state.id].1));
+            if let Some((query_set, index)) = query {
+                render_context
+                    .command_encoder
+                    .get_or_create(&render_context.device)
+                    .write_timestamp(query_set, index);
+            }
+            let start = Instant::now();
+            node_state.node.update(
+                world,
+                &mut render_context,
+                &node_state.input_slots,
+                &mut node_state.output_slots,
+            );
+            node_times.push((node_state.id, start, Instant::now()));
+            if let Some((query_set, index)) = query {
+                render_context
+                    .command_encoder
+                    .get_or_create(&render_context.device)
+                    .write_timestamp(query_set, index + 1);
+            }
 
-            queue.submit(command_buffers.drain(..));
+            node_outputs.insert(node_state.id, node_state.output_slots.clone());
         }
     }
+    EncodedJobs {
+        command_buffer: render_context.finish(),
+        node_outputs,
+        node_times,
+        thread: thread::current().id(),
+    }
 }
@@ -164,13 +164,22 @@ impl WgpuRenderResourceContext {
 
         let source = buffers.get(&source_buffer).unwrap();
         let destination = textures.get(&destination_texture).unwrap();
+        // compressed textures are laid out in rows of blocks
+        let block_height = self
+            .resources
+            .texture_descriptors
+            .read()
+            .get(&destination_texture)
+            .map_or(1, |descriptor| descriptor.format.block_dimensions().1);
         command_encoder.copy_buffer_to_texture(
             wgpu::ImageCopyBuffer {
                 buffer: source,
                 layout: wgpu::ImageDataLayout {
                     offset: source_offset,
                     bytes_per_row: NonZeroU32::new(source_bytes_per_row),
-                    rows_per_image: NonZeroU32::new(size.height),
+                    rows_per_image: NonZeroU32::new(
+                        (size.height + block_height - 1) / block_height,
+                    ),
                 },
             },
             wgpu::ImageCopyTexture {
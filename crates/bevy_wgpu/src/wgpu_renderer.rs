@@ -1,5 +1,5 @@
 use crate::{
-    renderer::{WgpuRenderGraphExecutor, WgpuRenderResourceContext},
+    renderer::{RenderGraphTimings, WgpuRenderGraphExecutor, WgpuRenderResourceContext},
     wgpu_type_converter::WgpuInto,
     WgpuBackend, WgpuOptions, WgpuPowerOptions,
 };
@@ -9,9 +9,49 @@ use bevy_render::{
     render_graph::{DependentNodeStager, RenderGraph, RenderGraphStager},
     renderer::RenderResourceContext,
 };
-use bevy_window::{WindowCreated, WindowResized, Windows};
+use bevy_utils::HashMap;
+use bevy_window::{WindowCreated, WindowId, WindowResized, Windows};
+use raw_window_handle::{HasRawWindowHandle, RawWindowHandle};
 use std::{ops::Deref, sync::Arc};
 
+/// Raw window handles of windows that something other than winit owns, ex: a native app that
+/// embeds Bevy in its own view. The renderer creates surfaces for these windows instead of asking
+/// winit when their [`WindowCreated`] event is sent.
+#[derive(Default)]
+pub struct ExternalWindowHandles {
+    handles: HashMap<WindowId, RawWindowHandle>,
+}
+
+// SAFE: handles are only used by the render system, and `insert` requires them to be usable from
+// the thread that runs it.
+unsafe impl Send for ExternalWindowHandles {}
+unsafe impl Sync for ExternalWindowHandles {}
+
+impl ExternalWindowHandles {
+    /// # Safety
+    /// `handle` must stay valid until it is removed, and must be usable from the thread that runs
+    /// the app's schedule.
+    pub unsafe fn insert(&mut self, id: WindowId, handle: RawWindowHandle) {
+        self.handles.insert(id, handle);
+    }
+
+    pub fn remove(&mut self, id: WindowId) -> Option<RawWindowHandle> {
+        self.handles.remove(&id)
+    }
+
+    fn get(&self, id: WindowId) -> Option<ExternalWindowHandle> {
+        self.handles.get(&id).copied().map(ExternalWindowHandle)
+    }
+}
+
+struct ExternalWindowHandle(RawWindowHandle);
+
+unsafe impl HasRawWindowHandle for ExternalWindowHandle {
+    fn raw_window_handle(&self) -> RawWindowHandle {
+        self.0
+    }
+}
+
 pub struct WgpuRenderer {
     pub instance: wgpu::Instance,
     pub device: Arc<wgpu::Device>,
@@ -19,6 +59,7 @@ pub struct WgpuRenderer {
     pub window_resized_event_reader: ManualEventReader<WindowResized>,
     pub window_created_event_reader: ManualEventReader<WindowCreated>,
     pub initialized: bool,
+    pub graph_executor: WgpuRenderGraphExecutor,
 }
 
 impl WgpuRenderer {
@@ -75,6 +116,7 @@ impl WgpuRenderer {
             window_resized_event_reader: Default::default(),
             window_created_event_reader: Default::default(),
             initialized: false,
+            graph_executor: WgpuRenderGraphExecutor::default(),
         }
     }
 
@@ -95,6 +137,15 @@ impl WgpuRenderer {
             let window = windows
                 .get(window_created_event.id)
                 .expect("Received window created event for non-existent window.");
+            let external_handle = world
+                .get_resource::<ExternalWindowHandles>()
+                .and_then(|handles| handles.get(window.id()));
+            if let Some(handle) = external_handle {
+                // SAFE: `ExternalWindowHandles::insert` requires the handle to be valid.
+                let surface = unsafe { self.instance.create_surface(&handle) };
+                render_resource_context.set_window_surface(window.id(), surface);
+                continue;
+            }
             #[cfg(feature = "bevy_winit")]
             {
                 let winit_windows = world.get_resource::<bevy_winit::WinitWindows>().unwrap();
@@ -115,10 +166,11 @@ impl WgpuRenderer {
             let mut borrowed = stages.borrow(&mut render_graph);
 
             // execute stages
-            let graph_executor = WgpuRenderGraphExecutor {
-                max_thread_count: 2,
-            };
-            graph_executor.execute(world, self.device.clone(), &mut self.queue, &mut borrowed);
+            self.graph_executor
+                .execute(world, self.device.clone(), &mut self.queue, &mut borrowed);
+            if let Some(mut timings) = world.get_resource_mut::<RenderGraphTimings>() {
+                timings.extend(self.graph_executor.drain_timings());
+            }
         })
     }
 
@@ -342,6 +342,26 @@ impl WgpuFrom<TextureFormat> for wgpu::TextureFormat {
             TextureFormat::Depth32Float => wgpu::TextureFormat::Depth32Float,
             TextureFormat::Depth24Plus => wgpu::TextureFormat::Depth24Plus,
             TextureFormat::Depth24PlusStencil8 => wgpu::TextureFormat::Depth24PlusStencil8,
+            TextureFormat::Bc1RgbaUnorm => wgpu::TextureFormat::Bc1RgbaUnorm,
+            TextureFormat::Bc1RgbaUnormSrgb => wgpu::TextureFormat::Bc1RgbaUnormSrgb,
+            TextureFormat::Bc2RgbaUnorm => wgpu::TextureFormat::Bc2RgbaUnorm,
+            TextureFormat::Bc2RgbaUnormSrgb => wgpu::TextureFormat::Bc2RgbaUnormSrgb,
+            TextureFormat::Bc3RgbaUnorm => wgpu::TextureFormat::Bc3RgbaUnorm,
+            TextureFormat::Bc3RgbaUnormSrgb => wgpu::TextureFormat::Bc3RgbaUnormSrgb,
+            TextureFormat::Bc4RUnorm => wgpu::TextureFormat::Bc4RUnorm,
+            TextureFormat::Bc4RSnorm => wgpu::TextureFormat::Bc4RSnorm,
+            TextureFormat::Bc5RgUnorm => wgpu::TextureFormat::Bc5RgUnorm,
+            TextureFormat::Bc5RgSnorm => wgpu::TextureFormat::Bc5RgSnorm,
+            TextureFormat::Bc6hRgbUfloat => wgpu::TextureFormat::Bc6hRgbUfloat,
+            TextureFormat::Bc6hRgbSfloat => wgpu::TextureFormat::Bc6hRgbSfloat,
+            TextureFormat::Bc7RgbaUnorm => wgpu::TextureFormat::Bc7RgbaUnorm,
+            TextureFormat::Bc7RgbaUnormSrgb => wgpu::TextureFormat::Bc7RgbaUnormSrgb,
+            TextureFormat::Etc2RgbUnorm => wgpu::TextureFormat::Etc2RgbUnorm,
+            TextureFormat::Etc2RgbUnormSrgb => wgpu::TextureFormat::Etc2RgbUnormSrgb,
+            TextureFormat::Etc2RgbA1Unorm => wgpu::TextureFormat::Etc2RgbA1Unorm,
+            TextureFormat::Etc2RgbA1UnormSrgb => wgpu::TextureFormat::Etc2RgbA1UnormSrgb,
+            TextureFormat::Etc2RgbA8Unorm => wgpu::TextureFormat::Etc2RgbA8Unorm,
+            TextureFormat::Etc2RgbA8UnormSrgb => wgpu::TextureFormat::Etc2RgbA8UnormSrgb,
         }
     }
 }
@@ -0,0 +1,70 @@
+use bevy::{
+    diagnostic::{FrameTimeDiagnosticsPlugin, LogDiagnosticsPlugin},
+    prelude::*,
+};
+use rand::{rngs::StdRng, Rng, SeedableRng};
+
+/// This example spawns a large number of sprites from a single texture and a single sprite sheet.
+/// Sprites with the `BatchedSprite` component that share a material or texture atlas are drawn
+/// with one draw call per batch. For the best results, run it in release mode:
+/// ```bash
+/// cargo run --example sprite_batching --release
+/// ```
+fn main() {
+    App::build()
+        .add_plugins(DefaultPlugins)
+        .add_plugin(FrameTimeDiagnosticsPlugin::default())
+        .add_plugin(LogDiagnosticsPlugin::default())
+        .add_startup_system(setup.system())
+        .add_system(spin_sprites.system())
+        .run();
+}
+
+fn spin_sprites(time: Res<Time>, mut query: Query<&mut Transform, With<BatchedSprite>>) {
+    for mut transform in query.iter_mut() {
+        transform.rotate(Quat::from_rotation_z(time.delta_seconds()));
+    }
+}
+
+fn setup(
+    mut commands: Commands,
+    asset_server: Res<AssetServer>,
+    mut materials: ResMut<Assets<ColorMaterial>>,
+    mut texture_atlases: ResMut<Assets<TextureAtlas>>,
+) {
+    commands.spawn_bundle(OrthographicCameraBundle::new_2d());
+
+    let material = materials.add(asset_server.load("branding/icon.png").into());
+    let texture_atlas = texture_atlases.add(TextureAtlas::from_grid(
+        asset_server.load("textures/rpg/chars/gabe/gabe-idle-run.png"),
+        Vec2::new(24.0, 24.0),
+        7,
+        1,
+    ));
+
+    let mut rng = StdRng::from_entropy();
+    let mut random_transform = |scale: f32| Transform {
+        translation: Vec3::new(
+            rng.gen_range(-600.0..600.0),
+            rng.gen_range(-350.0..350.0),
+            rng.gen_range(0.0..1.0),
+        ),
+        scale: Vec3::splat(scale),
+        ..Default::default()
+    };
+    for _ in 0..10000 {
+        commands.spawn_bundle(BatchedSpriteBundle {
+            material: material.clone(),
+            transform: random_transform(0.05),
+            ..Default::default()
+        });
+    }
+    for i in 0..10000u32 {
+        commands.spawn_bundle(BatchedSpriteSheetBundle {
+            texture_atlas: texture_atlas.clone(),
+            sprite: TextureAtlasSprite::new(i % 7),
+            transform: random_transform(1.0),
+            ..Default::default()
+        });
+    }
+}
@@ -0,0 +1,105 @@
+use bevy::{
+    diagnostic::{FrameTimeDiagnosticsPlugin, LogDiagnosticsPlugin},
+    prelude::*,
+    render::{
+        mesh::{Indices, VertexAttributeValues},
+        pipeline::PrimitiveTopology,
+    },
+};
+
+/// This example deforms a large grid mesh every frame. The mesh is marked as dynamic, so its gpu
+/// buffers are kept and only the changed parts of its vertex data are uploaded each frame.
+fn main() {
+    App::build()
+        .add_plugins(DefaultPlugins)
+        .add_plugin(FrameTimeDiagnosticsPlugin::default())
+        .add_plugin(LogDiagnosticsPlugin::default())
+        .add_startup_system(setup.system())
+        .add_system(wave.system())
+        .run();
+}
+
+const GRID_SIZE: usize = 128;
+const GRID_SPACING: f32 = 0.25;
+
+struct WaveMesh(Handle<Mesh>);
+
+fn setup(
+    mut commands: Commands,
+    mut meshes: ResMut<Assets<Mesh>>,
+    mut materials: ResMut<Assets<StandardMaterial>>,
+) {
+    let mut mesh = grid(GRID_SIZE, GRID_SPACING);
+    mesh.set_dynamic(true);
+    let mesh = meshes.add(mesh);
+    commands.insert_resource(WaveMesh(mesh.clone()));
+    commands.spawn_bundle(PbrBundle {
+        mesh,
+        material: materials.add(Color::rgb(0.2, 0.4, 0.8).into()),
+        ..Default::default()
+    });
+    // light
+    commands.spawn_bundle(PointLightBundle {
+        transform: Transform::from_xyz(4.0, 12.0, 4.0),
+        ..Default::default()
+    });
+    // camera
+    commands.spawn_bundle(PerspectiveCameraBundle {
+        transform: Transform::from_xyz(-20.0, 15.0, 20.0).looking_at(Vec3::ZERO, Vec3::Y),
+        ..Default::default()
+    });
+}
+
+/// A flat, indexed grid of `size` by `size` vertices centered on the origin
+fn grid(size: usize, spacing: f32) -> Mesh {
+    let offset = (size - 1) as f32 * spacing / 2.0;
+    let mut positions = Vec::with_capacity(size * size);
+    let mut uvs = Vec::with_capacity(size * size);
+    for z in 0..size {
+        for x in 0..size {
+            positions.push([
+                x as f32 * spacing - offset,
+                0.0,
+                z as f32 * spacing - offset,
+            ]);
+            uvs.push([x as f32 / (size - 1) as f32, z as f32 / (size - 1) as f32]);
+        }
+    }
+    let mut indices = Vec::with_capacity((size - 1) * (size - 1) * 6);
+    for z in 0..size as u32 - 1 {
+        for x in 0..size as u32 - 1 {
+            let i = z * size as u32 + x;
+            let below = i + size as u32;
+            indices.extend_from_slice(&[i, below, i + 1, i + 1, below, below + 1]);
+        }
+    }
+
+    let mut mesh = Mesh::new(PrimitiveTopology::TriangleList);
+    mesh.set_indices(Some(Indices::U32(indices)));
+    mesh.set_attribute(Mesh::ATTRIBUTE_NORMAL, vec![[0.0, 1.0, 0.0]; size * size]);
+    mesh.set_attribute(Mesh::ATTRIBUTE_POSITION, positions);
+    mesh.set_attribute(Mesh::ATTRIBUTE_UV_0, uvs);
+    mesh
+}
+
+fn wave(time: Res<Time>, wave_mesh: Res<WaveMesh>, mut meshes: ResMut<Assets<Mesh>>) {
+    let t = time.seconds_since_startup() as f32 * 2.0;
+    let mesh = meshes.get_mut(&wave_mesh.0).unwrap();
+    let mut slopes = Vec::with_capacity(GRID_SIZE * GRID_SIZE);
+    if let Some(VertexAttributeValues::Float32x3(positions)) =
+        mesh.attribute_mut(Mesh::ATTRIBUTE_POSITION)
+    {
+        for position in positions.iter_mut() {
+            let (x, z) = (position[0] * 0.5 + t, position[2] * 0.5 + t);
+            position[1] = x.sin() * z.cos();
+            slopes.push((0.5 * x.cos() * z.cos(), -0.5 * x.sin() * z.sin()));
+        }
+    }
+    if let Some(VertexAttributeValues::Float32x3(normals)) =
+        mesh.attribute_mut(Mesh::ATTRIBUTE_NORMAL)
+    {
+        for (normal, (dx, dz)) in normals.iter_mut().zip(slopes) {
+            *normal = Vec3::new(-dx, 1.0, -dz).normalize().into();
+        }
+    }
+}
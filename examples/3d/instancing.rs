@@ -0,0 +1,63 @@
+use bevy::{
+    diagnostic::{FrameTimeDiagnosticsPlugin, LogDiagnosticsPlugin},
+    prelude::*,
+};
+use rand::{rngs::StdRng, Rng, SeedableRng};
+
+/// This example spawns a large number of cubes that share a mesh and a handful of materials.
+/// Entities with the `Instanced` component that share a mesh and material are drawn with a single
+/// instanced draw call. For the best results, run it in release mode:
+/// ```bash
+/// cargo run --example instancing --release
+/// ```
+fn main() {
+    App::build()
+        .add_plugins(DefaultPlugins)
+        .add_plugin(FrameTimeDiagnosticsPlugin::default())
+        .add_plugin(LogDiagnosticsPlugin::default())
+        .add_startup_system(setup.system())
+        .add_system(rotate_cubes.system())
+        .run();
+}
+
+fn rotate_cubes(time: Res<Time>, mut query: Query<&mut Transform, With<Instanced>>) {
+    for mut transform in query.iter_mut() {
+        transform.rotate(Quat::from_rotation_y(time.delta_seconds()));
+    }
+}
+
+fn setup(
+    mut commands: Commands,
+    mut meshes: ResMut<Assets<Mesh>>,
+    mut materials: ResMut<Assets<StandardMaterial>>,
+) {
+    // light
+    commands.spawn_bundle(PointLightBundle {
+        transform: Transform::from_xyz(4.0, -4.0, 5.0),
+        ..Default::default()
+    });
+    // camera
+    commands.spawn_bundle(PerspectiveCameraBundle {
+        transform: Transform::from_xyz(0.0, 15.0, 150.0).looking_at(Vec3::ZERO, Vec3::Y),
+        ..Default::default()
+    });
+
+    let mut rng = StdRng::from_entropy();
+    let cube_handle = meshes.add(Mesh::from(shape::Cube { size: 1.0 }));
+    let material_handles = [Color::RED, Color::GREEN, Color::BLUE]
+        .iter()
+        .map(|color| materials.add((*color).into()))
+        .collect::<Vec<_>>();
+    for i in 0..10000 {
+        commands.spawn_bundle(InstancedPbrBundle {
+            mesh: cube_handle.clone(),
+            material: material_handles[i % material_handles.len()].clone(),
+            transform: Transform::from_xyz(
+                rng.gen_range(-50.0..50.0),
+                rng.gen_range(-50.0..50.0),
+                0.0,
+            ),
+            ..Default::default()
+        });
+    }
+}
@@ -0,0 +1,21 @@
+use bevy::{audio::StreamingAudioSource, prelude::*};
+
+/// This example illustrates how to stream a long audio file while it plays instead of loading it
+/// into memory
+fn main() {
+    App::build()
+        .add_plugins(DefaultPlugins)
+        .add_startup_system(setup.system())
+        .run();
+}
+
+fn setup(
+    asset_server: Res<AssetServer>,
+    mut streaming_audio_sources: ResMut<Assets<StreamingAudioSource>>,
+    audio: Res<Audio<StreamingAudioSource>>,
+) {
+    match StreamingAudioSource::new(&asset_server, "sounds/Windless Slopes.mp3") {
+        Ok(music) => audio.play(streaming_audio_sources.add(music)),
+        Err(err) => error!("Could not open the music: {}", err),
+    }
+}
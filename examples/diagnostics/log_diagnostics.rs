@@ -17,5 +17,11 @@ fn main() {
         // .add_plugin(bevy::diagnostic::EntityCountDiagnosticsPlugin::default())
         // Uncomment this to add an asset count diagnostics:
         // .add_plugin(bevy::asset::diagnostic::AssetCountDiagnosticsPlugin::<Texture>::default())
+        // Uncomment this to add run time diagnostics for every system:
+        // .add_plugin(bevy::diagnostic::SystemTimingDiagnosticsPlugin::default())
+        // Uncomment this to add encode time diagnostics for every render graph node:
+        // .add_plugin(bevy::wgpu::diagnostic::RenderGraphDiagnosticsPlugin::default())
+        // Uncomment this to also write those timings to trace.json, for chrome://tracing:
+        // .add_plugin(bevy::diagnostic::ChromeTracePlugin::default())
         .run();
 }
@@ -1 +1,34 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Runs the app on winit's event loop. Never returns.
 void main_rs(void);
+
+// A Bevy app whose frames are driven by the host, e.g. from a CADisplayLink callback.
+// No winit window is created, the app renders into a host-provided view instead.
+typedef struct HostApp HostApp;
+
+// `ui_view` must be a UIView backed by a CAMetalLayer that outlives the app. Sizes are in
+// physical pixels. The app must only be used from the main thread.
+HostApp *bevy_app_create(void *ui_view, uint32_t width, uint32_t height, double scale_factor);
+// Call when the view's size or scale factor changes.
+void bevy_app_resize(HostApp *app, uint32_t width, uint32_t height, double scale_factor);
+// Runs one frame. Does nothing while the app is suspended.
+void bevy_app_update(HostApp *app);
+void bevy_app_suspend(HostApp *app);
+void bevy_app_resume(HostApp *app);
+void bevy_app_destroy(HostApp *app);
+
+// Hands a host-owned byte range back to the host once Bevy has copied it.
+typedef void (*BevyReleaseCallback)(const uint8_t *ptr, size_t len, void *user_data);
+
+// Registers already decoded, tightly packed sRGB RGBA8 pixels as the texture at `path`, so
+// `AssetServer::get_handle(path)` resolves without reading or decoding a file. `release` is
+// called before returning. Returns false if `len` does not match `width * height * 4`.
+bool bevy_app_register_texture_rgba8(HostApp *app, const char *path, uint32_t width,
+                                     uint32_t height, const uint8_t *ptr, size_t len,
+                                     BevyReleaseCallback release, void *user_data);
+// Registers an encoded audio file (e.g. memory mapped bundle data) as the audio at `path`.
+bool bevy_app_register_audio(HostApp *app, const char *path, const uint8_t *ptr, size_t len,
+                             BevyReleaseCallback release, void *user_data);
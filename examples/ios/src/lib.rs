@@ -1,21 +1,279 @@
-use bevy::{prelude::*, window::WindowMode};
+use bevy::{
+    app::Events,
+    audio::AudioSource,
+    prelude::*,
+    render::texture::{Extent3d, TextureDimension, TextureFormat},
+    wgpu::ExternalWindowHandles,
+    window::{WindowCreated, WindowId, WindowMode, WindowResized, WindowScaleFactorChanged},
+    winit::WinitPlugin,
+};
+use raw_window_handle::{ios::IOSHandle, RawWindowHandle};
+use std::{
+    ffi::CStr,
+    os::raw::{c_char, c_void},
+    slice,
+};
 
 // the `bevy_main` proc_macro generates the required ios boilerplate
 #[bevy_main]
 fn main() {
-    App::build()
-        .insert_resource(WindowDescriptor {
-            vsync: true,
-            resizable: false,
-            mode: WindowMode::BorderlessFullscreen,
-            ..Default::default()
+    let mut app = App::build();
+    app.insert_resource(WindowDescriptor {
+        vsync: true,
+        resizable: false,
+        mode: WindowMode::BorderlessFullscreen,
+        ..Default::default()
+    })
+    .insert_resource(Msaa { samples: 4 })
+    .add_plugins(DefaultPlugins);
+    add_game(&mut app);
+    app.run();
+}
+
+fn add_game(app: &mut AppBuilder) {
+    app.add_startup_system(setup_scene.system())
+        .add_startup_system(setup_music.system());
+}
+
+/// An [`App`] whose frames are driven by the native host (for example from a `CADisplayLink`
+/// callback) instead of by the winit event loop.
+///
+/// winit owns `UIApplicationMain` on iOS, so the host creates the view instead and the app renders
+/// into it as its primary window. Everything else (assets, audio, game logic) runs exactly as it
+/// does under [`App::run`].
+pub struct HostApp {
+    app: App,
+    suspended: bool,
+}
+
+/// Builds the app, rendering into `ui_view`, which must be backed by a `CAMetalLayer`. The size is
+/// in physical pixels. Startup systems run on the first [`bevy_app_update`]. The returned pointer
+/// must be released with [`bevy_app_destroy`].
+///
+/// # Safety
+/// `ui_view` must stay alive until the app is destroyed, and the app must only be used from the
+/// main thread.
+#[no_mangle]
+pub unsafe extern "C" fn bevy_app_create(
+    ui_view: *mut c_void,
+    width: u32,
+    height: u32,
+    scale_factor: f64,
+) -> *mut HostApp {
+    let mut builder = App::build();
+    let mut window_handles = ExternalWindowHandles::default();
+    window_handles.insert(
+        WindowId::primary(),
+        RawWindowHandle::IOS(IOSHandle {
+            ui_view,
+            ..IOSHandle::empty()
+        }),
+    );
+    builder
+        .insert_resource(window_handles)
+        .add_plugins_with(DefaultPlugins, |group| group.disable::<WinitPlugin>());
+    add_game(&mut builder);
+
+    // without winit the primary window is never created from its `CreateWindow` event, so create
+    // it for the host's view directly
+    let world = builder.world_mut();
+    let window_descriptor = world
+        .get_resource::<WindowDescriptor>()
+        .cloned()
+        .unwrap_or_default();
+    let window = Window::new(
+        WindowId::primary(),
+        &window_descriptor,
+        width,
+        height,
+        scale_factor,
+        None,
+    );
+    world.get_resource_mut::<Windows>().unwrap().add(window);
+    world
+        .get_resource_mut::<Events<WindowCreated>>()
+        .unwrap()
+        .send(WindowCreated {
+            id: WindowId::primary(),
+        });
+
+    Box::into_raw(Box::new(HostApp {
+        app: std::mem::take(&mut builder.app),
+        suspended: false,
+    }))
+}
+
+/// Tells the app that the host's view changed size (in physical pixels) or scale factor. The
+/// swap chain is recreated on the next [`bevy_app_update`].
+///
+/// # Safety
+/// `app` must be a pointer returned by [`bevy_app_create`] that has not been destroyed.
+#[no_mangle]
+pub unsafe extern "C" fn bevy_app_resize(
+    app: *mut HostApp,
+    width: u32,
+    height: u32,
+    scale_factor: f64,
+) {
+    let world = &mut (*app).app.world;
+    let (scale_factor_changed, logical_width, logical_height) = {
+        let mut windows = world.get_resource_mut::<Windows>().unwrap();
+        let window = windows.get_primary_mut().unwrap();
+        let scale_factor_changed = window.scale_factor() != scale_factor;
+        window.update_scale_factor_from_backend(scale_factor);
+        window.update_actual_size_from_backend(width, height);
+        (scale_factor_changed, window.width(), window.height())
+    };
+
+    if scale_factor_changed {
+        world
+            .get_resource_mut::<Events<WindowScaleFactorChanged>>()
+            .unwrap()
+            .send(WindowScaleFactorChanged {
+                id: WindowId::primary(),
+                scale_factor,
+            });
+    }
+    world
+        .get_resource_mut::<Events<WindowResized>>()
+        .unwrap()
+        .send(WindowResized {
+            id: WindowId::primary(),
+            width: logical_width,
+            height: logical_height,
+        });
+}
+
+/// Runs one frame of the app's schedule. Does nothing while the app is suspended.
+///
+/// # Safety
+/// `app` must be a pointer returned by [`bevy_app_create`] that has not been destroyed.
+#[no_mangle]
+pub unsafe extern "C" fn bevy_app_update(app: *mut HostApp) {
+    let host_app = &mut *app;
+    if !host_app.suspended {
+        host_app.app.update();
+    }
+}
+
+/// Stops [`bevy_app_update`] from running frames until [`bevy_app_resume`] is called. Call this
+/// when the host moves to the background.
+///
+/// # Safety
+/// `app` must be a pointer returned by [`bevy_app_create`] that has not been destroyed.
+#[no_mangle]
+pub unsafe extern "C" fn bevy_app_suspend(app: *mut HostApp) {
+    (*app).suspended = true;
+}
+
+/// Resumes running frames after [`bevy_app_suspend`].
+///
+/// # Safety
+/// `app` must be a pointer returned by [`bevy_app_create`] that has not been destroyed.
+#[no_mangle]
+pub unsafe extern "C" fn bevy_app_resume(app: *mut HostApp) {
+    (*app).suspended = false;
+}
+
+/// Drops the app and everything in its world.
+///
+/// # Safety
+/// `app` must be a pointer returned by [`bevy_app_create`]. It must not be used afterwards.
+#[no_mangle]
+pub unsafe extern "C" fn bevy_app_destroy(app: *mut HostApp) {
+    if !app.is_null() {
+        drop(Box::from_raw(app));
+    }
+}
+
+/// Called by the bridge once it no longer needs a host-owned byte range.
+pub type ReleaseCallback = extern "C" fn(ptr: *const u8, len: usize, user_data: *mut c_void);
+
+/// Copies host-owned bytes into an asset of type `T` stored at `path`, then hands the range back
+/// to the host through `release`.
+///
+/// Assets registered this way never touch `AssetIo` or a decoder: the host's buffer is the only
+/// copy besides the one Bevy keeps. Game code reaches them with
+/// `AssetServer::get_handle(path)`.
+unsafe fn register_external_asset<T: bevy::asset::Asset>(
+    app: *mut HostApp,
+    path: *const c_char,
+    ptr: *const u8,
+    len: usize,
+    release: Option<ReleaseCallback>,
+    user_data: *mut c_void,
+    into_asset: impl FnOnce(&[u8]) -> Option<T>,
+) -> bool {
+    let host_app = &mut *app;
+    let path = match CStr::from_ptr(path).to_str() {
+        Ok(path) => path,
+        Err(_) => return false,
+    };
+    let asset = into_asset(slice::from_raw_parts(ptr, len));
+    if let Some(release) = release {
+        release(ptr, len, user_data);
+    }
+    let asset = match asset {
+        Some(asset) => asset,
+        None => return false,
+    };
+    let mut assets = host_app.app.world.get_resource_mut::<Assets<T>>().unwrap();
+    assets.set_untracked(path, asset);
+    true
+}
+
+/// Registers tightly packed, already decoded sRGB RGBA8 pixels as the [`Texture`] at `path`.
+/// Returns `false` if `len` does not match `width * height * 4`.
+///
+/// # Safety
+/// `app` must be a live pointer returned by [`bevy_app_create`], `path` a nul-terminated string
+/// and `ptr` must be valid for reads of `len` bytes until `release` is called.
+#[no_mangle]
+#[allow(clippy::too_many_arguments)]
+pub unsafe extern "C" fn bevy_app_register_texture_rgba8(
+    app: *mut HostApp,
+    path: *const c_char,
+    width: u32,
+    height: u32,
+    ptr: *const u8,
+    len: usize,
+    release: Option<ReleaseCallback>,
+    user_data: *mut c_void,
+) -> bool {
+    register_external_asset(app, path, ptr, len, release, user_data, |bytes| {
+        if bytes.len() != width as usize * height as usize * 4 {
+            return None;
+        }
+        Some(Texture::new(
+            Extent3d::new(width, height, 1),
+            TextureDimension::D2,
+            bytes.to_vec(),
+            TextureFormat::Rgba8UnormSrgb,
+        ))
+    })
+}
+
+/// Registers an encoded audio file (for example a memory mapped bundle resource) as the
+/// [`AudioSource`] at `path`.
+///
+/// # Safety
+/// Same requirements as [`bevy_app_register_texture_rgba8`].
+#[no_mangle]
+pub unsafe extern "C" fn bevy_app_register_audio(
+    app: *mut HostApp,
+    path: *const c_char,
+    ptr: *const u8,
+    len: usize,
+    release: Option<ReleaseCallback>,
+    user_data: *mut c_void,
+) -> bool {
+    register_external_asset(app, path, ptr, len, release, user_data, |bytes| {
+        Some(AudioSource {
+            bytes: bytes.into(),
         })
-        .insert_resource(Msaa { samples: 4 })
-        .add_plugins(DefaultPlugins)
-        .add_startup_system(setup_scene.system())
-        .add_startup_system(setup_music.system())
-        .run();
+    })
 }
+
 /// set up a simple 3D scene
 fn setup_scene(
     mut commands: Commands,
@@ -0,0 +1,104 @@
+use bevy_asset::{ArchiveCompression, AssetArchiveBuilder};
+use std::{
+    fs::{self, File},
+    io::{BufWriter, Write},
+    path::{Path, PathBuf},
+    process,
+};
+
+const USAGE: &str = "usage: asset_archive [--compress] <asset folder> <output archive>";
+
+/// Files that are already compressed are always stored as is: deflating them saves next to
+/// nothing, and stored entries can be read in ranges (ex: streamed audio) without decompressing the
+/// whole file
+const PRECOMPRESSED_EXTENSIONS: &[&str] = &["mp3", "ogg", "oga", "flac", "png", "jpg", "jpeg"];
+
+fn main() {
+    let mut compression = ArchiveCompression::None;
+    let mut paths = Vec::new();
+    for arg in std::env::args().skip(1) {
+        match arg.as_str() {
+            "--compress" => compression = ArchiveCompression::Deflate,
+            "-h" | "--help" => {
+                println!("{}", USAGE);
+                return;
+            }
+            _ => paths.push(PathBuf::from(arg)),
+        }
+    }
+    let (input, output) = match paths.as_slice() {
+        [input, output] => (input, output),
+        _ => {
+            eprintln!("{}", USAGE);
+            process::exit(2);
+        }
+    };
+
+    let mut files = Vec::new();
+    if let Err(err) = collect_files(input, &mut files) {
+        eprintln!("failed to read {}: {}", input.display(), err);
+        process::exit(1);
+    }
+    // a stable order keeps archives reproducible
+    files.sort();
+
+    let mut builder = AssetArchiveBuilder::default();
+    let mut total_size = 0;
+    for file in files.iter() {
+        let relative_path = file.strip_prefix(input).unwrap();
+        let result = fs::read(file).and_then(|bytes| {
+            total_size += bytes.len();
+            builder.add_file(relative_path, bytes, file_compression(file, compression))
+        });
+        if let Err(err) = result {
+            eprintln!("failed to add {}: {}", file.display(), err);
+            process::exit(1);
+        }
+    }
+
+    let result = File::create(output).and_then(|file| {
+        let mut writer = BufWriter::new(file);
+        builder.write(&mut writer)?;
+        writer.flush()
+    });
+    if let Err(err) = result {
+        eprintln!("failed to write {}: {}", output.display(), err);
+        process::exit(1);
+    }
+    let archive_size = fs::metadata(output).map_or(0, |metadata| metadata.len());
+    println!(
+        "packed {} files ({} bytes) into {} ({} bytes)",
+        files.len(),
+        total_size,
+        output.display(),
+        archive_size
+    );
+}
+
+fn file_compression(path: &Path, compression: ArchiveCompression) -> ArchiveCompression {
+    let precompressed = path
+        .extension()
+        .and_then(|extension| extension.to_str())
+        .map_or(false, |extension| {
+            PRECOMPRESSED_EXTENSIONS
+                .iter()
+                .any(|precompressed| extension.eq_ignore_ascii_case(precompressed))
+        });
+    if precompressed {
+        ArchiveCompression::None
+    } else {
+        compression
+    }
+}
+
+fn collect_files(directory: &Path, files: &mut Vec<PathBuf>) -> std::io::Result<()> {
+    for entry in fs::read_dir(directory)? {
+        let path = entry?.path();
+        if path.is_dir() {
+            collect_files(&path, files)?;
+        } else {
+            files.push(path);
+        }
+    }
+    Ok(())
+}